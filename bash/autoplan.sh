@@ -0,0 +1,22 @@
+export sourceName="mainAutoPlan"
+
+# COMPILE
+cd build
+cmake ..
+make
+cd ..
+echo ""
+
+# PARAMETERS
+medium="gulfMexicoShale";
+tolerance=1e-3;
+
+# RUN
+# The models are fitted to the convergence cases of export/manifest.jsonl, the pilot cases and
+# the planned ones are added to it; -plan_safety, -plan_max_mesh, -plan_max_steps and
+# -plan_attempts may be appended to the command line
+cd build
+echo "-- Planning and solving Terzaghi"
+./$sourceName ${medium} ${tolerance}
+cd ..
+echo ""
@@ -47,11 +47,11 @@ do
 	rm -rf export/*
 	cd build
 	echo "-- Testing method's dimensionless stability"
-	./$sourceName ${gridType[$i]} ${interpScheme[$i]} "alundum"
-	./$sourceName ${gridType[$i]} ${interpScheme[$i]} "ohioSandstone"
-	./$sourceName ${gridType[$i]} ${interpScheme[$i]} "danianChalk"
-	./$sourceName ${gridType[$i]} ${interpScheme[$i]} "coarseSand"
-	./$sourceName ${gridType[$i]} ${interpScheme[$i]} "hardSediment"
+	./$sourceName ${gridType[$i]} ${interpScheme[$i]} "alundum" "cached"
+	./$sourceName ${gridType[$i]} ${interpScheme[$i]} "ohioSandstone" "cached"
+	./$sourceName ${gridType[$i]} ${interpScheme[$i]} "danianChalk" "cached"
+	./$sourceName ${gridType[$i]} ${interpScheme[$i]} "coarseSand" "cached"
+	./$sourceName ${gridType[$i]} ${interpScheme[$i]} "hardSediment" "cached"
 	cd ..
 	echo "-- Plotting results"
 	python3 -W ignore ./postpro/terzaghiPlotDimless.py "hardSediment" "coarseSand" "danianChalk" \
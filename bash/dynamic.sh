@@ -0,0 +1,23 @@
+export sourceName="mainDynamic"
+
+# COMPILE
+cd build
+cmake ..
+make
+cd ..
+echo ""
+
+# PARAMETERS
+medium="boiseSandstone";
+mesh=10;
+
+# RUN
+# -dynamic_frequency, -dynamic_courant, -dynamic_tortuosity, -dynamic_absorbing_layer and
+# -dynamic_snapshots may be appended to the command line
+cd build
+echo "-- Solving dynamic stripfoot"
+./$sourceName ${medium} ${mesh}
+cd ..
+echo "-- Plotting results"
+python3 -W ignore ./postpro/dynamicPlotSolution.py ${medium} ${mesh}
+echo ""
@@ -0,0 +1,24 @@
+export sourceName="mainOrdering"
+
+# COMPILE
+cd build
+cmake ..
+make
+cd ..
+echo ""
+
+# PARAMETERS
+medium="boiseSandstone";
+mesh=10;
+declare -a formulations=("staggered NA" "collocated I2DPIS")
+
+# RUN
+# -ordering_tile, -ordering_repetitions and -lu_ordering may be appended to the command line; the
+# other problems are numbered along the curves with -cell_ordering morton|hilbert
+cd build
+for formulation in "${formulations[@]}"; do
+	echo "-- Comparing numberings, ${formulation}"
+	./$sourceName ${formulation} ${medium} ${mesh}
+done
+cd ..
+echo ""
@@ -0,0 +1,32 @@
+# PARAMETERS
+medium="gulfMexicoShale";
+problemsSolved="024";
+arraysNo=3;
+declare -a formulations=("staggered NA" "collocated CDS" "collocated 1DPIS" "collocated I2DPIS"
+	"collocated C2DPIS")
+
+# COMPILE AND EXPORT
+# The systems of Terzaghi's and Mandel's problems are written to export/operator_*, the cases are
+# solved again even if complete in export/manifest.jsonl
+export sourceName="mainSolution"
+cd build
+cmake ..
+make
+for formulation in "${formulations[@]}"; do
+	echo "-- Exporting linear systems, ${formulation}"
+	./$sourceName ${formulation} ${medium} ${problemsSolved} -operator_export ${arraysNo} \
+		-results_force 1
+done
+cd ..
+echo ""
+
+# COMPILE AND REPLAY
+# -replay_candidates and -replay_repetitions may be appended to the command line
+export sourceName="mainOperatorReplay"
+cd build
+cmake ..
+make
+echo "-- Replaying linear systems"
+./$sourceName ../export/operator_*_manifest.txt
+cd ..
+echo ""
@@ -71,9 +71,9 @@ cd ..
 medium="gulfMexicoShale";
 
 # RUN
+# Cases complete in export/manifest.jsonl are not solved again, delete it to solve them all
 for ((i=0; i<numRuns; i++));
 do
-	rm -rf export/*
 	cd build
 	echo "-- Solving benchmarking problems"
 	./$sourceName ${gridType[$i]} ${interpScheme[$i]} ${medium} ${problemsSolved}
@@ -95,4 +95,3 @@ do
 	IFS=""
 	echo ""
 done
-rm -rf export/*
\ No newline at end of file
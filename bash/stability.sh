@@ -57,9 +57,11 @@ done
 IFS=""
 
 # RUN
+# Cases complete in export/manifest.jsonl are not solved again, delete it to solve them all
+# Appending -screening_precision float32 solves the cases in single precision and again in double
+# precision those close to the stability threshold (-screening_threshold, -screening_band)
 for ((i=0; i<numRuns; i++));
 do
-	rm -rf export/*
 	cd build
 	echo "-- Testing method's stability"
 	./$sourceName ${gridType[$i]} ${interpScheme[$i]} "softSediment"  ${problemsSolved}
@@ -81,4 +83,3 @@ done
 # echo "-- Plotting results"
 # python3 -W ignore ./postpro/terzaghiPlotStabilityComparison.py "softSediment"
 # python3 -W ignore ./postpro/mandelPlotStabilityComparison.py "softSediment"
-rm -rf export/*
@@ -0,0 +1,23 @@
+export sourceName="mainTaskFarm"
+
+# COMPILE
+cd build
+cmake ..
+make
+cd ..
+echo ""
+
+# PARAMETERS
+ranksNo=4;
+problemsSolved=248;
+declare -a media=("softSediment" "gulfMexicoShale" "boiseSandstone")
+
+# RUN
+# Rank 0 hands out the cases to the other ranks, largest first; the files of the cases are kept in
+# export/taskFarm.tar and the cases in export/manifest.jsonl, complete cases are not solved again.
+# -farm_scratch and -farm_container may be appended to the command line
+cd build
+echo "-- Solving the sweep on ${ranksNo} ranks"
+mpirun -np ${ranksNo} ./$sourceName ${problemsSolved} ${media[@]}
+cd ..
+echo ""
@@ -42,9 +42,11 @@ IFS=""
 numRuns=${#gridType[@]}
 
 # RUN
+# Cases complete in export/manifest.jsonl are not solved again, delete it to solve them all;
+# the error norms of the complete ones are appended again from it
 for ((i=0; i<numRuns; i++));
 do
-    rm -rf export/*
+    rm -f export/terzaghiErrorNorm_*
     cd build
     echo "-- Testing method's convergence"
     ./$sourceName ${gridType[$i]} ${interpScheme[$i]} "gulfMexicoShale"
@@ -53,4 +55,3 @@ do
     python3 -W ignore ./postpro/terzaghiPlotTConvergence.py
     echo ""
 done
-rm -rf export/*
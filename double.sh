@@ -62,7 +62,6 @@ problemsSolved+=8
 # echo ""
 
 # STABILITY
-rm -rf export/*
 export sourceName="mainDoubleStability"
 medium="modifiedAbyssalRedClay";
 
@@ -74,6 +73,7 @@ cd ..
 echo ""
 
 # RUN
+# Cases complete in export/manifest.jsonl are not solved again, delete it to solve them all
 echo "-- Testing method's stability"
 echo ""
 for ((i=0; i<numRuns; i++));
@@ -88,4 +88,3 @@ done
 echo "-- Plotting results"
 python3 -W ignore ./postpro/doublePlotStabilityCILAMCE2020.py ${medium}
 echo ""
-rm -rf export/*
\ No newline at end of file
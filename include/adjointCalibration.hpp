@@ -0,0 +1,361 @@
+/*
+	This header is part of the development of a master's thesis entitled "Analysis of Numerical
+	Schemes in Collocated and Staggered Grids for Problems of Poroelasticity". The class defined
+	here contains the functions for the calibration of the parameters K, G, alpha and Q against
+	measured time series of settlement (displacement at the top of the column) and pore pressure
+	(at the base of the column).
+
+	The misfit is J=1/2*sum(((y-d)/s)^2), where y are the probes of the numerical solution linearly
+	interpolated in time, d the measurements and s the largest measurement of each probe. Its
+	gradient is obtained with the discrete adjoint [1] and minimized on the logarithm of the
+	parameters with a limited memory BFGS method [2] and a backtracking (Armijo) line search.
+
+ 	Written by FERREIRA, C. A. S.
+
+ 	Florianópolis, 2019.
+
+ 	[1] GILES, M. B.; PIERCE, N. A. An Introduction to the Adjoint Approach to Design. Flow,
+ 	Turbulence and Combustion, v. 65, pp. 393-415, 2000.
+ 	[2] NOCEDAL, J.; WRIGHT, S. J. Numerical Optimization. Springer, New York, 2006.
+*/
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <math.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class adjointCalibration
+{
+public:
+	// Class variables
+	vector<string> probeNames;
+	vector<vector<int>> probePositions;
+	vector<vector<double>> probeWeights;
+	vector<int> measuredProbes;
+	vector<double> measuredTimes;
+	vector<double> measuredValues;
+	vector<double> measuredScales;
+	vector<double> modelValues;
+	vector<int> calibratedParameters;
+	vector<double> parameterValues;
+	double dt;
+	int Nt;
+	PetscInt memoryNo=5;
+	PetscInt maxIterationNo=30;
+	PetscInt maxLineSearchNo=10;
+	PetscReal gradientTolerance=1e-6;
+	PetscReal armijoParameter=1e-4;
+	vector<vector<double>> positionUpdates;
+	vector<vector<double>> gradientUpdates;
+
+	// Class functions
+	int getProbeNo(string);
+	bool readMeasurements(string);
+	void setMeasuredValues(vector<double>);
+	void setMeasuredScales();
+	void setTerzaghiProbes(vector<vector<int>>,vector<vector<int>>,int,int,int,double);
+	void setCentralProbe(int,vector<vector<int>>,int,int);
+	void getTimeInterpolation(int,int&,double&);
+	double getMisfit(vector<vector<double>>,vector<vector<double>>,vector<vector<double>>,int,int);
+	vector<double> getMisfitDerivative(int,int);
+	vector<double> getLogPositions();
+	void setLogPositions(vector<double>);
+	vector<double> getLogGradient(vector<double>);
+	vector<double> getSearchDirection(vector<double>);
+	void updateHistory(vector<double>,vector<double>);
+
+	// Constructor
+	adjointCalibration(vector<int>);
+
+	// Destructor
+	~adjointCalibration();
+};
+
+adjointCalibration::adjointCalibration(vector<int> myCalibratedParameters)
+{
+	calibratedParameters=myCalibratedParameters;
+	probeNames={"settlement","pressure"};
+	probePositions.resize(probeNames.size());
+	probeWeights.resize(probeNames.size());
+
+	PetscOptionsGetInt(NULL,NULL,"-calibration_lbfgs_memory",&memoryNo,NULL);
+	PetscOptionsGetInt(NULL,NULL,"-calibration_max_it",&maxIterationNo,NULL);
+	PetscOptionsGetReal(NULL,NULL,"-calibration_gtol",&gradientTolerance,NULL);
+}
+
+adjointCalibration::~adjointCalibration(){}
+
+int adjointCalibration::getProbeNo(string probeName)
+{
+	int probeNo=find(probeNames.begin(),probeNames.end(),probeName)-probeNames.begin();
+
+	return probeNo;
+}
+
+bool adjointCalibration::readMeasurements(string fileName)
+{
+	// Each line holds the probe name, the time and the measured value
+	string probeName;
+	double time, value;
+
+	ifstream myFile(fileName);
+	if(!myFile.is_open()) return false;
+
+	measuredProbes.clear();
+	measuredTimes.clear();
+	measuredValues.clear();
+
+	while(myFile >> probeName >> time >> value)
+	{
+		if(getProbeNo(probeName)==probeNames.size())
+		{
+			cout << "Unknown probe " << probeName << " in " << fileName << "\n";
+			continue;
+		}
+
+		measuredProbes.push_back(getProbeNo(probeName));
+		measuredTimes.push_back(time);
+		measuredValues.push_back(value);
+	}
+	myFile.close();
+
+	setMeasuredScales();
+
+	return true;
+}
+
+void adjointCalibration::setMeasuredValues(vector<double> myMeasuredValues)
+{
+	measuredValues=myMeasuredValues;
+	setMeasuredScales();
+
+	return;
+}
+
+void adjointCalibration::setMeasuredScales()
+{
+	vector<double> probeScales(probeNames.size(),0);
+
+	for(int k=0; k<measuredValues.size(); k++)
+		probeScales[measuredProbes[k]]=max(probeScales[measuredProbes[k]],fabs(measuredValues[k]));
+
+	measuredScales.resize(measuredValues.size());
+	for(int k=0; k<measuredValues.size(); k++)
+	{
+		measuredScales[k]=probeScales[measuredProbes[k]];
+		if(measuredScales[k]==0) measuredScales[k]=1;
+	}
+
+	return;
+}
+
+void adjointCalibration::setTerzaghiProbes(vector<vector<int>> idV, vector<vector<int>> idP,
+	int Nu, int Nv, int myNt, double myDt)
+{
+	Nt=myNt;
+	dt=myDt;
+
+	// Settlement at the top and pore pressure at the base of the column, along its centerline
+	setCentralProbe(getProbeNo("settlement"),idV,0,Nu);
+	setCentralProbe(getProbeNo("pressure"),idP,idP.size()-1,Nu+Nv);
+
+	return;
+}
+
+void adjointCalibration::setCentralProbe(int probeNo, vector<vector<int>> myIndex, int row,
+	int offset)
+{
+	int midCols=myIndex[row].size()/2;
+
+	probePositions[probeNo].clear();
+	probeWeights[probeNo].clear();
+
+	if(myIndex[row].size()%2==0)
+	{
+		probePositions[probeNo].push_back(myIndex[row][midCols-1]+offset-1);
+		probePositions[probeNo].push_back(myIndex[row][midCols]+offset-1);
+		probeWeights[probeNo].push_back(0.5);
+		probeWeights[probeNo].push_back(0.5);
+	}
+	else
+	{
+		probePositions[probeNo].push_back(myIndex[row][midCols]+offset-1);
+		probeWeights[probeNo].push_back(1);
+	}
+
+	return;
+}
+
+void adjointCalibration::getTimeInterpolation(int measurementNo, int& timeStep, double& weight)
+{
+	// The measurement lies between time-steps timeStep and timeStep+1, weight being the share of
+	// the latter
+	double position=measuredTimes[measurementNo]/dt;
+
+	timeStep=floor(position);
+	if(timeStep<0) timeStep=0;
+	if(timeStep>Nt-2) timeStep=Nt-2;
+	weight=position-timeStep;
+	if(weight<0) weight=0;
+	if(weight>1) weight=1;
+
+	return;
+}
+
+double adjointCalibration::getMisfit(vector<vector<double>> uField, vector<vector<double>> vField,
+	vector<vector<double>> pField, int Nu, int Nv)
+{
+	int timeStep, position, probeNo;
+	double weight, probeValue, misfit=0;
+
+	modelValues.resize(measuredValues.size());
+
+	for(int k=0; k<measuredValues.size(); k++)
+	{
+		getTimeInterpolation(k,timeStep,weight);
+		probeNo=measuredProbes[k];
+
+		modelValues[k]=0;
+		for(int a=0; a<probePositions[probeNo].size(); a++)
+		{
+			position=probePositions[probeNo][a];
+
+			if(position<Nu) probeValue=(1-weight)*uField[position][timeStep]+
+				weight*uField[position][timeStep+1];
+			else if(position<Nu+Nv) probeValue=(1-weight)*vField[position-Nu][timeStep]+
+				weight*vField[position-Nu][timeStep+1];
+			else probeValue=(1-weight)*pField[position-Nu-Nv][timeStep]+
+				weight*pField[position-Nu-Nv][timeStep+1];
+
+			modelValues[k]+=probeWeights[probeNo][a]*probeValue;
+		}
+
+		misfit+=0.5*pow((modelValues[k]-measuredValues[k])/measuredScales[k],2);
+	}
+
+	return misfit;
+}
+
+vector<double> adjointCalibration::getMisfitDerivative(int timeStep, int n)
+{
+	// dJ/dx at the given time-step, requires the model values of the last misfit evaluation
+	int probeNo, interpTimeStep;
+	double weight, residual;
+	vector<double> misfitDerivative(n,0);
+
+	for(int k=0; k<measuredValues.size(); k++)
+	{
+		getTimeInterpolation(k,interpTimeStep,weight);
+		probeNo=measuredProbes[k];
+
+		if(interpTimeStep==timeStep) weight=1-weight;
+		else if(interpTimeStep+1!=timeStep) continue;
+
+		residual=(modelValues[k]-measuredValues[k])/(measuredScales[k]*measuredScales[k]);
+
+		for(int a=0; a<probePositions[probeNo].size(); a++)
+			misfitDerivative[probePositions[probeNo][a]]+=residual*weight*probeWeights[probeNo][a];
+	}
+
+	return misfitDerivative;
+}
+
+vector<double> adjointCalibration::getLogPositions()
+{
+	vector<double> logPositions(calibratedParameters.size());
+
+	for(int a=0; a<calibratedParameters.size(); a++)
+		logPositions[a]=log(parameterValues[calibratedParameters[a]]);
+
+	return logPositions;
+}
+
+void adjointCalibration::setLogPositions(vector<double> logPositions)
+{
+	for(int a=0; a<calibratedParameters.size(); a++)
+		parameterValues[calibratedParameters[a]]=exp(logPositions[a]);
+
+	return;
+}
+
+vector<double> adjointCalibration::getLogGradient(vector<double> gradient)
+{
+	// dJ/dlog(p)=p*dJ/dp
+	vector<double> logGradient(calibratedParameters.size());
+
+	for(int a=0; a<calibratedParameters.size(); a++)
+		logGradient[a]=parameterValues[calibratedParameters[a]]*gradient[calibratedParameters[a]];
+
+	return logGradient;
+}
+
+vector<double> adjointCalibration::getSearchDirection(vector<double> logGradient)
+{
+	// L-BFGS two-loop recursion
+	int m=positionUpdates.size();
+	int n=logGradient.size();
+	vector<double> direction=logGradient;
+	vector<double> rho(m), alpha(m);
+	double beta, gamma=1;
+
+	for(int l=m-1; l>=0; l--)
+	{
+		double sy=0, sq=0;
+		for(int a=0; a<n; a++)
+		{
+			sy+=positionUpdates[l][a]*gradientUpdates[l][a];
+			sq+=positionUpdates[l][a]*direction[a];
+		}
+		rho[l]=1/sy;
+		alpha[l]=rho[l]*sq;
+		for(int a=0; a<n; a++) direction[a]-=alpha[l]*gradientUpdates[l][a];
+	}
+
+	if(m>0)
+	{
+		double sy=0, yy=0;
+		for(int a=0; a<n; a++)
+		{
+			sy+=positionUpdates[m-1][a]*gradientUpdates[m-1][a];
+			yy+=gradientUpdates[m-1][a]*gradientUpdates[m-1][a];
+		}
+		gamma=sy/yy;
+	}
+	for(int a=0; a<n; a++) direction[a]*=gamma;
+
+	for(int l=0; l<m; l++)
+	{
+		double yr=0;
+		for(int a=0; a<n; a++) yr+=gradientUpdates[l][a]*direction[a];
+		beta=rho[l]*yr;
+		for(int a=0; a<n; a++) direction[a]+=positionUpdates[l][a]*(alpha[l]-beta);
+	}
+
+	for(int a=0; a<n; a++) direction[a]=-direction[a];
+
+	return direction;
+}
+
+void adjointCalibration::updateHistory(vector<double> positionUpdate,
+	vector<double> gradientUpdate)
+{
+	// Pairs without positive curvature are skipped to keep the approximation positive definite
+	double sy=0;
+
+	for(int a=0; a<positionUpdate.size(); a++) sy+=positionUpdate[a]*gradientUpdate[a];
+	if(sy<=0) return;
+
+	positionUpdates.push_back(positionUpdate);
+	gradientUpdates.push_back(gradientUpdate);
+	if(positionUpdates.size()>memoryNo)
+	{
+		positionUpdates.erase(positionUpdates.begin());
+		gradientUpdates.erase(gradientUpdates.begin());
+	}
+
+	return;
+}
@@ -0,0 +1,423 @@
+/*
+	This header is part of the development of a master's thesis entitled "Analysis of Numerical
+	Schemes in Collocated and Staggered Grids for Problems of Poroelasticity". The class defined
+	here chooses the formulation (grid type and interpolation scheme), the mesh and the time-step
+	with which the Terzaghi problem [2] of the convergence tests reaches a target pressure error at
+	the least predicted cost.
+
+	The error of each formulation, relative to the load, is modelled as a*h^p+b*dt^q. The observed
+	orders p and q are searched over a grid and, for each pair, the constants a and b are the non
+	negative least squares fit of the relative deviations, on the convergence cases of the medium
+	which are complete in the results manifest. The wall time of the same cases gives the cost
+	model c*n^beta per time-step, n being the number of FV, fitted in log scale. A formulation with
+	fewer than three cases gets a pilot set of coarse cases, which the manifest keeps for the next
+	plans.
+
+	For each mesh, no coarser than those of the cases, the largest time-step whose predicted error
+	is within a safety fraction of the target is taken, and the cheapest of all formulations and
+	meshes is chosen. The collocated grid
+	with CDS is only admissible above the minimum time-step of Verruijt [1], below which its
+	pressure oscillates; the staggered grid and the collocated grid with the PIS are stable for
+	every time-step.
+
+	The options -plan_safety (0.7), -plan_max_mesh (40) and -plan_max_steps (5000) bound the
+	search.
+
+ 	Written by FERREIRA, C. A. S.
+
+ 	Florianópolis, 2019.
+
+ 	[1] VERRUIJT, A. Theory and Problems of Poroelasticity. Delft University of Technology, 2013.
+ 	[2] TERZAGHI, K. Erdbaumechanik auf Bodenphysikalischer Grundlage. Franz Deuticke, Leipzig,
+ 	1925.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct plannedCase
+{
+	string gridType;
+	string interpScheme;
+	int meshSize;
+	int Nt;
+	double dt;
+	double predictedError;
+	double predictedSeconds;
+};
+
+struct formulationModel
+{
+	string gridType;
+	string interpScheme;
+	vector<double> h;
+	vector<double> dt;
+	vector<double> error;
+	vector<double> secondsPerStep;
+	vector<double> volumesNo;
+	double spaceOrder;
+	double timeOrder;
+	double spaceConstant;
+	double timeConstant;
+	double costConstant;
+	double costExponent;
+	bool isCalibrated;
+};
+
+class autoPlanner
+{
+public:
+	// Class variables
+	static const int minimumCasesNo=3;
+	string problemName="TerzaghiConvergence";
+	string medium;
+	double Lt;
+	double load;
+	double consolidationCoefficient;
+	double tolerance;
+	PetscReal safety=0.7;
+	PetscInt maxMeshSize=40;
+	PetscInt maxTimeStepsNo=5000;
+	vector<formulationModel> models;
+
+	// Class functions
+	int getVolumesNo(int);
+	double getMinimumTimeStep(int);
+	bool isStable(const formulationModel&,int,double);
+	void loadCases(resultsManifest&);
+	void fitErrorModel(formulationModel&);
+	void fitCostModel(formulationModel&);
+	void calibrate();
+	vector<plannedCase> getPilotCases();
+	bool plan(plannedCase&);
+	void printModels();
+	void exportModels(string);
+
+	// Constructor
+	autoPlanner(string,double,double,double,double);
+
+	// Destructor
+	~autoPlanner();
+};
+
+autoPlanner::autoPlanner(string myMedium, double myLt, double myLoad,
+	double myConsolidationCoefficient, double myTolerance)
+{
+	const string formulations[5][2]={{"staggered","NA"},{"collocated","CDS"},
+		{"collocated","1DPIS"},{"collocated","I2DPIS"},{"collocated","C2DPIS"}};
+
+	medium=myMedium;
+	Lt=myLt;
+	load=fabs(myLoad);
+	consolidationCoefficient=myConsolidationCoefficient;
+	tolerance=myTolerance;
+
+	PetscOptionsGetReal(NULL,NULL,"-plan_safety",&safety,NULL);
+	PetscOptionsGetInt(NULL,NULL,"-plan_max_mesh",&maxMeshSize,NULL);
+	PetscOptionsGetInt(NULL,NULL,"-plan_max_steps",&maxTimeStepsNo,NULL);
+
+	for(int n=0; n<5; n++)
+	{
+		formulationModel myModel;
+		myModel.gridType=formulations[n][0];
+		myModel.interpScheme=formulations[n][1];
+		myModel.isCalibrated=false;
+		models.push_back(myModel);
+	}
+}
+
+autoPlanner::~autoPlanner(){}
+
+// The column of the convergence tests is 1 m wide and 6 m high, with meshSize FV per meter
+
+int autoPlanner::getVolumesNo(int meshSize)
+{
+	return 6*meshSize*meshSize;
+}
+
+double autoPlanner::getMinimumTimeStep(int meshSize)
+{
+	double h=1./meshSize;
+
+	return h*h/(6*consolidationCoefficient);
+}
+
+bool autoPlanner::isStable(const formulationModel& myModel, int meshSize, double dt)
+{
+	if(myModel.interpScheme!="CDS") return true;
+
+	return dt>=getMinimumTimeStep(meshSize);
+}
+
+void autoPlanner::loadCases(resultsManifest& myManifest)
+{
+	// Complete convergence cases of the medium with the same total time, any version of the code
+	for(int n=0; n<models.size(); n++)
+	{
+		models[n].h.clear();
+		models[n].dt.clear();
+		models[n].error.clear();
+		models[n].secondsPerStep.clear();
+		models[n].volumesNo.clear();
+	}
+
+	for(map<string,string>::iterator record=myManifest.lastRecords.begin();
+		record!=myManifest.lastRecords.end(); record++)
+	{
+		const string& line=record->second;
+		int meshSize, Nt;
+		double dt, error, seconds;
+
+		if(resultsManifest::getField(line,"status")!="complete") continue;
+		if(resultsManifest::getField(line,"problem")!=problemName) continue;
+		if(resultsManifest::getField(line,"medium")!=medium) continue;
+
+		meshSize=(int)resultsManifest::getNumber(line,"mesh");
+		Nt=(int)resultsManifest::getNumber(line,"Nt");
+		dt=resultsManifest::getNumber(line,"dt");
+		error=resultsManifest::getNumber(line,"pErrorNorm")/load;
+		seconds=resultsManifest::getNumber(line,"seconds");
+		if(!(meshSize>0 && Nt>1 && error>0 && seconds>=0)) continue;
+		if(fabs((Nt-1)*dt-Lt)>1e-6*Lt) continue;
+
+		for(int n=0; n<models.size(); n++)
+		{
+			if(resultsManifest::getField(line,"grid")!=models[n].gridType) continue;
+			if(resultsManifest::getField(line,"scheme")!=models[n].interpScheme) continue;
+
+			models[n].h.push_back(1./meshSize);
+			models[n].dt.push_back(dt);
+			models[n].error.push_back(error);
+			models[n].secondsPerStep.push_back(seconds/(Nt-1));
+			models[n].volumesNo.push_back(getVolumesNo(meshSize));
+		}
+	}
+
+	return;
+}
+
+void autoPlanner::fitErrorModel(formulationModel& myModel)
+{
+	// Minimizes the sum of (1-(a*h^p+b*dt^q)/error)^2 with a and b non negative
+	int casesNo=myModel.error.size();
+	double bestResidual=INFINITY;
+
+	for(double p=0.5; p<=3+1e-9; p+=0.05)
+	for(double q=0.5; q<=2.5+1e-9; q+=0.05)
+	{
+		double s11=0, s12=0, s22=0, s1=0, s2=0;
+		double candidates[3][2];
+
+		for(int n=0; n<casesNo; n++)
+		{
+			double x1=pow(myModel.h[n],p)/myModel.error[n];
+			double x2=pow(myModel.dt[n],q)/myModel.error[n];
+
+			s11+=x1*x1;
+			s12+=x1*x2;
+			s22+=x2*x2;
+			s1+=x1;
+			s2+=x2;
+		}
+
+		// Both terms, the space term only and the time term only
+		double determinant=s11*s22-s12*s12;
+		candidates[0][0]=(determinant>1e-12*s11*s22) ? (s1*s22-s2*s12)/determinant : -1;
+		candidates[0][1]=(determinant>1e-12*s11*s22) ? (s2*s11-s1*s12)/determinant : -1;
+		candidates[1][0]=s1/s11;
+		candidates[1][1]=0;
+		candidates[2][0]=0;
+		candidates[2][1]=s2/s22;
+
+		for(int c=0; c<3; c++)
+		{
+			double a=candidates[c][0];
+			double b=candidates[c][1];
+			double residual=0;
+
+			if(a<0 || b<0) continue;
+
+			for(int n=0; n<casesNo; n++)
+				residual+=pow(1-(a*pow(myModel.h[n],p)+b*pow(myModel.dt[n],q))/myModel.error[n],
+					2);
+
+			if(residual>=bestResidual) continue;
+			bestResidual=residual;
+			myModel.spaceOrder=p;
+			myModel.timeOrder=q;
+			myModel.spaceConstant=a;
+			myModel.timeConstant=b;
+		}
+	}
+
+	return;
+}
+
+void autoPlanner::fitCostModel(formulationModel& myModel)
+{
+	// log(seconds per time-step)=log(c)+beta*log(n), beta within [1,3]
+	int casesNo=myModel.secondsPerStep.size();
+	double sx=0, sy=0, sxx=0, sxy=0;
+	int positiveNo=0;
+
+	for(int n=0; n<casesNo; n++)
+	{
+		if(myModel.secondsPerStep[n]<=0) continue;
+
+		double x=log(myModel.volumesNo[n]);
+		double y=log(myModel.secondsPerStep[n]);
+
+		sx+=x;
+		sy+=y;
+		sxx+=x*x;
+		sxy+=x*y;
+		positiveNo++;
+	}
+
+	myModel.costExponent=1.5;
+	if(positiveNo>1 && positiveNo*sxx-sx*sx>1e-12*sxx)
+		myModel.costExponent=(positiveNo*sxy-sx*sy)/(positiveNo*sxx-sx*sx);
+	myModel.costExponent=fmin(fmax(myModel.costExponent,1.),3.);
+	myModel.costConstant=(positiveNo>0) ? exp((sy-myModel.costExponent*sx)/positiveNo) : 1e-6;
+
+	return;
+}
+
+void autoPlanner::calibrate()
+{
+	for(int n=0; n<models.size(); n++)
+	{
+		models[n].isCalibrated=models[n].error.size()>=minimumCasesNo;
+		if(!models[n].isCalibrated) continue;
+
+		fitErrorModel(models[n]);
+		fitCostModel(models[n]);
+	}
+
+	return;
+}
+
+vector<plannedCase> autoPlanner::getPilotCases()
+{
+	// Three meshes at 20 time-steps and the finest one at 5 and 80, the unstable ones left out
+	const int pilotCases[5][2]={{4,20},{8,20},{16,20},{16,5},{16,80}};
+	vector<plannedCase> myPilotCases;
+
+	for(int n=0; n<models.size(); n++)
+	{
+		if(models[n].error.size()>=minimumCasesNo) continue;
+
+		for(int c=0; c<5; c++)
+		{
+			plannedCase myCase;
+			myCase.gridType=models[n].gridType;
+			myCase.interpScheme=models[n].interpScheme;
+			myCase.meshSize=pilotCases[c][0];
+			myCase.Nt=pilotCases[c][1]+1;
+			myCase.dt=Lt/pilotCases[c][1];
+			myCase.predictedError=NAN;
+			myCase.predictedSeconds=NAN;
+			if(isStable(models[n],myCase.meshSize,myCase.dt)) myPilotCases.push_back(myCase);
+		}
+	}
+
+	return myPilotCases;
+}
+
+bool autoPlanner::plan(plannedCase& bestCase)
+{
+	// False when no formulation reaches the target within the bounds of the search
+	bool isFound=false;
+
+	for(int n=0; n<models.size(); n++)
+	{
+		const formulationModel& myModel=models[n];
+
+		if(!myModel.isCalibrated) continue;
+
+		// The models are not extrapolated to meshes coarser than those of their cases
+		int minMeshSize=(int)round(1/(*max_element(myModel.h.begin(),myModel.h.end())));
+
+		for(int meshSize=minMeshSize; meshSize<=maxMeshSize; meshSize++)
+		{
+			double spaceError=myModel.spaceConstant*pow(1./meshSize,myModel.spaceOrder);
+			double budget=safety*tolerance-spaceError;
+			double dt=Lt;
+			int timeStepsNo;
+
+			if(budget<=0) continue;
+			if(myModel.timeConstant>0) dt=fmin(pow(budget/myModel.timeConstant,
+				1/myModel.timeOrder),Lt);
+			timeStepsNo=(int)ceil(Lt/dt*(1-1e-12));
+			if(timeStepsNo>maxTimeStepsNo) continue;
+			dt=Lt/timeStepsNo;
+			if(!isStable(myModel,meshSize,dt)) continue;
+
+			plannedCase myCase;
+			myCase.gridType=myModel.gridType;
+			myCase.interpScheme=myModel.interpScheme;
+			myCase.meshSize=meshSize;
+			myCase.Nt=timeStepsNo+1;
+			myCase.dt=dt;
+			myCase.predictedError=spaceError+myModel.timeConstant*pow(dt,myModel.timeOrder);
+			myCase.predictedSeconds=myModel.costConstant*pow(getVolumesNo(meshSize),
+				myModel.costExponent)*timeStepsNo;
+
+			if(isFound && myCase.predictedSeconds>=bestCase.predictedSeconds) continue;
+			bestCase=myCase;
+			isFound=true;
+		}
+	}
+
+	return isFound;
+}
+
+void autoPlanner::printModels()
+{
+	for(int n=0; n<models.size(); n++)
+	{
+		const formulationModel& myModel=models[n];
+
+		cout << myModel.gridType << "/" << myModel.interpScheme << ": ";
+		if(!myModel.isCalibrated)
+		{
+			cout << myModel.error.size() << " cases, not calibrated\n";
+			continue;
+		}
+		cout << "error=" << myModel.spaceConstant << "*h^" << myModel.spaceOrder << "+" <<
+			myModel.timeConstant << "*dt^" << myModel.timeOrder << ", seconds per time-step=" <<
+			myModel.costConstant << "*n^" << myModel.costExponent << " (" <<
+			myModel.error.size() << " cases)\n";
+	}
+
+	return;
+}
+
+void autoPlanner::exportModels(string fileName)
+{
+	ofstream myFile("../export/"+fileName+".txt");
+
+	if(!myFile.is_open()) return;
+
+	myFile << "# grid\tscheme\tcases\tp\ta\tq\tb\tbeta\tc\n";
+	for(int n=0; n<models.size(); n++)
+	{
+		const formulationModel& myModel=models[n];
+
+		if(!myModel.isCalibrated) continue;
+		myFile << myModel.gridType << "\t" << myModel.interpScheme << "\t" <<
+			myModel.error.size() << "\t" << myModel.spaceOrder << "\t" << myModel.spaceConstant <<
+			"\t" << myModel.timeOrder << "\t" << myModel.timeConstant << "\t" <<
+			myModel.costExponent << "\t" << myModel.costConstant << "\n";
+	}
+	myFile.close();
+
+	return;
+}
@@ -14,43 +14,219 @@
  	1925.
 */
 
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include "runArena.hpp"
+#include "numaPlacement.hpp"
 #include "gridDesign.hpp"
 #include "problemParameters.hpp"
 #include "problemDoubleParameters.hpp"
 #include "coefficientsAssembly.hpp"
 #include "independentTermsAssembly.hpp"
+#include "resultsManifest.hpp"
+#include "taskFarm.hpp"
 #include "linearSystemSolver.hpp"
+#include "liveMetrics.hpp"
+#include "autoPlanner.hpp"
+#include "realTimeStepper.hpp"
+#include "dynamicBiotSolver.hpp"
+#include "gridDesign3D.hpp"
+#include "matrixFreeOperator3D.hpp"
+#include "multigridSolver3D.hpp"
+#include "sensitivityAnalysis.hpp"
+#include "adjointCalibration.hpp"
+#include "randomFieldGenerator.hpp"
+#include "ensembleStatistics.hpp"
+#include "solutionHistory.hpp"
 #include "dataProcessing.hpp"
 #include "doubleDataProcessing.hpp"
+#include "insituRenderer.hpp"
+#include "dimensionlessCache.hpp"
+#include "convergenceAnalysis.hpp"
+#include "simulationPipeline.hpp"
+
+int sealedColumn(string gridType, string interpScheme, int Nt, int meshSize, double Lt, double g,
+	double sigmab, poroelasticProperties myProperties)
+{
+/*		PROBLEM DESCRIPTION
+	----------------------------------------------------------------*/
+
+	problemDescriptor myDescriptor;
+	myDescriptor.problemName="sealedColumn";
+
+	// Grid parameters
+	myDescriptor.Nx=meshSize;
+	myDescriptor.Ny=6*meshSize;
+
+	// Reservoir parameters
+	myDescriptor.Lx=1; // [m]
+	myDescriptor.Ly=6; // [m]
+
+	// BC types ({u,v,P} 1 for Dirichlet and 0 for Neumann, -1 for Stress/Fluid Flow, starts on
+	// "north" and follows counterclockwise)
+	myDescriptor.bcType=
+	{
+		{-1,-1,0},
+		{1,-1,-1},
+		{-1,1,0},
+		{1,-1,-1}
+	};
+
+	// BC values ({u,v,P}, starts on "north" and follows counterclockwise)
+	double rho_f=myProperties.fluidDensity;
+	myDescriptor.bcValue=
+	{
+		{0,sigmab,rho_f*g},
+		{0,0,0},
+		{0,0,rho_f*g},
+		{0,0,0}
+	};
+	myDescriptor.load=sigmab;
+
+	// Initial conditions
+	myDescriptor.initialConditions=[](simulationState& myState)
+	{
+		myState.singleProblem->applySealedColumnInitialConditions();
+	};
 
-struct poroelasticProperties
+/*		DATA PROCESSING
+	----------------------------------------------------------------*/
+
+	myDescriptor.exporters.push_back([sigmab](simulationState& myState)
+	{
+		// Variables declaration
+		int Nt=myState.Nt;
+		vector<int> exportedTimeSteps=
+		{
+			{1},
+			{(Nt-1)/8},
+			{(Nt-1)/2},
+			{Nt-1}
+		};
+
+		// Constructor
+		dataProcessing myDataProcessing(myState.idU,myState.idV,myState.idP,*myState.history,
+			myState.gridType,myState.interpScheme,myState.dx,myState.dy);
+
+		// Exports data for specified time-steps
+		for(int i=0; i<exportedTimeSteps.size(); i++)
+		{
+			myDataProcessing.exportSealedColumnAnalyticalSolution(myState.Ly,myState.alpha,
+				myState.Q,myState.rho,myState.g,myState.rho_f,myState.longitudinalModulus,sigmab,
+				myState.dt,exportedTimeSteps[i],myState.consolidationCoefficient,myState.pairName);
+			myDataProcessing.exportSealedColumnNumericalSolution(myState.dy,myState.dt,myState.Ly,
+				exportedTimeSteps[i],myState.pairName);
+		}
+	});
+
+	return runSimulationPipeline(myDescriptor,gridType,interpScheme,Nt,Lt,g,myProperties);
+};
+
+template<class scalar=double>
+basicProblemDescriptor<scalar> terzaghiDescriptor(int meshSize, double g, double sigmab,
+	poroelasticProperties myProperties)
 {
-	// Pair name
-	string pairName;
-
-	// Bulk parameters
-	double shearModulus;
-	double bulkModulus;
-	double porosity;
-	double permeability;
-	double macroPorosity;
-	double macroPermeability;
-
-	// Solid parameters
-	double solidBulkModulus;
-	double solidDensity;
-
-	// Fluid parameters
-	double fluidBulkModulus;
-	double fluidViscosity;
-	double fluidDensity;
+	// Column loaded on the top, which is drained, and shared by the Terzaghi solution and its
+	// convergence analysis
+	basicProblemDescriptor<scalar> myDescriptor;
+
+	// Grid parameters
+	myDescriptor.Nx=meshSize;
+	myDescriptor.Ny=6*meshSize;
+
+	// Reservoir parameters
+	myDescriptor.Lx=1; // [m]
+	myDescriptor.Ly=6; // [m]
+
+	// BC types ({u,v,P} 1 for Dirichlet and 0 for Neumann, -1 for Stress/Fluid Flow, starts on
+	// "north" and follows counterclockwise)
+	myDescriptor.bcType=
+	{
+		{-1,-1,1},
+		{1,-1,-1},
+		{-1,1,0},
+		{1,-1,-1}
+	};
+
+	// BC values ({u,v,P}, starts on "north" and follows counterclockwise)
+	double rho_f=myProperties.fluidDensity;
+	myDescriptor.bcValue=
+	{
+		{0,sigmab,0},
+		{0,0,0},
+		{0,0,rho_f*g},
+		{0,0,0}
+	};
+	myDescriptor.load=sigmab;
+
+	// Initial conditions
+	myDescriptor.initialConditions=[](basicSimulationState<scalar>& myState)
+	{
+		myState.singleProblem->applyTerzaghiInitialConditions();
+	};
+
+	return myDescriptor;
 };
 
-int sealedColumn(string gridType, string interpScheme, int Nt, int meshSize, double Lt, double g,
+template<class scalar=double>
+int terzaghi(string gridType, string interpScheme, int Nt, int meshSize, double Lt, double g,
 	double sigmab, poroelasticProperties myProperties)
+{
+/*		PROBLEM DESCRIPTION
+	----------------------------------------------------------------*/
+
+	basicProblemDescriptor<scalar> myDescriptor=terzaghiDescriptor<scalar>(meshSize,g,sigmab,
+		myProperties);
+	myDescriptor.problemName="terzaghi";
+
+/*		DATA PROCESSING
+	----------------------------------------------------------------*/
+
+	myDescriptor.exporters.push_back([sigmab](basicSimulationState<scalar>& myState)
+	{
+		// Variables declaration
+		int Nt=myState.Nt;
+		vector<int> exportedTimeSteps=
+		{
+			{1},
+			{(Nt-1)/8},
+			{(Nt-1)/2},
+			{Nt-1}
+		};
+		if(Nt==2)
+		{
+			exportedTimeSteps.clear();
+			exportedTimeSteps.push_back(1);
+		}
+
+		// Constructor
+		dataProcessing myDataProcessing(myState.idU,myState.idV,myState.idP,*myState.history,
+			myState.gridType,myState.interpScheme,myState.dx,myState.dy);
+
+		// Exports data for specified time-steps
+		for(int i=0; i<exportedTimeSteps.size(); i++)
+		{
+			myDataProcessing.exportTerzaghiAnalyticalSolution(myState.Ly,myState.alpha,myState.Q,
+				myState.rho,myState.g,myState.rho_f,myState.longitudinalModulus,sigmab,myState.dt,
+				exportedTimeSteps[i],myState.consolidationCoefficient,myState.pairName);
+			myDataProcessing.exportTerzaghiNumericalSolution(myState.dy,myState.dt,myState.Ly,
+				exportedTimeSteps[i],myState.pairName);
+		}
+	});
+
+	return runSimulationPipeline(myDescriptor,gridType,interpScheme,Nt,Lt,g,myProperties);
+};
+
+int terzaghiSensitivity(string gridType, string interpScheme, int Nt, int meshSize, double Lt,
+	double g, double sigmab, poroelasticProperties myProperties)
 {
 	PetscErrorCode ierr;
 
+	// Objects of this run are allocated from the run arena
+	runArenaScope myRunArena;
+
 /*		ENTRY PARAMETERS
 	----------------------------------------------------------------*/
 
@@ -90,7 +266,7 @@ int sealedColumn(string gridType, string interpScheme, int Nt, int meshSize, dou
 	// "north" and follows counterclockwise)
 	vector<vector<int>> bcType=
 	{
-		{-1,-1,0},
+		{-1,-1,1},
 		{1,-1,-1},
 		{-1,1,0},
 		{1,-1,-1}
@@ -99,7 +275,7 @@ int sealedColumn(string gridType, string interpScheme, int Nt, int meshSize, dou
 	// BC values ({u,v,P}, starts on "north" and follows counterclockwise)
 	vector<vector<double>> bcValue=
 	{
-		{0,sigmab,rho_f*g},
+		{0,sigmab,0},
 		{0,0,0},
 		{0,0,rho_f*g},
 		{0,0,0}
@@ -138,8 +314,11 @@ int sealedColumn(string gridType, string interpScheme, int Nt, int meshSize, dou
 	problemParameters myProblem(dx,dy,K,phi,rho_s,c_s,mu_f,rho_f,c_f,G,lambda,sigmab,Lx,Ly,
 		uField,vField,pField,cooU,cooV,cooP,idU,idV,idP,g);
 
+	// Copy kept for the initial conditions of the sensitivities
+	problemParameters myInitialProblem=myProblem;
+
 	// Apply initial conditions
-	myProblem.applySealedColumnInitialConditions();
+	myProblem.applyTerzaghiInitialConditions();
 
 	// Passing variables
 	double Q;swap(Q,myProblem.Q);
@@ -196,6 +375,17 @@ int sealedColumn(string gridType, string interpScheme, int Nt, int meshSize, dou
 	ierr=myLinearSystemSolver.createPETScArrays();CHKERRQ(ierr);
 	ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
 
+	// Sensitivities of the initial conditions and of the coefficients matrix
+	sensitivityAnalysis mySensitivity(bcType,bcValue,Nu,Nv,NP,Nt,idU,idV,idP,cooU,cooV,cooP,
+		horFaceStatus,verFaceStatus,gridType,interpScheme,K,G,alpha,Q,lambda,mu_f,rho,g,Nt);
+	mySensitivity.setTerzaghiInitialSensitivity(myInitialProblem);
+	mySensitivity.assemblyMatrixDerivatives(dx,dy,dt);
+	int parametersNo=mySensitivity.parameterNames.size();
+	vector<double> sensitivityRHS, sensitivityArray;
+
+	// Progress of the run written to -metrics_file
+	liveMetrics myMetrics("terzaghiSensitivity",gridType,interpScheme,Nt-1,dt);
+
 	for(timeStep=0; timeStep<Nt-1; timeStep++)
 	{
 		// Assembly of the independent terms array
@@ -217,6 +407,19 @@ int sealedColumn(string gridType, string interpScheme, int Nt, int meshSize, dou
 		pField=myLinearSystemSolver.pField;
 		ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
 
+		// Sensitivity systems, solved with the factorized coefficients matrix
+		for(int parameter=0; parameter<parametersNo; parameter++)
+		{
+			sensitivityRHS=mySensitivity.assemblySensitivityRHS(parameter,dx,dy,dt,uField,vField,
+				pField,timeStep);
+			ierr=myLinearSystemSolver.setRHSValue(sensitivityRHS);CHKERRQ(ierr);
+			ierr=myLinearSystemSolver.solveLinearSystem();CHKERRQ(ierr);
+			ierr=myLinearSystemSolver.getSolutionArray(sensitivityArray);CHKERRQ(ierr);
+			mySensitivity.setSensitivityValue(parameter,timeStep+1,sensitivityArray);
+			ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
+		}
+
+		myMetrics.update(timeStep+1,myLinearSystemSolver);
 		cout << timeStep+1<< "\r";
 	}
 
@@ -234,6 +437,11 @@ int sealedColumn(string gridType, string interpScheme, int Nt, int meshSize, dou
 		{(Nt-1)/2},
 		{Nt-1}
 	};
+	if(Nt==2)
+	{
+		exportedTimeSteps.clear();
+		exportedTimeSteps.push_back(1);
+	}
 
 	// Constructor
 	dataProcessing myDataProcessing(idU,idV,idP,uField,vField,pField,gridType,interpScheme,dx,dy);
@@ -241,20 +449,35 @@ int sealedColumn(string gridType, string interpScheme, int Nt, int meshSize, dou
 	// Exports data for specified time-steps
 	for(int i=0; i<exportedTimeSteps.size(); i++)
 	{
-		myDataProcessing.exportSealedColumnAnalyticalSolution(Ly,alpha,Q,rho,g,rho_f,
+		myDataProcessing.exportTerzaghiAnalyticalSolution(Ly,alpha,Q,rho,g,rho_f,
 			longitudinalModulus,sigmab,dt,exportedTimeSteps[i],consolidationCoefficient,pairName);
-		myDataProcessing.exportSealedColumnNumericalSolution(dy,dt,Ly,exportedTimeSteps[i],
-			pairName);
+		myDataProcessing.exportTerzaghiNumericalSolution(dy,dt,Ly,exportedTimeSteps[i],pairName);
+	}
+
+	// Exports the sensitivities, profiles for the specified time-steps and histories
+	for(int parameter=0; parameter<parametersNo; parameter++)
+	{
+		string parameterName=mySensitivity.parameterNames[parameter];
+		dataProcessing mySensitivityProcessing(idU,idV,idP,
+			mySensitivity.uSensitivityField[parameter],mySensitivity.vSensitivityField[parameter],
+			mySensitivity.pSensitivityField[parameter],gridType,interpScheme,dx,dy);
+
+		for(int i=0; i<exportedTimeSteps.size(); i++)
+			mySensitivityProcessing.exportTerzaghiNumericalSolution(dy,dt,Ly,exportedTimeSteps[i],
+				pairName+"_d"+parameterName);
 	}
+	mySensitivity.exportTerzaghiSensitivityHistory(dt,pairName);
 
 	return ierr;
 };
 
-int terzaghi(string gridType, string interpScheme, int Nt, int meshSize, double Lt, double g,
-	double sigmab, poroelasticProperties myProperties)
+int terzaghiAdjoint(string gridType, string interpScheme, int Nt, int meshSize, double Lt,
+	double g, double sigmab, poroelasticProperties myProperties, adjointCalibration& myCalibration,
+	double& misfit, vector<double>& gradient)
 {
 	PetscErrorCode ierr;
 
+	// No run arena, the calibration, the misfit and the gradient are owned by the caller
 /*		ENTRY PARAMETERS
 	----------------------------------------------------------------*/
 
@@ -281,6 +504,14 @@ int terzaghi(string gridType, string interpScheme, int Nt, int meshSize, double
 	double phi=myProperties.porosity;
 	double K=myProperties.permeability;
 
+	// Calibrated parameters replace the ones of the medium (drained bulk modulus kept)
+	if(!myCalibration.parameterValues.empty())
+	{
+		K=myCalibration.parameterValues[0];
+		G=myCalibration.parameterValues[1];
+		lambda=myProperties.bulkModulus-2*G/3;
+	}
+
 	// Solid properties
 	double c_s=1/myProperties.solidBulkModulus;
 	double rho_s=myProperties.solidDensity;
@@ -342,6 +573,16 @@ int terzaghi(string gridType, string interpScheme, int Nt, int meshSize, double
 	problemParameters myProblem(dx,dy,K,phi,rho_s,c_s,mu_f,rho_f,c_f,G,lambda,sigmab,Lx,Ly,
 		uField,vField,pField,cooU,cooV,cooP,idU,idV,idP,g);
 
+	if(!myCalibration.parameterValues.empty())
+	{
+		myProblem.alpha=myCalibration.parameterValues[2];
+		myProblem.Q=myCalibration.parameterValues[3];
+	}
+	else myCalibration.parameterValues={K,G,myProblem.alpha,myProblem.Q};
+
+	// Copy kept for the initial conditions of the sensitivities
+	problemParameters myInitialProblem=myProblem;
+
 	// Apply initial conditions
 	myProblem.applyTerzaghiInitialConditions();
 
@@ -393,13 +634,17 @@ int terzaghi(string gridType, string interpScheme, int Nt, int meshSize, double
 		sparseCoefficientsColumn,sparseCoefficientsValue,uField,vField,pField,Nu,Nv,NP,Nt,idU,idV,
 		idP,cooU,cooV,cooP);
 
-	// LU Factorization of coefficientsMatrix
+	// LU Factorization of coefficientsMatrix, the transpose solves need the factors
+	myLinearSystemSolver.solverType="lu";
 	ierr=myLinearSystemSolver.coefficientsMatrixLUFactorization();CHKERRQ(ierr);
 	
 	// Creation of arrays
 	ierr=myLinearSystemSolver.createPETScArrays();CHKERRQ(ierr);
 	ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
 
+	// Progress of the run written to -metrics_file
+	liveMetrics myMetrics("terzaghiAdjoint",gridType,interpScheme,Nt-1,dt);
+
 	for(timeStep=0; timeStep<Nt-1; timeStep++)
 	{
 		// Assembly of the independent terms array
@@ -421,45 +666,177 @@ int terzaghi(string gridType, string interpScheme, int Nt, int meshSize, double
 		pField=myLinearSystemSolver.pField;
 		ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
 
+		myMetrics.update(timeStep+1,myLinearSystemSolver);
 		cout << timeStep+1<< "\r";
 	}
 
-	cout << Ny << "x" << Nx << "x" << Nt-1 << " ";
-	cout << "(h=" << h << ", dt=" << dt << ")\n";
-
-/*		DATA PROCESSING
+/*		ADJOINT SOLUTION
 	----------------------------------------------------------------*/
-	
+
 	// Variables declaration
-	vector<int> exportedTimeSteps=
-	{
-		{1},
-		{(Nt-1)/8},
-		{(Nt-1)/2},
-		{Nt-1}
-	};
-	if(Nt==2)
-	{
-		exportedTimeSteps.clear();
-		exportedTimeSteps.push_back(1);
+	int n=Nu+Nv+NP;
+	int parameter;
+	vector<double> adjointRHS, adjointArray, nextAdjointArray(n,0), transposeProduct;
+	vector<double> residualDerivative, initialSensitivity;
+
+	// Misfit of the probes
+	myCalibration.setTerzaghiProbes(idV,idP,Nu,Nv,Nt,dt);
+	misfit=myCalibration.getMisfit(uField,vField,pField,Nu,Nv);
+
+	// Linearization of the independent terms with respect to the previous time-step, b=B*x(n)+c
+	myIndependentTerms.assemblyPreviousStepOperator(dx,dy,dt,G,lambda,alpha,K,mu_f,Q,rho,g,
+		sparseCoefficientsRow,sparseCoefficientsColumn);
+
+	// Derivatives of the coefficients matrix and of the initial conditions, whose sensitivities
+	// are the only ones stored
+	sensitivityAnalysis mySensitivity(bcType,bcValue,Nu,Nv,NP,Nt,idU,idV,idP,cooU,cooV,cooP,
+		horFaceStatus,verFaceStatus,gridType,interpScheme,K,G,alpha,Q,lambda,mu_f,rho,g,1);
+	mySensitivity.setTerzaghiInitialSensitivity(myInitialProblem);
+	mySensitivity.assemblyMatrixDerivatives(dx,dy,dt);
+	gradient.assign(mySensitivity.parameterNames.size(),0);
+
+	// Backward in time, A^T*l(n)=dJ/dx(n)+B^T*l(n+1), with transpose solves on the same LU
+	for(timeStep=Nt-1; timeStep>0; timeStep--)
+	{
+		adjointRHS=myCalibration.getMisfitDerivative(timeStep,n);
+		transposeProduct=myIndependentTerms.getPreviousStepTransposeProduct(nextAdjointArray);
+		for(int i=0; i<n; i++) adjointRHS[i]+=transposeProduct[i];
+
+		ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
+		ierr=myLinearSystemSolver.setRHSValue(adjointRHS);CHKERRQ(ierr);
+		ierr=myLinearSystemSolver.solveTransposeLinearSystem();CHKERRQ(ierr);
+		ierr=myLinearSystemSolver.getSolutionArray(adjointArray);CHKERRQ(ierr);
+
+		// dJ/dp+=l(n)*(db/dp-dA/dp*x(n))
+		for(int a=0; a<myCalibration.calibratedParameters.size(); a++)
+		{
+			parameter=myCalibration.calibratedParameters[a];
+			residualDerivative=mySensitivity.assemblyDerivativeRHS(parameter,dx,dy,dt,uField,
+				vField,pField,timeStep-1,0);
+			for(int i=0; i<n; i++) gradient[parameter]+=adjointArray[i]*residualDerivative[i];
+		}
+
+		swap(nextAdjointArray,adjointArray);
+
+		cout << timeStep << "  \r";
 	}
 
-	// Constructor
-	dataProcessing myDataProcessing(idU,idV,idP,uField,vField,pField,gridType,interpScheme,dx,dy);
+	// Initial conditions, dJ/dp+=(dJ/dx(0)+B^T*l(1))*dx(0)/dp
+	adjointRHS=myCalibration.getMisfitDerivative(0,n);
+	transposeProduct=myIndependentTerms.getPreviousStepTransposeProduct(nextAdjointArray);
+	for(int a=0; a<myCalibration.calibratedParameters.size(); a++)
+	{
+		parameter=myCalibration.calibratedParameters[a];
+		initialSensitivity=mySensitivity.getSolutionArray(
+			mySensitivity.uSensitivityField[parameter],mySensitivity.vSensitivityField[parameter],
+			mySensitivity.pSensitivityField[parameter],0);
+		for(int i=0; i<n; i++) gradient[parameter]+=(adjointRHS[i]+transposeProduct[i])*
+			initialSensitivity[i];
+	}
 
-	// Exports data for specified time-steps
-	for(int i=0; i<exportedTimeSteps.size(); i++)
-	{
-		myDataProcessing.exportTerzaghiAnalyticalSolution(Ly,alpha,Q,rho,g,rho_f,
-			longitudinalModulus,sigmab,dt,exportedTimeSteps[i],consolidationCoefficient,pairName);
-		myDataProcessing.exportTerzaghiNumericalSolution(dy,dt,Ly,exportedTimeSteps[i],pairName);
+	return ierr;
+};
+
+int terzaghiCalibration(string gridType, string interpScheme, int Nt, int meshSize, double Lt,
+	double g, double sigmab, poroelasticProperties myProperties, adjointCalibration& myCalibration)
+{
+	PetscErrorCode ierr;
+
+	// Variables declaration
+	int iterationNo, lineSearchNo;
+	double misfit, trialMisfit, slope, stepLength, gradientNorm, initialGradientNorm;
+	vector<double> gradient, trialGradient, logGradient, trialLogGradient;
+	vector<double> logPositions, trialLogPositions, direction, positionUpdate, gradientUpdate;
+	string gridName=gridType;
+	if(gridType=="collocated") gridName+="+"+interpScheme;
+	string fileName="../export/terzaghiCalibration_"+myProperties.pairName+"_"+gridName+
+		"-grid.txt";
+
+	ofstream myFile(fileName);
+
+	// Initial guess
+	ierr=terzaghiAdjoint(gridType,interpScheme,Nt,meshSize,Lt,g,sigmab,myProperties,myCalibration,
+		misfit,gradient);CHKERRQ(ierr);
+	logGradient=myCalibration.getLogGradient(gradient);
+	initialGradientNorm=0;
+	for(int a=0; a<logGradient.size(); a++) initialGradientNorm+=logGradient[a]*logGradient[a];
+	initialGradientNorm=sqrt(initialGradientNorm);
+
+	for(iterationNo=0; iterationNo<=myCalibration.maxIterationNo; iterationNo++)
+	{
+		gradientNorm=0;
+		for(int a=0; a<logGradient.size(); a++) gradientNorm+=logGradient[a]*logGradient[a];
+		gradientNorm=sqrt(gradientNorm);
+
+		cout << "Iteration " << iterationNo << ": J=" << misfit << ", |dJ|=" << gradientNorm;
+		if(myFile.is_open()) myFile << iterationNo << " " << misfit << " " << gradientNorm;
+		for(int a=0; a<myCalibration.parameterValues.size(); a++)
+		{
+			cout << " " << myCalibration.parameterValues[a];
+			if(myFile.is_open()) myFile << " " << myCalibration.parameterValues[a];
+		}
+		cout << "\n";
+		if(myFile.is_open()) myFile << "\n";
+
+		if(gradientNorm<=myCalibration.gradientTolerance*initialGradientNorm ||
+			iterationNo==myCalibration.maxIterationNo) break;
+
+		// Search direction, restarted along the gradient if it is not a descent one
+		direction=myCalibration.getSearchDirection(logGradient);
+		slope=0;
+		for(int a=0; a<direction.size(); a++) slope+=direction[a]*logGradient[a];
+		if(slope>=0)
+		{
+			myCalibration.positionUpdates.clear();
+			myCalibration.gradientUpdates.clear();
+			for(int a=0; a<direction.size(); a++) direction[a]=-logGradient[a];
+			slope=-gradientNorm*gradientNorm;
+		}
+
+		// Backtracking line search
+		logPositions=myCalibration.getLogPositions();
+		trialLogPositions=logPositions;
+		stepLength=1;
+		for(lineSearchNo=0; lineSearchNo<myCalibration.maxLineSearchNo; lineSearchNo++)
+		{
+			for(int a=0; a<direction.size(); a++)
+				trialLogPositions[a]=logPositions[a]+stepLength*direction[a];
+			myCalibration.setLogPositions(trialLogPositions);
+
+			ierr=terzaghiAdjoint(gridType,interpScheme,Nt,meshSize,Lt,g,sigmab,myProperties,
+				myCalibration,trialMisfit,trialGradient);CHKERRQ(ierr);
+
+			if(trialMisfit<=misfit+myCalibration.armijoParameter*stepLength*slope) break;
+			stepLength/=2;
+		}
+		if(lineSearchNo==myCalibration.maxLineSearchNo)
+		{
+			myCalibration.setLogPositions(logPositions);
+			cout << "Line search failed\n";
+			break;
+		}
+
+		trialLogGradient=myCalibration.getLogGradient(trialGradient);
+		positionUpdate.resize(direction.size());
+		gradientUpdate.resize(direction.size());
+		for(int a=0; a<direction.size(); a++)
+		{
+			positionUpdate[a]=trialLogPositions[a]-logPositions[a];
+			gradientUpdate[a]=trialLogGradient[a]-logGradient[a];
+		}
+		myCalibration.updateHistory(positionUpdate,gradientUpdate);
+
+		misfit=trialMisfit;
+		logGradient=trialLogGradient;
 	}
 
+	if(myFile.is_open()) myFile.close();
+
 	return ierr;
 };
 
-int mandel(string gridType, string interpScheme, int Nt, int meshSize, double Lt, double g,
-	double forceb, poroelasticProperties myProperties)
+int terzaghiDimless(string gridType, string interpScheme, int Nt, int meshSize, double Lt,
+	double g, double sigmab, poroelasticProperties myProperties, dimensionlessCache& myCache)
 {
 	PetscErrorCode ierr;
 
@@ -467,12 +844,13 @@ int mandel(string gridType, string interpScheme, int Nt, int meshSize, double Lt
 	----------------------------------------------------------------*/
 
 	// Grid parameters
-	int Nx=5*meshSize;
-	int Ny=5*meshSize;
+	int Nx=meshSize;
+	int Ny=6*meshSize;
 
 	// Reservoir parameters
-	double Lx=5; // [m]
-	double Ly=5; // [m]
+	double Lx=1; // [m]
+	double Ly=6; // [m]
+
 	vector<vector<double>> sCoordinates=
 	{
 		{Lx,Ly},
@@ -501,16 +879,16 @@ int mandel(string gridType, string interpScheme, int Nt, int meshSize, double Lt
 	// "north" and follows counterclockwise)
 	vector<vector<int>> bcType=
 	{
-		{-1,-1,0},
+		{-1,-1,1},
 		{1,-1,-1},
 		{-1,1,0},
-		{-1,-1,1}
+		{1,-1,-1}
 	};
 
 	// BC values ({u,v,P}, starts on "north" and follows counterclockwise)
 	vector<vector<double>> bcValue=
 	{
-		{0,0,rho_f*g},
+		{0,sigmab,0},
 		{0,0,0},
 		{0,0,rho_f*g},
 		{0,0,0}
@@ -546,12 +924,9 @@ int mandel(string gridType, string interpScheme, int Nt, int meshSize, double Lt
 	----------------------------------------------------------------*/
 
 	// Constructor
-	problemParameters myProblem(dx,dy,K,phi,rho_s,c_s,mu_f,rho_f,c_f,G,lambda,forceb,Lx,Ly,
+	problemParameters myProblem(dx,dy,K,phi,rho_s,c_s,mu_f,rho_f,c_f,G,lambda,sigmab,Lx,Ly,
 		uField,vField,pField,cooU,cooV,cooP,idU,idV,idP,g);
 
-	// Apply initial conditions
-	myProblem.applyMandelInitialConditions();
-
 	// Passing variables
 	double Q;swap(Q,myProblem.Q);
 	double alpha;swap(alpha,myProblem.alpha);
@@ -561,84 +936,140 @@ int mandel(string gridType, string interpScheme, int Nt, int meshSize, double Lt
 	double minimumTimeStepVerruijt;swap(minimumTimeStepVerruijt,myProblem.dt_vv);
 	double dt_carlos;swap(dt_carlos,myProblem.dt_carlos);
 	double rho=(phi*rho_f+(1-phi)*rho_s);
-	double initialPressure;swap(initialPressure,myProblem.P0);
-	uField=myProblem.uDisplacementField;
-	vField=myProblem.vDisplacementField;
-	pField=myProblem.pressureField;
-	
-/*		LINEAR SYSTEM'S COEFFICIENTS MATRIX ASSEMBLY
+
+/*		NONDIMENSIONALIZATION
 	----------------------------------------------------------------*/
 
-	// Constructor
-	coefficientsAssembly myCoefficients(bcType,Nu,Nv,NP,idU,idV,idP,cooU,cooV,cooP,
-		horFaceStatus,verFaceStatus,gridType,interpScheme);
+	// Dimensionless groups (p*=alpha*p/sigmab, u*=M*u/sigmab and t*=t/dt)
+	double storageGroup=alpha*alpha*Q/longitudinalModulus;
+	double shearGroup=G/longitudinalModulus;
+	double mobilityGroup=K*longitudinalModulus*dt/(mu_f*alpha*alpha);
+	double pressureScale=sigmab/alpha;
+	double displacementScale=sigmab/longitudinalModulus;
+	string key=myCache.getKey(gridType,interpScheme,meshSize,Nt,storageGroup,shearGroup,
+		mobilityGroup);
+
+	// Only the problem without gravity is self-similar
+	bool isDimensionless=(g==0);
+	bool isCached=false;
+	if(isDimensionless) isCached=myCache.lookUpSolution(key,uField,vField,pField);
+
+	// Parameters of the solved system
+	double sG=G, sLambda=lambda, sAlpha=alpha, sK=K, sMu_f=mu_f, sQ=Q, sRho=rho, sGravity=g;
+	double sDt=dt;
+	if(isDimensionless)
+	{
+		sG=shearGroup;
+		sLambda=1-2*shearGroup;
+		sAlpha=1;
+		sK=mobilityGroup;
+		sMu_f=1;
+		sQ=storageGroup;
+		sRho=0;
+		sGravity=0;
+		sDt=1;
+
+		myProblem.alpha=sAlpha;
+		myProblem.Q=sQ;
+		myProblem.M=1;
+		myProblem.sigmab=1;
+		myProblem.rho=sRho;
+	}
+	else
+	{
+		myProblem.alpha=alpha;
+		myProblem.Q=Q;
+		myProblem.M=longitudinalModulus;
+	}
 
-	// Coefficients matrix assembly
-	myCoefficients.assemblyCoefficientsMatrix(dx,dy,dt,G,lambda,alpha,K,mu_f,Q,rho,g);
-	myCoefficients.assemblyMandelCoefficientsMatrix(dx,dy,G,lambda,alpha);
-	myCoefficients.assemblySparseMatrix(myCoefficients.coefficientsMatrix);
+	if(!isCached)
+	{
+		// Apply initial conditions
+		myProblem.applyTerzaghiInitialConditions();
+		uField=myProblem.uDisplacementField;
+		vField=myProblem.vDisplacementField;
+		pField=myProblem.pressureField;
+
+		// Coefficients matrix assembly
+		coefficientsAssembly myCoefficients(bcType,Nu,Nv,NP,idU,idV,idP,cooU,cooV,cooP,
+			horFaceStatus,verFaceStatus,gridType,interpScheme);
+		myCoefficients.assemblyCoefficientsMatrix(dx,dy,sDt,sG,sLambda,sAlpha,sK,sMu_f,sQ,sRho,
+			sGravity);
+
+		// Passing variables
+		vector<vector<double>> coefficientsMatrix;swap(coefficientsMatrix,
+			myCoefficients.coefficientsMatrix);
+		vector<double> sparseCoefficientsRow;swap(sparseCoefficientsRow,
+			myCoefficients.sparseCoefficientsRow);
+		vector<double> sparseCoefficientsColumn;swap(sparseCoefficientsColumn,
+			myCoefficients.sparseCoefficientsColumn);
+		vector<double> sparseCoefficientsValue;swap(sparseCoefficientsValue,
+			myCoefficients.sparseCoefficientsValue);
+
+		// Linear system solution
+		int timeStep;
+		vector<double> independentTermsArray;
+
+		if(isDimensionless) bcValue[0][1]=1;
+		independentTermsAssembly myIndependentTerms(bcType,bcValue,Nu,Nv,NP,idU,idV,idP,cooU,cooV,
+			cooP,horFaceStatus,verFaceStatus,gridType,interpScheme);
+		linearSystemSolver myLinearSystemSolver(coefficientsMatrix,sparseCoefficientsRow,
+			sparseCoefficientsColumn,sparseCoefficientsValue,uField,vField,pField,Nu,Nv,NP,Nt,idU,
+			idV,idP,cooU,cooV,cooP);
+
+		// LU Factorization of coefficientsMatrix
+		ierr=myLinearSystemSolver.coefficientsMatrixLUFactorization();CHKERRQ(ierr);
+
+		// Creation of arrays
+		ierr=myLinearSystemSolver.createPETScArrays();CHKERRQ(ierr);
+		ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
 
-	// Passing variables
-	vector<vector<double>> coefficientsMatrix;swap(coefficientsMatrix,
-		myCoefficients.coefficientsMatrix);
-	vector<double> sparseCoefficientsRow;swap(sparseCoefficientsRow,
-		myCoefficients.sparseCoefficientsRow);
-	vector<double> sparseCoefficientsColumn;swap(sparseCoefficientsColumn,
-		myCoefficients.sparseCoefficientsColumn);
-	vector<double> sparseCoefficientsValue;swap(sparseCoefficientsValue,
-		myCoefficients.sparseCoefficientsValue);
+		// Progress of the run written to -metrics_file
+		liveMetrics myMetrics("terzaghiDimless",gridType,interpScheme,Nt-1,dt);
 
-/*		LINEAR SYSTEM SOLVER
-	----------------------------------------------------------------*/
+		for(timeStep=0; timeStep<Nt-1; timeStep++)
+		{
+			// Assembly of the independent terms array
+			myIndependentTerms.assemblyIndependentTermsArray(dx,dy,sDt,sG,sLambda,sAlpha,sK,sMu_f,
+				sQ,sRho,sGravity,uField,vField,pField,timeStep);
 
-	// Variables declaration
-	int timeStep;
-	vector<double> independentTermsArray;
+			// Passing independent terms array
+			independentTermsArray=myIndependentTerms.independentTermsArray;
 
-	// Constructors
-	independentTermsAssembly myIndependentTerms(bcType,bcValue,Nu,Nv,NP,idU,idV,idP,cooU,cooV,cooP,
-		horFaceStatus,verFaceStatus,gridType,interpScheme);
-	linearSystemSolver myLinearSystemSolver(coefficientsMatrix,sparseCoefficientsRow,
-		sparseCoefficientsColumn,sparseCoefficientsValue,uField,vField,pField,Nu,Nv,NP,Nt,idU,idV,
-		idP,cooU,cooV,cooP);
+			// Solution of the linear system
+			ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
+			ierr=myLinearSystemSolver.setRHSValue(independentTermsArray);CHKERRQ(ierr);
+			ierr=myLinearSystemSolver.solveLinearSystem();CHKERRQ(ierr);
+			ierr=myLinearSystemSolver.setFieldValue(timeStep+1);CHKERRQ(ierr);
 
-	// Increase the independent terms array
-	myIndependentTerms.increaseMandelIndependentTermsArray();
+			// Passing solutions
+			uField=myLinearSystemSolver.uField;
+			vField=myLinearSystemSolver.vField;
+			pField=myLinearSystemSolver.pField;
+			ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
 
-	// LU Factorization of coefficientsMatrix
-	ierr=myLinearSystemSolver.coefficientsMatrixLUFactorization();CHKERRQ(ierr);
+			myMetrics.update(timeStep+1,myLinearSystemSolver);
+			cout << timeStep+1<< "\r";
+		}
 
-	// Creation of arrays
-	ierr=myLinearSystemSolver.createPETScArrays();CHKERRQ(ierr);
-	ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
+		if(isDimensionless) myCache.storeSolution(key,uField,vField,pField);
+	}
 
-	for(timeStep=0; timeStep<Nt-1; timeStep++)
+	// Rescales the dimensionless solution
+	if(isDimensionless)
 	{
-		// Assembly of the independent terms array
-		myIndependentTerms.assemblyIndependentTermsArray(dx,dy,dt,G,lambda,alpha,K,mu_f,Q,rho,g,
-			uField,vField,pField,timeStep);
-		myIndependentTerms.assemblyMandelIndependentTermsArray(forceb,Lx);
-
-		// Passing independent terms array
-		independentTermsArray=myIndependentTerms.independentTermsArray;
-		
-		// Solution of the linear system
-		ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
-		ierr=myLinearSystemSolver.setRHSValue(independentTermsArray);CHKERRQ(ierr);
-		ierr=myLinearSystemSolver.solveLinearSystem();CHKERRQ(ierr);
-		ierr=myLinearSystemSolver.setFieldValue(timeStep+1);CHKERRQ(ierr);
-
-		// Passing solutions
-		uField=myLinearSystemSolver.uField;
-		vField=myLinearSystemSolver.vField;
-		pField=myLinearSystemSolver.pField;
-		ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
-
-		cout << timeStep+1<< "\r";
+		for(int i=0; i<uField.size(); i++)
+			for(int k=0; k<uField[i].size(); k++) uField[i][k]*=displacementScale;
+		for(int i=0; i<vField.size(); i++)
+			for(int k=0; k<vField[i].size(); k++) vField[i][k]*=displacementScale;
+		for(int i=0; i<pField.size(); i++)
+			for(int k=0; k<pField[i].size(); k++) pField[i][k]*=pressureScale;
 	}
 
 	cout << Ny << "x" << Nx << "x" << Nt-1 << " ";
-	cout << "(h=" << h << ", dt=" << dt << ")\n";
+	cout << "(h=" << h << ", dt=" << dt;
+	if(isCached) cout << ", served from cache";
+	cout << ")\n";
 
 /*		DATA PROCESSING
 	----------------------------------------------------------------*/
@@ -647,9 +1078,9 @@ int mandel(string gridType, string interpScheme, int Nt, int meshSize, double Lt
 	vector<int> exportedTimeSteps=
 	{
 		{1},
-		{(Nt-1)/16},
-		{(Nt-1)/4},
-		{(Nt-1)}
+		{(Nt-1)/8},
+		{(Nt-1)/2},
+		{Nt-1}
 	};
 	if(Nt==2)
 	{
@@ -660,26 +1091,25 @@ int mandel(string gridType, string interpScheme, int Nt, int meshSize, double Lt
 	// Constructor
 	dataProcessing myDataProcessing(idU,idV,idP,uField,vField,pField,gridType,interpScheme,dx,dy);
 
-	// Gets Mandel transcendental equation roots
-	myDataProcessing.findMandelRoots(initialPressure,forceb,Lx,alpha,longitudinalModulus,lambda,Q);
-
 	// Exports data for specified time-steps
 	for(int i=0; i<exportedTimeSteps.size(); i++)
 	{
-		myDataProcessing.exportMandelAnalyticalSolution(Lx,Ly,consolidationCoefficient,
-			initialPressure,alpha,Q,longitudinalModulus,lambda,forceb,K,mu_f,dt,
-			exportedTimeSteps[i],pairName);
-		myDataProcessing.exportMandelNumericalSolution(dx,dy,dt,Lx,Ly,exportedTimeSteps[i],
-			pairName);
+		myDataProcessing.exportTerzaghiAnalyticalSolution(Ly,alpha,Q,rho,g,rho_f,
+			longitudinalModulus,sigmab,dt,exportedTimeSteps[i],consolidationCoefficient,pairName);
+		myDataProcessing.exportTerzaghiNumericalSolution(dy,dt,Ly,exportedTimeSteps[i],pairName);
 	}
-	
+
 	return ierr;
 };
 
-int convergence(string gridType, string interpScheme, int Nt, int meshSize, double Lt, double g,
-	double sigmab, poroelasticProperties myProperties)
+int terzaghiEnsemble(string gridType, string interpScheme, int Nt, int meshSize, double Lt,
+	double g, double sigmab, poroelasticProperties myProperties, int realizationsNo,
+	double correlationLength, double logDeviation)
 {
-	PetscErrorCode ierr;
+	PetscErrorCode ierr=0;
+
+	// Objects of this run are allocated from the run arena
+	runArenaScope myRunArena;
 
 /*		ENTRY PARAMETERS
 	----------------------------------------------------------------*/
@@ -735,6 +1165,22 @@ int convergence(string gridType, string interpScheme, int Nt, int meshSize, doub
 		{0,0,0}
 	};
 
+	// Ensemble parameters
+	PetscInt threadsNo=thread::hardware_concurrency();
+	PetscInt baseSeed=0;
+	PetscOptionsGetInt(NULL,NULL,"-ensemble_threads",&threadsNo,NULL);
+	PetscOptionsGetInt(NULL,NULL,"-ensemble_seed",&baseSeed,NULL);
+	if(threadsNo<1) threadsNo=1;
+	if(threadsNo>realizationsNo) threadsNo=realizationsNo;
+
+	// Property fields live on the cells, which only the staggered grid discretizes separately
+	if(gridType!="staggered")
+	{
+		cout << "Random property fields require the staggered grid\n";
+
+		return ierr;
+	}
+
 /*		GRID CREATION
 	----------------------------------------------------------------*/
 
@@ -768,123 +1214,182 @@ int convergence(string gridType, string interpScheme, int Nt, int meshSize, doub
 	problemParameters myProblem(dx,dy,K,phi,rho_s,c_s,mu_f,rho_f,c_f,G,lambda,sigmab,Lx,Ly,
 		uField,vField,pField,cooU,cooV,cooP,idU,idV,idP,g);
 
-	// Apply initial conditions
-	myProblem.applyTerzaghiInitialConditions();
+	// The undrained response of an heterogeneous column is not known in closed form, so the
+	// column starts unloaded and the load is applied in the first time-step
+	myProblem.applySealedColumnInitialConditions();
 
 	// Passing variables
 	double Q;swap(Q,myProblem.Q);
 	double alpha;swap(alpha,myProblem.alpha);
-	double storageCoefficient=1/Q;
-	double longitudinalModulus;swap(longitudinalModulus,myProblem.M);
-	double consolidationCoefficient;swap(consolidationCoefficient,myProblem.c);
-	double minimumTimeStepVerruijt;swap(minimumTimeStepVerruijt,myProblem.dt_vv);
-	double dt_carlos;swap(dt_carlos,myProblem.dt_carlos);
 	double rho=(phi*rho_f+(1-phi)*rho_s);
-	double initialPressure;swap(initialPressure,myProblem.P0);
 	uField=myProblem.uDisplacementField;
 	vField=myProblem.vDisplacementField;
 	pField=myProblem.pressureField;
-	
-/*		LINEAR SYSTEM'S COEFFICIENTS MATRIX ASSEMBLY
-	----------------------------------------------------------------*/
-
-	// Constructor
-	coefficientsAssembly myCoefficients(bcType,Nu,Nv,NP,idU,idV,idP,cooU,cooV,cooP,
-		horFaceStatus,verFaceStatus,gridType,interpScheme);
-
-	// Coefficients matrix assembly
-	myCoefficients.assemblyCoefficientsMatrix(dx,dy,dt,G,lambda,alpha,K,mu_f,Q,rho,g);
-
-	// Passing variables
-	vector<vector<double>> coefficientsMatrix;swap(coefficientsMatrix,
-		myCoefficients.coefficientsMatrix);
-	vector<double> sparseCoefficientsRow;swap(sparseCoefficientsRow,
-		myCoefficients.sparseCoefficientsRow);
-	vector<double> sparseCoefficientsColumn;swap(sparseCoefficientsColumn,
-		myCoefficients.sparseCoefficientsColumn);
-	vector<double> sparseCoefficientsValue;swap(sparseCoefficientsValue,
-		myCoefficients.sparseCoefficientsValue);
 
-/*		LINEAR SYSTEM SOLVER
+/*		ENSEMBLE SOLUTION
 	----------------------------------------------------------------*/
 
-	// Variables declaration
-	int timeStep;
-	vector<double> independentTermsArray;
+	// Probes: settlement at the top and pore pressure at the base of the column, on its centerline
+	vector<int> settlementPositions={idV[0][(Nx-1)/2]-1,idV[0][Nx/2]-1};
+	vector<int> pressurePositions={idP[Ny-1][(Nx-1)/2]-1,idP[Ny-1][Nx/2]-1};
 
 	// Constructors
-	independentTermsAssembly myIndependentTerms(bcType,bcValue,Nu,Nv,NP,idU,idV,idP,cooU,cooV,cooP,
-		horFaceStatus,verFaceStatus,gridType,interpScheme);
-	linearSystemSolver myLinearSystemSolver(coefficientsMatrix,sparseCoefficientsRow,
-		sparseCoefficientsColumn,sparseCoefficientsValue,uField,vField,pField,Nu,Nv,NP,Nt,idU,idV,
-		idP,cooU,cooV,cooP);
-
-	// LU Factorization of coefficientsMatrix
-	ierr=myLinearSystemSolver.coefficientsMatrixLUFactorization();CHKERRQ(ierr);
-	
-	// Creation of arrays
-	ierr=myLinearSystemSolver.createPETScArrays();CHKERRQ(ierr);
-	ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
-
-	for(timeStep=0; timeStep<Nt-1; timeStep++)
-	{
-		// Assembly of the independent terms array
-		myIndependentTerms.assemblyIndependentTermsArray(dx,dy,dt,G,lambda,alpha,K,mu_f,Q,rho,g,
-			uField,vField,pField,timeStep);
-
-		// Passing independent terms array
-		independentTermsArray=myIndependentTerms.independentTermsArray;
-
-		// Solution of the linear system
-		ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
-		ierr=myLinearSystemSolver.setRHSValue(independentTermsArray);CHKERRQ(ierr);
-		ierr=myLinearSystemSolver.solveLinearSystem();CHKERRQ(ierr);
-		ierr=myLinearSystemSolver.setFieldValue(timeStep+1);CHKERRQ(ierr);
-
-		// Passing solutions
-		uField=myLinearSystemSolver.uField;
-		vField=myLinearSystemSolver.vField;
-		pField=myLinearSystemSolver.pField;
-		ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
+	randomFieldGenerator myFields(Nx,Ny,dx,dy,correlationLength);
+	ensembleStatistics myStatistics({"settlement","pressure"},{0.05,0.5,0.95},Nt);
+
+	if(myFields.negativeEigenvaluesNo>0) cout << myFields.negativeEigenvaluesNo <<
+		" negative eigenvalues of the covariance embedding clipped\n";
+
+	// PETSc is not thread safe, so its calls are serialized; the fields generation and the
+	// assembly, which dominate the cost, run concurrently. Realizations are accumulated in order,
+	// so the statistics do not depend on the number of threads.
+	mutex petscMutex, statisticsMutex;
+	atomic<int> nextRealization(0);
+	int accumulatedNo=0;
+	vector<vector<vector<double>>> pendingSeries(realizationsNo);
+	vector<int> finishedRealizations(realizationsNo,0);
+	vector<PetscErrorCode> threadErrors(threadsNo,0);
+
+	auto solveRealizations=[&]() -> PetscErrorCode
+	{
+		PetscErrorCode ierr;
+		int realization;
+		vector<vector<double>> logK, logG;
+		vector<vector<double>> series(2,vector<double>(Nt));
+		vector<vector<double>> uRealization, vRealization, pRealization;
+
+		// Constructors, the solver is factorized for the homogeneous medium, whose nonzero pattern
+		// is shared by every realization
+		coefficientsAssembly myCoefficients(bcType,Nu,Nv,NP,idU,idV,idP,cooU,cooV,cooP,
+			horFaceStatus,verFaceStatus,gridType,interpScheme);
+		independentTermsAssembly myIndependentTerms(bcType,bcValue,Nu,Nv,NP,idU,idV,idP,cooU,cooV,
+			cooP,horFaceStatus,verFaceStatus,gridType,interpScheme);
+		myCoefficients.assemblyCoefficientsMatrix(dx,dy,dt,G,lambda,alpha,K,mu_f,Q,rho,g);
+
+		unique_lock<mutex> petscLock(petscMutex);
+		linearSystemSolver myLinearSystemSolver(myCoefficients.coefficientsMatrix,
+			myCoefficients.sparseCoefficientsRow,myCoefficients.sparseCoefficientsColumn,
+			myCoefficients.sparseCoefficientsValue,uField,vField,pField,Nu,Nv,NP,Nt,idU,idV,idP,
+			cooU,cooV,cooP);
+		ierr=myLinearSystemSolver.coefficientsMatrixSymbolicFactorization();CHKERRQ(ierr);
+		ierr=myLinearSystemSolver.createPETScArrays();CHKERRQ(ierr);
+		petscLock.unlock();
+
+		while((realization=nextRealization++)<realizationsNo)
+		{
+			// Lognormal fields with the mean values of the medium
+			myFields.getGaussianFields(baseSeed+realization,logK,logG);
+			myCoefficients.setPropertyFields(myFields.getLognormalField(logG,G,logDeviation),
+				myFields.getLognormalField(logK,K,logDeviation));
+
+			// Coefficients matrix assembly
+			myCoefficients.resizeLinearProblem();
+			myCoefficients.assemblyCoefficientsMatrix(dx,dy,dt,G,lambda,alpha,K,mu_f,Q,rho,g);
+
+			petscLock.lock();
+			ierr=myLinearSystemSolver.coefficientsMatrixNumericFactorization(
+				myCoefficients.sparseCoefficientsRow,myCoefficients.sparseCoefficientsColumn,
+				myCoefficients.sparseCoefficientsValue);CHKERRQ(ierr);
+			petscLock.unlock();
+
+			uRealization=uField;
+			vRealization=vField;
+			pRealization=pField;
+			myLinearSystemSolver.uField=uField;
+			myLinearSystemSolver.vField=vField;
+			myLinearSystemSolver.pField=pField;
+
+			for(int timeStep=0; timeStep<Nt-1; timeStep++)
+			{
+				// Assembly of the independent terms array
+				myIndependentTerms.assemblyIndependentTermsArray(dx,dy,dt,G,lambda,alpha,K,mu_f,Q,
+					rho,g,uRealization,vRealization,pRealization,timeStep);
+
+				// Solution of the linear system
+				petscLock.lock();
+				ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
+				ierr=myLinearSystemSolver.setRHSValue(myIndependentTerms.independentTermsArray);
+					CHKERRQ(ierr);
+				ierr=myLinearSystemSolver.solveLinearSystem();CHKERRQ(ierr);
+				ierr=myLinearSystemSolver.setFieldValue(timeStep+1);CHKERRQ(ierr);
+				petscLock.unlock();
+
+				// Passing solutions
+				uRealization=myLinearSystemSolver.uField;
+				vRealization=myLinearSystemSolver.vField;
+				pRealization=myLinearSystemSolver.pField;
+			}
+
+			for(int timeStep=0; timeStep<Nt; timeStep++)
+			{
+				series[0][timeStep]=0.5*(vRealization[settlementPositions[0]][timeStep]+
+					vRealization[settlementPositions[1]][timeStep]);
+				series[1][timeStep]=0.5*(pRealization[pressurePositions[0]][timeStep]+
+					pRealization[pressurePositions[1]][timeStep]);
+			}
+
+			lock_guard<mutex> statisticsLock(statisticsMutex);
+			pendingSeries[realization]=series;
+			finishedRealizations[realization]=1;
+			while(accumulatedNo<realizationsNo && finishedRealizations[accumulatedNo]==1)
+			{
+				myStatistics.addSample(pendingSeries[accumulatedNo]);
+				pendingSeries[accumulatedNo].clear();
+				accumulatedNo++;
+			}
+			cout << accumulatedNo << "\r";
+		}
+
+		// The solver destroys its PETSc objects when leaving the scope
+		petscLock.lock();
+
+		return 0;
+	};
 
-		cout << timeStep+1<< "\r";
-	}
+	vector<thread> myThreads;
+	for(int threadNo=0; threadNo<threadsNo; threadNo++)
+		myThreads.push_back(thread([&,threadNo](){threadErrors[threadNo]=solveRealizations();}));
+	for(int threadNo=0; threadNo<threadsNo; threadNo++) myThreads[threadNo].join();
+	for(int threadNo=0; threadNo<threadsNo; threadNo++) CHKERRQ(threadErrors[threadNo]);
 
-	cout << Ny << "x" << Nx << "x" << Nt-1 << " ";
-	cout << "(h=" << h << ", dt=" << dt;
+	cout << Ny << "x" << Nx << "x" << Nt-1 << "x" << realizationsNo << " ";
+	cout << "(h=" << h << ", dt=" << dt << ", threads=" << threadsNo << ")\n";
 
 /*		DATA PROCESSING
 	----------------------------------------------------------------*/
-	
-	// Constructor
-	dataProcessing myDataProcessing(idU,idV,idP,uField,vField,pField,gridType,interpScheme,dx,dy);
 
-	// Gets error norm
-	myDataProcessing.getTerzaghiErrorNorm(dy,dt,h,Ly,initialPressure,consolidationCoefficient,
-		alpha,longitudinalModulus,sigmab,Q,rho,g,rho_f);
-	double pErrorNorm=myDataProcessing.myErrorNorm.p;
-	double vErrorNorm=myDataProcessing.myErrorNorm.v;
-	cout << ", pErrorNorm=" << pErrorNorm << ", vErrorNorm=" << vErrorNorm << ")\n";
+	myStatistics.exportStatistics("../export/terzaghiEnsemble_"+pairName+"_"+gridType+
+		"-grid.txt",dt);
 
 	return ierr;
 };
 
-int stripfoot(string gridType, string interpScheme, int Nt, int meshSize, double Lt, double g,
-	double sigmab, poroelasticProperties myProperties)
+int terzaghiRealTime(string gridType, string interpScheme, int Nt, int meshSize, double Lt,
+	double g, double sigmab, poroelasticProperties myProperties, vector<double> loadSeries)
 {
 	PetscErrorCode ierr;
 
+	// A reading per time-step, dt=Lt/(Nt-1) requires at least two
+	if(loadSeries.size()<2 || Nt!=loadSeries.size()+1)
+	{
+		cout << "The load series must hold a reading per time-step, at least two.\n";
+
+		return 1;
+	}
+
+	// Objects of this run are allocated from the run arena
+	runArenaScope myRunArena;
+
 /*		ENTRY PARAMETERS
 	----------------------------------------------------------------*/
 
 	// Grid parameters
-	int Nx=5*meshSize;
-	int Ny=5*meshSize;
-	int stripSize=meshSize;
+	int Nx=meshSize;
+	int Ny=6*meshSize;
 
 	// Reservoir parameters
-	double Lx=5; // [m]
-	double Ly=5; // [m]
+	double Lx=1; // [m]
+	double Ly=6; // [m]
 
 	vector<vector<double>> sCoordinates=
 	{
@@ -910,22 +1415,22 @@ int stripfoot(string gridType, string interpScheme, int Nt, int meshSize, double
 	double rho_f=myProperties.fluidDensity;
 	double mu_f=myProperties.fluidViscosity;
 
-	// BC types ({u,v,p-micro,p-macro} 1 for Dirichlet and 0 for Neumann, -1 for Stress/Fluid Flow, starts on
+	// BC types ({u,v,P} 1 for Dirichlet and 0 for Neumann, -1 for Stress/Fluid Flow, starts on
 	// "north" and follows counterclockwise)
 	vector<vector<int>> bcType=
 	{
-		{-1,-1,-1},
+		{-1,-1,1},
 		{1,-1,-1},
-		{-1,1,-1},
+		{-1,1,0},
 		{1,-1,-1}
 	};
 
 	// BC values ({u,v,P}, starts on "north" and follows counterclockwise)
 	vector<vector<double>> bcValue=
 	{
+		{0,sigmab,0},
 		{0,0,0},
-		{0,0,0},
-		{0,0,0},
+		{0,0,rho_f*g},
 		{0,0,0}
 	};
 
@@ -988,7 +1493,6 @@ int stripfoot(string gridType, string interpScheme, int Nt, int meshSize, double
 
 	// Coefficients matrix assembly
 	myCoefficients.assemblyCoefficientsMatrix(dx,dy,dt,G,lambda,alpha,K,mu_f,Q,rho,g);
-	myCoefficients.addStripfootBC(stripSize,K,mu_f);
 
 	// Passing variables
 	vector<vector<double>> coefficientsMatrix;swap(coefficientsMatrix,
@@ -1000,12 +1504,22 @@ int stripfoot(string gridType, string interpScheme, int Nt, int meshSize, double
 	vector<double> sparseCoefficientsValue;swap(sparseCoefficientsValue,
 		myCoefficients.sparseCoefficientsValue);
 
-/*		LINEAR SYSTEM SOLVER
+/*		REAL-TIME SOLUTION
 	----------------------------------------------------------------*/
 
-	// Variables declaration
-	int timeStep;
-	vector<double> independentTermsArray;
+	// Variables declaration, loadSeries holds the load of each of the Nt-1 time-steps and the
+	// initial conditions are the ones of the load sigmab
+	int n=Nu+Nv+NP;
+	PetscInt lockMemory=0;
+	vector<double> constantArray, loadArray, initialSolution;
+	vector<vector<double>> uZero(Nu,vector<double>(1,0));
+	vector<vector<double>> vZero(Nv,vector<double>(1,0));
+	vector<vector<double>> pZero(NP,vector<double>(1,0));
+	vector<vector<double>> series(2,vector<double>(Nt,0));
+
+	// Probes: settlement at the top and pore pressure at the base of the column, on its centerline
+	vector<int> settlementPositions={Nu+idV[0][(Nx-1)/2]-1,Nu+idV[0][Nx/2]-1};
+	vector<int> pressurePositions={Nu+Nv+idP[Ny-1][(Nx-1)/2]-1,Nu+Nv+idP[Ny-1][Nx/2]-1};
 
 	// Constructors
 	independentTermsAssembly myIndependentTerms(bcType,bcValue,Nu,Nv,NP,idU,idV,idP,cooU,cooV,cooP,
@@ -1014,257 +1528,416 @@ int stripfoot(string gridType, string interpScheme, int Nt, int meshSize, double
 		sparseCoefficientsColumn,sparseCoefficientsValue,uField,vField,pField,Nu,Nv,NP,Nt,idU,idV,
 		idP,cooU,cooV,cooP);
 
-	// LU Factorization of coefficientsMatrix
+	// LU Factorization of coefficientsMatrix, the stepper solves with the factors
+	myLinearSystemSolver.solverType="lu";
 	ierr=myLinearSystemSolver.coefficientsMatrixLUFactorization();CHKERRQ(ierr);
-	
+
 	// Creation of arrays
 	ierr=myLinearSystemSolver.createPETScArrays();CHKERRQ(ierr);
 	ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
 
-	for(timeStep=0; timeStep<Nt-1; timeStep++)
-	{
-		// Assembly of the independent terms array
-		myIndependentTerms.assemblyIndependentTermsArray(dx,dy,dt,G,lambda,alpha,K,mu_f,Q,rho,g,
-			uField,vField,pField,timeStep);
-		myIndependentTerms.addStripfootBC(stripSize,dx,sigmab);
+	// Independent terms, b=B*x(n)+c+load*l, with c and l from the assembly with no load and with a
+	// unit load on the top
+	myIndependentTerms.assemblyPreviousStepOperator(dx,dy,dt,G,lambda,alpha,K,mu_f,Q,rho,g,
+		sparseCoefficientsRow,sparseCoefficientsColumn);
+	myIndependentTerms.boundaryConditionValue[0][1]=0;
+	myIndependentTerms.assemblyIndependentTermsArray(dx,dy,dt,G,lambda,alpha,K,mu_f,Q,rho,g,uZero,
+		vZero,pZero,0);
+	constantArray=myIndependentTerms.independentTermsArray;
+	myIndependentTerms.boundaryConditionValue[0][1]=1;
+	myIndependentTerms.assemblyIndependentTermsArray(dx,dy,dt,G,lambda,alpha,K,mu_f,Q,rho,g,uZero,
+		vZero,pZero,0);
+	loadArray=myIndependentTerms.independentTermsArray;
+	for(int i=0; i<n; i++) loadArray[i]-=constantArray[i];
+	myIndependentTerms.boundaryConditionValue[0][1]=sigmab;
+
+	for(int i=0; i<Nu; i++) initialSolution.push_back(uField[i][0]);
+	for(int i=0; i<Nv; i++) initialSolution.push_back(vField[i][0]);
+	for(int i=0; i<NP; i++) initialSolution.push_back(pField[i][0]);
 
-		// Passing independent terms array
-		independentTermsArray=myIndependentTerms.independentTermsArray;
+	// Constructor
+	realTimeStepper myStepper(myIndependentTerms.previousStepOperatorRow,
+		myIndependentTerms.previousStepOperatorColumn,myIndependentTerms.previousStepOperatorValue,
+		constantArray,loadArray,initialSolution,myLinearSystemSolver.coefficientsMatrixPETSc,
+		myLinearSystemSolver.independentTermsArrayPETSc,
+		myLinearSystemSolver.linearSystemSolutionPETSc);
 
-		// Solution of the linear system
-		ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
-		ierr=myLinearSystemSolver.setRHSValue(independentTermsArray);CHKERRQ(ierr);
-		ierr=myLinearSystemSolver.solveLinearSystem();CHKERRQ(ierr);
-		ierr=myLinearSystemSolver.setFieldValue(timeStep+1);CHKERRQ(ierr);
+	// -realtime_lock_memory 1 locks the arrays of the stepper in memory
+	PetscOptionsGetInt(NULL,NULL,"-realtime_lock_memory",&lockMemory,NULL);
+	if(lockMemory)
+	{
+		ierr=myStepper.lockMemory();CHKERRQ(ierr);
+	}
 
-		// Passing solutions
-		uField=myLinearSystemSolver.uField;
-		vField=myLinearSystemSolver.vField;
-		pField=myLinearSystemSolver.pField;
-		ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
+	// Nothing is allocated nor printed inside the loop
+	for(int timeStep=0; timeStep<Nt; timeStep++)
+	{
+		if(timeStep>0)
+		{
+			ierr=myStepper.step(loadSeries[timeStep-1]);CHKERRQ(ierr);
+		}
 
-		cout << timeStep+1<< "\r";
+		series[0][timeStep]=0.5*(myStepper.solutionArray[settlementPositions[0]]+
+			myStepper.solutionArray[settlementPositions[1]]);
+		series[1][timeStep]=0.5*(myStepper.solutionArray[pressurePositions[0]]+
+			myStepper.solutionArray[pressurePositions[1]]);
 	}
 
 	cout << Ny << "x" << Nx << "x" << Nt-1 << " ";
 	cout << "(h=" << h << ", dt=" << dt << ")\n";
+	cout << "Latency: mean=" << myStepper.getMeanLatency() << "s, p50=" <<
+		myStepper.getLatencyQuantile(0.5) << "s, p99=" << myStepper.getLatencyQuantile(0.99) <<
+		"s, max=" << myStepper.maxLatency << "s\n";
 
 /*		DATA PROCESSING
 	----------------------------------------------------------------*/
-	
-	// Variables declaration
-	vector<int> exportedTimeSteps=
-	{
-		{1},
-		{(Nt-1)/8},
-		{(Nt-1)/2},
-		{Nt-1}
-	};
-	if(Nt==2)
+
+	string fileName="../export/terzaghiRealTime_"+pairName+"_"+gridType+"-grid.txt";
+	ofstream myFile(fileName);
+	if(myFile.is_open())
 	{
-		exportedTimeSteps.clear();
-		exportedTimeSteps.push_back(1);
+		myFile << "# t load settlement pressure\n";
+		for(int timeStep=0; timeStep<Nt; timeStep++)
+			myFile << timeStep*dt << " " << ((timeStep>0) ? loadSeries[timeStep-1] : sigmab) <<
+				" " << series[0][timeStep] << " " << series[1][timeStep] << "\n";
+		myFile.close();
 	}
+	else cout << "Unable to open " << fileName << "\n";
 
-	// Constructor
-	dataProcessing myDataProcessing(idU,idV,idP,uField,vField,pField,gridType,interpScheme,dx,dy);
+	myStepper.exportLatencyHistogram("../export/terzaghiRealTimeLatency_"+pairName+"_"+gridType+
+		"-grid.txt");
 
-	// Exports data for specified time-steps
-	for(int i=0; i<exportedTimeSteps.size(); i++)
-	{
-		myDataProcessing.exportStripfootTSolution(dx,dy,dt,Ly,exportedTimeSteps[i],pairName);
-		myDataProcessing.exportStripfootHSolution(dx,dy,h,Ly,exportedTimeSteps[i],pairName);
-	}
-	
 	return ierr;
 };
 
-int terzaghiDouble(string gridType, string interpScheme, int Nt, int meshSize, double Lt, double g,
-	double sigmab, poroelasticProperties myProperties)
+template<class scalar=double>
+int mandel(string gridType, string interpScheme, int Nt, int meshSize, double Lt, double g,
+	double forceb, poroelasticProperties myProperties)
 {
-	PetscErrorCode ierr;
-
-/*		ENTRY PARAMETERS
+/*		PROBLEM DESCRIPTION
 	----------------------------------------------------------------*/
 
+	basicProblemDescriptor<scalar> myDescriptor;
+	myDescriptor.problemName="mandel";
+
 	// Grid parameters
-	int Nx=meshSize;
-	int Ny=6*meshSize;
+	myDescriptor.Nx=5*meshSize;
+	myDescriptor.Ny=5*meshSize;
 
 	// Reservoir parameters
-	double Lx=1; // [m]
-	double Ly=6; // [m]
+	myDescriptor.Lx=5; // [m]
+	myDescriptor.Ly=5; // [m]
 
-	vector<vector<double>> sCoordinates=
+	// BC types ({u,v,P} 1 for Dirichlet and 0 for Neumann, -1 for Stress/Fluid Flow, starts on
+	// "north" and follows counterclockwise)
+	myDescriptor.bcType=
 	{
-		{Lx,Ly},
-		{0,Ly},
-		{0,0},
-		{Lx,0}
+		{-1,-1,0},
+		{1,-1,-1},
+		{-1,1,0},
+		{-1,-1,1}
 	};
 
-	// Bulk properties
-	string pairName=myProperties.pairName;
-	double G=myProperties.shearModulus;
-	double lambda=myProperties.bulkModulus-2*G/3;
-	double phiPore=myProperties.porosity;
-	double phiFrac=myProperties.macroPorosity;
-	double KPore=myProperties.permeability;
-	double KFrac=myProperties.macroPermeability;
-
-	// Solid properties
-	double c_s=1/myProperties.solidBulkModulus;
-	double rho_s=myProperties.solidDensity;
-
-	// Fluid properties
-	double c_f=1/myProperties.fluidBulkModulus;
+	// BC values ({u,v,P}, starts on "north" and follows counterclockwise)
 	double rho_f=myProperties.fluidDensity;
-	double mu_f=myProperties.fluidViscosity;
+	myDescriptor.bcValue=
+	{
+		{0,0,rho_f*g},
+		{0,0,0},
+		{0,0,rho_f*g},
+		{0,0,0}
+	};
+	myDescriptor.load=forceb;
 
-	// BC types ({u,v,p-pore,p-frac} 1 for Dirichlet and 0 for Neumann, -1 for Stress/Fluid Flow, starts on
-	// "north" and follows counterclockwise)
-	vector<vector<int>> bcType=
+	// Initial conditions
+	myDescriptor.initialConditions=[](basicSimulationState<scalar>& myState)
 	{
-		{-1,-1,1,1},
-		{1,-1,-1,-1},
-		{-1,1,-1,-1},
-		{1,-1,-1,-1}
+		myState.singleProblem->applyMandelInitialConditions();
 	};
 
-	// BC values ({u,v,P}, starts on "north" and follows counterclockwise)
-	vector<vector<double>> bcValue=
+	// Rigid plate on the top, loaded by forceb
+	myDescriptor.coefficientsLoad=[](basicSimulationState<scalar>& myState,
+		basicCoefficientsAssembly<scalar>& myCoefficients)
 	{
-		{0,sigmab,0,0},
-		{0,0,0,0},
-		{0,0,0,0},
-		{0,0,0,0}
+		myCoefficients.assemblyMandelCoefficientsMatrix(myState.dx,myState.dy,myState.G,
+			myState.lambda,myState.alpha);
+		myCoefficients.assemblySparseMatrix(myCoefficients.coefficientsMatrix);
+	};
+	myDescriptor.independentTermsSetup=[](basicSimulationState<scalar>& myState,
+		basicIndependentTermsAssembly<scalar>& myIndependentTerms)
+	{
+		myIndependentTerms.increaseMandelIndependentTermsArray();
+	};
+	myDescriptor.independentTermsLoad=[forceb](basicSimulationState<scalar>& myState,
+		basicIndependentTermsAssembly<scalar>& myIndependentTerms)
+	{
+		myIndependentTerms.assemblyMandelIndependentTermsArray(forceb,myState.Lx);
 	};
 
-/*		GRID CREATION
+/*		DATA PROCESSING
 	----------------------------------------------------------------*/
 
-	// Constructor
-	gridDesign myGrid(Nx,Ny,Nt,Lx,Ly,Lt,gridType,sCoordinates);
-
-	// Passing variables
-	int Nu;swap(Nu,myGrid.numberOfActiveUDisplacementFV);
-	int Nv;swap(Nv,myGrid.numberOfActiveVDisplacementFV);
-	int NP;swap(NP,myGrid.numberOfActiveGeneralFV);
-	double dx;swap(dx,myGrid.dx);
-	double dy;swap(dy,myGrid.dy);
-	double dt;swap(dt,myGrid.dt);
-	double h;swap(h,myGrid.h);
-	vector<vector<int>> idU;swap(idU,myGrid.uDisplacementFVIndex);
-	vector<vector<int>> idV;swap(idV,myGrid.vDisplacementFVIndex);
-	vector<vector<int>> idP;swap(idP,myGrid.generalFVIndex);
-	vector<vector<int>> cooU;swap(cooU,myGrid.uDisplacementFVCoordinates);
-	vector<vector<int>> cooV;swap(cooV,myGrid.vDisplacementFVCoordinates);
-	vector<vector<int>> cooP;swap(cooP,myGrid.generalFVCoordinates);
-	vector<vector<int>> horFaceStatus;swap(horFaceStatus,myGrid.horizontalFacesStatus);
-	vector<vector<int>> verFaceStatus;swap(verFaceStatus,myGrid.verticalFacesStatus);
-	vector<vector<double>> uField;swap(uField,myGrid.uDisplacementField);
-	vector<vector<double>> vField;swap(vField,myGrid.vDisplacementField);
-	vector<vector<double>> pPoreField=myGrid.pressureField;
-	vector<vector<double>> pFracField=pPoreField;
+	myDescriptor.exporters.push_back([forceb](basicSimulationState<scalar>& myState)
+	{
+		// Variables declaration
+		int Nt=myState.Nt;
+		vector<int> exportedTimeSteps=
+		{
+			{1},
+			{(Nt-1)/16},
+			{(Nt-1)/4},
+			{(Nt-1)}
+		};
+		if(Nt==2)
+		{
+			exportedTimeSteps.clear();
+			exportedTimeSteps.push_back(1);
+		}
+
+		// Levels of the downsampled fields, 0 for none
+		PetscInt pyramidLevelsNo=3;
+		PetscOptionsGetInt(NULL,NULL,"-pyramid_levels",&pyramidLevelsNo,NULL);
+
+		// Constructor
+		dataProcessing myDataProcessing(myState.idU,myState.idV,myState.idP,*myState.history,
+			myState.gridType,myState.interpScheme,myState.dx,myState.dy);
+
+		// Gets Mandel transcendental equation roots
+		myDataProcessing.findMandelRoots(myState.initialPressure,forceb,myState.Lx,myState.alpha,
+			myState.longitudinalModulus,myState.lambda,myState.Q);
+
+		// Exports data for specified time-steps
+		for(int i=0; i<exportedTimeSteps.size(); i++)
+		{
+			myDataProcessing.exportMandelAnalyticalSolution(myState.Lx,myState.Ly,
+				myState.consolidationCoefficient,myState.initialPressure,myState.alpha,myState.Q,
+				myState.longitudinalModulus,myState.lambda,forceb,myState.K,myState.mu_f,
+				myState.dt,exportedTimeSteps[i],myState.pairName);
+			myDataProcessing.exportMandelNumericalSolution(myState.dx,myState.dy,myState.dt,
+				myState.Lx,myState.Ly,exportedTimeSteps[i],myState.pairName);
+			myDataProcessing.exportFieldPyramid("../export/mandel_"+myState.pairName+
+				"_Pyramid_dt="+to_string(myState.dt)+"_timeStep="+
+				to_string(exportedTimeSteps[i])+"_"+myDataProcessing.gridType+"-grid.bin",
+				myState.dx,myState.dy,myState.Ly,exportedTimeSteps[i],pyramidLevelsNo);
+		}
+	});
+
+	return runSimulationPipeline(myDescriptor,gridType,interpScheme,Nt,Lt,g,myProperties);
+};
 
-/*		PROBLEM PARAMETERS CALCULATION
+int convergence(string gridType, string interpScheme, int Nt, int meshSize, double Lt, double g,
+	double sigmab, poroelasticProperties myProperties)
+{
+/*		PROBLEM DESCRIPTION
 	----------------------------------------------------------------*/
 
-	// Constructor
-	problemDoubleParameters myProblem(phiPore,phiFrac,c_f,c_s,G,lambda,mu_f,KPore,KFrac,sigmab,
-		cooV,idV);
+	problemDescriptor myDescriptor=terzaghiDescriptor(meshSize,g,sigmab,myProperties);
+	myDescriptor.problemName="convergence";
 
-	// Passing variables
-	double psiPore=myProblem.psiPore;
-	double psiFrac=myProblem.psiFrac;
-	double alpha=myProblem.alpha;
-	double S11=myProblem.S11;
-	double S12=myProblem.S12;
-	double S22=myProblem.S22;
-	double leak=myProblem.computeLeakTerm(11);
-	double consolidationCoefficient=myProblem.consolCoef;
-	
-/*		LINEAR SYSTEM'S COEFFICIENTS MATRIX ASSEMBLY
+/*		DATA PROCESSING
 	----------------------------------------------------------------*/
 
-	// Constructor
-	coefficientsAssembly myCoefficients(bcType,Nu,Nv,NP,idU,idV,idP,cooU,cooV,cooP,
-		horFaceStatus,verFaceStatus,gridType,interpScheme);
-
-	// Coefficients matrix assembly
-	myCoefficients.assemblyDoublePorosityMatrix(dx,dy,dt,G,lambda,alpha,KPore,KFrac,mu_f,S11,S12,
-		S22,psiPore,psiFrac,leak);
+	myDescriptor.observers.push_back([sigmab](simulationState& myState)
+	{
+		// Constructor
+		dataProcessing myDataProcessing(myState.idU,myState.idV,myState.idP,*myState.history,
+			myState.gridType,myState.interpScheme,myState.dx,myState.dy);
 
-	// Passing variables
-	vector<vector<double>> coefficientsMatrix;swap(coefficientsMatrix,
-		myCoefficients.coefficientsMatrix);
-	vector<double> sparseCoefficientsRow;swap(sparseCoefficientsRow,
-		myCoefficients.sparseCoefficientsRow);
-	vector<double> sparseCoefficientsColumn;swap(sparseCoefficientsColumn,
-		myCoefficients.sparseCoefficientsColumn);
-	vector<double> sparseCoefficientsValue;swap(sparseCoefficientsValue,
-		myCoefficients.sparseCoefficientsValue);
+		// Gets error norm
+		myDataProcessing.getTerzaghiErrorNorm(myState.dy,myState.dt,myState.h,myState.Ly,
+			myState.initialPressure,myState.consolidationCoefficient,myState.alpha,
+			myState.longitudinalModulus,sigmab,myState.Q,myState.rho,myState.g,myState.rho_f);
+		double pErrorNorm=myDataProcessing.myErrorNorm.p;
+		double vErrorNorm=myDataProcessing.myErrorNorm.v;
+		cout << "(pErrorNorm=" << pErrorNorm << ", vErrorNorm=" << vErrorNorm << ")\n";
+		resultsManifest::recordValue("pErrorNorm",pErrorNorm);
+		resultsManifest::recordValue("vErrorNorm",vErrorNorm);
+	});
 
-/*		LINEAR SYSTEM SOLVER
-	----------------------------------------------------------------*/
+	return runSimulationPipeline(myDescriptor,gridType,interpScheme,Nt,Lt,g,myProperties);
+};
 
-	// Variables declaration
-	int timeStep;
-	vector<double> independentTermsArray;
+int terzaghiAutoPlan(double tolerance, double Lt, double g, double sigmab,
+	poroelasticProperties myProperties)
+{
+	PetscErrorCode ierr=0;
+	PetscInt attemptsNo=3;
+	resultsManifest myManifest;
+	string medium=myProperties.pairName;
 
-	// Constructors
-	independentTermsAssembly myIndependentTerms(bcType,bcValue,Nu,Nv,NP,idU,idV,idP,cooU,cooV,cooP,
-		horFaceStatus,verFaceStatus,gridType,interpScheme);
-	linearSystemSolver myLinearSystemSolver(coefficientsMatrix,sparseCoefficientsRow,
-		sparseCoefficientsColumn,sparseCoefficientsValue,uField,vField,pPoreField,Nu,Nv,NP,Nt,idU,
-		idV,idP,cooU,cooV,cooP);
+	PetscOptionsGetInt(NULL,NULL,"-plan_attempts",&attemptsNo,NULL);
 
-	// Increase the independent terms array
-	myIndependentTerms.increaseMacroIndependentTermsArray();
+	if(!myManifest.enabled)
+	{
+		cout << "The planner fits its models to the cases of the results manifest, which is "
+			"disabled\n";
 
-	// Creates macro-pressure field
-	myLinearSystemSolver.createMacroPressureField(pFracField);
+		return ierr;
+	}
 
-	// LU Factorization of coefficientsMatrix
-	ierr=myLinearSystemSolver.coefficientsMatrixLUFactorization();CHKERRQ(ierr);
-	
-	// Creation of arrays
-	ierr=myLinearSystemSolver.createPETScArrays();CHKERRQ(ierr);
-	ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
+	// Consolidation coefficient of the medium
+	double c_f=1/myProperties.fluidBulkModulus;
+	double c_s=1/myProperties.solidBulkModulus;
+	double alpha=1-c_s*myProperties.bulkModulus;
+	double longitudinalModulus=myProperties.bulkModulus+4*myProperties.shearModulus/3;
+	double storativity=myProperties.porosity*c_f+(alpha-myProperties.porosity)*c_s;
+	double consolidationCoefficient=(myProperties.permeability/myProperties.fluidViscosity)/
+		(storativity+alpha*alpha/longitudinalModulus);
 
-	for(timeStep=0; timeStep<Nt-1; timeStep++)
+/*		CALIBRATION
+	----------------------------------------------------------------*/
+
+	autoPlanner myPlanner(medium,Lt,sigmab,consolidationCoefficient,tolerance);
+	myPlanner.loadCases(myManifest);
+
+	// Pilot cases of the formulations with too few cases to fit the models
+	vector<plannedCase> pilotCases=myPlanner.getPilotCases();
+	for(int n=0; n<pilotCases.size(); n++)
 	{
-		// Assembly of the independent terms array
-		myIndependentTerms.assemblyMacroIndependentTermsArray(dx,dy,dt,G,lambda,alpha,KPore,mu_f,
-			S11,0,0,uField,vField,pPoreField,pFracField,timeStep,phiPore,phiFrac,KFrac,S12,S22);
+		const plannedCase& myCase=pilotCases[n];
 
-		// Passing independent terms array
-		independentTermsArray=myIndependentTerms.independentTermsArray;
+		if(n==0) cout << "Pilot cases: " << pilotCases.size() << "\n";
+		if(!myManifest.beginCase(myPlanner.problemName,myCase.gridType,myCase.interpScheme,
+			medium,myCase.meshSize,myCase.Nt,myCase.dt)) continue;
+		ierr=convergence(myCase.gridType,myCase.interpScheme,myCase.Nt,myCase.meshSize,Lt,g,sigmab,
+			myProperties);CHKERRQ(ierr);
+		myManifest.completeCase();
+	}
 
-		// Solution of the linear system
-		ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
-		ierr=myLinearSystemSolver.setRHSValue(independentTermsArray);CHKERRQ(ierr);
-		ierr=myLinearSystemSolver.solveLinearSystem();CHKERRQ(ierr);
-		ierr=myLinearSystemSolver.setFieldValue(timeStep+1);CHKERRQ(ierr);
-		ierr=myLinearSystemSolver.setMacroFieldValue(timeStep+1);CHKERRQ(ierr);
+	myPlanner.loadCases(myManifest);
+	myPlanner.calibrate();
+	myPlanner.printModels();
+	myPlanner.exportModels("terzaghiPlanModels_"+medium);
 
-		// Passing solutions
-		uField=myLinearSystemSolver.uField;
-		vField=myLinearSystemSolver.vField;
-		pPoreField=myLinearSystemSolver.pField;
-		pFracField=myLinearSystemSolver.pMField;
-		ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
+/*		PLANNED RUN AND A POSTERIORI CHECK
+	----------------------------------------------------------------*/
 
-		cout << timeStep+1<< "\r";
+	for(int attemptNo=0; attemptNo<attemptsNo; attemptNo++)
+	{
+		plannedCase myCase;
+		double error;
+
+		if(!myPlanner.plan(myCase))
+		{
+			cout << "No formulation is predicted to reach " << tolerance << " within mesh " <<
+				myPlanner.maxMeshSize << " and " << myPlanner.maxTimeStepsNo << " time-steps\n";
+
+			return ierr;
+		}
+
+		cout << "Plan: " << myCase.gridType << "/" << myCase.interpScheme << ", mesh=" <<
+			myCase.meshSize << ", " << myCase.Nt-1 << " time-steps (dt=" << myCase.dt <<
+			"), predicted error " << myCase.predictedError << " in " << myCase.predictedSeconds <<
+			" s\n";
+
+		if(myManifest.beginCase(myPlanner.problemName,myCase.gridType,myCase.interpScheme,medium,
+			myCase.meshSize,myCase.Nt,myCase.dt))
+		{
+			ierr=convergence(myCase.gridType,myCase.interpScheme,myCase.Nt,myCase.meshSize,Lt,g,
+				sigmab,myProperties);CHKERRQ(ierr);
+			myManifest.completeCase();
+		}
+
+		// The case, solved or skipped, is the last record of its hash
+		error=resultsManifest::getNumber(myManifest.lastRecords[myManifest.caseHash],
+			"pErrorNorm")/fabs(sigmab);
+		cout << "A posteriori: relative pressure error " << error << " of " << tolerance <<
+			" in " << resultsManifest::getNumber(myManifest.lastRecords[myManifest.caseHash],
+			"seconds") << " s\n";
+		if(error<=tolerance)
+		{
+			cout << "Accepted\n";
+
+			return ierr;
+		}
+
+		// The case joins the fit and the plan is repeated with a safety scaled by the miss
+		myPlanner.safety*=tolerance/error;
+		myPlanner.loadCases(myManifest);
+		myPlanner.calibrate();
 	}
 
-	cout << Ny << "x" << Nx << "x" << Nt-1 << " ";
-	cout << "(h=" << h << ", dt=" << dt << ")\n";
+	cout << "Target not reached after " << attemptsNo << " plans\n";
 
-/*		DATA PROCESSING
-	----------------------------------------------------------------*/
-	
+	return ierr;
+};
+
+template<class scalar=double>
+basicProblemDescriptor<scalar> stripfootDescriptor(int meshSize, double sigmab, bool doublePorosity)
+{
+	// Square loaded by sigmab on a strip of the top which is drained, shared by the single and
+	// double porosity problems
+	basicProblemDescriptor<scalar> myDescriptor;
+	myDescriptor.doublePorosity=doublePorosity;
+
+	// Grid parameters
+	myDescriptor.Nx=5*meshSize;
+	myDescriptor.Ny=5*meshSize;
+	myDescriptor.stripSize=meshSize;
+
+	// Reservoir parameters
+	myDescriptor.Lx=5; // [m]
+	myDescriptor.Ly=5; // [m]
+
+	// BC types ({u,v,P} or {u,v,p-pore,p-frac} 1 for Dirichlet and 0 for Neumann, -1 for
+	// Stress/Fluid Flow, starts on "north" and follows counterclockwise)
+	myDescriptor.bcType=
+	{
+		{-1,-1,-1},
+		{1,-1,-1},
+		{-1,1,-1},
+		{1,-1,-1}
+	};
+
+	// BC values ({u,v,P} or {u,v,p-pore,p-frac}, starts on "north" and follows counterclockwise)
+	myDescriptor.bcValue=
+	{
+		{0,0,0},
+		{0,0,0},
+		{0,0,0},
+		{0,0,0}
+	};
+	if(doublePorosity)
+	{
+		for(int i=0; i<4; i++) myDescriptor.bcType[i].push_back(-1);
+		for(int i=0; i<4; i++) myDescriptor.bcValue[i].push_back(0);
+	}
+	myDescriptor.load=sigmab;
+
+	// Initial conditions
+	if(!doublePorosity) myDescriptor.initialConditions=[](basicSimulationState<scalar>& myState)
+	{
+		myState.singleProblem->applyTerzaghiInitialConditions();
+	};
+
+	// Load on the strip
+	myDescriptor.coefficientsLoad=[](basicSimulationState<scalar>& myState,
+		basicCoefficientsAssembly<scalar>& myCoefficients)
+	{
+		int stripSize=myState.descriptor->stripSize;
+
+		myCoefficients.addStripfootBC(stripSize,myState.K,myState.mu_f);
+		if(myState.descriptor->doublePorosity)
+			myCoefficients.addMacroStripfootBC(stripSize,myState.KFrac,myState.mu_f);
+	};
+	myDescriptor.independentTermsLoad=[sigmab](basicSimulationState<scalar>& myState,
+		basicIndependentTermsAssembly<scalar>& myIndependentTerms)
+	{
+		int stripSize=myState.descriptor->stripSize;
+
+		myIndependentTerms.addStripfootBC(stripSize,myState.dx,sigmab);
+		if(myState.descriptor->doublePorosity)
+			myIndependentTerms.addMacroStripfootBC(stripSize,myState.dx,sigmab);
+	};
+
+	return myDescriptor;
+};
+
+template<class scalar=double>
+void stripfootExporter(basicSimulationState<scalar>& myState)
+{
 	// Variables declaration
+	int Nt=myState.Nt;
 	vector<int> exportedTimeSteps=
 	{
 		{1},
@@ -1278,35 +1951,467 @@ int terzaghiDouble(string gridType, string interpScheme, int Nt, int meshSize, d
 		exportedTimeSteps.push_back(1);
 	}
 
+	// Levels of the downsampled fields, 0 for none
+	PetscInt pyramidLevelsNo=3;
+	PetscOptionsGetInt(NULL,NULL,"-pyramid_levels",&pyramidLevelsNo,NULL);
+
 	// Constructor
-	dataProcessing myDataProcessing(idU,idV,idP,uField,vField,pPoreField,gridType,interpScheme,dx,
-		dy);
-	myDataProcessing.storeMacroPressure3DField(idP,pFracField);
+	dataProcessing myDataProcessing(myState.idU,myState.idV,myState.idP,*myState.history,
+		myState.gridType,myState.interpScheme,myState.dx,myState.dy);
 
 	// Exports data for specified time-steps
 	for(int i=0; i<exportedTimeSteps.size(); i++)
 	{
-		myDataProcessing.exportTerzaghiAnalyticalSolution(Ly,psiPore*alpha,1/S11,0,0,0,2*G+lambda,
-			sigmab,dt,exportedTimeSteps[i],consolidationCoefficient,pairName);
-		myDataProcessing.exportMacroPressureHSolution(dy,h,Ly,exportedTimeSteps[i],pairName);
-		myDataProcessing.exportMacroPressureTSolution(dy,dt,Ly,exportedTimeSteps[i],pairName);
+		myDataProcessing.exportStripfootTSolution(myState.dx,myState.dy,myState.dt,myState.Ly,
+			exportedTimeSteps[i],myState.pairName);
+		myDataProcessing.exportStripfootHSolution(myState.dx,myState.dy,myState.h,myState.Ly,
+			exportedTimeSteps[i],myState.pairName);
+		myDataProcessing.exportFieldPyramid("../export/stripfoot_"+myState.pairName+
+			"_Pyramid_dt="+to_string(myState.dt)+"_timeStep="+to_string(exportedTimeSteps[i])+"_"+
+			myDataProcessing.gridType+"-grid.bin",myState.dx,myState.dy,myState.Ly,
+			exportedTimeSteps[i],pyramidLevelsNo);
+	}
+
+	return;
+};
+
+template<class scalar=double>
+int stripfoot(string gridType, string interpScheme, int Nt, int meshSize, double Lt, double g,
+	double sigmab, poroelasticProperties myProperties, convergenceAnalysis* myAnalysis=NULL)
+{
+/*		PROBLEM DESCRIPTION
+	----------------------------------------------------------------*/
+
+	basicProblemDescriptor<scalar> myDescriptor=stripfootDescriptor<scalar>(meshSize,sigmab,false);
+	myDescriptor.problemName="stripfoot";
+
+/*		DATA PROCESSING
+	----------------------------------------------------------------*/
+
+	myDescriptor.exporters.push_back(stripfootExporter<scalar>);
+
+	// Passes the last time-step to the convergence analysis
+	if(myAnalysis!=NULL) myDescriptor.observers.push_back([myAnalysis](
+		basicSimulationState<scalar>& myState)
+	{
+		myAnalysis->addLevel(myState.gridType,myState.h,myState.dt,myState.dx,myState.dy,
+			myState.idU,myState.idV,myState.idP,convertField<double>(myState.uField),
+			convertField<double>(myState.vField),convertField<double>(myState.pField),
+			vector<vector<double>>(),0);
+	});
+
+	return runSimulationPipeline(myDescriptor,gridType,interpScheme,Nt,Lt,g,myProperties);
+};
+
+int stripfootOrdering(string gridType, string interpScheme, int meshSize, double Lt,
+	double sigmab, poroelasticProperties myProperties)
+{
+	PetscErrorCode ierr;
+
+/*		ENTRY PARAMETERS
+	----------------------------------------------------------------*/
+
+	// Numberings compared, the tiles of the curves and the repetitions of each timed operation
+	vector<string> cellOrderings={"rowmajor","morton","hilbert"};
+	PetscInt orderingTile=0;
+	PetscInt repetitionsNo=20;
+	PetscOptionsGetInt(NULL,NULL,"-ordering_tile",&orderingTile,NULL);
+	PetscOptionsGetInt(NULL,NULL,"-ordering_repetitions",&repetitionsNo,NULL);
+
+	problemDescriptor myDescriptor=stripfootDescriptor<double>(meshSize,sigmab,false);
+	vector<vector<double>> sCoordinates=
+	{
+		{myDescriptor.Lx,myDescriptor.Ly},
+		{0,myDescriptor.Ly},
+		{0,0},
+		{myDescriptor.Lx,0}
+	};
+	vector<double> referenceSolution;
+	vector<vector<double>> timings;
+
+	for(int o=0; o<cellOrderings.size(); o++)
+	{
+		simulationState myState;
+		myState.descriptor=&myDescriptor;
+		myState.gridType=gridType;
+		myState.interpScheme=interpScheme;
+		myState.pairName=myProperties.pairName;
+		myState.Nt=2;
+		myState.Lx=myDescriptor.Lx;
+		myState.Ly=myDescriptor.Ly;
+		myState.G=myProperties.shearModulus;
+		myState.lambda=myProperties.bulkModulus-2*myState.G/3;
+		myState.phi=myProperties.porosity;
+		myState.K=myProperties.permeability;
+		myState.c_s=1/myProperties.solidBulkModulus;
+		myState.rho_s=myProperties.solidDensity;
+		myState.c_f=1/myProperties.fluidBulkModulus;
+		myState.rho_f=myProperties.fluidDensity;
+		myState.mu_f=myProperties.fluidViscosity;
+		myState.g=0;
+		myState.rho=(myState.phi*myState.rho_f+(1-myState.phi)*myState.rho_s);
+
+/*		GRID CREATION
+	----------------------------------------------------------------*/
+
+		// Constructor
+		gridDesign myGrid(myDescriptor.Nx,myDescriptor.Ny,2,myState.Lx,myState.Ly,Lt,gridType,
+			sCoordinates,cellOrderings[o],orderingTile);
+
+		// Passing variables, the permutations are kept in myGrid
+		swap(myState.Nu,myGrid.numberOfActiveUDisplacementFV);
+		swap(myState.Nv,myGrid.numberOfActiveVDisplacementFV);
+		swap(myState.NP,myGrid.numberOfActiveGeneralFV);
+		swap(myState.dx,myGrid.dx);
+		swap(myState.dy,myGrid.dy);
+		swap(myState.dt,myGrid.dt);
+		swap(myState.h,myGrid.h);
+		swap(myState.idU,myGrid.uDisplacementFVIndex);
+		swap(myState.idV,myGrid.vDisplacementFVIndex);
+		swap(myState.idP,myGrid.generalFVIndex);
+		swap(myState.cooU,myGrid.uDisplacementFVCoordinates);
+		swap(myState.cooV,myGrid.vDisplacementFVCoordinates);
+		swap(myState.cooP,myGrid.generalFVCoordinates);
+		swap(myState.horFaceStatus,myGrid.horizontalFacesStatus);
+		swap(myState.verFaceStatus,myGrid.verticalFacesStatus);
+
+/*		PROBLEM PARAMETERS CALCULATION
+	----------------------------------------------------------------*/
+
+		// Constructor
+		problemParameters myProblem(myState.dx,myState.dy,myState.K,myState.phi,myState.rho_s,
+			myState.c_s,myState.mu_f,myState.rho_f,myState.c_f,myState.G,myState.lambda,sigmab,
+			myState.Lx,myState.Ly,myGrid.uDisplacementField,myGrid.vDisplacementField,
+			myGrid.pressureField,myState.cooU,myState.cooV,myState.cooP,myState.idU,myState.idV,
+			myState.idP,myState.g);
+
+		// Apply initial conditions
+		myState.singleProblem=&myProblem;
+		myDescriptor.initialConditions(myState);
+		myState.singleProblem=NULL;
+
+		// Passing variables
+		myState.Q=myProblem.Q;
+		myState.alpha=myProblem.alpha;
+		swap(myState.uField,myProblem.uDisplacementField);
+		swap(myState.vField,myProblem.vDisplacementField);
+		swap(myState.pField,myProblem.pressureField);
+
+/*		LINEAR SYSTEM'S COEFFICIENTS MATRIX ASSEMBLY
+	----------------------------------------------------------------*/
+
+		// The last of the repetitions is kept
+		double assemblySeconds=0;
+		coefficientsAssembly* myCoefficients=NULL;
+		for(int r=0; r<repetitionsNo; r++)
+		{
+			delete myCoefficients;
+			myCoefficients=new coefficientsAssembly(myDescriptor.bcType,myState.Nu,myState.Nv,
+				myState.NP,myState.idU,myState.idV,myState.idP,myState.cooU,myState.cooV,
+				myState.cooP,myState.horFaceStatus,myState.verFaceStatus,gridType,interpScheme);
+
+			chrono::steady_clock::time_point start=chrono::steady_clock::now();
+			myCoefficients->assemblyCoefficientsMatrix(myState.dx,myState.dy,myState.dt,
+				myState.G,myState.lambda,myState.alpha,myState.K,myState.mu_f,myState.Q,
+				myState.rho,myState.g);
+			myDescriptor.coefficientsLoad(myState,*myCoefficients);
+			assemblySeconds+=chrono::duration<double>(chrono::steady_clock::now()-start).count();
+		}
+
+		// Distance of the nonzero entries to the diagonal
+		long long bandwidth=0;
+		long long profile=0;
+		for(int k=0; k<myCoefficients->sparseCoefficientsValue.size(); k++)
+		{
+			long long distance=llabs((long long)myCoefficients->sparseCoefficientsRow[k]-
+				(long long)myCoefficients->sparseCoefficientsColumn[k]);
+			bandwidth=max(bandwidth,distance);
+			profile+=distance;
+		}
+
+/*		LINEAR SYSTEM SOLVER
+	----------------------------------------------------------------*/
+
+		// Independent terms of the first time-step
+		independentTermsAssembly myIndependentTerms(myDescriptor.bcType,myDescriptor.bcValue,
+			myState.Nu,myState.Nv,myState.NP,myState.idU,myState.idV,myState.idP,myState.cooU,
+			myState.cooV,myState.cooP,myState.horFaceStatus,myState.verFaceStatus,gridType,
+			interpScheme);
+		double rhsSeconds=0;
+		for(int r=0; r<repetitionsNo; r++)
+		{
+			chrono::steady_clock::time_point start=chrono::steady_clock::now();
+			myIndependentTerms.assemblyIndependentTermsArray(myState.dx,myState.dy,myState.dt,
+				myState.G,myState.lambda,myState.alpha,myState.K,myState.mu_f,myState.Q,
+				myState.rho,myState.g,myState.uField,myState.vField,myState.pField,0);
+			myDescriptor.independentTermsLoad(myState,myIndependentTerms);
+			rhsSeconds+=chrono::duration<double>(chrono::steady_clock::now()-start).count();
+		}
+
+		// Constructor, the assembled matrix is kept for the products
+		linearSystemSolver myLinearSystemSolver(myCoefficients->coefficientsMatrix,
+			myCoefficients->sparseCoefficientsRow,myCoefficients->sparseCoefficientsColumn,
+			myCoefficients->sparseCoefficientsValue,myState.uField,myState.vField,myState.pField,
+			myState.Nu,myState.Nv,myState.NP,2,myState.idU,myState.idV,myState.idP,myState.cooU,
+			myState.cooV,myState.cooP);
+		delete myCoefficients;
+		ierr=myLinearSystemSolver.coefficientsMatrixSymbolicFactorization();CHKERRQ(ierr);
+		ierr=myLinearSystemSolver.createPETScArrays();CHKERRQ(ierr);
+		ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
+		ierr=myLinearSystemSolver.setRHSValue(myIndependentTerms.independentTermsArray);
+			CHKERRQ(ierr);
+
+		// Triangular solves with the LU factors
+		double solveSeconds=0;
+		for(int r=0; r<repetitionsNo; r++)
+		{
+			ierr=myLinearSystemSolver.solveLinearSystem();CHKERRQ(ierr);
+			solveSeconds+=myLinearSystemSolver.lastSolveSeconds;
+		}
+
+		// Products of the matrix by the solution, as in the residual of the independent terms
+		double spmvSeconds=0;
+		chrono::steady_clock::time_point start=chrono::steady_clock::now();
+		for(int r=0; r<repetitionsNo; r++)
+		{
+			ierr=MatMult(myLinearSystemSolver.operatorMatrixPETSc,
+				myLinearSystemSolver.linearSystemSolutionPETSc,
+				myLinearSystemSolver.independentTermsArrayPETSc);CHKERRQ(ierr);
+		}
+		spmvSeconds=chrono::duration<double>(chrono::steady_clock::now()-start).count();
+
+		// The solutions of every numbering, back in the row by row one, are the same
+		vector<double> solutionArray;
+		ierr=myLinearSystemSolver.getSolutionArray(solutionArray);CHKERRQ(ierr);
+		myGrid.toRowMajorOrder(solutionArray);
+		double difference=0;
+		double norm=0;
+		if(o==0) referenceSolution=solutionArray;
+		for(int k=0; k<solutionArray.size(); k++)
+		{
+			difference=max(difference,fabs(solutionArray[k]-referenceSolution[k]));
+			norm=max(norm,fabs(referenceSolution[k]));
+		}
+
+		timings.push_back({(double)bandwidth,(double)profile/
+			myLinearSystemSolver.sparseCoefficientsValue.size(),assemblySeconds/repetitionsNo,
+			rhsSeconds/repetitionsNo,spmvSeconds/repetitionsNo,solveSeconds/repetitionsNo});
+		cout << cellOrderings[o] << ": bandwidth " << bandwidth << ", assembly " <<
+			timings[o][2] << "s, RHS " << timings[o][3] << "s, SpMV " << timings[o][4] <<
+			"s, triangular solves " << timings[o][5] << "s (difference " <<
+			difference/max(norm,1e-300) << ")\n";
+	}
+
+/*		DATA PROCESSING
+	----------------------------------------------------------------*/
+
+	string fileName="../export/stripfootOrdering_"+myProperties.pairName+"_mesh="+
+		to_string(meshSize)+"_"+gridType+"-grid.txt";
+	ofstream myFile(fileName);
+	if(myFile.is_open())
+	{
+		for(int o=0; o<cellOrderings.size(); o++)
+		{
+			myFile << cellOrderings[o];
+			for(int k=0; k<timings[o].size(); k++) myFile << "\t" << timings[o][k];
+			myFile << "\n";
+		}
+
+		myFile.close();
 	}
 
 	return ierr;
 };
 
-int stripfootDouble(string gridType, string interpScheme, int Nt, int meshSize, double Lt,
-	double g, double sigmab, poroelasticProperties myProperties)
+int operatorReplay(string manifestName)
+{
+	PetscErrorCode ierr=0;
+
+/*		ENTRY PARAMETERS
+	----------------------------------------------------------------*/
+
+	// Manifest written by -operator_export, the files of the systems are next to it
+	map<string,vector<string>> myManifest;
+	string directory=manifestName.substr(0,manifestName.rfind('/')+1);
+	string key, value;
+	ifstream manifestFile(manifestName);
+	if(!manifestFile)
+	{
+		cout << "Unable to open operator manifest.\n";
+		return 1;
+	}
+	while(manifestFile >> key >> value) myManifest[key].push_back(value);
+	manifestFile.close();
+	if(myManifest["matrix"].empty() || myManifest["Nt"].empty())
+	{
+		cout << "Incomplete operator manifest.\n";
+		return 1;
+	}
+
+	int Nu=stoi(myManifest["Nu"][0]);
+	int Nv=stoi(myManifest["Nv"][0]);
+	int NP=stoi(myManifest["NP"][0]);
+	int Nt=stoi(myManifest["Nt"][0]);
+
+	// Configurations replayed, those of the autotune and the natural ordering by default, and
+	// the repetitions of the setup and the solves of each one
+	char myCandidates[PETSC_MAX_PATH_LEN]="lu_rcm,lu_nd,lu_qmd,lu_natural,gcr";
+	PetscInt repetitionsNo=1;
+	PetscOptionsGetString(NULL,NULL,"-replay_candidates",myCandidates,PETSC_MAX_PATH_LEN,NULL);
+	PetscOptionsGetInt(NULL,NULL,"-replay_repetitions",&repetitionsNo,NULL);
+	repetitionsNo=max(repetitionsNo,(PetscInt)1);
+	vector<string> candidates;
+	string candidateList=myCandidates;
+	for(size_t start=0, end; start<candidateList.size(); start=end+1)
+	{
+		end=candidateList.find(',',start);
+		if(end==string::npos) end=candidateList.size();
+		if(end>start) candidates.push_back(candidateList.substr(start,end-start));
+	}
+
+/*		LINEAR SYSTEMS IMPORT
+	----------------------------------------------------------------*/
+
+	// Coefficients matrix, from the MatrixMarket coordinate file
+	int n, nonZeroEntries;
+	string header;
+	ifstream matrixFile(directory+myManifest["matrix"][0]+".mtx");
+	if(!matrixFile)
+	{
+		cout << "Unable to open coefficients matrix file.\n";
+		return 1;
+	}
+	getline(matrixFile,header);
+	matrixFile >> n >> n >> nonZeroEntries;
+	vector<double> sparseCoefficientsRow(nonZeroEntries);
+	vector<double> sparseCoefficientsColumn(nonZeroEntries);
+	vector<double> sparseCoefficientsValue(nonZeroEntries);
+	for(int k=0; k<nonZeroEntries; k++)
+	{
+		matrixFile >> sparseCoefficientsRow[k] >> sparseCoefficientsColumn[k] >>
+			sparseCoefficientsValue[k];
+		sparseCoefficientsRow[k]--;
+		sparseCoefficientsColumn[k]--;
+	}
+	matrixFile.close();
+
+	// Independent terms arrays, from the MatrixMarket array files
+	vector<string>& arrayNames=myManifest["independentTerms"];
+	vector<vector<double>> independentTermsArrays(arrayNames.size(),vector<double>(n));
+	for(int r=0; r<arrayNames.size(); r++)
+	{
+		int rowNo, colNo;
+		ifstream arrayFile(directory+arrayNames[r]+".mtx");
+		getline(arrayFile,header);
+		arrayFile >> rowNo >> colNo;
+		for(int i=0; i<n; i++) arrayFile >> independentTermsArrays[r][i];
+		arrayFile.close();
+	}
+
+	cout << myManifest["problem"][0] << ", " << myManifest["gridType"][0] << " grid (" <<
+		myManifest["interpScheme"][0] << "), " << myManifest["medium"][0] << ", " <<
+		myManifest["Ny"][0] << "x" << myManifest["Nx"][0] << " FV, dt=" << myManifest["dt"][0] <<
+		": " << n << " unknowns, " << nonZeroEntries << " nonzeros, " << arrayNames.size() <<
+		" independent terms arrays\n";
+
+/*		REPLAY OF THE SOLVERS
+	----------------------------------------------------------------*/
+
+	// The solvers only hold the sparse matrix, their dense matrix is n empty rows
+	vector<vector<double>> noField;
+	vector<vector<int>> noIndex;
+	vector<vector<double>> timings;
+
+	for(int c=0; c<candidates.size(); c++)
+	{
+		double setupSeconds=0;
+		double solveSeconds=0;
+		double residual=0;
+
+		for(int repetition=0; repetition<repetitionsNo; repetition++)
+		{
+			chrono::steady_clock::time_point start=chrono::steady_clock::now();
+			linearSystemSolver myLinearSystemSolver(vector<vector<double>>(n),
+				sparseCoefficientsRow,sparseCoefficientsColumn,sparseCoefficientsValue,noField,
+				noField,noField,Nu,Nv,NP,Nt,noIndex,noIndex,noIndex,noIndex,noIndex,noIndex);
+			myLinearSystemSolver.setConfiguration(candidates[c]);
+			ierr=myLinearSystemSolver.coefficientsMatrixLUFactorization();CHKERRQ(ierr);
+			ierr=myLinearSystemSolver.createPETScArrays();CHKERRQ(ierr);
+			setupSeconds+=chrono::duration<double>(chrono::steady_clock::now()-start).count();
+
+			// The arrays in the order of their time-steps, as the gcr recycles its directions
+			for(int r=0; r<independentTermsArrays.size(); r++)
+			{
+				vector<double> solutionArray;
+				vector<double> residualArray=independentTermsArrays[r];
+				double norm=0;
+				double maxResidual=0;
+
+				ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
+				ierr=myLinearSystemSolver.setRHSValue(independentTermsArrays[r]);CHKERRQ(ierr);
+				ierr=myLinearSystemSolver.solveLinearSystem();CHKERRQ(ierr);
+				solveSeconds+=myLinearSystemSolver.lastSolveSeconds;
+
+				// Residual relative to the independent terms
+				ierr=myLinearSystemSolver.getSolutionArray(solutionArray);CHKERRQ(ierr);
+				for(int k=0; k<nonZeroEntries; k++)
+					residualArray[(int)sparseCoefficientsRow[k]]-=sparseCoefficientsValue[k]*
+						solutionArray[(int)sparseCoefficientsColumn[k]];
+				for(int i=0; i<n; i++)
+				{
+					norm=max(norm,fabs(independentTermsArrays[r][i]));
+					maxResidual=max(maxResidual,fabs(residualArray[i]));
+				}
+				residual=max(residual,maxResidual/max(norm,1e-300));
+			}
+		}
+
+		double solvesNo=max((double)repetitionsNo*independentTermsArrays.size(),1.);
+		timings.push_back({setupSeconds/repetitionsNo,solveSeconds/solvesNo,
+			setupSeconds/repetitionsNo+(Nt-1)*solveSeconds/solvesNo,residual});
+		cout << candidates[c] << ": setup " << timings[c][0] << "s, solve " << timings[c][1] <<
+			"s, predicted for " << Nt-1 << " time-steps " << timings[c][2] << "s (residual " <<
+			timings[c][3] << ")\n";
+	}
+
+/*		DATA PROCESSING
+	----------------------------------------------------------------*/
+
+	string caseName=myManifest["matrix"][0];
+	caseName=caseName.substr(caseName.find('_')+1);
+	caseName=caseName.substr(0,caseName.size()-2);
+	ofstream myFile("../export/operatorReplay_"+caseName+".txt");
+	if(myFile.is_open())
+	{
+		for(int c=0; c<candidates.size(); c++)
+		{
+			myFile << candidates[c];
+			for(int k=0; k<timings[c].size(); k++) myFile << "\t" << timings[c][k];
+			myFile << "\n";
+		}
+
+		myFile.close();
+	}
+
+	return ierr;
+};
+
+int stripfootSweep(string gridType, string interpScheme, int Nt, int meshSize, double Lt,
+	double g, double sigmab, vector<int> stripSizes, poroelasticProperties myProperties)
 {
 	PetscErrorCode ierr;
 
+	// Objects of this run are allocated from the run arena
+	runArenaScope myRunArena;
+
 /*		ENTRY PARAMETERS
 	----------------------------------------------------------------*/
 
 	// Grid parameters
 	int Nx=5*meshSize;
 	int Ny=5*meshSize;
-	int stripSize=meshSize;
+	int stripSize;
+	int baseStripSize=stripSizes[0];
 
 	// Reservoir parameters
 	double Lx=5; // [m]
@@ -1324,10 +2429,8 @@ int stripfootDouble(string gridType, string interpScheme, int Nt, int meshSize,
 	string pairName=myProperties.pairName;
 	double G=myProperties.shearModulus;
 	double lambda=myProperties.bulkModulus-2*G/3;
-	double phiPore=myProperties.porosity;
-	double phiFrac=myProperties.macroPorosity;
-	double KPore=myProperties.permeability;
-	double KFrac=myProperties.macroPermeability;
+	double phi=myProperties.porosity;
+	double K=myProperties.permeability;
 
 	// Solid properties
 	double c_s=1/myProperties.solidBulkModulus;
@@ -1338,23 +2441,23 @@ int stripfootDouble(string gridType, string interpScheme, int Nt, int meshSize,
 	double rho_f=myProperties.fluidDensity;
 	double mu_f=myProperties.fluidViscosity;
 
-	// BC types ({u,v,p-pore,p-frac} 1 for Dirichlet and 0 for Neumann, -1 for Stress/Fluid Flow, starts on
+	// BC types ({u,v,p-micro,p-macro} 1 for Dirichlet and 0 for Neumann, -1 for Stress/Fluid Flow, starts on
 	// "north" and follows counterclockwise)
 	vector<vector<int>> bcType=
 	{
-		{-1,-1,-1,-1},
-		{1,-1,-1,-1},
-		{-1,1,-1,-1},
-		{1,-1,-1,-1}
+		{-1,-1,-1},
+		{1,-1,-1},
+		{-1,1,-1},
+		{1,-1,-1}
 	};
 
 	// BC values ({u,v,P}, starts on "north" and follows counterclockwise)
 	vector<vector<double>> bcValue=
 	{
-		{0,0,0,0},
-		{0,0,0,0},
-		{0,0,0,0},
-		{0,0,0,0}
+		{0,0,0},
+		{0,0,0},
+		{0,0,0},
+		{0,0,0}
 	};
 
 /*		GRID CREATION
@@ -1381,24 +2484,31 @@ int stripfootDouble(string gridType, string interpScheme, int Nt, int meshSize,
 	vector<vector<int>> verFaceStatus;swap(verFaceStatus,myGrid.verticalFacesStatus);
 	vector<vector<double>> uField;swap(uField,myGrid.uDisplacementField);
 	vector<vector<double>> vField;swap(vField,myGrid.vDisplacementField);
-	vector<vector<double>> pPoreField=myGrid.pressureField;
-	vector<vector<double>> pFracField=pPoreField;
+	vector<vector<double>> pField;swap(pField,myGrid.pressureField);
 
 /*		PROBLEM PARAMETERS CALCULATION
 	----------------------------------------------------------------*/
 
 	// Constructor
-	problemDoubleParameters myProblem(phiPore,phiFrac,c_f,c_s,G,lambda,mu_f,KPore,KFrac,sigmab,
-		cooV,idV);
+	problemParameters myProblem(dx,dy,K,phi,rho_s,c_s,mu_f,rho_f,c_f,G,lambda,sigmab,Lx,Ly,
+		uField,vField,pField,cooU,cooV,cooP,idU,idV,idP,g);
+
+	// Apply initial conditions
+	myProblem.applyTerzaghiInitialConditions();
 
 	// Passing variables
-	double psiPore=myProblem.psiPore;
-	double psiFrac=myProblem.psiFrac;
-	double alpha=myProblem.alpha;
-	double S11=myProblem.S11;
-	double S12=myProblem.S12;
-	double S22=myProblem.S22;
-	double leak=myProblem.computeLeakTerm(11);
+	double Q;swap(Q,myProblem.Q);
+	double alpha;swap(alpha,myProblem.alpha);
+	double storageCoefficient=1/Q;
+	double longitudinalModulus;swap(longitudinalModulus,myProblem.M);
+	double consolidationCoefficient;swap(consolidationCoefficient,myProblem.c);
+	double minimumTimeStepVerruijt;swap(minimumTimeStepVerruijt,myProblem.dt_vv);
+	double dt_carlos;swap(dt_carlos,myProblem.dt_carlos);
+	double rho=(phi*rho_f+(1-phi)*rho_s);
+	double initialPressure;swap(initialPressure,myProblem.P0);
+	uField=myProblem.uDisplacementField;
+	vField=myProblem.vDisplacementField;
+	pField=myProblem.pressureField;
 	
 /*		LINEAR SYSTEM'S COEFFICIENTS MATRIX ASSEMBLY
 	----------------------------------------------------------------*/
@@ -1408,20 +2518,22 @@ int stripfootDouble(string gridType, string interpScheme, int Nt, int meshSize,
 		horFaceStatus,verFaceStatus,gridType,interpScheme);
 
 	// Coefficients matrix assembly
-	myCoefficients.assemblyDoublePorosityMatrix(dx,dy,dt,G,lambda,alpha,KPore,KFrac,mu_f,S11,S12,
-		S22,psiPore,psiFrac,leak);
-	myCoefficients.addStripfootBC(stripSize,KPore,mu_f);
-	myCoefficients.addMacroStripfootBC(stripSize,KFrac,mu_f);
+	myCoefficients.assemblyCoefficientsMatrix(dx,dy,dt,G,lambda,alpha,K,mu_f,Q,rho,g);
 
-	// Passing variables
-	vector<vector<double>> coefficientsMatrix;swap(coefficientsMatrix,
-		myCoefficients.coefficientsMatrix);
-	vector<double> sparseCoefficientsRow;swap(sparseCoefficientsRow,
-		myCoefficients.sparseCoefficientsRow);
-	vector<double> sparseCoefficientsColumn;swap(sparseCoefficientsColumn,
-		myCoefficients.sparseCoefficientsColumn);
-	vector<double> sparseCoefficientsValue;swap(sparseCoefficientsValue,
-		myCoefficients.sparseCoefficientsValue);
+	// Base operator, factorized once for the whole sweep (strip BC of the first strip size)
+	myCoefficients.assemblyStripfootBCUpdate(-1,baseStripSize,K,mu_f);
+
+	// Passing variables (the matrix without strip BC is kept for the following updates)
+	vector<vector<double>> coefficientsMatrix=myCoefficients.coefficientsMatrix;
+	vector<double> sparseCoefficientsRow=myCoefficients.sparseCoefficientsRow;
+	vector<double> sparseCoefficientsColumn=myCoefficients.sparseCoefficientsColumn;
+	vector<double> sparseCoefficientsValue=myCoefficients.sparseCoefficientsValue;
+	sparseCoefficientsRow.insert(sparseCoefficientsRow.end(),
+		myCoefficients.sparseUpdateRow.begin(),myCoefficients.sparseUpdateRow.end());
+	sparseCoefficientsColumn.insert(sparseCoefficientsColumn.end(),
+		myCoefficients.sparseUpdateColumn.begin(),myCoefficients.sparseUpdateColumn.end());
+	sparseCoefficientsValue.insert(sparseCoefficientsValue.end(),
+		myCoefficients.sparseUpdateValue.begin(),myCoefficients.sparseUpdateValue.end());
 
 /*		LINEAR SYSTEM SOLVER
 	----------------------------------------------------------------*/
@@ -1434,14 +2546,8 @@ int stripfootDouble(string gridType, string interpScheme, int Nt, int meshSize,
 	independentTermsAssembly myIndependentTerms(bcType,bcValue,Nu,Nv,NP,idU,idV,idP,cooU,cooV,cooP,
 		horFaceStatus,verFaceStatus,gridType,interpScheme);
 	linearSystemSolver myLinearSystemSolver(coefficientsMatrix,sparseCoefficientsRow,
-		sparseCoefficientsColumn,sparseCoefficientsValue,uField,vField,pPoreField,Nu,Nv,NP,Nt,idU,
-		idV,idP,cooU,cooV,cooP);
-
-	// Increase the independent terms array
-	myIndependentTerms.increaseMacroIndependentTermsArray();
-
-	// Creates macro-pressure field
-	myLinearSystemSolver.createMacroPressureField(pFracField);
+		sparseCoefficientsColumn,sparseCoefficientsValue,uField,vField,pField,Nu,Nv,NP,Nt,idU,idV,
+		idP,cooU,cooV,cooP);
 
 	// LU Factorization of coefficientsMatrix
 	ierr=myLinearSystemSolver.coefficientsMatrixLUFactorization();CHKERRQ(ierr);
@@ -1450,84 +2556,111 @@ int stripfootDouble(string gridType, string interpScheme, int Nt, int meshSize,
 	ierr=myLinearSystemSolver.createPETScArrays();CHKERRQ(ierr);
 	ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
 
-	for(timeStep=0; timeStep<Nt-1; timeStep++)
-	{
-		// Assembly of the independent terms array
-		myIndependentTerms.assemblyMacroIndependentTermsArray(dx,dy,dt,G,lambda,alpha,KPore,mu_f,
-			S11,0,0,uField,vField,pPoreField,pFracField,timeStep,phiPore,phiFrac,KFrac,S12,S22);
-		myIndependentTerms.addStripfootBC(stripSize,dx,sigmab);
-		myIndependentTerms.addMacroStripfootBC(stripSize,dx,sigmab);
-
-		// Passing independent terms array
-		independentTermsArray=myIndependentTerms.independentTermsArray;
-
-		// Solution of the linear system
-		ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
-		ierr=myLinearSystemSolver.setRHSValue(independentTermsArray);CHKERRQ(ierr);
-		ierr=myLinearSystemSolver.solveLinearSystem();CHKERRQ(ierr);
-		ierr=myLinearSystemSolver.setFieldValue(timeStep+1);CHKERRQ(ierr);
-		ierr=myLinearSystemSolver.setMacroFieldValue(timeStep+1);CHKERRQ(ierr);
-
-		// Passing solutions
-		uField=myLinearSystemSolver.uField;
-		vField=myLinearSystemSolver.vField;
-		pPoreField=myLinearSystemSolver.pField;
-		pFracField=myLinearSystemSolver.pMField;
-		ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
-
-		cout << timeStep+1<< "\r";
-	}
-
-	cout << Ny << "x" << Nx << "x" << Nt-1 << " ";
-	cout << "(h=" << h << ", dt=" << dt << ")\n";
+	for(int stripNo=0; stripNo<stripSizes.size(); stripNo++)
+	{
+		stripSize=stripSizes[stripNo];
+
+		// Low-rank update from the factorized operator to the current strip BC
+		myCoefficients.assemblyStripfootBCUpdate(baseStripSize,stripSize,K,mu_f);
+		ierr=myLinearSystemSolver.createLowRankUpdate(myCoefficients.sparseUpdateRow,
+			myCoefficients.sparseUpdateColumn,myCoefficients.sparseUpdateValue);CHKERRQ(ierr);
+		if(myLinearSystemSolver.lowRankRefactored) baseStripSize=stripSize;
+
+		// Restarts from the initial conditions
+		uField=myProblem.uDisplacementField;
+		vField=myProblem.vDisplacementField;
+		pField=myProblem.pressureField;
+		myLinearSystemSolver.uField=uField;
+		myLinearSystemSolver.vField=vField;
+		myLinearSystemSolver.pField=pField;
+
+		// Progress of the run written to -metrics_file
+		liveMetrics myMetrics("stripfootSweep",gridType,interpScheme,Nt-1,dt);
+
+		for(timeStep=0; timeStep<Nt-1; timeStep++)
+		{
+			// Assembly of the independent terms array
+			myIndependentTerms.assemblyIndependentTermsArray(dx,dy,dt,G,lambda,alpha,K,mu_f,Q,rho,g,
+				uField,vField,pField,timeStep);
+			myIndependentTerms.addStripfootBC(stripSize,dx,sigmab);
+
+			// Passing independent terms array
+			independentTermsArray=myIndependentTerms.independentTermsArray;
+
+			// Solution of the linear system
+			ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
+			ierr=myLinearSystemSolver.setRHSValue(independentTermsArray);CHKERRQ(ierr);
+			ierr=myLinearSystemSolver.solveLowRankLinearSystem();CHKERRQ(ierr);
+			ierr=myLinearSystemSolver.setFieldValue(timeStep+1);CHKERRQ(ierr);
+
+			// Passing solutions
+			uField=myLinearSystemSolver.uField;
+			vField=myLinearSystemSolver.vField;
+			pField=myLinearSystemSolver.pField;
+			ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
+
+			myMetrics.update(timeStep+1,myLinearSystemSolver);
+			cout << timeStep+1<< "\r";
+		}
+
+		cout << Ny << "x" << Nx << "x" << Nt-1 << " ";
+		cout << "(h=" << h << ", dt=" << dt << ", strip=" << stripSize << ", rank=" <<
+			myLinearSystemSolver.lowRankRows.size() << ")\n";
 
 /*		DATA PROCESSING
 	----------------------------------------------------------------*/
+
+		string caseName=pairName+"_strip="+to_string(stripSize);
 	
-	// Variables declaration
-	vector<int> exportedTimeSteps=
-	{
-		{1},
-		{(Nt-1)/8},
-		{(Nt-1)/2},
-		{Nt-1}
-	};
-	if(Nt==2)
-	{
-		exportedTimeSteps.clear();
-		exportedTimeSteps.push_back(1);
+		// Variables declaration
+		vector<int> exportedTimeSteps=
+		{
+			{1},
+			{(Nt-1)/8},
+			{(Nt-1)/2},
+			{Nt-1}
+		};
+		if(Nt==2)
+		{
+			exportedTimeSteps.clear();
+			exportedTimeSteps.push_back(1);
+		}
+
+		// Constructor
+		dataProcessing myDataProcessing(idU,idV,idP,uField,vField,pField,gridType,interpScheme,dx,
+			dy);
+
+		// Exports data for specified time-steps
+		for(int i=0; i<exportedTimeSteps.size(); i++)
+		{
+			myDataProcessing.exportStripfootTSolution(dx,dy,dt,Ly,exportedTimeSteps[i],caseName);
+			myDataProcessing.exportStripfootHSolution(dx,dy,h,Ly,exportedTimeSteps[i],caseName);
+		}
 	}
 
-	// Constructor
-	dataProcessing myDataProcessing(idU,idV,idP,uField,vField,pPoreField,gridType,interpScheme,dx,
-		dy);
-	myDataProcessing.storeMacroPressure3DField(idP,pFracField);
-
-	// Exports data for specified time-steps
-	for(int i=0; i<exportedTimeSteps.size(); i++)
-	{
-		myDataProcessing.exportStripfootTSolution(dx,dy,dt,Ly,exportedTimeSteps[i],pairName);
-		myDataProcessing.exportStripfootHSolution(dx,dy,h,Ly,exportedTimeSteps[i],pairName);
-	}
-	
 	return ierr;
 };
 
-int sealedDouble(string gridType, string interpScheme, int Nt, int meshSize, double Lt, double g,
-	double sigmab, poroelasticProperties myProperties)
+int stripfootDynamic(int meshSize, double Lt, double sigmab, poroelasticProperties myProperties)
 {
-	PetscErrorCode ierr;
+	PetscErrorCode ierr=0;
+
+	// Objects of this run are allocated from the run arena
+	runArenaScope myRunArena;
 
 /*		ENTRY PARAMETERS
 	----------------------------------------------------------------*/
 
-	// Grid parameters
-	int Nx=meshSize;
-	int Ny=6*meshSize;
+	// Grid parameters, dynamic problems are solved only in the staggered grid
+	string gridType="staggered";
+	int Nx=20*meshSize;
+	int Ny=20*meshSize;
+	int Nt=2;
 
 	// Reservoir parameters
-	double Lx=1; // [m]
-	double Ly=6; // [m]
+	double Lx=20; // [m]
+	double Ly=20; // [m]
+	double stripWidth=Lx/10; // [m]
 
 	vector<vector<double>> sCoordinates=
 	{
@@ -1541,10 +2674,8 @@ int sealedDouble(string gridType, string interpScheme, int Nt, int meshSize, dou
 	string pairName=myProperties.pairName;
 	double G=myProperties.shearModulus;
 	double lambda=myProperties.bulkModulus-2*G/3;
-	double phiPore=myProperties.porosity;
-	double phiFrac=myProperties.macroPorosity;
-	double KPore=myProperties.permeability;
-	double KFrac=myProperties.macroPermeability;
+	double phi=myProperties.porosity;
+	double K=myProperties.permeability;
 
 	// Solid properties
 	double c_s=1/myProperties.solidBulkModulus;
@@ -1555,38 +2686,27 @@ int sealedDouble(string gridType, string interpScheme, int Nt, int meshSize, dou
 	double rho_f=myProperties.fluidDensity;
 	double mu_f=myProperties.fluidViscosity;
 
-	// BC types ({u,v,p-pore,p-frac} 1 for Dirichlet and 0 for Neumann, -1 for Stress/Fluid Flow, starts on
-	// "north" and follows counterclockwise)
-	vector<vector<int>> bcType=
-	{
-		{-1,-1,-1,-1},
-		{1,-1,-1,-1},
-		{-1,1,-1,-1},
-		{1,-1,-1,-1}
-	};
-
-	// BC values ({u,v,P}, starts on "north" and follows counterclockwise)
-	vector<vector<double>> bcValue=
-	{
-		{0,sigmab,0,0},
-		{0,0,0,0},
-		{0,0,0,0},
-		{0,0,0,0}
-	};
+	// Wave parameters, the tortuosity of Berryman when none is given
+	PetscReal frequency=0; // [Hz]
+	PetscReal courantNumber=0.9;
+	PetscReal tortuosity=0.5*(1+1/phi);
+	PetscInt absorbingLayerWidth=20; // No of FV
+	PetscInt snapshotsNo=4;
+	PetscOptionsGetReal(NULL,NULL,"-dynamic_frequency",&frequency,NULL);
+	PetscOptionsGetReal(NULL,NULL,"-dynamic_courant",&courantNumber,NULL);
+	PetscOptionsGetReal(NULL,NULL,"-dynamic_tortuosity",&tortuosity,NULL);
+	PetscOptionsGetInt(NULL,NULL,"-dynamic_absorbing_layer",&absorbingLayerWidth,NULL);
+	PetscOptionsGetInt(NULL,NULL,"-dynamic_snapshots",&snapshotsNo,NULL);
 
 /*		GRID CREATION
 	----------------------------------------------------------------*/
 
-	// Constructor
-	gridDesign myGrid(Nx,Ny,Nt,Lx,Ly,Lt,gridType,sCoordinates);
+	// Constructor, the time-step of the grid is replaced by the one of the CFL condition
+	gridDesign myGrid(Nx,Ny,Nt,Lx,Ly,1,gridType,sCoordinates);
 
 	// Passing variables
-	int Nu;swap(Nu,myGrid.numberOfActiveUDisplacementFV);
-	int Nv;swap(Nv,myGrid.numberOfActiveVDisplacementFV);
-	int NP;swap(NP,myGrid.numberOfActiveGeneralFV);
 	double dx;swap(dx,myGrid.dx);
 	double dy;swap(dy,myGrid.dy);
-	double dt;swap(dt,myGrid.dt);
 	double h;swap(h,myGrid.h);
 	vector<vector<int>> idU;swap(idU,myGrid.uDisplacementFVIndex);
 	vector<vector<int>> idV;swap(idV,myGrid.vDisplacementFVIndex);
@@ -1594,585 +2714,524 @@ int sealedDouble(string gridType, string interpScheme, int Nt, int meshSize, dou
 	vector<vector<int>> cooU;swap(cooU,myGrid.uDisplacementFVCoordinates);
 	vector<vector<int>> cooV;swap(cooV,myGrid.vDisplacementFVCoordinates);
 	vector<vector<int>> cooP;swap(cooP,myGrid.generalFVCoordinates);
-	vector<vector<int>> horFaceStatus;swap(horFaceStatus,myGrid.horizontalFacesStatus);
-	vector<vector<int>> verFaceStatus;swap(verFaceStatus,myGrid.verticalFacesStatus);
 	vector<vector<double>> uField;swap(uField,myGrid.uDisplacementField);
 	vector<vector<double>> vField;swap(vField,myGrid.vDisplacementField);
-	vector<vector<double>> pPoreField=myGrid.pressureField;
-	vector<vector<double>> pFracField=pPoreField;
+	vector<vector<double>> pField;swap(pField,myGrid.pressureField);
 
 /*		PROBLEM PARAMETERS CALCULATION
 	----------------------------------------------------------------*/
 
 	// Constructor
-	problemDoubleParameters myProblem(phiPore,phiFrac,c_f,c_s,G,lambda,mu_f,KPore,KFrac,sigmab,
-		cooV,idV);
-
-	// Passing variables
-	double psiPore=myProblem.psiPore;
-	double psiFrac=myProblem.psiFrac;
-	double alpha=myProblem.alpha;
-	double S11=myProblem.S11;
-	double S12=myProblem.S12;
-	double S22=myProblem.S22;
-	double leak=myProblem.computeLeakTerm(11);
-	
-/*		LINEAR SYSTEM'S COEFFICIENTS MATRIX ASSEMBLY
-	----------------------------------------------------------------*/
-
-	// Constructor
-	coefficientsAssembly myCoefficients(bcType,Nu,Nv,NP,idU,idV,idP,cooU,cooV,cooP,
-		horFaceStatus,verFaceStatus,gridType,interpScheme);
-
-	// Coefficients matrix assembly
-	myCoefficients.assemblyDoublePorosityMatrix(dx,dy,dt,G,lambda,alpha,KPore,KFrac,mu_f,S11,S12,
-		S22,psiPore,psiFrac,leak);
+	problemParameters myProblem(dx,dy,K,phi,rho_s,c_s,mu_f,rho_f,c_f,G,lambda,sigmab,Lx,Ly,
+		uField,vField,pField,cooU,cooV,cooP,idU,idV,idP,0);
 
 	// Passing variables
-	vector<vector<double>> coefficientsMatrix;swap(coefficientsMatrix,
-		myCoefficients.coefficientsMatrix);
-	vector<double> sparseCoefficientsRow;swap(sparseCoefficientsRow,
-		myCoefficients.sparseCoefficientsRow);
-	vector<double> sparseCoefficientsColumn;swap(sparseCoefficientsColumn,
-		myCoefficients.sparseCoefficientsColumn);
-	vector<double> sparseCoefficientsValue;swap(sparseCoefficientsValue,
-		myCoefficients.sparseCoefficientsValue);
+	double Q;swap(Q,myProblem.Q);
+	double alpha;swap(alpha,myProblem.alpha);
 
-/*		LINEAR SYSTEM SOLVER
+/*		EXPLICIT TIME-STEPPING
 	----------------------------------------------------------------*/
 
-	// Variables declaration
-	int timeStep;
-	vector<double> independentTermsArray;
-
-	// Constructors
-	independentTermsAssembly myIndependentTerms(bcType,bcValue,Nu,Nv,NP,idU,idV,idP,cooU,cooV,cooP,
-		horFaceStatus,verFaceStatus,gridType,interpScheme);
-	linearSystemSolver myLinearSystemSolver(coefficientsMatrix,sparseCoefficientsRow,
-		sparseCoefficientsColumn,sparseCoefficientsValue,uField,vField,pPoreField,Nu,Nv,NP,Nt,idU,
-		idV,idP,cooU,cooV,cooP);
-
-	// Increase the independent terms array
-	myIndependentTerms.increaseMacroIndependentTermsArray();
+	// Constructor
+	dynamicBiotSolver myDynamicSolver(Nx,Ny,dx,dy,G,lambda,alpha,Q,phi,rho_s,rho_f,mu_f,K,
+		tortuosity,sigmab,frequency,courantNumber,absorbingLayerWidth,stripWidth);
+	double dt=myDynamicSolver.dt;
 
-	// Creates macro-pressure field
-	myLinearSystemSolver.createMacroPressureField(pFracField);
+	// By default, until the shear wave crosses the reservoir
+	if(Lt<=0) Lt=Ly/myDynamicSolver.shearVelocity;
+	Nt=ceil(Lt/dt)+1;
+	int snapshotInterval=max((Nt-1)/max((int)snapshotsNo,1),1);
+	myDynamicSolver.surfaceVelocity.reserve(Nt);
 
-	// LU Factorization of coefficientsMatrix
-	ierr=myLinearSystemSolver.coefficientsMatrixLUFactorization();CHKERRQ(ierr);
-	
-	// Creation of arrays
-	ierr=myLinearSystemSolver.createPETScArrays();CHKERRQ(ierr);
-	ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
-
-	for(timeStep=0; timeStep<Nt-1; timeStep++)
+	for(int timeStep=0; timeStep<Nt-1; timeStep++)
 	{
-		// Assembly of the independent terms array
-		myIndependentTerms.assemblyMacroIndependentTermsArray(dx,dy,dt,G,lambda,alpha,KPore,mu_f,
-			S11,0,0,uField,vField,pPoreField,pFracField,timeStep,phiPore,phiFrac,KFrac,S12,S22);
+		myDynamicSolver.step();
 
-		// Passing independent terms array
-		independentTermsArray=myIndependentTerms.independentTermsArray;
-
-		// Solution of the linear system
-		ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
-		ierr=myLinearSystemSolver.setRHSValue(independentTermsArray);CHKERRQ(ierr);
-		ierr=myLinearSystemSolver.solveLinearSystem();CHKERRQ(ierr);
-		ierr=myLinearSystemSolver.setFieldValue(timeStep+1);CHKERRQ(ierr);
-		ierr=myLinearSystemSolver.setMacroFieldValue(timeStep+1);CHKERRQ(ierr);
-
-		// Passing solutions
-		uField=myLinearSystemSolver.uField;
-		vField=myLinearSystemSolver.vField;
-		pPoreField=myLinearSystemSolver.pField;
-		pFracField=myLinearSystemSolver.pMField;
-		ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
-
-		cout << timeStep+1<< "\r";
+		if((timeStep+1)%snapshotInterval==0)
+			myDynamicSolver.exportCentroidFields(pairName,"timeStep="+to_string(timeStep+1));
 	}
 
+	double maxVelocity=myDynamicSolver.getMaxVelocity();
+	double cellUpdates=(double)Nx*Ny*(Nt-1);
+	double cellRate=cellUpdates/myDynamicSolver.stepSeconds;
+
 	cout << Ny << "x" << Nx << "x" << Nt-1 << " ";
-	cout << "(h=" << h << ", dt=" << dt << ")\n";
+	cout << "(h=" << h << ", dt=" << dt << ", f=" << myDynamicSolver.frequency << ")\n";
+	cout << "Wave velocities: fast=" << myDynamicSolver.fastVelocity << "m/s, slow=" <<
+		myDynamicSolver.slowVelocity << "m/s, shear=" << myDynamicSolver.shearVelocity << "m/s\n";
+	cout << "Throughput: " << cellRate/1e6 << " Mcell/s, " <<
+		cellRate*dynamicBiotSolver::bytesPerCellUpdate/1e9 << " GB/s of " <<
+		myDynamicSolver.measureTriadBandwidth()/1e9 << " GB/s (triad)\n";
+	if(!isfinite(maxVelocity)) cout << "Unstable solution, reduce -dynamic_courant\n";
 
 /*		DATA PROCESSING
 	----------------------------------------------------------------*/
-	
-	// Variables declaration
-	vector<int> exportedTimeSteps=
-	{
-		// {1},
-		// {(Nt-1)/16},
-		// {(Nt-1)/8},
-		{Nt-1}
-	};
-	if(Nt==2)
-	{
-		exportedTimeSteps.clear();
-		exportedTimeSteps.push_back(1);
-	}
-
-	// Constructor
-	doubleDataProcessing myDataProcessing(idU,idV,idP,uField,vField,pPoreField,gridType,
-		interpScheme,dx,dy);
-	myDataProcessing.storeMacroPressure3DField(idP,pFracField);
 
-	// Exports data for specified time-steps
-	for(int i=0; i<exportedTimeSteps.size(); i++)
-	{
-		myDataProcessing.exportSealedDoubleAnalyticalSolution(Ly,alpha*psiPore,alpha*psiFrac,
-			2*G+lambda,S11,S12,S22,sigmab,dt,exportedTimeSteps[i],pairName);
-		myDataProcessing.exportSealedDoubleNumericalSolution(dy,dt,Ly,exportedTimeSteps[i],
-			pairName);
-	}
+	myDynamicSolver.exportSurfaceVelocity(pairName,meshSize);
 
 	return ierr;
 };
 
-int storageDouble(string gridType, string interpScheme, int Nt, int meshSize, double Lt, double g,
-	double sigmab, poroelasticProperties myProperties)
+int footing3D(string gridType, int Nt, int meshSize, double Lt, double sigmab,
+	poroelasticProperties myProperties)
 {
-	PetscErrorCode ierr;
+	PetscErrorCode ierr=0;
+
+	// Objects of this run are allocated from the run arena
+	runArenaScope myRunArena;
+
+	if(gridType!="staggered")
+	{
+		cout << "The 3D operators are discretized in the staggered grid only\n";
+
+		return ierr;
+	}
 
 /*		ENTRY PARAMETERS
 	----------------------------------------------------------------*/
 
 	// Grid parameters
-	int Nx=meshSize;
-	int Ny=6*meshSize;
+	int Nx=8*meshSize;
+	int Ny=8*meshSize;
+	int Nz=8*meshSize;
 
 	// Reservoir parameters
-	double Lx=1; // [m]
-	double Ly=6; // [m]
-
-	vector<vector<double>> sCoordinates=
-	{
-		{Lx,Ly},
-		{0,Ly},
-		{0,0},
-		{Lx,0}
-	};
+	double Lx=5; // [m]
+	double Ly=5; // [m]
+	double Lz=5; // [m]
 
 	// Bulk properties
 	string pairName=myProperties.pairName;
 	double G=myProperties.shearModulus;
 	double lambda=myProperties.bulkModulus-2*G/3;
-	double phiPore=myProperties.porosity;
-	double phiFrac=myProperties.macroPorosity;
-	double KPore=myProperties.permeability;
-	double KFrac=myProperties.macroPermeability;
+	double phi=myProperties.porosity;
+	double K=myProperties.permeability;
 
 	// Solid properties
 	double c_s=1/myProperties.solidBulkModulus;
-	double rho_s=myProperties.solidDensity;
 
 	// Fluid properties
 	double c_f=1/myProperties.fluidBulkModulus;
-	double rho_f=myProperties.fluidDensity;
 	double mu_f=myProperties.fluidViscosity;
 
-	// BC types ({u,v,p-pore,p-frac} 1 for Dirichlet and 0 for Neumann, -1 for Stress/Fluid Flow, starts on
-	// "north" and follows counterclockwise)
-	vector<vector<int>> bcType=
-	{
-		{-1,-1,1,1},
-		{1,-1,-1,-1},
-		{-1,1,-1,-1},
-		{1,-1,-1,-1}
-	};
-
-	// BC values ({u,v,P}, starts on "north" and follows counterclockwise)
-	vector<vector<double>> bcValue=
-	{
-		{0,sigmab,0,0},
-		{0,0,0,0},
-		{0,0,0,0},
-		{0,0,0,0}
-	};
+	// Solver parameters, a footing as wide as the top is the problem of Terzaghi
+	PetscReal footingWidth=Lx/5; // [m]
+	PetscInt tileSize=16;
+	PetscReal tolerance=1e-8;
+	PetscReal fixedStressTolerance=1e-6;
+	PetscInt maxFixedStressIterationsNo=50;
+	PetscOptionsGetReal(NULL,NULL,"-footing3d_width",&footingWidth,NULL);
+	PetscOptionsGetInt(NULL,NULL,"-mf_tile",&tileSize,NULL);
+	PetscOptionsGetReal(NULL,NULL,"-mf_rtol",&tolerance,NULL);
+	PetscOptionsGetReal(NULL,NULL,"-fixed_stress_rtol",&fixedStressTolerance,NULL);
+	PetscOptionsGetInt(NULL,NULL,"-fixed_stress_max_it",&maxFixedStressIterationsNo,NULL);
 
 /*		GRID CREATION
 	----------------------------------------------------------------*/
 
 	// Constructor
-	gridDesign myGrid(Nx,Ny,Nt,Lx,Ly,Lt,gridType,sCoordinates);
+	gridDesign3D myGrid(Nx,Ny,Nz,Nt,Lx,Ly,Lz,Lt,gridType);
 
 	// Passing variables
-	int Nu;swap(Nu,myGrid.numberOfActiveUDisplacementFV);
-	int Nv;swap(Nv,myGrid.numberOfActiveVDisplacementFV);
-	int NP;swap(NP,myGrid.numberOfActiveGeneralFV);
-	double dx;swap(dx,myGrid.dx);
-	double dy;swap(dy,myGrid.dy);
-	double dt;swap(dt,myGrid.dt);
-	double h;swap(h,myGrid.h);
-	vector<vector<int>> idU;swap(idU,myGrid.uDisplacementFVIndex);
-	vector<vector<int>> idV;swap(idV,myGrid.vDisplacementFVIndex);
-	vector<vector<int>> idP;swap(idP,myGrid.generalFVIndex);
-	vector<vector<int>> cooU;swap(cooU,myGrid.uDisplacementFVCoordinates);
-	vector<vector<int>> cooV;swap(cooV,myGrid.vDisplacementFVCoordinates);
-	vector<vector<int>> cooP;swap(cooP,myGrid.generalFVCoordinates);
-	vector<vector<int>> horFaceStatus;swap(horFaceStatus,myGrid.horizontalFacesStatus);
-	vector<vector<int>> verFaceStatus;swap(verFaceStatus,myGrid.verticalFacesStatus);
-	vector<vector<double>> uField;swap(uField,myGrid.uDisplacementField);
-	vector<vector<double>> vField;swap(vField,myGrid.vDisplacementField);
-	vector<vector<double>> pPoreField=myGrid.pressureField;
-	vector<vector<double>> pFracField=pPoreField;
+	double dx=myGrid.dx;
+	double dy=myGrid.dy;
+	double dz=myGrid.dz;
+	double dt=myGrid.dt;
+	double h=myGrid.h;
+	int NP=myGrid.NP;
 
 /*		PROBLEM PARAMETERS CALCULATION
 	----------------------------------------------------------------*/
 
-	// Constructor
-	problemDoubleParameters myProblem(phiPore,phiFrac,c_f,c_s,G,lambda,mu_f,KPore,KFrac,sigmab,
-		cooV,idV);
+	double drainedBulkModulus=lambda+2*G/3;
+	double alpha=1-c_s*drainedBulkModulus;
+	double Q=1/(c_s*(alpha-phi)+c_f*phi);
+	double fixedStressStorage=1/Q+alpha*alpha/drainedBulkModulus;
+	double V=dx*dy*dz;
 
-	// Apply initial conditions
-	myProblem.applyDoublePoreInitialConditions(dy,Ly,vField,pPoreField,pFracField);
+	// Load on the top FV under the footing
+	vector<double> topLoad(Nx*Ny,0);
+	for(int j=0; j<Ny; j++)
+	for(int i=0; i<Nx; i++)
+	{
+		vector<double> coordinates=myGrid.getPCoordinates(i,j,0);
+		if(fabs(coordinates[0]-Lx/2)<footingWidth/2 && fabs(coordinates[1]-Ly/2)<footingWidth/2)
+			topLoad[j*Nx+i]=sigmab;
+	}
 
-	// Passing variables
-	double psiPore=myProblem.psiPore;
-	double psiFrac=myProblem.psiFrac;
-	double alpha=myProblem.alpha;
-	double S11=myProblem.S11;
-	double S12=myProblem.S12;
-	double S22=myProblem.S22;
-	double leak=myProblem.computeLeakTerm(0);
-	vField=myProblem.vDisplacementField;
-	pPoreField=myProblem.pressurePoreField;
-	pFracField=myProblem.pressureFracField;
-	
-/*		LINEAR SYSTEM'S COEFFICIENTS MATRIX ASSEMBLY
+/*		MATRIX-FREE SOLVER
 	----------------------------------------------------------------*/
 
 	// Constructor
-	coefficientsAssembly myCoefficients(bcType,Nu,Nv,NP,idU,idV,idP,cooU,cooV,cooP,
-		horFaceStatus,verFaceStatus,gridType,interpScheme);
-
-	// Coefficients matrix assembly
-	myCoefficients.assemblyDoublePorosityMatrix(dx,dy,dt,G,lambda,alpha,KPore,KFrac,mu_f,S11,S12,
-		S22,psiPore,psiFrac,leak);
-
-	// Passing variables
-	vector<vector<double>> coefficientsMatrix;swap(coefficientsMatrix,
-		myCoefficients.coefficientsMatrix);
-	vector<double> sparseCoefficientsRow;swap(sparseCoefficientsRow,
-		myCoefficients.sparseCoefficientsRow);
-	vector<double> sparseCoefficientsColumn;swap(sparseCoefficientsColumn,
-		myCoefficients.sparseCoefficientsColumn);
-	vector<double> sparseCoefficientsValue;swap(sparseCoefficientsValue,
-		myCoefficients.sparseCoefficientsValue);
-
-/*		LINEAR SYSTEM SOLVER
-	----------------------------------------------------------------*/
+	multigridSolver3D mySolver(myGrid,G,lambda,fixedStressStorage,dt*K/mu_f,tileSize);
+	matrixFreeOperator3D& myOperator=mySolver.levels[0];
 
 	// Variables declaration
-	int timeStep;
-	vector<double> independentTermsArray;
-
-	// Constructors
-	independentTermsAssembly myIndependentTerms(bcType,bcValue,Nu,Nv,NP,idU,idV,idP,cooU,cooV,cooP,
-		horFaceStatus,verFaceStatus,gridType,interpScheme);
-	linearSystemSolver myLinearSystemSolver(coefficientsMatrix,sparseCoefficientsRow,
-		sparseCoefficientsColumn,sparseCoefficientsValue,uField,vField,pPoreField,Nu,Nv,NP,Nt,idU,
-		idV,idP,cooU,cooV,cooP);
-
-	// Increase the independent terms array
-	myIndependentTerms.increaseMacroIndependentTermsArray();
-
-	// Creates macro-pressure field
-	myLinearSystemSolver.createMacroPressureField(pFracField);
-
-	// LU Factorization of coefficientsMatrix
-	ierr=myLinearSystemSolver.coefficientsMatrixLUFactorization();CHKERRQ(ierr);
-	
-	// Creation of arrays
-	ierr=myLinearSystemSolver.createPETScArrays();CHKERRQ(ierr);
-	ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
-
-	for(timeStep=0; timeStep<Nt-1; timeStep++)
-	{
-		// Assembly of the independent terms array
-		myIndependentTerms.assemblyMacroIndependentTermsArray(dx,dy,dt,G,lambda,alpha,KPore,mu_f,
-			S11,0,0,uField,vField,pPoreField,pFracField,timeStep,phiPore,phiFrac,KFrac,S12,S22);
-
-		// Passing independent terms array
-		independentTermsArray=myIndependentTerms.independentTermsArray;
-
-		// Solution of the linear system
-		ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
-		ierr=myLinearSystemSolver.setRHSValue(independentTermsArray);CHKERRQ(ierr);
-		ierr=myLinearSystemSolver.solveLinearSystem();CHKERRQ(ierr);
-		ierr=myLinearSystemSolver.setFieldValue(timeStep+1);CHKERRQ(ierr);
-		ierr=myLinearSystemSolver.setMacroFieldValue(timeStep+1);CHKERRQ(ierr);
-
-		// Passing solutions
-		uField=myLinearSystemSolver.uField;
-		vField=myLinearSystemSolver.vField;
-		pPoreField=myLinearSystemSolver.pField;
-		pFracField=myLinearSystemSolver.pMField;
-		ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
+	vector<double> displacement(myOperator.mechanicsSize,0), momentumRHS;
+	vector<double> pressure(NP,0), oldPressure, iterationPressure, continuityRHS(NP);
+	vector<double> strain(NP,0), oldStrain;
+	int settlementPosition=myOperator.Nu+myOperator.Nv+myOperator.wIndex(Nx/2,Ny/2,0);
+	int pressurePosition=myOperator.pIndex(Nx/2,Ny/2,(int)(footingWidth/(2*dz)));
+	vector<vector<double>> series(Nt,vector<double>(3,0));
+	long long pressureIterationsNo=0, mechanicsIterationsNo=0, fixedStressIterationsNo=0;
+	chrono::steady_clock::time_point start=chrono::steady_clock::now();
+
+	for(int timeStep=0; timeStep<Nt-1; timeStep++)
+	{
+		oldPressure=pressure;
+		oldStrain=strain;
+
+		// Fixed-stress split, the pressure with the mean stress of the last iteration
+		for(int iterationNo=0; iterationNo<maxFixedStressIterationsNo; iterationNo++)
+		{
+			iterationPressure=pressure;
+			for(int n=0; n<NP; n++)
+				continuityRHS[n]=V*(oldPressure[n]/Q+alpha*alpha/drainedBulkModulus*
+					iterationPressure[n]-alpha*(strain[n]-oldStrain[n]));
+			pressureIterationsNo+=mySolver.solve(multigridSolver3D::pressureField,continuityRHS,
+				pressure,tolerance,500);
+
+			myOperator.assemblyMomentumRHS(pressure,topLoad,alpha,momentumRHS);
+			mechanicsIterationsNo+=mySolver.solve(multigridSolver3D::mechanicsField,momentumRHS,
+				displacement,tolerance,500);
+			myOperator.computeVolumetricStrain(displacement,strain);
+			fixedStressIterationsNo++;
+
+			double change=0, maxPressure=1e-300;
+			for(int n=0; n<NP; n++)
+			{
+				change=max(change,fabs(pressure[n]-iterationPressure[n]));
+				maxPressure=max(maxPressure,fabs(pressure[n]));
+			}
+			if(iterationNo>0 && change<=fixedStressTolerance*maxPressure) break;
+		}
+
+		series[timeStep+1][0]=(timeStep+1)*dt;
+		series[timeStep+1][1]=displacement[settlementPosition];
+		series[timeStep+1][2]=pressure[pressurePosition];
 
 		cout << timeStep+1<< "\r";
 	}
 
-	cout << Ny << "x" << Nx << "x" << Nt-1 << " ";
-	cout << "(h=" << h << ", dt=" << dt << ")\n";
+	double seconds=chrono::duration<double>(chrono::steady_clock::now()-start).count();
+	struct rusage usage;
+	getrusage(RUSAGE_SELF,&usage);
+
+	cout << Nz << "x" << Ny << "x" << Nx << "x" << Nt-1 << " ";
+	cout << "(h=" << h << ", dt=" << dt << ", unknowns=" << myOperator.mechanicsSize+NP <<
+		", levels=" << mySolver.levels.size() << ")\n";
+	cout << "Per time-step: " << (double)fixedStressIterationsNo/(Nt-1) <<
+		" fixed-stress iterations, " << seconds/(Nt-1) << "s; per solve: " <<
+		(double)pressureIterationsNo/fixedStressIterationsNo << " pressure and " <<
+		(double)mechanicsIterationsNo/fixedStressIterationsNo << " displacement CG iterations\n";
+	cout << "Peak memory: " << usage.ru_maxrss/1024.0 << " MB\n";
 
 /*		DATA PROCESSING
 	----------------------------------------------------------------*/
-	
-	// Variables declaration
-	vector<int> exportedTimeSteps=
-	{
-		{1},
-		{2},
-		{3},
-		{4},
-		{125},
-		{250},
-		{500}
-	};
-	if(Nt==2)
+
+	string fileName="../export/footing3D_"+pairName+"_mesh="+to_string(meshSize)+"_"+gridType+
+		"-grid.txt";
+	ofstream seriesFile(fileName);
+	if(seriesFile.is_open())
 	{
-		exportedTimeSteps.clear();
-		exportedTimeSteps.push_back(1);
-	}
+		for(int timeStep=0; timeStep<Nt; timeStep++)
+			seriesFile << series[timeStep][0] << "\t" << series[timeStep][1] << "\t" <<
+				series[timeStep][2] << "\n";
 
-	// Constructor
-	doubleDataProcessing myDataProcessing(idU,idV,idP,uField,vField,pPoreField,gridType,
-		interpScheme,dx,dy);
-	myDataProcessing.storeMacroPressure3DField(idP,pFracField);
+		seriesFile.close();
+	}
 
-	// Exports data for specified time-steps
-	for(int i=0; i<exportedTimeSteps.size(); i++)
+	// Pressure under the center of the footing at the last time-step
+	fileName="../export/footing3D_"+pairName+"_PProfile_mesh="+to_string(meshSize)+"_"+gridType+
+		"-grid.txt";
+	ofstream profileFile(fileName);
+	if(profileFile.is_open())
 	{
-		myDataProcessing.exportDrainedDoubleNumericalSolution(dy,dt,Ly,exportedTimeSteps[i],
-			pairName);
-		myDataProcessing.exportStorageAnalyticalSolution(Ly,alpha*psiPore,alpha*psiFrac,
-			2*G+lambda,S11,S12,S22,KPore,KFrac,mu_f,sigmab,dt,exportedTimeSteps[i],pairName);
+		for(int k=0; k<Nz; k++)
+			profileFile << myGrid.getPCoordinates(Nx/2,Ny/2,k)[2] << "\t" <<
+				pressure[myOperator.pIndex(Nx/2,Ny/2,k)] << "\n";
+
+		profileFile.close();
 	}
 
 	return ierr;
 };
 
-int leakingDouble(string gridType, string interpScheme, int Nt, int meshSize, double Lt, double g,
-	double sigmab, poroelasticProperties myProperties)
+problemDescriptor doubleColumnDescriptor(int meshSize, double sigmab, bool drainedTop)
 {
-	PetscErrorCode ierr;
-
-/*		ENTRY PARAMETERS
-	----------------------------------------------------------------*/
+	// Double porosity column loaded by sigmab on the top, which is drained or sealed, shared by
+	// the Terzaghi, sealed, storage and leaking problems
+	problemDescriptor myDescriptor;
+	myDescriptor.doublePorosity=true;
 
 	// Grid parameters
-	int Nx=meshSize;
-	int Ny=6*meshSize;
+	myDescriptor.Nx=meshSize;
+	myDescriptor.Ny=6*meshSize;
 
 	// Reservoir parameters
-	double Lx=1; // [m]
-	double Ly=6; // [m]
+	myDescriptor.Lx=1; // [m]
+	myDescriptor.Ly=6; // [m]
 
-	vector<vector<double>> sCoordinates=
-	{
-		{Lx,Ly},
-		{0,Ly},
-		{0,0},
-		{Lx,0}
-	};
-
-	// Bulk properties
-	string pairName=myProperties.pairName;
-	double G=myProperties.shearModulus;
-	double lambda=myProperties.bulkModulus-2*G/3;
-	double phiPore=myProperties.porosity;
-	double phiFrac=myProperties.macroPorosity;
-	double KPore=myProperties.permeability;
-	double KFrac=myProperties.macroPermeability;
-
-	// Solid properties
-	double c_s=1/myProperties.solidBulkModulus;
-	double rho_s=myProperties.solidDensity;
-
-	// Fluid properties
-	double c_f=1/myProperties.fluidBulkModulus;
-	double rho_f=myProperties.fluidDensity;
-	double mu_f=myProperties.fluidViscosity;
-
-	// BC types ({u,v,p-pore,p-frac} 1 for Dirichlet and 0 for Neumann, -1 for Stress/Fluid Flow, starts on
-	// "north" and follows counterclockwise)
-	vector<vector<int>> bcType=
+	// BC types ({u,v,p-pore,p-frac} 1 for Dirichlet and 0 for Neumann, -1 for Stress/Fluid Flow,
+	// starts on "north" and follows counterclockwise)
+	int topPressureType=drainedTop ? 1 : -1;
+	myDescriptor.bcType=
 	{
-		{-1,-1,1,1},
+		{-1,-1,topPressureType,topPressureType},
 		{1,-1,-1,-1},
 		{-1,1,-1,-1},
 		{1,-1,-1,-1}
 	};
 
-	// BC values ({u,v,P}, starts on "north" and follows counterclockwise)
-	vector<vector<double>> bcValue=
+	// BC values ({u,v,p-pore,p-frac}, starts on "north" and follows counterclockwise)
+	myDescriptor.bcValue=
 	{
 		{0,sigmab,0,0},
 		{0,0,0,0},
 		{0,0,0,0},
 		{0,0,0,0}
 	};
+	myDescriptor.load=sigmab;
 
-/*		GRID CREATION
-	----------------------------------------------------------------*/
+	return myDescriptor;
+};
 
-	// Constructor
-	gridDesign myGrid(Nx,Ny,Nt,Lx,Ly,Lt,gridType,sCoordinates);
+void doubleColumnInitialConditions(simulationState& myState)
+{
+	// Undrained response of the double porosity column to the load
+	myState.doubleProblem->applyDoublePoreInitialConditions(myState.dy,myState.Ly,myState.vField,
+		myState.pField,myState.pMField);
 
-	// Passing variables
-	int Nu;swap(Nu,myGrid.numberOfActiveUDisplacementFV);
-	int Nv;swap(Nv,myGrid.numberOfActiveVDisplacementFV);
-	int NP;swap(NP,myGrid.numberOfActiveGeneralFV);
-	double dx;swap(dx,myGrid.dx);
-	double dy;swap(dy,myGrid.dy);
-	double dt;swap(dt,myGrid.dt);
-	double h;swap(h,myGrid.h);
-	vector<vector<int>> idU;swap(idU,myGrid.uDisplacementFVIndex);
-	vector<vector<int>> idV;swap(idV,myGrid.vDisplacementFVIndex);
-	vector<vector<int>> idP;swap(idP,myGrid.generalFVIndex);
-	vector<vector<int>> cooU;swap(cooU,myGrid.uDisplacementFVCoordinates);
-	vector<vector<int>> cooV;swap(cooV,myGrid.vDisplacementFVCoordinates);
-	vector<vector<int>> cooP;swap(cooP,myGrid.generalFVCoordinates);
-	vector<vector<int>> horFaceStatus;swap(horFaceStatus,myGrid.horizontalFacesStatus);
-	vector<vector<int>> verFaceStatus;swap(verFaceStatus,myGrid.verticalFacesStatus);
-	vector<vector<double>> uField;swap(uField,myGrid.uDisplacementField);
-	vector<vector<double>> vField;swap(vField,myGrid.vDisplacementField);
-	vector<vector<double>> pPoreField=myGrid.pressureField;
-	vector<vector<double>> pFracField=pPoreField;
+	return;
+};
 
-/*		PROBLEM PARAMETERS CALCULATION
+int terzaghiDouble(string gridType, string interpScheme, int Nt, int meshSize, double Lt, double g,
+	double sigmab, poroelasticProperties myProperties)
+{
+/*		PROBLEM DESCRIPTION
 	----------------------------------------------------------------*/
 
-	// Constructor
-	problemDoubleParameters myProblem(phiPore,phiFrac,c_f,c_s,G,lambda,mu_f,KPore,KFrac,sigmab,
-		cooV,idV);
+	problemDescriptor myDescriptor=doubleColumnDescriptor(meshSize,sigmab,true);
+	myDescriptor.problemName="terzaghiDouble";
 
-	// Apply initial conditions
-	myProblem.applyDoublePoreInitialConditions(dy,Ly,vField,pPoreField,pFracField);
+/*		DATA PROCESSING
+	----------------------------------------------------------------*/
 
-	// Passing variables
-	double psiPore=myProblem.psiPore;
-	double psiFrac=myProblem.psiFrac;
-	double alpha=myProblem.alpha;
-	double S11=myProblem.S11;
-	double S12=myProblem.S12;
-	double S22=myProblem.S22;
-	double leak=myProblem.computeLeakTerm(11);
-	vField=myProblem.vDisplacementField;
-	pPoreField=myProblem.pressurePoreField;
-	pFracField=myProblem.pressureFracField;
+	myDescriptor.exporters.push_back([sigmab](simulationState& myState)
+	{
+		// Variables declaration
+		int Nt=myState.Nt;
+		vector<int> exportedTimeSteps=
+		{
+			{1},
+			{(Nt-1)/8},
+			{(Nt-1)/2},
+			{Nt-1}
+		};
+		if(Nt==2)
+		{
+			exportedTimeSteps.clear();
+			exportedTimeSteps.push_back(1);
+		}
+
+		// Constructor
+		dataProcessing myDataProcessing(myState.idU,myState.idV,myState.idP,*myState.history,
+			myState.gridType,myState.interpScheme,myState.dx,myState.dy);
+
+		// Exports data for specified time-steps
+		for(int i=0; i<exportedTimeSteps.size(); i++)
+		{
+			myDataProcessing.exportTerzaghiAnalyticalSolution(myState.Ly,
+				myState.psiPore*myState.alpha,1/myState.S11,0,0,0,2*myState.G+myState.lambda,
+				sigmab,myState.dt,exportedTimeSteps[i],myState.consolidationCoefficient,
+				myState.pairName);
+			myDataProcessing.exportMacroPressureHSolution(myState.dy,myState.h,myState.Ly,
+				exportedTimeSteps[i],myState.pairName);
+			myDataProcessing.exportMacroPressureTSolution(myState.dy,myState.dt,myState.Ly,
+				exportedTimeSteps[i],myState.pairName);
+		}
+	});
+
+	return runSimulationPipeline(myDescriptor,gridType,interpScheme,Nt,Lt,g,myProperties);
+};
 
-	// Forcing transient term decoupling
-	double M=2*G+lambda;
-	S12=-psiPore*alpha*psiFrac*alpha/M;
-	
-/*		LINEAR SYSTEM'S COEFFICIENTS MATRIX ASSEMBLY
+int stripfootDouble(string gridType, string interpScheme, int Nt, int meshSize, double Lt,
+	double g, double sigmab, poroelasticProperties myProperties,
+	convergenceAnalysis* myAnalysis=NULL)
+{
+/*		PROBLEM DESCRIPTION
 	----------------------------------------------------------------*/
 
-	// Constructor
-	coefficientsAssembly myCoefficients(bcType,Nu,Nv,NP,idU,idV,idP,cooU,cooV,cooP,
-		horFaceStatus,verFaceStatus,gridType,interpScheme);
+	problemDescriptor myDescriptor=stripfootDescriptor(meshSize,sigmab,true);
+	myDescriptor.problemName="stripfootDouble";
 
-	// Coefficients matrix assembly
-	myCoefficients.assemblyDoublePorosityMatrix(dx,dy,dt,G,lambda,alpha,KPore,KFrac,mu_f,S11,S12,
-		S22,psiPore,psiFrac,leak);
+/*		DATA PROCESSING
+	----------------------------------------------------------------*/
 
-	// Passing variables
-	vector<vector<double>> coefficientsMatrix;swap(coefficientsMatrix,
-		myCoefficients.coefficientsMatrix);
-	vector<double> sparseCoefficientsRow;swap(sparseCoefficientsRow,
-		myCoefficients.sparseCoefficientsRow);
-	vector<double> sparseCoefficientsColumn;swap(sparseCoefficientsColumn,
-		myCoefficients.sparseCoefficientsColumn);
-	vector<double> sparseCoefficientsValue;swap(sparseCoefficientsValue,
-		myCoefficients.sparseCoefficientsValue);
+	myDescriptor.exporters.push_back(stripfootExporter<double>);
 
-/*		LINEAR SYSTEM SOLVER
+	// Passes the last time-step to the convergence analysis
+	if(myAnalysis!=NULL) myDescriptor.observers.push_back([myAnalysis](simulationState& myState)
+	{
+		myAnalysis->addLevel(myState.gridType,myState.h,myState.dt,myState.dx,myState.dy,
+			myState.idU,myState.idV,myState.idP,myState.uField,myState.vField,myState.pField,
+			myState.pMField,0);
+	});
+
+	return runSimulationPipeline(myDescriptor,gridType,interpScheme,Nt,Lt,g,myProperties);
+};
+
+int sealedDouble(string gridType, string interpScheme, int Nt, int meshSize, double Lt, double g,
+	double sigmab, poroelasticProperties myProperties)
+{
+/*		PROBLEM DESCRIPTION
 	----------------------------------------------------------------*/
 
-	// Variables declaration
-	int timeStep;
-	vector<double> independentTermsArray;
+	problemDescriptor myDescriptor=doubleColumnDescriptor(meshSize,sigmab,false);
+	myDescriptor.problemName="sealedDouble";
 
-	// Constructors
-	independentTermsAssembly myIndependentTerms(bcType,bcValue,Nu,Nv,NP,idU,idV,idP,cooU,cooV,cooP,
-		horFaceStatus,verFaceStatus,gridType,interpScheme);
-	linearSystemSolver myLinearSystemSolver(coefficientsMatrix,sparseCoefficientsRow,
-		sparseCoefficientsColumn,sparseCoefficientsValue,uField,vField,pPoreField,Nu,Nv,NP,Nt,idU,
-		idV,idP,cooU,cooV,cooP);
+/*		DATA PROCESSING
+	----------------------------------------------------------------*/
 
-	// Increase the independent terms array
-	myIndependentTerms.increaseMacroIndependentTermsArray();
+	myDescriptor.exporters.push_back([sigmab](simulationState& myState)
+	{
+		// Variables declaration
+		int Nt=myState.Nt;
+		vector<int> exportedTimeSteps=
+		{
+			// {1},
+			// {(Nt-1)/16},
+			// {(Nt-1)/8},
+			{Nt-1}
+		};
+		if(Nt==2)
+		{
+			exportedTimeSteps.clear();
+			exportedTimeSteps.push_back(1);
+		}
+
+		// Constructor
+		doubleDataProcessing myDataProcessing(myState.idU,myState.idV,myState.idP,
+			*myState.history,myState.gridType,myState.interpScheme,myState.dx,myState.dy);
+
+		// Exports data for specified time-steps
+		for(int i=0; i<exportedTimeSteps.size(); i++)
+		{
+			myDataProcessing.exportSealedDoubleAnalyticalSolution(myState.Ly,
+				myState.alpha*myState.psiPore,myState.alpha*myState.psiFrac,
+				2*myState.G+myState.lambda,myState.S11,myState.S12,myState.S22,sigmab,myState.dt,
+				exportedTimeSteps[i],myState.pairName);
+			myDataProcessing.exportSealedDoubleNumericalSolution(myState.dy,myState.dt,myState.Ly,
+				exportedTimeSteps[i],myState.pairName);
+		}
+	});
+
+	return runSimulationPipeline(myDescriptor,gridType,interpScheme,Nt,Lt,g,myProperties);
+};
 
-	// Creates macro-pressure field
-	myLinearSystemSolver.createMacroPressureField(pFracField);
+int storageDouble(string gridType, string interpScheme, int Nt, int meshSize, double Lt, double g,
+	double sigmab, poroelasticProperties myProperties)
+{
+/*		PROBLEM DESCRIPTION
+	----------------------------------------------------------------*/
 
-	// LU Factorization of coefficientsMatrix
-	ierr=myLinearSystemSolver.coefficientsMatrixLUFactorization();CHKERRQ(ierr);
-	
-	// Creation of arrays
-	ierr=myLinearSystemSolver.createPETScArrays();CHKERRQ(ierr);
-	ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
+	problemDescriptor myDescriptor=doubleColumnDescriptor(meshSize,sigmab,true);
+	myDescriptor.problemName="storageDouble";
+	myDescriptor.leakCoefficient=0;
 
-	for(timeStep=0; timeStep<Nt-1; timeStep++)
-	{
-		// Assembly of the independent terms array
-		myIndependentTerms.assemblyMacroIndependentTermsArray(dx,dy,dt,G,lambda,alpha,KPore,mu_f,
-			S11,0,0,uField,vField,pPoreField,pFracField,timeStep,phiPore,phiFrac,KFrac,S12,S22);
+	// Initial conditions
+	myDescriptor.initialConditions=doubleColumnInitialConditions;
 
-		// Passing independent terms array
-		independentTermsArray=myIndependentTerms.independentTermsArray;
+/*		DATA PROCESSING
+	----------------------------------------------------------------*/
 
-		// Solution of the linear system
-		ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
-		ierr=myLinearSystemSolver.setRHSValue(independentTermsArray);CHKERRQ(ierr);
-		ierr=myLinearSystemSolver.solveLinearSystem();CHKERRQ(ierr);
-		ierr=myLinearSystemSolver.setFieldValue(timeStep+1);CHKERRQ(ierr);
-		ierr=myLinearSystemSolver.setMacroFieldValue(timeStep+1);CHKERRQ(ierr);
+	myDescriptor.exporters.push_back([sigmab](simulationState& myState)
+	{
+		// Variables declaration
+		vector<int> exportedTimeSteps=
+		{
+			{1},
+			{2},
+			{3},
+			{4},
+			{125},
+			{250},
+			{500}
+		};
+		if(myState.Nt==2)
+		{
+			exportedTimeSteps.clear();
+			exportedTimeSteps.push_back(1);
+		}
+
+		// Constructor
+		doubleDataProcessing myDataProcessing(myState.idU,myState.idV,myState.idP,
+			*myState.history,myState.gridType,myState.interpScheme,myState.dx,myState.dy);
+
+		// Exports data for specified time-steps
+		for(int i=0; i<exportedTimeSteps.size(); i++)
+		{
+			myDataProcessing.exportDrainedDoubleNumericalSolution(myState.dy,myState.dt,
+				myState.Ly,exportedTimeSteps[i],myState.pairName);
+			myDataProcessing.exportStorageAnalyticalSolution(myState.Ly,
+				myState.alpha*myState.psiPore,myState.alpha*myState.psiFrac,
+				2*myState.G+myState.lambda,myState.S11,myState.S12,myState.S22,myState.K,
+				myState.KFrac,myState.mu_f,sigmab,myState.dt,exportedTimeSteps[i],
+				myState.pairName);
+		}
+	});
+
+	return runSimulationPipeline(myDescriptor,gridType,interpScheme,Nt,Lt,g,myProperties);
+};
 
-		// Passing solutions
-		uField=myLinearSystemSolver.uField;
-		vField=myLinearSystemSolver.vField;
-		pPoreField=myLinearSystemSolver.pField;
-		pFracField=myLinearSystemSolver.pMField;
-		ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
+int leakingDouble(string gridType, string interpScheme, int Nt, int meshSize, double Lt, double g,
+	double sigmab, poroelasticProperties myProperties)
+{
+/*		PROBLEM DESCRIPTION
+	----------------------------------------------------------------*/
 
-		cout << timeStep+1<< "\r";
-	}
+	problemDescriptor myDescriptor=doubleColumnDescriptor(meshSize,sigmab,true);
+	myDescriptor.problemName="leakingDouble";
 
-	cout << Ny << "x" << Nx << "x" << Nt-1 << " ";
-	cout << "(h=" << h << ", dt=" << dt << ")\n";
+	// Initial conditions and forcing transient term decoupling
+	myDescriptor.initialConditions=doubleColumnInitialConditions;
+	myDescriptor.decoupledStorage=true;
 
 /*		DATA PROCESSING
 	----------------------------------------------------------------*/
-	
-	// Variables declaration
-	vector<int> exportedTimeSteps=
-	{
-		{1},
-		{62},
-		{125},
-		{500}
-	};
-	if(Nt==2)
-	{
-		exportedTimeSteps.clear();
-		exportedTimeSteps.push_back(1);
-	}
-
-	// Constructor
-	doubleDataProcessing myDataProcessing(idU,idV,idP,uField,vField,pPoreField,gridType,
-		interpScheme,dx,dy);
-	myDataProcessing.storeMacroPressure3DField(idP,pFracField);
 
-	// Exports data for specified time-steps
-	for(int i=0; i<exportedTimeSteps.size(); i++)
-	{
-		myDataProcessing.exportDrainedDoubleNumericalSolution(dy,dt,Ly,exportedTimeSteps[i],
-			pairName);
-		myDataProcessing.exportLeakingAnalyticalSolution(Ly,alpha*psiPore,alpha*psiFrac,
-			2*G+lambda,S11,S12,S22,KPore,KFrac,mu_f,sigmab,leak,dt,exportedTimeSteps[i],pairName);
-	}
-
-	return ierr;
+	myDescriptor.exporters.push_back([sigmab](simulationState& myState)
+	{
+		// Variables declaration
+		vector<int> exportedTimeSteps=
+		{
+			{1},
+			{62},
+			{125},
+			{500}
+		};
+		if(myState.Nt==2)
+		{
+			exportedTimeSteps.clear();
+			exportedTimeSteps.push_back(1);
+		}
+
+		// Constructor
+		doubleDataProcessing myDataProcessing(myState.idU,myState.idV,myState.idP,
+			*myState.history,myState.gridType,myState.interpScheme,myState.dx,myState.dy);
+
+		// Exports data for specified time-steps
+		for(int i=0; i<exportedTimeSteps.size(); i++)
+		{
+			myDataProcessing.exportDrainedDoubleNumericalSolution(myState.dy,myState.dt,
+				myState.Ly,exportedTimeSteps[i],myState.pairName);
+			myDataProcessing.exportLeakingAnalyticalSolution(myState.Ly,
+				myState.alpha*myState.psiPore,myState.alpha*myState.psiFrac,
+				2*myState.G+myState.lambda,myState.S11,myState.S12,myState.S22,myState.K,
+				myState.KFrac,myState.mu_f,sigmab,myState.leak,myState.dt,exportedTimeSteps[i],
+				myState.pairName);
+		}
+	});
+
+	return runSimulationPipeline(myDescriptor,gridType,interpScheme,Nt,Lt,g,myProperties);
 };
\ No newline at end of file
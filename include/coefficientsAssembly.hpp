@@ -2,13 +2,15 @@
 	This header is part of the development of a master's thesis entitled "Analysis of Numerical
 	Schemes in Collocated and Staggered Grids for Problems of Poroelasticity". The class defined
 	here contains the functions for assembly of the coefficients matrix of the linear system which
-	represents the discretized problem of poroelasticity.
+	represents the discretized problem of poroelasticity. The class is templated on the scalar type
+	of the matrix, coefficientsAssembly being the double precision one.
 
  	Written by FERREIRA, C. A. S.
 
  	Florianópolis, 2019.
 */
 
+#include <chrono>
 #include <iostream>
 #include <math.h>
 #include <string>
@@ -16,11 +18,12 @@
 
 using namespace std;
 
-class coefficientsAssembly
+template<class scalar>
+class basicCoefficientsAssembly
 {
 public:
 	// Class variables
-	vector<vector<double>> coefficientsMatrix;
+	vector<vector<scalar>> coefficientsMatrix;
 	vector<vector<int>> boundaryConditionType;
 	int Nu, Nv, NP, NPM;
 	vector<vector<int>> uDisplacementFVIndex;
@@ -33,9 +36,14 @@ public:
 	vector<vector<int>> verticalFacesStatus;
 	string gridType;
 	string interpScheme;
-	vector<double> sparseCoefficientsRow;
-	vector<double> sparseCoefficientsColumn;
-	vector<double> sparseCoefficientsValue;
+	vector<scalar> sparseCoefficientsRow;
+	vector<scalar> sparseCoefficientsColumn;
+	vector<scalar> sparseCoefficientsValue;
+	vector<scalar> sparseUpdateRow;
+	vector<scalar> sparseUpdateColumn;
+	vector<scalar> sparseUpdateValue;
+	vector<vector<scalar>> shearModulusField;
+	vector<vector<scalar>> permeabilityField;
 
 	// Class functions
 	void resizeLinearProblem();
@@ -43,86 +51,98 @@ public:
 	int getVDisplacementFVPosition(int,int);
 	int getPressureFVPosition(int,int);
 	int getMacroPressureFVPosition(int,int);
-	void assemblyCoefficientsMatrix(double,double,double,double,double,double,double,double,double,
-		double,double);
-	void assemblyXMomentum(double,double,double,double,double);
-	void assemblyYMomentum(double,double,double,double,double);
-	void assemblyContinuity(double,double,double,double,double,double,double,double,double);
-	void addUDisplacementToXMomentum(double,double,double,double);
-	void addVDisplacementToXMomentum(double,double,double,double);
-	void addPressureToXMomentum(double,double);
-	void addBCToXMomentum(double,double,double);
-	void addUDisplacementToYMomentum(double,double,double,double);
-	void addVDisplacementToYMomentum(double,double,double,double);
-	void addPressureToYMomentum(double,double);
-	void addBCToYMomentum(double,double,double);
-	void addTransientToContinuity(double,double,double,double);
-	void addFluidFlowToContinuity(double,double,double,double,double,double,double,double);
-	void addDisplacementToContinuity(double,double,double,double,double,double);
+	void setPropertyFields(vector<vector<scalar>>,vector<vector<scalar>>);
+	bool isInsideCell(int,int);
+	scalar getCellShearModulus(int,int,scalar);
+	scalar getCellLambda(int,int,scalar,scalar);
+	scalar getCellPermeability(int,int,scalar);
+	scalar getCornerShearModulus(int,int,scalar);
+	scalar getFacePermeability(int,int,int,int,scalar);
+	void assemblyCoefficientsMatrix(scalar,scalar,scalar,scalar,scalar,scalar,scalar,scalar,scalar,
+		scalar,scalar);
+	void assemblyXMomentum(scalar,scalar,scalar,scalar,scalar);
+	void assemblyYMomentum(scalar,scalar,scalar,scalar,scalar);
+	void assemblyContinuity(scalar,scalar,scalar,scalar,scalar,scalar,scalar,scalar,scalar);
+	void addUDisplacementToXMomentum(scalar,scalar,scalar,scalar);
+	void addVDisplacementToXMomentum(scalar,scalar,scalar,scalar);
+	void addPressureToXMomentum(scalar,scalar);
+	void addBCToXMomentum(scalar,scalar,scalar);
+	void addUDisplacementToYMomentum(scalar,scalar,scalar,scalar);
+	void addVDisplacementToYMomentum(scalar,scalar,scalar,scalar);
+	void addPressureToYMomentum(scalar,scalar);
+	void addBCToYMomentum(scalar,scalar,scalar);
+	void addTransientToContinuity(scalar,scalar,scalar,scalar);
+	void addFluidFlowToContinuity(scalar,scalar,scalar,scalar,scalar,scalar,scalar,scalar);
+	void addDisplacementToContinuity(scalar,scalar,scalar,scalar,scalar,scalar);
 	void addBCToContinuity();
-	void addStaggeredVDisplacementToXMomentum(double,double,double,double);
-	void addStaggeredPressureToXMomentum(double,double);
-	void addStaggeredUDisplacementToYMomentum(double,double,double,double);
-	void addStaggeredPressureToYMomentum(double,double);
-	void addStaggeredFluidFlowToContinuity(double,double,double,double);
-	void addStaggeredDisplacementToContinuity(double,double,double,double);
-	void addCollocatedFluidFlowToContinuity(double,double,double,double);
-	void addCDSVDisplacementToXMomentum(double,double,double,double);
-	void addCDSPressureToXMomentum(double,double);
-	void addCDSUDisplacementToYMomentum(double,double,double,double);
-	void addCDSPressureToYMomentum(double,double);
-	void addCDSDisplacementToContinuity(double,double,double,double);
-	void addDirichletBCToXMomentum(double,double,double,int);
-	void addDirichletBCToYMomentum(double,double,double,int);
+	void addStaggeredVDisplacementToXMomentum(scalar,scalar,scalar,scalar);
+	void addStaggeredPressureToXMomentum(scalar,scalar);
+	void addStaggeredUDisplacementToYMomentum(scalar,scalar,scalar,scalar);
+	void addStaggeredPressureToYMomentum(scalar,scalar);
+	void addStaggeredFluidFlowToContinuity(scalar,scalar,scalar,scalar);
+	void addStaggeredDisplacementToContinuity(scalar,scalar,scalar,scalar);
+	void addCollocatedFluidFlowToContinuity(scalar,scalar,scalar,scalar);
+	void addCDSVDisplacementToXMomentum(scalar,scalar,scalar,scalar);
+	void addCDSPressureToXMomentum(scalar,scalar);
+	void addCDSUDisplacementToYMomentum(scalar,scalar,scalar,scalar);
+	void addCDSPressureToYMomentum(scalar,scalar);
+	void addCDSDisplacementToContinuity(scalar,scalar,scalar,scalar);
+	void addDirichletBCToXMomentum(scalar,scalar,scalar,int);
+	void addDirichletBCToYMomentum(scalar,scalar,scalar,int);
 	void addDirichletBCToContinuity(int);
-	void add1DPISFluidFlowToContinuity(double,double,double,double,double,double);
-	void addI2DPISFluidFlowToContinuity(double,double,double,double,double);
-	void addI2DPISDisplacementToContinuity(double,double,double,double);
-	void addC2DPISFluidFlowToContinuity(double,double,double,double,double,double);
-	void addC2DPISDisplacementToContinuity(double,double,double,double,double,double);
-	void assemblySparseMatrix(vector<vector<double>>);
-	void assemblyMandelCoefficientsMatrix(double,double,double,double,double);
+	void add1DPISFluidFlowToContinuity(scalar,scalar,scalar,scalar,scalar,scalar);
+	void addI2DPISFluidFlowToContinuity(scalar,scalar,scalar,scalar,scalar);
+	void addI2DPISDisplacementToContinuity(scalar,scalar,scalar,scalar);
+	void addC2DPISFluidFlowToContinuity(scalar,scalar,scalar,scalar,scalar,scalar);
+	void addC2DPISDisplacementToContinuity(scalar,scalar,scalar,scalar,scalar,scalar);
+	void assemblySparseMatrix(const vector<vector<scalar>>&);
+	void assemblyMandelCoefficientsMatrix(scalar,scalar,scalar,scalar,scalar);
 	void addMandelRigidMotion();
 	void increaseMandelCoefficientsMatrixSize();
-	void addMandelStaggeredStressToVDisplacement(double);
-	void addMandelStaggeredStress(double,double,double,double,double);
-	void addMandelCollocatedStressToVDisplacement(double);
-	void addMandelCollocatedStress(double,double,double,double,double);
-	void addStripfootBC(int,double,double);
-	void assemblyDoublePorosityMatrix(double,double,double,double,double,double,double,double,double,double,double,double,double,double,double);
+	void addMandelStaggeredStressToVDisplacement(scalar);
+	void addMandelStaggeredStress(scalar,scalar,scalar,scalar,scalar);
+	void addMandelCollocatedStressToVDisplacement(scalar);
+	void addMandelCollocatedStress(scalar,scalar,scalar,scalar,scalar);
+	void addStripfootBC(int,scalar,scalar);
+	void assemblyStripfootBCUpdate(int,int,scalar,scalar);
+	bool isStripfootDrainedFV(int,int);
+	void assemblyDoublePorosityMatrix(scalar,scalar,scalar,scalar,scalar,scalar,scalar,scalar,scalar,scalar,scalar,scalar,scalar,scalar,scalar);
 	void increaseMacroPorosityCoefficientsMatrixSize();
-	void addMacroPressureToXMomentum(double,double);
-	void addStaggeredMacroPressureToXMomentum(double,double);
-	void addCDSMacroPressureToXMomentum(double,double);
-	void addMacroPressureToYMomentum(double,double);
-	void addStaggeredMacroPressureToYMomentum(double,double);
-	void addCDSMacroPressureToYMomentum(double,double);
-	void addMacroTransientToContinuity(double,double,double,double,double);
-	void addMacroDisplacementToContinuity(double,double,double,double,double,double);
-	void addStaggeredMacroDisplacementToContinuity(double,double,double,double);
-	void addCDSMacroDisplacementToContinuity(double,double,double,double);
-	void addI2DPISMacroDisplacementToContinuity(double,double,double,double);
-	void addMacroFluidFlowToContinuity(double,double,double,double,double,double,double,double,
-		double);
-	void addStaggeredMacroFluidFlowToContinuity(double,double,double,double);
-	void addCollocatedMacroFluidFlowToContinuity(double,double,double,double);
-	void addI2DPISFluidFlowToMicroContinuity(double,double,double,double,double,double);
-	void addLeaktoContinuity(double);
+	void addMacroPressureToXMomentum(scalar,scalar);
+	void addStaggeredMacroPressureToXMomentum(scalar,scalar);
+	void addCDSMacroPressureToXMomentum(scalar,scalar);
+	void addMacroPressureToYMomentum(scalar,scalar);
+	void addStaggeredMacroPressureToYMomentum(scalar,scalar);
+	void addCDSMacroPressureToYMomentum(scalar,scalar);
+	void addMacroTransientToContinuity(scalar,scalar,scalar,scalar,scalar);
+	void addMacroDisplacementToContinuity(scalar,scalar,scalar,scalar,scalar,scalar);
+	void addStaggeredMacroDisplacementToContinuity(scalar,scalar,scalar,scalar);
+	void addCDSMacroDisplacementToContinuity(scalar,scalar,scalar,scalar);
+	void addI2DPISMacroDisplacementToContinuity(scalar,scalar,scalar,scalar);
+	void addMacroFluidFlowToContinuity(scalar,scalar,scalar,scalar,scalar,scalar,scalar,scalar,
+		scalar);
+	void addStaggeredMacroFluidFlowToContinuity(scalar,scalar,scalar,scalar);
+	void addCollocatedMacroFluidFlowToContinuity(scalar,scalar,scalar,scalar);
+	void addI2DPISFluidFlowToMicroContinuity(scalar,scalar,scalar,scalar,scalar,scalar);
+	void addLeaktoContinuity(scalar);
 	void addMacroBCToContinuity();
 	void addMacroDirichletBCToContinuity(int);
-	void assignFakePressure(double,double);
-	void addMacroStripfootBC(int,double,double);
+	void assignFakePressure(scalar,scalar);
+	void addMacroStripfootBC(int,scalar,scalar);
 
 	// Constructor
-	coefficientsAssembly(vector<vector<int>>,int,int,int,vector<vector<int>>,vector<vector<int>>,
+	basicCoefficientsAssembly(vector<vector<int>>,int,int,int,vector<vector<int>>,
 		vector<vector<int>>,vector<vector<int>>,vector<vector<int>>,vector<vector<int>>,
-		vector<vector<int>>,vector<vector<int>>,string,string);
+		vector<vector<int>>,vector<vector<int>>,vector<vector<int>>,string,string);
 
 	// Destructor
-	~coefficientsAssembly();
+	~basicCoefficientsAssembly();
 };
 
-coefficientsAssembly::coefficientsAssembly(vector<vector<int>> bcType, 
+typedef basicCoefficientsAssembly<double> coefficientsAssembly;
+
+template<class scalar>
+basicCoefficientsAssembly<scalar>::basicCoefficientsAssembly(vector<vector<int>> bcType, 
 	int numberOfActiveUDisplacementFV, int numberOfActiveVDisplacementFV,
 	int numberOfActivePressureFV, vector<vector<int>> idU, vector<vector<int>> idV,
 	vector<vector<int>> idP, vector<vector<int>> cooU, vector<vector<int>> cooV,
@@ -148,29 +168,24 @@ coefficientsAssembly::coefficientsAssembly(vector<vector<int>> bcType,
 	resizeLinearProblem();
 }
 
-coefficientsAssembly::~coefficientsAssembly(){}
+template<class scalar>
+basicCoefficientsAssembly<scalar>::~basicCoefficientsAssembly(){}
 
-void coefficientsAssembly::resizeLinearProblem()
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::resizeLinearProblem()
 {
 	int rowNo, colNo;
 
-	// Resize coefficientsMatrix
+	// Resize coefficientsMatrix, each row zeroed by the thread which owns its unknown
 	rowNo=NP+Nv+Nu;
 	colNo=rowNo;
-	coefficientsMatrix.resize(rowNo);
-	for(int i=0; i<rowNo; i++)
-	{
-		coefficientsMatrix[i].resize(colNo);
-		for(int j=0; j<colNo; j++)
-		{
-			coefficientsMatrix[i][j]=0;
-		}
-	}
+	numaPlacement::firstTouch(coefficientsMatrix,rowNo,colNo);
 
 	return;
 }
 
-int coefficientsAssembly::getUDisplacementFVPosition(int x, int y)
+template<class scalar>
+int basicCoefficientsAssembly<scalar>::getUDisplacementFVPosition(int x, int y)
 {
 	int uDisplacementFVPosition;
 
@@ -179,7 +194,8 @@ int coefficientsAssembly::getUDisplacementFVPosition(int x, int y)
 	return uDisplacementFVPosition;
 }
 
-int coefficientsAssembly::getVDisplacementFVPosition(int x, int y)
+template<class scalar>
+int basicCoefficientsAssembly<scalar>::getVDisplacementFVPosition(int x, int y)
 {
 	int vDisplacementFVPosition;
 
@@ -188,7 +204,8 @@ int coefficientsAssembly::getVDisplacementFVPosition(int x, int y)
 	return vDisplacementFVPosition;
 }
 
-int coefficientsAssembly::getPressureFVPosition(int x, int y)
+template<class scalar>
+int basicCoefficientsAssembly<scalar>::getPressureFVPosition(int x, int y)
 {
 	int pressureFVPosition;
 
@@ -197,7 +214,8 @@ int coefficientsAssembly::getPressureFVPosition(int x, int y)
 	return pressureFVPosition;
 }
 
-int coefficientsAssembly::getMacroPressureFVPosition(int x, int y)
+template<class scalar>
+int basicCoefficientsAssembly<scalar>::getMacroPressureFVPosition(int x, int y)
 {
 	int pressureFVPosition;
 
@@ -206,8 +224,84 @@ int coefficientsAssembly::getMacroPressureFVPosition(int x, int y)
 	return pressureFVPosition;
 }
 
-void coefficientsAssembly::assemblyCoefficientsMatrix(double dx, double dy, double dt, double G,
-	double lambda, double alpha, double K, double mu_f, double Q, double rho, double g)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::setPropertyFields(
+	vector<vector<scalar>> myShearModulusField, vector<vector<scalar>> myPermeabilityField)
+{
+	// Fields hold one value per pressure FV, being used by the staggered grid only; empty fields
+	// mean an homogeneous medium
+	shearModulusField=myShearModulusField;
+	permeabilityField=myPermeabilityField;
+
+	return;
+}
+
+template<class scalar>
+bool basicCoefficientsAssembly<scalar>::isInsideCell(int i, int j)
+{
+	return i>=0 && j>=0 && i<pressureFVIndex.size() && j<pressureFVIndex[0].size();
+}
+
+template<class scalar>
+scalar basicCoefficientsAssembly<scalar>::getCellShearModulus(int i, int j, scalar G)
+{
+	if(shearModulusField.empty() || gridType!="staggered" || !isInsideCell(i,j)) return G;
+
+	return shearModulusField[i][j];
+}
+
+template<class scalar>
+scalar basicCoefficientsAssembly<scalar>::getCellLambda(int i, int j, scalar G, scalar lambda)
+{
+	// The drained bulk modulus lambda+2G/3 is kept when G varies
+	if(shearModulusField.empty() || gridType!="staggered" || !isInsideCell(i,j)) return lambda;
+
+	return lambda+2*(G-shearModulusField[i][j])/3;
+}
+
+template<class scalar>
+scalar basicCoefficientsAssembly<scalar>::getCellPermeability(int i, int j, scalar K)
+{
+	if(permeabilityField.empty() || gridType!="staggered" || !isInsideCell(i,j)) return K;
+
+	return permeabilityField[i][j];
+}
+
+template<class scalar>
+scalar basicCoefficientsAssembly<scalar>::getCornerShearModulus(int i, int j, scalar G)
+{
+	// Harmonic mean of the cells sharing the node (i,j) of the pressure grid
+	int cellsNo=0;
+	scalar inverseSum=0;
+
+	if(shearModulusField.empty() || gridType!="staggered") return G;
+
+	for(int a=i-1; a<=i; a++)
+		for(int b=j-1; b<=j; b++)
+			if(isInsideCell(a,b))
+			{
+				inverseSum+=1/shearModulusField[a][b];
+				cellsNo++;
+			}
+
+	return cellsNo/inverseSum;
+}
+
+template<class scalar>
+scalar basicCoefficientsAssembly<scalar>::getFacePermeability(int i1, int j1, int i2, int j2,
+	scalar K)
+{
+	// Harmonic mean of the cells sharing the face
+	if(permeabilityField.empty() || gridType!="staggered") return K;
+	if(!isInsideCell(i2,j2)) return permeabilityField[i1][j1];
+
+	return 2/(1/permeabilityField[i1][j1]+1/permeabilityField[i2][j2]);
+}
+
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::assemblyCoefficientsMatrix(scalar dx, scalar dy,
+	scalar dt, scalar G,
+	scalar lambda, scalar alpha, scalar K, scalar mu_f, scalar Q, scalar rho, scalar g)
 {
 	assemblyXMomentum(dx,dy,G,lambda,alpha);
 	assemblyYMomentum(dx,dy,G,lambda,alpha);
@@ -217,8 +311,10 @@ void coefficientsAssembly::assemblyCoefficientsMatrix(double dx, double dy, doub
 	return;
 }
 
-void coefficientsAssembly::assemblyXMomentum(double dx, double dy, double G, double lambda,
-	double alpha)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::assemblyXMomentum(scalar dx, scalar dy, scalar G,
+	scalar lambda,
+	scalar alpha)
 {	
 	addUDisplacementToXMomentum(dx,dy,G,lambda);
 	addVDisplacementToXMomentum(dx,dy,G,lambda);
@@ -228,8 +324,10 @@ void coefficientsAssembly::assemblyXMomentum(double dx, double dy, double G, dou
 	return;
 }
 
-void coefficientsAssembly::assemblyYMomentum(double dx, double dy, double G, double lambda,
-	double alpha)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::assemblyYMomentum(scalar dx, scalar dy, scalar G,
+	scalar lambda,
+	scalar alpha)
 {	
 	addUDisplacementToYMomentum(dx,dy,G,lambda);
 	addVDisplacementToYMomentum(dx,dy,G,lambda);
@@ -239,8 +337,10 @@ void coefficientsAssembly::assemblyYMomentum(double dx, double dy, double G, dou
 	return;
 }
 
-void coefficientsAssembly::assemblyContinuity(double dx, double dy, double dt, double alpha,
-	double K, double mu_f, double Q, double G, double lambda)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::assemblyContinuity(scalar dx, scalar dy, scalar dt,
+	scalar alpha,
+	scalar K, scalar mu_f, scalar Q, scalar G, scalar lambda)
 {
 	addTransientToContinuity(dx,dy,dt,Q);
 	addFluidFlowToContinuity(dx,dy,dt,K,mu_f,alpha,G,lambda);
@@ -250,13 +350,15 @@ void coefficientsAssembly::assemblyContinuity(double dx, double dy, double dt, d
 	return;
 }
 
-void coefficientsAssembly::addUDisplacementToXMomentum(double dx, double dy, double G,
-	double lambda)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addUDisplacementToXMomentum(scalar dx, scalar dy, scalar G,
+	scalar lambda)
 {
 	int u_P, u_E, u_W, u_N, u_S;
 	int FVCounter;
 	int i, j;
-	double value=1;
+	scalar value=1;
+	scalar G_N, G_S, modulus_E, modulus_W;
 
 	for(FVCounter=0; FVCounter<Nu; FVCounter++)
 	{
@@ -265,14 +367,20 @@ void coefficientsAssembly::addUDisplacementToXMomentum(double dx, double dy, dou
 
 		u_P=getUDisplacementFVPosition(i,j);
 
+		// Moduli of the faces of the control volume, uniform unless property fields are set
+		G_N=getCornerShearModulus(i,j,G);
+		G_S=getCornerShearModulus(i+1,j,G);
+		modulus_E=2*getCellShearModulus(i,j,G)+getCellLambda(i,j,G,lambda);
+		modulus_W=2*getCellShearModulus(i,j-1,G)+getCellLambda(i,j-1,G,lambda);
+
 		if(i==0) // Northern border
 		{
 			u_S=getUDisplacementFVPosition(i+1,j);
 
 			if(j==0 || j==uDisplacementFVIndex[0].size()-1)	value=0.5;
 
-			coefficientsMatrix[u_P][u_S]-=G*(dx/dy)*value;
-			coefficientsMatrix[u_P][u_P]+=G*(dx/dy)*value;
+			coefficientsMatrix[u_P][u_S]-=G_S*(dx/dy)*value;
+			coefficientsMatrix[u_P][u_P]+=G_S*(dx/dy)*value;
 
 			value=1;
 		}
@@ -282,8 +390,8 @@ void coefficientsAssembly::addUDisplacementToXMomentum(double dx, double dy, dou
 
 			if(j==0 || j==uDisplacementFVIndex[0].size()-1) value=0.5;
 
-			coefficientsMatrix[u_P][u_N]-=G*(dx/dy)*value;
-			coefficientsMatrix[u_P][u_P]+=G*(dx/dy)*value;
+			coefficientsMatrix[u_P][u_N]-=G_N*(dx/dy)*value;
+			coefficientsMatrix[u_P][u_P]+=G_N*(dx/dy)*value;
 
 			value=1;
 		}
@@ -294,9 +402,9 @@ void coefficientsAssembly::addUDisplacementToXMomentum(double dx, double dy, dou
 
 			if(j==0 || j==uDisplacementFVIndex[0].size()-1) value=0.5;
 
-			coefficientsMatrix[u_P][u_N]-=G*(dx/dy)*value;
-			coefficientsMatrix[u_P][u_S]-=G*(dx/dy)*value;
-			coefficientsMatrix[u_P][u_P]+=2*G*(dx/dy)*value;
+			coefficientsMatrix[u_P][u_N]-=G_N*(dx/dy)*value;
+			coefficientsMatrix[u_P][u_S]-=G_S*(dx/dy)*value;
+			coefficientsMatrix[u_P][u_P]+=(G_N+G_S)*(dx/dy)*value;
 
 			value=1;
 		}
@@ -307,8 +415,8 @@ void coefficientsAssembly::addUDisplacementToXMomentum(double dx, double dy, dou
 
 			if(i==0 || i==uDisplacementFVIndex.size()-1) if(gridType!="staggered") value=0.5;
 
-			coefficientsMatrix[u_P][u_E]-=(2*G+lambda)*(dy/dx)*value;
-			coefficientsMatrix[u_P][u_P]+=(2*G+lambda)*(dy/dx)*value;
+			coefficientsMatrix[u_P][u_E]-=modulus_E*(dy/dx)*value;
+			coefficientsMatrix[u_P][u_P]+=modulus_E*(dy/dx)*value;
 
 			value=1;
 		}
@@ -318,8 +426,8 @@ void coefficientsAssembly::addUDisplacementToXMomentum(double dx, double dy, dou
 
 			if(i==0 || i==uDisplacementFVIndex.size()-1) if(gridType!="staggered") value=0.5;
 
-			coefficientsMatrix[u_P][u_W]-=(2*G+lambda)*(dy/dx)*value;
-			coefficientsMatrix[u_P][u_P]+=(2*G+lambda)*(dy/dx)*value;
+			coefficientsMatrix[u_P][u_W]-=modulus_W*(dy/dx)*value;
+			coefficientsMatrix[u_P][u_P]+=modulus_W*(dy/dx)*value;
 
 			value=1;
 		}
@@ -330,9 +438,9 @@ void coefficientsAssembly::addUDisplacementToXMomentum(double dx, double dy, dou
 
 			if(i==0 || i==uDisplacementFVIndex.size()-1) if(gridType!="staggered") value=0.5;
 
-			coefficientsMatrix[u_P][u_E]-=(2*G+lambda)*(dy/dx)*value;
-			coefficientsMatrix[u_P][u_W]-=(2*G+lambda)*(dy/dx)*value;
-			coefficientsMatrix[u_P][u_P]+=2*(2*G+lambda)*(dy/dx)*value;
+			coefficientsMatrix[u_P][u_E]-=modulus_E*(dy/dx)*value;
+			coefficientsMatrix[u_P][u_W]-=modulus_W*(dy/dx)*value;
+			coefficientsMatrix[u_P][u_P]+=(modulus_E+modulus_W)*(dy/dx)*value;
 
 			value=1;
 		}
@@ -341,8 +449,9 @@ void coefficientsAssembly::addUDisplacementToXMomentum(double dx, double dy, dou
 	return;
 }
 
-void coefficientsAssembly::addVDisplacementToXMomentum(double dx, double dy, double G,
-	double lambda)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addVDisplacementToXMomentum(scalar dx, scalar dy, scalar G,
+	scalar lambda)
 {
 	if(gridType=="staggered") addStaggeredVDisplacementToXMomentum(dx,dy,G,lambda);
 	else if(gridType=="collocated")
@@ -356,7 +465,8 @@ void coefficientsAssembly::addVDisplacementToXMomentum(double dx, double dy, dou
 	return;
 }
 
-void coefficientsAssembly::addPressureToXMomentum(double dy, double alpha)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addPressureToXMomentum(scalar dy, scalar alpha)
 {
 	if(gridType=="staggered") addStaggeredPressureToXMomentum(dy,alpha);
 	else if(gridType=="collocated")
@@ -370,7 +480,8 @@ void coefficientsAssembly::addPressureToXMomentum(double dy, double alpha)
 	return;
 }
 
-void coefficientsAssembly::addBCToXMomentum(double dx, double dy, double G)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addBCToXMomentum(scalar dx, scalar dy, scalar G)
 {
 	addDirichletBCToXMomentum(dx,dy,G,0);
 	addDirichletBCToXMomentum(dx,dy,G,2);
@@ -380,8 +491,9 @@ void coefficientsAssembly::addBCToXMomentum(double dx, double dy, double G)
 	return;
 }
 
-void coefficientsAssembly::addUDisplacementToYMomentum(double dx, double dy, double G,
-	double lambda)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addUDisplacementToYMomentum(scalar dx, scalar dy, scalar G,
+	scalar lambda)
 {
 	if(gridType=="staggered") addStaggeredUDisplacementToYMomentum(dx,dy,G,lambda);
 	else if(gridType=="collocated")
@@ -395,13 +507,15 @@ void coefficientsAssembly::addUDisplacementToYMomentum(double dx, double dy, dou
 	return;
 }
 
-void coefficientsAssembly::addVDisplacementToYMomentum(double dx, double dy, double G,
-	double lambda)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addVDisplacementToYMomentum(scalar dx, scalar dy, scalar G,
+	scalar lambda)
 {
 	int v_P, v_E, v_W, v_N, v_S;
 	int FVCounter;
 	int i, j;
-	double value=1;
+	scalar value=1;
+	scalar G_E, G_W, modulus_N, modulus_S;
 
 	for(FVCounter=0; FVCounter<Nv; FVCounter++)
 	{
@@ -410,14 +524,20 @@ void coefficientsAssembly::addVDisplacementToYMomentum(double dx, double dy, dou
 
 		v_P=getVDisplacementFVPosition(i,j);
 
+		// Moduli of the faces of the control volume, uniform unless property fields are set
+		G_E=getCornerShearModulus(i,j+1,G);
+		G_W=getCornerShearModulus(i,j,G);
+		modulus_N=2*getCellShearModulus(i-1,j,G)+getCellLambda(i-1,j,G,lambda);
+		modulus_S=2*getCellShearModulus(i,j,G)+getCellLambda(i,j,G,lambda);
+
 		if(i==0) // Northern border
 		{
 			v_S=getVDisplacementFVPosition(i+1,j);
 
 			if(j==0 || j==vDisplacementFVIndex[0].size()-1) if(gridType!="staggered") value=0.5;
 
-			coefficientsMatrix[v_P][v_S]-=(2*G+lambda)*(dx/dy)*value;
-			coefficientsMatrix[v_P][v_P]+=(2*G+lambda)*(dx/dy)*value;
+			coefficientsMatrix[v_P][v_S]-=modulus_S*(dx/dy)*value;
+			coefficientsMatrix[v_P][v_P]+=modulus_S*(dx/dy)*value;
 
 			value=1;
 		}
@@ -427,8 +547,8 @@ void coefficientsAssembly::addVDisplacementToYMomentum(double dx, double dy, dou
 
 			if(j==0 || j==vDisplacementFVIndex[0].size()-1) if(gridType!="staggered") value=0.5;
 
-			coefficientsMatrix[v_P][v_N]-=(2*G+lambda)*(dx/dy)*value;
-			coefficientsMatrix[v_P][v_P]+=(2*G+lambda)*(dx/dy)*value;
+			coefficientsMatrix[v_P][v_N]-=modulus_N*(dx/dy)*value;
+			coefficientsMatrix[v_P][v_P]+=modulus_N*(dx/dy)*value;
 
 			value=1;
 		}
@@ -439,9 +559,9 @@ void coefficientsAssembly::addVDisplacementToYMomentum(double dx, double dy, dou
 
 			if(j==0 || j==vDisplacementFVIndex[0].size()-1) if(gridType!="staggered") value=0.5;
 
-			coefficientsMatrix[v_P][v_N]-=(2*G+lambda)*(dx/dy)*value;
-			coefficientsMatrix[v_P][v_S]-=(2*G+lambda)*(dx/dy)*value;
-			coefficientsMatrix[v_P][v_P]+=2*(2*G+lambda)*(dx/dy)*value;
+			coefficientsMatrix[v_P][v_N]-=modulus_N*(dx/dy)*value;
+			coefficientsMatrix[v_P][v_S]-=modulus_S*(dx/dy)*value;
+			coefficientsMatrix[v_P][v_P]+=(modulus_N+modulus_S)*(dx/dy)*value;
 
 			value=1;
 		}
@@ -452,8 +572,8 @@ void coefficientsAssembly::addVDisplacementToYMomentum(double dx, double dy, dou
 
 			if(i==0 || i==vDisplacementFVIndex.size()-1) value=0.5;
 
-			coefficientsMatrix[v_P][v_E]-=G*(dy/dx)*value;
-			coefficientsMatrix[v_P][v_P]+=G*(dy/dx)*value;
+			coefficientsMatrix[v_P][v_E]-=G_E*(dy/dx)*value;
+			coefficientsMatrix[v_P][v_P]+=G_E*(dy/dx)*value;
 
 			value=1;
 		}
@@ -463,8 +583,8 @@ void coefficientsAssembly::addVDisplacementToYMomentum(double dx, double dy, dou
 
 			if(i==0 || i==vDisplacementFVIndex.size()-1) value=0.5;
 
-			coefficientsMatrix[v_P][v_W]-=G*(dy/dx)*value;
-			coefficientsMatrix[v_P][v_P]+=G*(dy/dx)*value;
+			coefficientsMatrix[v_P][v_W]-=G_W*(dy/dx)*value;
+			coefficientsMatrix[v_P][v_P]+=G_W*(dy/dx)*value;
 
 			value=1;
 		}
@@ -475,9 +595,9 @@ void coefficientsAssembly::addVDisplacementToYMomentum(double dx, double dy, dou
 
 			if(i==0 || i==vDisplacementFVIndex.size()-1) value=0.5;
 
-			coefficientsMatrix[v_P][v_E]-=G*(dy/dx)*value;
-			coefficientsMatrix[v_P][v_W]-=G*(dy/dx)*value;
-			coefficientsMatrix[v_P][v_P]+=2*G*(dy/dx)*value;
+			coefficientsMatrix[v_P][v_E]-=G_E*(dy/dx)*value;
+			coefficientsMatrix[v_P][v_W]-=G_W*(dy/dx)*value;
+			coefficientsMatrix[v_P][v_P]+=(G_E+G_W)*(dy/dx)*value;
 
 			value=1;
 		}
@@ -486,7 +606,8 @@ void coefficientsAssembly::addVDisplacementToYMomentum(double dx, double dy, dou
 	return;
 }
 
-void coefficientsAssembly::addPressureToYMomentum(double dx, double alpha)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addPressureToYMomentum(scalar dx, scalar alpha)
 {
 	if(gridType=="staggered") addStaggeredPressureToYMomentum(dx,alpha);
 	else if(gridType=="collocated")
@@ -500,7 +621,8 @@ void coefficientsAssembly::addPressureToYMomentum(double dx, double alpha)
 	return;
 }
 
-void coefficientsAssembly::addBCToYMomentum(double dx, double dy, double G)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addBCToYMomentum(scalar dx, scalar dy, scalar G)
 {
 	addDirichletBCToYMomentum(dx,dy,G,1);
 	addDirichletBCToYMomentum(dx,dy,G,3);
@@ -510,12 +632,14 @@ void coefficientsAssembly::addBCToYMomentum(double dx, double dy, double G)
 	return;
 }
 
-void coefficientsAssembly::addTransientToContinuity(double dx, double dy, double dt, double Q)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addTransientToContinuity(scalar dx, scalar dy, scalar dt,
+	scalar Q)
 {	
 	int P_P;
 	int FVCounter;
 	int i, j;
-	double Mp=(1/Q)*(dx*dy/dt);
+	scalar Mp=(1/Q)*(dx*dy/dt);
 	int borderCounter=0;
 
 	for(FVCounter=0; FVCounter<NP; FVCounter++)
@@ -541,8 +665,10 @@ void coefficientsAssembly::addTransientToContinuity(double dx, double dy, double
 	}
 }
 
-void coefficientsAssembly::addFluidFlowToContinuity(double dx, double dy, double dt, double K,
-	double mu_f, double alpha, double G, double lambda)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addFluidFlowToContinuity(scalar dx, scalar dy, scalar dt,
+	scalar K,
+	scalar mu_f, scalar alpha, scalar G, scalar lambda)
 {
 	if(gridType=="staggered") addStaggeredFluidFlowToContinuity(dx,dy,K,mu_f);
 	else if(gridType=="collocated") 
@@ -557,8 +683,9 @@ void coefficientsAssembly::addFluidFlowToContinuity(double dx, double dy, double
 	return;
 }
 
-void coefficientsAssembly::addDisplacementToContinuity(double dx, double dy, double dt,
-	double alpha, double G, double lambda)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addDisplacementToContinuity(scalar dx, scalar dy, scalar dt,
+	scalar alpha, scalar G, scalar lambda)
 {
 	if(gridType=="staggered") addStaggeredDisplacementToContinuity(dx,dy,dt,alpha);
 	else if(gridType=="collocated")
@@ -572,7 +699,8 @@ void coefficientsAssembly::addDisplacementToContinuity(double dx, double dy, dou
 	return;
 }
 
-void coefficientsAssembly::addBCToContinuity()
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addBCToContinuity()
 {
 	if(gridType=="collocated")
 		for(int counter=0; counter<4; counter++)
@@ -581,13 +709,16 @@ void coefficientsAssembly::addBCToContinuity()
 	return;
 }
 
-void coefficientsAssembly::addStaggeredVDisplacementToXMomentum(double dx, double dy, double G,
-	double lambda)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addStaggeredVDisplacementToXMomentum(scalar dx, scalar dy,
+	scalar G,
+	scalar lambda)
 {
 	int u_P;
 	int v_P, v_W, v_S, v_SW;
 	int FVCounter;
 	int i, j;
+	scalar G_N, G_S, lambda_E, lambda_W;
 
 	for(FVCounter=0; FVCounter<Nu; FVCounter++)
 	{
@@ -596,21 +727,27 @@ void coefficientsAssembly::addStaggeredVDisplacementToXMomentum(double dx, doubl
 
 		u_P=getUDisplacementFVPosition(i,j);
 
+		// Lambda at the cell centres east and west of the FV and G at its corners
+		G_N=getCornerShearModulus(i,j,G);
+		G_S=getCornerShearModulus(i+1,j,G);
+		lambda_E=getCellLambda(i,j,G,lambda);
+		lambda_W=getCellLambda(i,j-1,G,lambda);
+
 		if(j==0) // Western border
 		{
 			v_P=getVDisplacementFVPosition(i,j);
 			v_S=getVDisplacementFVPosition(i+1,j);
 
-			coefficientsMatrix[u_P][v_P]-=lambda;
-			coefficientsMatrix[u_P][v_S]-=-lambda;
+			coefficientsMatrix[u_P][v_P]-=lambda_E;
+			coefficientsMatrix[u_P][v_S]-=-lambda_E;
 		}
 		else if(j==uDisplacementFVIndex[0].size()-1) // Eastern border
 		{
 			v_W=getVDisplacementFVPosition(i,j-1);
 			v_SW=getVDisplacementFVPosition(i+1,j-1);
 
-			coefficientsMatrix[u_P][v_W]-=-lambda;
-			coefficientsMatrix[u_P][v_SW]-=lambda;
+			coefficientsMatrix[u_P][v_W]-=-lambda_W;
+			coefficientsMatrix[u_P][v_SW]-=lambda_W;
 		}
 		else
 		{
@@ -621,10 +758,10 @@ void coefficientsAssembly::addStaggeredVDisplacementToXMomentum(double dx, doubl
 				v_S=getVDisplacementFVPosition(i+1,j);
 				v_SW=getVDisplacementFVPosition(i+1,j-1);
 
-				coefficientsMatrix[u_P][v_P]-=lambda;
-				coefficientsMatrix[u_P][v_W]-=-lambda;
-				coefficientsMatrix[u_P][v_S]-=-G-lambda;
-				coefficientsMatrix[u_P][v_SW]-=G+lambda;
+				coefficientsMatrix[u_P][v_P]-=lambda_E;
+				coefficientsMatrix[u_P][v_W]-=-lambda_W;
+				coefficientsMatrix[u_P][v_S]-=-G_S-lambda_E;
+				coefficientsMatrix[u_P][v_SW]-=G_S+lambda_W;
 			}
 			else if(i==uDisplacementFVIndex.size()-1) // Southern border
 			{
@@ -633,10 +770,10 @@ void coefficientsAssembly::addStaggeredVDisplacementToXMomentum(double dx, doubl
 				v_S=getVDisplacementFVPosition(i+1,j);
 				v_SW=getVDisplacementFVPosition(i+1,j-1);
 
-				coefficientsMatrix[u_P][v_P]-=G+lambda;
-				coefficientsMatrix[u_P][v_W]-=-G-lambda;
-				coefficientsMatrix[u_P][v_S]-=-lambda;
-				coefficientsMatrix[u_P][v_SW]-=lambda;
+				coefficientsMatrix[u_P][v_P]-=G_N+lambda_E;
+				coefficientsMatrix[u_P][v_W]-=-G_N-lambda_W;
+				coefficientsMatrix[u_P][v_S]-=-lambda_E;
+				coefficientsMatrix[u_P][v_SW]-=lambda_W;
 			}	
 			else
 			{
@@ -645,10 +782,10 @@ void coefficientsAssembly::addStaggeredVDisplacementToXMomentum(double dx, doubl
 				v_S=getVDisplacementFVPosition(i+1,j);
 				v_SW=getVDisplacementFVPosition(i+1,j-1);
 
-				coefficientsMatrix[u_P][v_P]-=G+lambda;
-				coefficientsMatrix[u_P][v_W]-=-G-lambda;
-				coefficientsMatrix[u_P][v_S]-=-G-lambda;
-				coefficientsMatrix[u_P][v_SW]-=G+lambda;
+				coefficientsMatrix[u_P][v_P]-=G_N+lambda_E;
+				coefficientsMatrix[u_P][v_W]-=-G_N-lambda_W;
+				coefficientsMatrix[u_P][v_S]-=-G_S-lambda_E;
+				coefficientsMatrix[u_P][v_SW]-=G_S+lambda_W;
 			}
 		}
 	}
@@ -656,7 +793,8 @@ void coefficientsAssembly::addStaggeredVDisplacementToXMomentum(double dx, doubl
 	return;
 }
 
-void coefficientsAssembly::addStaggeredPressureToXMomentum(double dy, double alpha)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addStaggeredPressureToXMomentum(scalar dy, scalar alpha)
 {
 	int u_P;
 	int P_P, P_W;
@@ -695,13 +833,16 @@ void coefficientsAssembly::addStaggeredPressureToXMomentum(double dy, double alp
 	return;
 }
 
-void coefficientsAssembly::addStaggeredUDisplacementToYMomentum(double dx, double dy, double G,
-	double lambda)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addStaggeredUDisplacementToYMomentum(scalar dx, scalar dy,
+	scalar G,
+	scalar lambda)
 {
 	int u_P, u_E, u_N, u_NE;
 	int v_P;
 	int FVCounter;
 	int i, j;
+	scalar G_E, G_W, lambda_N, lambda_S;
 
 	for(FVCounter=0; FVCounter<Nv; FVCounter++)
 	{
@@ -710,21 +851,27 @@ void coefficientsAssembly::addStaggeredUDisplacementToYMomentum(double dx, doubl
 
 		v_P=getVDisplacementFVPosition(i,j);
 
+		// Lambda at the cell centres north and south of the FV and G at its corners
+		G_E=getCornerShearModulus(i,j+1,G);
+		G_W=getCornerShearModulus(i,j,G);
+		lambda_N=getCellLambda(i-1,j,G,lambda);
+		lambda_S=getCellLambda(i,j,G,lambda);
+
 		if(i==0) // Northern border
 		{
 			u_P=getUDisplacementFVPosition(i,j);
 			u_E=getUDisplacementFVPosition(i,j+1);
 
-			coefficientsMatrix[v_P][u_P]-=lambda;
-			coefficientsMatrix[v_P][u_E]-=-lambda;
+			coefficientsMatrix[v_P][u_P]-=lambda_S;
+			coefficientsMatrix[v_P][u_E]-=-lambda_S;
 		}
 		else if(i==vDisplacementFVIndex.size()-1) // Southern border
 		{
 			u_N=getUDisplacementFVPosition(i-1,j);
 			u_NE=getUDisplacementFVPosition(i-1,j+1);
 
-			coefficientsMatrix[v_P][u_N]-=-lambda;
-			coefficientsMatrix[v_P][u_NE]-=lambda;
+			coefficientsMatrix[v_P][u_N]-=-lambda_N;
+			coefficientsMatrix[v_P][u_NE]-=lambda_N;
 		}
 		else
 		{
@@ -735,10 +882,10 @@ void coefficientsAssembly::addStaggeredUDisplacementToYMomentum(double dx, doubl
 				u_N=getUDisplacementFVPosition(i-1,j);
 				u_NE=getUDisplacementFVPosition(i-1,j+1);
 
-				coefficientsMatrix[v_P][u_P]-=lambda;
-				coefficientsMatrix[v_P][u_E]-=-G-lambda;
-				coefficientsMatrix[v_P][u_N]-=-lambda;
-				coefficientsMatrix[v_P][u_NE]-=G+lambda;
+				coefficientsMatrix[v_P][u_P]-=lambda_S;
+				coefficientsMatrix[v_P][u_E]-=-G_E-lambda_S;
+				coefficientsMatrix[v_P][u_N]-=-lambda_N;
+				coefficientsMatrix[v_P][u_NE]-=G_E+lambda_N;
 			}
 			else if(j==vDisplacementFVIndex[0].size()-1) // Eastern border
 			{
@@ -747,10 +894,10 @@ void coefficientsAssembly::addStaggeredUDisplacementToYMomentum(double dx, doubl
 				u_N=getUDisplacementFVPosition(i-1,j);
 				u_NE=getUDisplacementFVPosition(i-1,j+1);
 
-				coefficientsMatrix[v_P][u_P]-=G+lambda;
-				coefficientsMatrix[v_P][u_E]-=-lambda;
-				coefficientsMatrix[v_P][u_N]-=-G-lambda;
-				coefficientsMatrix[v_P][u_NE]-=lambda;
+				coefficientsMatrix[v_P][u_P]-=G_W+lambda_S;
+				coefficientsMatrix[v_P][u_E]-=-lambda_S;
+				coefficientsMatrix[v_P][u_N]-=-G_W-lambda_N;
+				coefficientsMatrix[v_P][u_NE]-=lambda_N;
 			}
 			else
 			{
@@ -759,10 +906,10 @@ void coefficientsAssembly::addStaggeredUDisplacementToYMomentum(double dx, doubl
 				u_N=getUDisplacementFVPosition(i-1,j);
 				u_NE=getUDisplacementFVPosition(i-1,j+1);
 
-				coefficientsMatrix[v_P][u_P]-=G+lambda;
-				coefficientsMatrix[v_P][u_E]-=-G-lambda;
-				coefficientsMatrix[v_P][u_N]-=-G-lambda;
-				coefficientsMatrix[v_P][u_NE]-=G+lambda;
+				coefficientsMatrix[v_P][u_P]-=G_W+lambda_S;
+				coefficientsMatrix[v_P][u_E]-=-G_E-lambda_S;
+				coefficientsMatrix[v_P][u_N]-=-G_W-lambda_N;
+				coefficientsMatrix[v_P][u_NE]-=G_E+lambda_N;
 			}
 		}
 	}
@@ -770,7 +917,8 @@ void coefficientsAssembly::addStaggeredUDisplacementToYMomentum(double dx, doubl
 	return;
 }
 
-void coefficientsAssembly::addStaggeredPressureToYMomentum(double dx, double alpha)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addStaggeredPressureToYMomentum(scalar dx, scalar alpha)
 {
 	int v_P;
 	int P_P, P_N;
@@ -809,13 +957,16 @@ void coefficientsAssembly::addStaggeredPressureToYMomentum(double dx, double alp
 	return;
 }
 
-void coefficientsAssembly::addStaggeredFluidFlowToContinuity(double dx, double dy, double K,
-	double mu_f)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addStaggeredFluidFlowToContinuity(scalar dx, scalar dy,
+	scalar K,
+	scalar mu_f)
 {
 	int P_P, P_E, P_W, P_N, P_S;
 	int FVCounter;
 	int i, j;
 	int bcType;
+	scalar K_P, K_E, K_W, K_N, K_S;
 
 	for(FVCounter=0; FVCounter<NP; FVCounter++)
 	{
@@ -824,72 +975,81 @@ void coefficientsAssembly::addStaggeredFluidFlowToContinuity(double dx, double d
 
 		P_P=getPressureFVPosition(i,j);
 
+		// Permeabilities of the faces, harmonic means between neighbouring cells
+		K_P=getCellPermeability(i,j,K);
+		K_N=getFacePermeability(i,j,i-1,j,K);
+		K_S=getFacePermeability(i,j,i+1,j,K);
+		K_E=getFacePermeability(i,j,i,j+1,K);
+		K_W=getFacePermeability(i,j,i,j-1,K);
+
 		if(i==0) // Northern border
 		{
 			P_S=getPressureFVPosition(i+1,j);
 
-			coefficientsMatrix[P_P][P_S]-=(K/mu_f)*(dx/dy);
-			coefficientsMatrix[P_P][P_P]+=(K/mu_f)*(dx/dy);
+			coefficientsMatrix[P_P][P_S]-=(K_S/mu_f)*(dx/dy);
+			coefficientsMatrix[P_P][P_P]+=(K_S/mu_f)*(dx/dy);
 
 			bcType=boundaryConditionType[0][2];
-			if(bcType==1) coefficientsMatrix[P_P][P_P]+=2*(K/mu_f)*(dx/dy);
+			if(bcType==1) coefficientsMatrix[P_P][P_P]+=2*(K_P/mu_f)*(dx/dy);
 		}
 		else if(i==pressureFVIndex.size()-1) // Southern border
 		{
 			P_N=getPressureFVPosition(i-1,j);
 
-			coefficientsMatrix[P_P][P_N]-=(K/mu_f)*(dx/dy);
-			coefficientsMatrix[P_P][P_P]+=(K/mu_f)*(dx/dy);
+			coefficientsMatrix[P_P][P_N]-=(K_N/mu_f)*(dx/dy);
+			coefficientsMatrix[P_P][P_P]+=(K_N/mu_f)*(dx/dy);
 
 			bcType=boundaryConditionType[2][2];
-			if(bcType==1) coefficientsMatrix[P_P][P_P]+=2*(K/mu_f)*(dx/dy);
+			if(bcType==1) coefficientsMatrix[P_P][P_P]+=2*(K_P/mu_f)*(dx/dy);
 		}
 		else
 		{
 			P_N=getPressureFVPosition(i-1,j);
 			P_S=getPressureFVPosition(i+1,j);
 
-			coefficientsMatrix[P_P][P_N]-=(K/mu_f)*(dx/dy);
-			coefficientsMatrix[P_P][P_S]-=(K/mu_f)*(dx/dy);
-			coefficientsMatrix[P_P][P_P]+=2*(K/mu_f)*(dx/dy);
+			coefficientsMatrix[P_P][P_N]-=(K_N/mu_f)*(dx/dy);
+			coefficientsMatrix[P_P][P_S]-=(K_S/mu_f)*(dx/dy);
+			coefficientsMatrix[P_P][P_P]+=(K_N/mu_f+K_S/mu_f)*(dx/dy);
 		}
 
 		if(j==0) // Western border
 		{
 			P_E=getPressureFVPosition(i,j+1);
 
-			coefficientsMatrix[P_P][P_E]-=(K/mu_f)*(dy/dx);
-			coefficientsMatrix[P_P][P_P]+=(K/mu_f)*(dy/dx);
+			coefficientsMatrix[P_P][P_E]-=(K_E/mu_f)*(dy/dx);
+			coefficientsMatrix[P_P][P_P]+=(K_E/mu_f)*(dy/dx);
 
 			bcType=boundaryConditionType[1][2];
-			if(bcType==1) coefficientsMatrix[P_P][P_P]+=2*(K/mu_f)*(dy/dx);
+			if(bcType==1) coefficientsMatrix[P_P][P_P]+=2*(K_P/mu_f)*(dy/dx);
 		}
 		else if(j==pressureFVIndex[0].size()-1) // Eastern border
 		{
 			P_W=getPressureFVPosition(i,j-1);
 
-			coefficientsMatrix[P_P][P_W]-=(K/mu_f)*(dy/dx);
-			coefficientsMatrix[P_P][P_P]+=(K/mu_f)*(dy/dx);
+			coefficientsMatrix[P_P][P_W]-=(K_W/mu_f)*(dy/dx);
+			coefficientsMatrix[P_P][P_P]+=(K_W/mu_f)*(dy/dx);
 
 			bcType=boundaryConditionType[3][2];
-			if(bcType==1) coefficientsMatrix[P_P][P_P]+=2*(K/mu_f)*(dy/dx);
+			if(bcType==1) coefficientsMatrix[P_P][P_P]+=2*(K_P/mu_f)*(dy/dx);
 		}
 		else
 		{
 			P_E=getPressureFVPosition(i,j+1);
 			P_W=getPressureFVPosition(i,j-1);
 
-			coefficientsMatrix[P_P][P_E]-=(K/mu_f)*(dy/dx);
-			coefficientsMatrix[P_P][P_W]-=(K/mu_f)*(dy/dx);
-			coefficientsMatrix[P_P][P_P]+=2*(K/mu_f)*(dy/dx);
+			coefficientsMatrix[P_P][P_E]-=(K_E/mu_f)*(dy/dx);
+			coefficientsMatrix[P_P][P_W]-=(K_W/mu_f)*(dy/dx);
+			coefficientsMatrix[P_P][P_P]+=(K_E/mu_f+K_W/mu_f)*(dy/dx);
 		}
 	}
 
 	return;
 }
 
-void coefficientsAssembly::addStaggeredDisplacementToContinuity(double dx, double dy, double dt,
-	double alpha)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addStaggeredDisplacementToContinuity(scalar dx, scalar dy,
+	scalar dt,
+	scalar alpha)
 {
 	int u_P, u_E;
 	int v_P, v_S;
@@ -917,13 +1077,15 @@ void coefficientsAssembly::addStaggeredDisplacementToContinuity(double dx, doubl
 	return;
 }
 
-void coefficientsAssembly::addCollocatedFluidFlowToContinuity(double dx, double dy, double K,
-	double mu_f)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addCollocatedFluidFlowToContinuity(scalar dx, scalar dy,
+	scalar K,
+	scalar mu_f)
 {
 	int P_P, P_E, P_W, P_N, P_S;
 	int FVCounter;
 	int i, j;
-	double value=1;
+	scalar value=1;
 
 	for(FVCounter=0; FVCounter<NP; FVCounter++)
 	{
@@ -1008,8 +1170,10 @@ void coefficientsAssembly::addCollocatedFluidFlowToContinuity(double dx, double
 	return;
 }
 
-void coefficientsAssembly::addCDSVDisplacementToXMomentum(double dx, double dy, double G,
-	double lambda)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addCDSVDisplacementToXMomentum(scalar dx, scalar dy,
+	scalar G,
+	scalar lambda)
 {
 	int u_P;
 	int v_P, v_E, v_W, v_N, v_S, v_NE, v_NW, v_SE, v_SW;
@@ -1146,13 +1310,14 @@ void coefficientsAssembly::addCDSVDisplacementToXMomentum(double dx, double dy,
 	return;
 }
 
-void coefficientsAssembly::addCDSPressureToXMomentum(double dy, double alpha)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addCDSPressureToXMomentum(scalar dy, scalar alpha)
 {
 	int u_P;
 	int P_P, P_E, P_W;
 	int FVCounter;
 	int i, j;
-	double value=1;
+	scalar value=1;
 	
 	for(FVCounter=0; FVCounter<Nu; FVCounter++)
 	{	
@@ -1202,8 +1367,10 @@ void coefficientsAssembly::addCDSPressureToXMomentum(double dy, double alpha)
 	return;
 }
 
-void coefficientsAssembly::addCDSUDisplacementToYMomentum(double dx, double dy, double G,
-	double lambda)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addCDSUDisplacementToYMomentum(scalar dx, scalar dy,
+	scalar G,
+	scalar lambda)
 {
 	int v_P;
 	int u_P, u_E, u_W, u_N, u_S, u_NE, u_NW, u_SE, u_SW;
@@ -1340,13 +1507,14 @@ void coefficientsAssembly::addCDSUDisplacementToYMomentum(double dx, double dy,
 	return;
 }
 
-void coefficientsAssembly::addCDSPressureToYMomentum(double dx, double alpha)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addCDSPressureToYMomentum(scalar dx, scalar alpha)
 {
 	int v_P;
 	int P_P, P_N, P_S;
 	int FVCounter;
 	int i, j;
-	double value=1;
+	scalar value=1;
 
 	for(FVCounter=0; FVCounter<Nv; FVCounter++)
 	{
@@ -1396,15 +1564,17 @@ void coefficientsAssembly::addCDSPressureToYMomentum(double dx, double alpha)
 	return;
 }
 
-void coefficientsAssembly::addCDSDisplacementToContinuity(double dx, double dy, double dt,
-	double alpha)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addCDSDisplacementToContinuity(scalar dx, scalar dy,
+	scalar dt,
+	scalar alpha)
 {
 	int P_P;
 	int u_P, u_E, u_W;
 	int v_P, v_N, v_S;
 	int FVCounter;
 	int i, j;
-	double value=1;
+	scalar value=1;
 
 	for(FVCounter=0; FVCounter<NP; FVCounter++)
 	{
@@ -1491,7 +1661,9 @@ void coefficientsAssembly::addCDSDisplacementToContinuity(double dx, double dy,
 	return;
 }
 
-void coefficientsAssembly::addDirichletBCToXMomentum(double dx, double dy, double G, int counter)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addDirichletBCToXMomentum(scalar dx, scalar dy, scalar G,
+	int counter)
 {
 	int u_P;
 	int bcType;
@@ -1510,7 +1682,7 @@ void coefficientsAssembly::addDirichletBCToXMomentum(double dx, double dy, doubl
 
 					if(gridType=="staggered")
 					{
-						coefficientsMatrix[u_P][u_P]+=2*G*(dx/dy);
+						coefficientsMatrix[u_P][u_P]+=2*getCornerShearModulus(0,j,G)*(dx/dy);
 					}
 					else if(gridType=="collocated")
 					{
@@ -1537,7 +1709,8 @@ void coefficientsAssembly::addDirichletBCToXMomentum(double dx, double dy, doubl
 
 					if(gridType=="staggered")
 					{
-						coefficientsMatrix[u_P][u_P]+=2*G*(dx/dy);
+						coefficientsMatrix[u_P][u_P]+=2*getCornerShearModulus(
+							uDisplacementFVIndex.size(),j,G)*(dx/dy);
 					}					
 					else if(gridType=="collocated")
 					{
@@ -1562,7 +1735,9 @@ void coefficientsAssembly::addDirichletBCToXMomentum(double dx, double dy, doubl
 	return;
 }
 
-void coefficientsAssembly::addDirichletBCToYMomentum(double dx, double dy, double G, int counter)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addDirichletBCToYMomentum(scalar dx, scalar dy, scalar G,
+	int counter)
 {
 	int v_P;
 	int bcType;
@@ -1591,7 +1766,7 @@ void coefficientsAssembly::addDirichletBCToYMomentum(double dx, double dy, doubl
 
 					if(gridType=="staggered")
 					{
-						coefficientsMatrix[v_P][v_P]+=2*G*(dy/dx);
+						coefficientsMatrix[v_P][v_P]+=2*getCornerShearModulus(i,0,G)*(dy/dx);
 					}
 					else if(gridType=="collocated")
 					{
@@ -1618,7 +1793,8 @@ void coefficientsAssembly::addDirichletBCToYMomentum(double dx, double dy, doubl
 
 					if(gridType=="staggered")
 					{
-						coefficientsMatrix[v_P][v_P]+=2*G*(dy/dx);
+						coefficientsMatrix[v_P][v_P]+=2*getCornerShearModulus(i,
+							vDisplacementFVIndex[0].size(),G)*(dy/dx);
 					}
 					else if(gridType=="collocated")
 					{
@@ -1633,7 +1809,8 @@ void coefficientsAssembly::addDirichletBCToYMomentum(double dx, double dy, doubl
 	return;
 }
 
-void coefficientsAssembly::addDirichletBCToContinuity(int counter)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addDirichletBCToContinuity(int counter)
 {
 	int P_P;
 	int bcType;
@@ -1690,13 +1867,15 @@ void coefficientsAssembly::addDirichletBCToContinuity(int counter)
 	return;
 }
 
-void coefficientsAssembly::add1DPISFluidFlowToContinuity(double dx, double dy, double dt,
-	double alpha, double G, double lambda)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::add1DPISFluidFlowToContinuity(scalar dx, scalar dy,
+	scalar dt,
+	scalar alpha, scalar G, scalar lambda)
 {
 	int P_P, P_E, P_W, P_N, P_S;
 	int FVCounter;
 	int i, j;
-	double value=1;
+	scalar value=1;
 
 	for(FVCounter=0; FVCounter<NP; FVCounter++)
 	{
@@ -1781,13 +1960,15 @@ void coefficientsAssembly::add1DPISFluidFlowToContinuity(double dx, double dy, d
 	return;
 }
 
-void coefficientsAssembly::addI2DPISFluidFlowToContinuity(double dx, double dy, double dt,
-	double alpha, double G)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addI2DPISFluidFlowToContinuity(scalar dx, scalar dy,
+	scalar dt,
+	scalar alpha, scalar G)
 {
 	int P_P, P_E, P_W, P_N, P_S;
 	int FVCounter;
 	int i, j;
-	double value=1;
+	scalar value=1;
 
 	for(FVCounter=0; FVCounter<NP; FVCounter++)
 	{
@@ -1912,15 +2093,17 @@ void coefficientsAssembly::addI2DPISFluidFlowToContinuity(double dx, double dy,
 	return;
 }
 
-void coefficientsAssembly::addI2DPISDisplacementToContinuity(double dx, double dy, double dt,
-	double alpha)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addI2DPISDisplacementToContinuity(scalar dx, scalar dy,
+	scalar dt,
+	scalar alpha)
 {
 	int P_P;
 	int u_P, u_E, u_W, u_N, u_S, u_NE, u_NW, u_SE, u_SW;
 	int v_P, v_E, v_W, v_N, v_S, v_NE, v_NW, v_SE, v_SW;
 	int FVCounter;
 	int i, j;
-	double value=1;
+	scalar value=1;
 
 	for(FVCounter=0; FVCounter<NP; FVCounter++)
 	{
@@ -2103,14 +2286,16 @@ void coefficientsAssembly::addI2DPISDisplacementToContinuity(double dx, double d
 	return;
 }
 
-void coefficientsAssembly::addC2DPISFluidFlowToContinuity(double dx, double dy, double dt,
-	double alpha, double G, double lambda)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addC2DPISFluidFlowToContinuity(scalar dx, scalar dy,
+	scalar dt,
+	scalar alpha, scalar G, scalar lambda)
 {
 	int P_P, P_E, P_W, P_N, P_S;
 	int FVCounter;
 	int i, j;
-	double value=1;
-	double Hx, Hy;
+	scalar value=1;
+	scalar Hx, Hy;
 
 	Hx=alpha/(2*(G*dx*dx+(2*G+lambda)*dy*dy)*dt);
 	Hy=alpha/(2*((2*G+lambda)*dx*dx+G*dy*dy)*dt);
@@ -2238,15 +2423,17 @@ void coefficientsAssembly::addC2DPISFluidFlowToContinuity(double dx, double dy,
 	return;
 }
 
-void coefficientsAssembly::addC2DPISDisplacementToContinuity(double dx, double dy, double dt,
-	double alpha, double G, double lambda)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addC2DPISDisplacementToContinuity(scalar dx, scalar dy,
+	scalar dt,
+	scalar alpha, scalar G, scalar lambda)
 {
 	int P_P;
 	int u_P, u_E, u_W, u_N, u_S, u_NE, u_NW, u_SE, u_SW;
 	int v_P, v_E, v_W, v_N, v_S, v_NE, v_NW, v_SE, v_SW;
 	int FVCounter;
 	int i, j;
-	double value=1;
+	scalar value=1;
 
 	for(FVCounter=0; FVCounter<NP; FVCounter++)
 	{
@@ -2505,38 +2692,64 @@ void coefficientsAssembly::addC2DPISDisplacementToContinuity(double dx, double d
 	return;
 }
 
-void coefficientsAssembly::assemblySparseMatrix(vector<vector<double>> myCoefficientsMatrix)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::assemblySparseMatrix(
+	const vector<vector<scalar>>& myCoefficientsMatrix)
 {
 	int rowNo, colNo;
-	double i, j;
-	double value;
+	vector<vector<scalar>> threadRow, threadColumn, threadValue;
 
 	rowNo=myCoefficientsMatrix.size();
 	colNo=rowNo;
 
-	sparseCoefficientsRow.clear();
-	sparseCoefficientsColumn.clear();
-	sparseCoefficientsValue.clear();
-
-	for(i=0; i<rowNo; i++)
+	// Rows scanned by the threads which zeroed them, the triplets joined in the order of the rows
+	numaPlacement::configure();
+	threadRow.resize(numaPlacement::threadsNo);
+	threadColumn.resize(numaPlacement::threadsNo);
+	threadValue.resize(numaPlacement::threadsNo);
+	numaPlacement::parallelFor(rowNo,[&](int threadNo, int begin, int end)
 	{
-		for(j=0; j<colNo; j++)
+		auto start=chrono::steady_clock::now();
+		int i, j;
+		scalar value;
+
+		for(i=begin; i<end; i++)
 		{
-			value=myCoefficientsMatrix[i][j];
-			if(value!=0)
+			for(j=0; j<colNo; j++)
 			{
-				sparseCoefficientsRow.push_back(i);
-				sparseCoefficientsColumn.push_back(j);
-				sparseCoefficientsValue.push_back(value);
+				value=myCoefficientsMatrix[i][j];
+				if(value!=0)
+				{
+					threadRow[threadNo].push_back(i);
+					threadColumn[threadNo].push_back(j);
+					threadValue[threadNo].push_back(value);
+				}
 			}
 		}
+		numaPlacement::recordBandwidth((double)(end-begin)*colNo*sizeof(scalar),
+			chrono::duration<double>(chrono::steady_clock::now()-start).count());
+	});
+
+	sparseCoefficientsRow.clear();
+	sparseCoefficientsColumn.clear();
+	sparseCoefficientsValue.clear();
+	for(int threadNo=0; threadNo<threadRow.size(); threadNo++)
+	{
+		sparseCoefficientsRow.insert(sparseCoefficientsRow.end(),threadRow[threadNo].begin(),
+			threadRow[threadNo].end());
+		sparseCoefficientsColumn.insert(sparseCoefficientsColumn.end(),
+			threadColumn[threadNo].begin(),threadColumn[threadNo].end());
+		sparseCoefficientsValue.insert(sparseCoefficientsValue.end(),threadValue[threadNo].begin(),
+			threadValue[threadNo].end());
 	}
 
 	return;
 }
 
-void coefficientsAssembly::assemblyMandelCoefficientsMatrix(double dx, double dy, double G,
-	double lambda, double alpha)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::assemblyMandelCoefficientsMatrix(scalar dx, scalar dy,
+	scalar G,
+	scalar lambda, scalar alpha)
 {
 	addMandelRigidMotion();
 	increaseMandelCoefficientsMatrixSize();
@@ -2555,7 +2768,8 @@ void coefficientsAssembly::assemblyMandelCoefficientsMatrix(double dx, double dy
 	return;
 }
 
-void coefficientsAssembly::addMandelRigidMotion()
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addMandelRigidMotion()
 {
 	int i, j;
 	int v_P, v_ref;
@@ -2580,7 +2794,8 @@ void coefficientsAssembly::addMandelRigidMotion()
 	return;
 }
 
-void coefficientsAssembly::increaseMandelCoefficientsMatrixSize()
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::increaseMandelCoefficientsMatrixSize()
 {
 	int rowNo=coefficientsMatrix.size()+1;
 	int colNo=coefficientsMatrix[0].size()+1;
@@ -2592,7 +2807,8 @@ void coefficientsAssembly::increaseMandelCoefficientsMatrixSize()
 	return;
 }
 
-void coefficientsAssembly::addMandelStaggeredStressToVDisplacement(double dx)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addMandelStaggeredStressToVDisplacement(scalar dx)
 {
 	int v_P=getVDisplacementFVPosition(0,vDisplacementFVIndex[0].size()-1);
 	int sigma_P=coefficientsMatrix.size()-1;
@@ -2602,8 +2818,10 @@ void coefficientsAssembly::addMandelStaggeredStressToVDisplacement(double dx)
 	return;
 }
 
-void coefficientsAssembly::addMandelStaggeredStress(double dx, double dy, double G, double lambda,
-	double alpha)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addMandelStaggeredStress(scalar dx, scalar dy, scalar G,
+	scalar lambda,
+	scalar alpha)
 {
 	int i, j;
 	int u_P, u_E, v_P, v_S, P_P;
@@ -2635,7 +2853,8 @@ void coefficientsAssembly::addMandelStaggeredStress(double dx, double dy, double
 	return;
 }
 
-void coefficientsAssembly::addMandelCollocatedStressToVDisplacement(double dx)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addMandelCollocatedStressToVDisplacement(scalar dx)
 {
 	int v_P=getVDisplacementFVPosition(0,vDisplacementFVIndex[0].size()-1);
 	int sigma_P=coefficientsMatrix.size()-1;
@@ -2645,8 +2864,10 @@ void coefficientsAssembly::addMandelCollocatedStressToVDisplacement(double dx)
 	return;
 }
 
-void coefficientsAssembly::addMandelCollocatedStress(double dx, double dy, double G, double lambda,
-	double alpha)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addMandelCollocatedStress(scalar dx, scalar dy, scalar G,
+	scalar lambda,
+	scalar alpha)
 {
 	int i, j;
 	int u_P, u_E, u_W, v_P, v_S, P_P;
@@ -2692,7 +2913,8 @@ void coefficientsAssembly::addMandelCollocatedStress(double dx, double dy, doubl
 	return;
 }
 
-void coefficientsAssembly::addStripfootBC(int strip, double K, double mu_f)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addStripfootBC(int strip, scalar K, scalar mu_f)
 {
 	int P_P;
 	int j;
@@ -2722,9 +2944,74 @@ void coefficientsAssembly::addStripfootBC(int strip, double K, double mu_f)
 	return;
 }
 
-void coefficientsAssembly::assemblyDoublePorosityMatrix(double dx, double dy, double dt, double G,
-	double lambda, double alpha, double KPore, double KFrac, double mu_f, double A11, double A12,
-	double A22, double psiPore, double psiFrac, double leak)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::assemblyStripfootBCUpdate(int fromStrip, int toStrip,
+	scalar K,
+	scalar mu_f)
+{
+	// Stores as sparse triplets the rows that change when the strip BC of width fromStrip is
+	// replaced by the one of width toStrip. The coefficients matrix must not contain any strip BC.
+	int P_P;
+	int colNo=pressureFVIndex[0].size();
+	bool fromDrained, toDrained;
+	scalar sign;
+
+	sparseUpdateRow.clear();
+	sparseUpdateColumn.clear();
+	sparseUpdateValue.clear();
+
+	for(int j=0; j<colNo; j++)
+	{
+		fromDrained=isStripfootDrainedFV(fromStrip,j);
+		toDrained=isStripfootDrainedFV(toStrip,j);
+
+		if(fromDrained==toDrained) continue;
+
+		P_P=getPressureFVPosition(0,j);
+		if(toDrained) sign=1;
+		else sign=-1;
+
+		if(gridType=="collocated")
+		{
+			for(int k=0; k<coefficientsMatrix[P_P].size(); k++)
+			{
+				if(coefficientsMatrix[P_P][k]!=0)
+				{
+					sparseUpdateRow.push_back(P_P);
+					sparseUpdateColumn.push_back(k);
+					sparseUpdateValue.push_back(-sign*coefficientsMatrix[P_P][k]);
+				}
+			}
+
+			sparseUpdateRow.push_back(P_P);
+			sparseUpdateColumn.push_back(P_P);
+			sparseUpdateValue.push_back(sign);
+		}
+		else
+		{
+			sparseUpdateRow.push_back(P_P);
+			sparseUpdateColumn.push_back(P_P);
+			sparseUpdateValue.push_back(sign*2*K/mu_f);
+		}
+	}
+
+	return;
+}
+
+template<class scalar>
+bool basicCoefficientsAssembly<scalar>::isStripfootDrainedFV(int strip, int j)
+{
+	// A negative strip means no strip BC is applied
+	if(strip<0) return false;
+
+	return j>=strip+1;
+}
+
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::assemblyDoublePorosityMatrix(scalar dx, scalar dy,
+	scalar dt, scalar G,
+	scalar lambda, scalar alpha, scalar KPore, scalar KFrac, scalar mu_f, scalar A11, scalar A12,
+	scalar A22, scalar psiPore, scalar psiFrac, scalar leak)
 {
 	increaseMacroPorosityCoefficientsMatrixSize();
 	addUDisplacementToXMomentum(dx,dy,G,lambda);
@@ -2756,7 +3043,8 @@ void coefficientsAssembly::assemblyDoublePorosityMatrix(double dx, double dy, do
 	return;
 }
 
-void coefficientsAssembly::increaseMacroPorosityCoefficientsMatrixSize()
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::increaseMacroPorosityCoefficientsMatrixSize()
 {
 	int rowNo=coefficientsMatrix.size()+NP;
 	int colNo=coefficientsMatrix[0].size()+NP;
@@ -2768,7 +3056,8 @@ void coefficientsAssembly::increaseMacroPorosityCoefficientsMatrixSize()
 	return;
 }
 
-void coefficientsAssembly::addMacroPressureToXMomentum(double dy, double alpha)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addMacroPressureToXMomentum(scalar dy, scalar alpha)
 {
 	if(gridType=="staggered") addStaggeredMacroPressureToXMomentum(dy,alpha);
 	else if(gridType=="collocated")
@@ -2782,7 +3071,9 @@ void coefficientsAssembly::addMacroPressureToXMomentum(double dy, double alpha)
 	return;
 }
 
-void coefficientsAssembly::addStaggeredMacroPressureToXMomentum(double dy, double alpha)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addStaggeredMacroPressureToXMomentum(scalar dy,
+	scalar alpha)
 {
 	int u_P;
 	int P_P, P_W;
@@ -2821,13 +3112,14 @@ void coefficientsAssembly::addStaggeredMacroPressureToXMomentum(double dy, doubl
 	return;
 }
 
-void coefficientsAssembly::addCDSMacroPressureToXMomentum(double dy, double alpha)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addCDSMacroPressureToXMomentum(scalar dy, scalar alpha)
 {
 	int u_P;
 	int P_P, P_E, P_W;
 	int FVCounter;
 	int i, j;
-	double value=1;
+	scalar value=1;
 	
 	for(FVCounter=0; FVCounter<Nu; FVCounter++)
 	{	
@@ -2877,7 +3169,8 @@ void coefficientsAssembly::addCDSMacroPressureToXMomentum(double dy, double alph
 	return;
 }
 
-void coefficientsAssembly::addMacroPressureToYMomentum(double dx, double alpha)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addMacroPressureToYMomentum(scalar dx, scalar alpha)
 {
 	if(gridType=="staggered") addStaggeredMacroPressureToYMomentum(dx,alpha);
 	else if(gridType=="collocated")
@@ -2891,7 +3184,9 @@ void coefficientsAssembly::addMacroPressureToYMomentum(double dx, double alpha)
 	return;
 }
 
-void coefficientsAssembly::addStaggeredMacroPressureToYMomentum(double dx, double alpha)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addStaggeredMacroPressureToYMomentum(scalar dx,
+	scalar alpha)
 {
 	int v_P;
 	int P_P, P_N;
@@ -2930,13 +3225,14 @@ void coefficientsAssembly::addStaggeredMacroPressureToYMomentum(double dx, doubl
 	return;
 }
 
-void coefficientsAssembly::addCDSMacroPressureToYMomentum(double dx, double alpha)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addCDSMacroPressureToYMomentum(scalar dx, scalar alpha)
 {
 	int v_P;
 	int P_P, P_N, P_S;
 	int FVCounter;
 	int i, j;
-	double value=1;
+	scalar value=1;
 
 	for(FVCounter=0; FVCounter<Nv; FVCounter++)
 	{
@@ -2986,14 +3282,16 @@ void coefficientsAssembly::addCDSMacroPressureToYMomentum(double dx, double alph
 	return;
 }
 
-void coefficientsAssembly::addMacroTransientToContinuity(double dx, double dy, double dt,
-	double A12, double A22)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addMacroTransientToContinuity(scalar dx, scalar dy,
+	scalar dt,
+	scalar A12, scalar A22)
 {	
 	int P_P, PM_P;
 	int FVCounter;
 	int i, j;
-	double Mp12=A12*(dx*dy/dt);
-	double Mp22=A22*(dx*dy/dt);
+	scalar Mp12=A12*(dx*dy/dt);
+	scalar Mp22=A22*(dx*dy/dt);
 	int borderCounter=0;
 
 	for(FVCounter=0; FVCounter<NPM; FVCounter++)
@@ -3024,8 +3322,10 @@ void coefficientsAssembly::addMacroTransientToContinuity(double dx, double dy, d
 	}
 }
 
-void coefficientsAssembly::addMacroDisplacementToContinuity(double dx, double dy, double dt,
-	double alpha, double G, double lambda)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addMacroDisplacementToContinuity(scalar dx, scalar dy,
+	scalar dt,
+	scalar alpha, scalar G, scalar lambda)
 {
 	if(gridType=="staggered") addStaggeredMacroDisplacementToContinuity(dx,dy,dt,alpha);
 	else if(gridType=="collocated")
@@ -3037,8 +3337,10 @@ void coefficientsAssembly::addMacroDisplacementToContinuity(double dx, double dy
 	return;
 }
 
-void coefficientsAssembly::addStaggeredMacroDisplacementToContinuity(double dx, double dy,
-	double dt, double alpha)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addStaggeredMacroDisplacementToContinuity(scalar dx,
+	scalar dy,
+	scalar dt, scalar alpha)
 {
 	int u_P, u_E;
 	int v_P, v_S;
@@ -3066,15 +3368,17 @@ void coefficientsAssembly::addStaggeredMacroDisplacementToContinuity(double dx,
 	return;
 }
 
-void coefficientsAssembly::addCDSMacroDisplacementToContinuity(double dx, double dy, double dt,
-	double alpha)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addCDSMacroDisplacementToContinuity(scalar dx, scalar dy,
+	scalar dt,
+	scalar alpha)
 {
 	int P_P;
 	int u_P, u_E, u_W;
 	int v_P, v_N, v_S;
 	int FVCounter;
 	int i, j;
-	double value=1;
+	scalar value=1;
 
 	for(FVCounter=0; FVCounter<NP; FVCounter++)
 	{
@@ -3161,15 +3465,17 @@ void coefficientsAssembly::addCDSMacroDisplacementToContinuity(double dx, double
 	return;
 }
 
-void coefficientsAssembly::addI2DPISMacroDisplacementToContinuity(double dx, double dy, double dt,
-	double alpha)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addI2DPISMacroDisplacementToContinuity(scalar dx,
+	scalar dy, scalar dt,
+	scalar alpha)
 {
 	int P_P;
 	int u_P, u_E, u_W, u_N, u_S, u_NE, u_NW, u_SE, u_SW;
 	int v_P, v_E, v_W, v_N, v_S, v_NE, v_NW, v_SE, v_SW;
 	int FVCounter;
 	int i, j;
-	double value=1;
+	scalar value=1;
 
 	for(FVCounter=0; FVCounter<NPM; FVCounter++)
 	{
@@ -3352,8 +3658,10 @@ void coefficientsAssembly::addI2DPISMacroDisplacementToContinuity(double dx, dou
 	return;
 }
 
-void coefficientsAssembly::addMacroFluidFlowToContinuity(double dx, double dy, double dt, double K,
-	double mu_f, double alpham, double alphaM, double G, double lambda)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addMacroFluidFlowToContinuity(scalar dx, scalar dy,
+	scalar dt, scalar K,
+	scalar mu_f, scalar alpham, scalar alphaM, scalar G, scalar lambda)
 {
 	if(gridType=="staggered") addStaggeredMacroFluidFlowToContinuity(dx,dy,K,mu_f);
 	else if(gridType=="collocated") 
@@ -3369,8 +3677,10 @@ void coefficientsAssembly::addMacroFluidFlowToContinuity(double dx, double dy, d
 	return;
 }
 
-void coefficientsAssembly::addStaggeredMacroFluidFlowToContinuity(double dx, double dy, double K,
-	double mu_f)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addStaggeredMacroFluidFlowToContinuity(scalar dx,
+	scalar dy, scalar K,
+	scalar mu_f)
 {
 	int P_P, P_E, P_W, P_N, P_S;
 	int FVCounter;
@@ -3448,13 +3758,15 @@ void coefficientsAssembly::addStaggeredMacroFluidFlowToContinuity(double dx, dou
 	return;
 }
 
-void coefficientsAssembly::addCollocatedMacroFluidFlowToContinuity(double dx, double dy, double K,
-	double mu_f)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addCollocatedMacroFluidFlowToContinuity(scalar dx,
+	scalar dy, scalar K,
+	scalar mu_f)
 {
 	int P_P, P_E, P_W, P_N, P_S;
 	int FVCounter;
 	int i, j;
-	double value=1;
+	scalar value=1;
 
 	for(FVCounter=0; FVCounter<NP; FVCounter++)
 	{
@@ -3539,13 +3851,15 @@ void coefficientsAssembly::addCollocatedMacroFluidFlowToContinuity(double dx, do
 	return;
 }
 
-void coefficientsAssembly::addI2DPISFluidFlowToMicroContinuity(double dx, double dy, double dt,
-	double alpham, double alphaM, double G)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addI2DPISFluidFlowToMicroContinuity(scalar dx, scalar dy,
+	scalar dt,
+	scalar alpham, scalar alphaM, scalar G)
 {
 	int P_P, PM_E, PM_W, PM_N, PM_S;
 	int FVCounter;
 	int i, j;
-	double value=1;
+	scalar value=1;
 
 	for(FVCounter=0; FVCounter<NP; FVCounter++)
 	{
@@ -3670,7 +3984,8 @@ void coefficientsAssembly::addI2DPISFluidFlowToMicroContinuity(double dx, double
 	return;
 }
 
-void coefficientsAssembly::addLeaktoContinuity(double leak)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addLeaktoContinuity(scalar leak)
 {
 	int i, j;
 	int P_P, PM_P;
@@ -3692,7 +4007,8 @@ void coefficientsAssembly::addLeaktoContinuity(double leak)
 	return;
 }
 
-void coefficientsAssembly::addMacroBCToContinuity()
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addMacroBCToContinuity()
 {
 	if(gridType=="collocated")
 		for(int counter=0; counter<4; counter++)
@@ -3701,7 +4017,8 @@ void coefficientsAssembly::addMacroBCToContinuity()
 	return;
 }
 
-void coefficientsAssembly::addMacroDirichletBCToContinuity(int counter)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addMacroDirichletBCToContinuity(int counter)
 {
 	int P_P;
 	int bcType;
@@ -3758,7 +4075,8 @@ void coefficientsAssembly::addMacroDirichletBCToContinuity(int counter)
 	return;
 }
 
-void coefficientsAssembly::assignFakePressure(double psiPore, double psiFrac)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::assignFakePressure(scalar psiPore, scalar psiFrac)
 {
 	int P_P;
 	int FVCounter;
@@ -3794,7 +4112,8 @@ void coefficientsAssembly::assignFakePressure(double psiPore, double psiFrac)
 	return;
 }
 
-void coefficientsAssembly::addMacroStripfootBC(int strip, double K, double mu_f)
+template<class scalar>
+void basicCoefficientsAssembly<scalar>::addMacroStripfootBC(int strip, scalar K, scalar mu_f)
 {
 	int P_P;
 	int j;
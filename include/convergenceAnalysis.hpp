@@ -0,0 +1,411 @@
+/*
+	This header is part of the development of a master's thesis entitled "Analysis of Numerical
+	Schemes in Collocated and Staggered Grids for Problems of Poroelasticity". The class defined
+	here estimates the convergence of problems without analytical solution, such as the strip
+	footing, from the solutions of a hierarchy of meshes or time-steps.
+
+	The fields of the last time-step of each level are interpolated onto a common reference grid,
+	made of the centroids of referenceNx x referenceNy volumes, where they are compared. Since
+	every grid is a tensor product, the bilinear interpolation is done as two passes of linear
+	interpolation, along x for each row of the level and then along y for each reference row, with
+	the positions of the unknowns of the staggered (u and v at the faces, p at the centroids) and
+	of the collocated (every unknown at the vertices) grids; the reference points outside the
+	unknowns of a level, near the boundaries of the staggered grid, are extrapolated linearly.
+
+	From three successive levels the observed order of each field is found as in [2], which allows
+	refinement ratios which are not constant, and the Richardson extrapolation [1] of the finest
+	level gives the estimate of its error. When a fine reference run is given, the error of each
+	level is also measured against it. Only the fields of the reference, of the previous and of
+	the current level are kept, so the memory does not grow with the hierarchy. The arrays are all
+	allocated at construction, since the levels are added from within the runs, whose allocations
+	the run arena drops at their end.
+
+ 	Written by FERREIRA, C. A. S.
+
+ 	Florianópolis, 2019.
+
+ 	[1] RICHARDSON, L. F. The Approximate Arithmetical Solution by Finite Differences of Physical
+ 	Problems Involving Differential Equations, with an Application to the Stresses in a Masonry
+ 	Dam. Philosophical Transactions of the Royal Society A, v. 210, pp. 307-357, 1911.
+ 	[2] CELIK, I. B. et al. Procedure for Estimation and Reporting of Uncertainty Due to
+ 	Discretization in CFD Applications. Journal of Fluids Engineering, v. 130, n. 7, 2008.
+*/
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <math.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct convergenceLevel
+{
+	double h;
+	double dt;
+	double ratio;
+	double change[4];
+	double order[4];
+	double richardsonError[4];
+	double referenceError[4];
+	double referenceOrder[4];
+};
+
+class convergenceAnalysis
+{
+public:
+	// Class variables
+	static const int fieldsNo=4;
+	const string fieldNames[fieldsNo]={"u","v","p","pMacro"};
+	double Lx;
+	double Ly;
+	int referenceNx;
+	int referenceNy;
+	int maxLevelsNo;
+	bool fineReferenceRun=false;
+	bool hasFineReference=false;
+	bool hasMacroPressure=false;
+	vector<double> referenceX;
+	vector<double> referenceDepth;
+	vector<vector<double>> currentFields;
+	vector<vector<double>> previousFields;
+	vector<vector<double>> fineReferenceFields;
+	vector<vector<double>> extrapolatedFields;
+	vector<convergenceLevel> levels;
+
+	// Class functions
+	int addLevel(string,double,double,double,double,const vector<vector<int>>&,
+		const vector<vector<int>>&,const vector<vector<int>>&,const vector<vector<double>>&,
+		const vector<vector<double>>&,const vector<vector<double>>&,
+		const vector<vector<double>>&,int);
+	void getLinearWeights(const vector<double>&,const vector<double>&,vector<int>&,
+		vector<double>&);
+	void interpolateField(const vector<vector<int>>&,const vector<vector<double>>&,int,double,
+		double,double,double,vector<double>&);
+	double getNorm(const vector<double>&,const vector<double>&);
+	double getObservedOrder(double,double,double,double);
+	void printSummary();
+	void exportSummary(string);
+	void exportExtrapolatedField(string,int);
+
+	// Constructor
+	convergenceAnalysis(double,double,int,int,int);
+
+	// Destructor
+	~convergenceAnalysis();
+};
+
+convergenceAnalysis::convergenceAnalysis(double myLx, double myLy, int myReferenceNx,
+	int myReferenceNy, int myMaxLevelsNo)
+{
+	int pointsNo=myReferenceNx*myReferenceNy;
+
+	Lx=myLx;
+	Ly=myLy;
+	referenceNx=myReferenceNx;
+	referenceNy=myReferenceNy;
+	maxLevelsNo=myMaxLevelsNo;
+
+	referenceX.resize(referenceNx);
+	referenceDepth.resize(referenceNy);
+	for(int j=0; j<referenceNx; j++) referenceX[j]=(j+0.5)*Lx/referenceNx;
+	for(int i=0; i<referenceNy; i++) referenceDepth[i]=(i+0.5)*Ly/referenceNy;
+
+	currentFields.assign(fieldsNo,vector<double>(pointsNo,0));
+	previousFields.assign(fieldsNo,vector<double>(pointsNo,0));
+	fineReferenceFields.assign(fieldsNo,vector<double>(pointsNo,0));
+	extrapolatedFields.assign(fieldsNo,vector<double>(pointsNo,0));
+	levels.reserve(maxLevelsNo);
+}
+
+convergenceAnalysis::~convergenceAnalysis(){}
+
+void convergenceAnalysis::getLinearWeights(const vector<double>& coordinates,
+	const vector<double>& points, vector<int>& lowerIndex, vector<double>& weight)
+{
+	// Segment of the ascending coordinates holding each point, the weight of its upper end lying
+	// outside [0,1] for the points beyond the first or the last coordinate
+	int n=coordinates.size();
+	int k=0;
+
+	lowerIndex.resize(points.size());
+	weight.resize(points.size());
+	for(int i=0; i<points.size(); i++)
+	{
+		if(n==1)
+		{
+			lowerIndex[i]=0;
+			weight[i]=0;
+			continue;
+		}
+
+		while(k<n-2 && coordinates[k+1]<points[i]) k++;
+		lowerIndex[i]=k;
+		weight[i]=(points[i]-coordinates[k])/(coordinates[k+1]-coordinates[k]);
+	}
+
+	return;
+}
+
+void convergenceAnalysis::interpolateField(const vector<vector<int>>& index,
+	const vector<vector<double>>& field, int timeStep, double dx, double dy, double xOffset,
+	double depthOffset, vector<double>& result)
+{
+	// The unknown of row i and column j lies at x=xOffset+j*dx and at the depth depthOffset+i*dy
+	int rowNo=index.size();
+	int colNo=index[0].size();
+	vector<double> x(colNo), depth(rowNo);
+	vector<int> xIndex, depthIndex;
+	vector<double> xWeight, depthWeight;
+	vector<double> rowValues(rowNo*referenceNx);
+	int position;
+	double lower, upper;
+
+	for(int j=0; j<colNo; j++) x[j]=xOffset+j*dx;
+	for(int i=0; i<rowNo; i++) depth[i]=depthOffset+i*dy;
+	getLinearWeights(x,referenceX,xIndex,xWeight);
+	getLinearWeights(depth,referenceDepth,depthIndex,depthWeight);
+
+	// Along x, for each row of the level
+	for(int i=0; i<rowNo; i++)
+	{
+		for(int j=0; j<referenceNx; j++)
+		{
+			position=index[i][xIndex[j]]-1;
+			lower=(position>=0) ? field[position][timeStep] : 0;
+			if(colNo==1)
+			{
+				rowValues[i*referenceNx+j]=lower;
+				continue;
+			}
+
+			position=index[i][xIndex[j]+1]-1;
+			upper=(position>=0) ? field[position][timeStep] : 0;
+			rowValues[i*referenceNx+j]=lower+xWeight[j]*(upper-lower);
+		}
+	}
+
+	// Along y, for each reference row
+	for(int i=0; i<referenceNy; i++)
+	{
+		int k=depthIndex[i];
+
+		for(int j=0; j<referenceNx; j++)
+		{
+			lower=rowValues[k*referenceNx+j];
+			upper=(rowNo>1) ? rowValues[(k+1)*referenceNx+j] : lower;
+			result[i*referenceNx+j]=lower+depthWeight[i]*(upper-lower);
+		}
+	}
+
+	return;
+}
+
+double convergenceAnalysis::getNorm(const vector<double>& first, const vector<double>& second)
+{
+	// Root mean square of the difference over the reference grid
+	double sum=0;
+
+	for(int i=0; i<first.size(); i++) sum+=(first[i]-second[i])*(first[i]-second[i]);
+
+	return sqrt(sum/first.size());
+}
+
+double convergenceAnalysis::getObservedOrder(double coarseChange, double fineChange,
+	double coarseRatio, double fineRatio)
+{
+	// Fixed point of p=|ln(e32/e21)+q(p)|/ln(r21), with q(p)=ln((r21^p-1)/(r32^p-1)) [2]
+	double order=0;
+	double previousOrder;
+	double q=0;
+
+	if(fineChange<=0 || coarseChange<=0 || fineRatio<=1 || coarseRatio<=1) return NAN;
+
+	for(int iteration=0; iteration<100; iteration++)
+	{
+		previousOrder=order;
+		order=fabs(log(coarseChange/fineChange)+q)/log(fineRatio);
+		if(order==0) break;
+		q=log((pow(fineRatio,order)-1)/(pow(coarseRatio,order)-1));
+		if(fabs(order-previousOrder)<1e-10*order) break;
+	}
+
+	return order;
+}
+
+int convergenceAnalysis::addLevel(string gridType, double h, double dt, double dx, double dy,
+	const vector<vector<int>>& idU, const vector<vector<int>>& idV, const vector<vector<int>>& idP,
+	const vector<vector<double>>& uField, const vector<vector<double>>& vField,
+	const vector<vector<double>>& pField, const vector<vector<double>>& pMacroField,
+	int timeStep)
+{
+	// Fields of the given time-step, the macro-pressure one being empty for the single porosity
+	// problems. Returns the number of levels of the hierarchy.
+	bool isStaggered=(gridType=="staggered");
+	convergenceLevel myLevel;
+	double ratio, fineChange, coarseChange, order;
+	int levelNo=levels.size();
+
+	if(!fineReferenceRun && levelNo>=maxLevelsNo)
+	{
+		cout << "Convergence analysis is limited to " << maxLevelsNo << " levels\n";
+
+		return levelNo;
+	}
+
+	// u at the vertical faces, v at the horizontal faces and p at the centroids when staggered
+	if(!fineReferenceRun) swap(previousFields,currentFields);
+	vector<vector<double>>& fields=fineReferenceRun ? fineReferenceFields : currentFields;
+	interpolateField(idU,uField,timeStep,dx,dy,0,isStaggered ? dy/2 : 0,fields[0]);
+	interpolateField(idV,vField,timeStep,dx,dy,isStaggered ? dx/2 : 0,0,fields[1]);
+	interpolateField(idP,pField,timeStep,dx,dy,isStaggered ? dx/2 : 0,isStaggered ? dy/2 : 0,
+		fields[2]);
+	hasMacroPressure=!pMacroField.empty();
+	if(hasMacroPressure) interpolateField(idP,pMacroField,timeStep,dx,dy,
+		isStaggered ? dx/2 : 0,isStaggered ? dy/2 : 0,fields[3]);
+
+	if(fineReferenceRun)
+	{
+		hasFineReference=true;
+
+		return levelNo;
+	}
+
+	myLevel.h=h;
+	myLevel.dt=dt;
+	myLevel.ratio=NAN;
+	for(int f=0; f<fieldsNo; f++)
+	{
+		myLevel.change[f]=NAN;
+		myLevel.order[f]=NAN;
+		myLevel.richardsonError[f]=NAN;
+		myLevel.referenceError[f]=NAN;
+		myLevel.referenceOrder[f]=NAN;
+	}
+
+	// Refinement of the mesh, or of the time-step when the mesh is kept
+	if(levelNo>0)
+	{
+		const convergenceLevel& previousLevel=levels[levelNo-1];
+
+		ratio=(fabs(previousLevel.h-h)>1e-12*h) ? previousLevel.h/h : previousLevel.dt/dt;
+		myLevel.ratio=ratio;
+	}
+
+	for(int f=0; f<fieldsNo; f++)
+	{
+		if(f==3 && !hasMacroPressure) continue;
+
+		if(hasFineReference)
+		{
+			myLevel.referenceError[f]=getNorm(currentFields[f],fineReferenceFields[f]);
+			if(levelNo>0) myLevel.referenceOrder[f]=log(levels[levelNo-1].referenceError[f]/
+				myLevel.referenceError[f])/log(myLevel.ratio);
+		}
+
+		if(levelNo==0) continue;
+		fineChange=getNorm(currentFields[f],previousFields[f]);
+		myLevel.change[f]=fineChange;
+		if(levelNo==1) continue;
+
+		// Observed order and Richardson extrapolation of the finest level
+		coarseChange=levels[levelNo-1].change[f];
+		order=getObservedOrder(coarseChange,fineChange,levels[levelNo-1].ratio,ratio);
+		myLevel.order[f]=order;
+		if(isnan(order) || order==0) continue;
+
+		for(int k=0; k<currentFields[f].size(); k++)
+			extrapolatedFields[f][k]=currentFields[f][k]+(currentFields[f][k]-
+				previousFields[f][k])/(pow(ratio,order)-1);
+		myLevel.richardsonError[f]=fineChange/(pow(ratio,order)-1);
+	}
+
+	levels.push_back(myLevel);
+
+	return levels.size();
+}
+
+void convergenceAnalysis::printSummary()
+{
+	int lastFieldNo=hasMacroPressure ? fieldsNo : fieldsNo-1;
+
+	cout << "Convergence analysis on a " << referenceNy << "x" << referenceNx <<
+		" reference grid:\n";
+	for(int k=0; k<levels.size(); k++)
+	{
+		cout << "h=" << levels[k].h << ", dt=" << levels[k].dt;
+		for(int f=0; f<lastFieldNo; f++)
+		{
+			cout << " | " << fieldNames[f] << ": ";
+			if(!isnan(levels[k].order[f])) cout << "order=" << levels[k].order[f] <<
+				", error~" << levels[k].richardsonError[f];
+			else if(!isnan(levels[k].change[f])) cout << "change=" << levels[k].change[f];
+			if(hasFineReference) cout << " (" << levels[k].referenceError[f] << " from reference)";
+		}
+		cout << "\n";
+	}
+
+	return;
+}
+
+void convergenceAnalysis::exportSummary(string fileName)
+{
+	int lastFieldNo=hasMacroPressure ? fieldsNo : fieldsNo-1;
+	ofstream myFile(fileName);
+
+	if(!myFile.is_open())
+	{
+		cout << "Unable to open " << fileName << "\n";
+
+		return;
+	}
+
+	myFile << "h\tdt\tratio";
+	for(int f=0; f<lastFieldNo; f++)
+		myFile << "\t" << fieldNames[f] << "Change\t" << fieldNames[f] << "Order\t" <<
+			fieldNames[f] << "RichardsonError\t" << fieldNames[f] << "ReferenceError\t" <<
+			fieldNames[f] << "ReferenceOrder";
+	myFile << "\n" << setprecision(10);
+	for(int k=0; k<levels.size(); k++)
+	{
+		myFile << levels[k].h << "\t" << levels[k].dt << "\t" << levels[k].ratio;
+		for(int f=0; f<lastFieldNo; f++)
+			myFile << "\t" << levels[k].change[f] << "\t" << levels[k].order[f] << "\t" <<
+				levels[k].richardsonError[f] << "\t" << levels[k].referenceError[f] << "\t" <<
+				levels[k].referenceOrder[f];
+		myFile << "\n";
+	}
+
+	myFile.close();
+
+	return;
+}
+
+void convergenceAnalysis::exportExtrapolatedField(string fileName, int fieldNo)
+{
+	// Rows from the top of the domain, as the exports of dataProcessing
+	ofstream myFile(fileName);
+
+	if(!myFile.is_open())
+	{
+		cout << "Unable to open " << fileName << "\n";
+
+		return;
+	}
+
+	for(int i=0; i<referenceNy; i++)
+	{
+		for(int j=0; j<referenceNx; j++)
+		{
+			myFile << extrapolatedFields[fieldNo][i*referenceNx+j];
+			myFile << "\t";
+		}
+
+		myFile << "\n";
+	}
+
+	myFile.close();
+
+	return;
+}
@@ -4,11 +4,20 @@
 	here contains the functions for post-processing of the data obtained with the solution of the
 	discretized problem of poroelasticity.
 
+	Besides the text files of the full fields, exportFieldPyramid writes a binary file with the
+	fields downsampled by 2, 4, 8, ... (one level per factor), so that a quick look at a large field
+	reads a coarse level only. The values of the FV centred in the cells are averaged over blocks
+	of factor x factor FV, those of the FV centred on the nodes (the collocated grid, the normal
+	direction of the staggered displacements) over the dual cell of the coarse node, with half
+	weights on its faces, so that each level keeps the layout of the grid.
+
  	Written by FERREIRA, C. A. S.
 
  	Florianópolis, 2019.
 */
 
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -23,6 +32,7 @@ class dataProcessing
 public:
 	// Class variables
 	int aisleNo;
+	int timeStepsNo;
 	vector<vector<vector<double>>> uDisplacement3DField;
 	vector<vector<vector<double>>> vDisplacement3DField;
 	vector<vector<vector<double>>> pressure3DField;
@@ -31,6 +41,10 @@ public:
 	string gridType;
 	vector<double> mandelRoots;
 	double mandelTransCoef;
+	solutionHistory* history=NULL;
+	vector<vector<int>> historyIdU, historyIdV, historyIdP;
+	double historyDx, historyDy;
+	int storedTimeStep;
 
 	// Class structures
 	struct errorNorm
@@ -42,6 +56,7 @@ public:
 	} myErrorNorm;
 
 	// Class functions
+	int loadTimeStep(int);
 	void resize3DFields(vector<vector<int>>,vector<vector<int>>,vector<vector<int>>);
 	void storeUDisplacem3DField(vector<vector<int>>,vector<vector<double>>);
 	void storeVDisplacem3DField(vector<vector<int>>,vector<vector<double>>);
@@ -78,11 +93,17 @@ public:
 	void exportMacroPressureTSolution(double,double,double,int,string);
 	void exportStripfootTSolution(double,double,double,double,int,string);
 	void exportStripfootHSolution(double,double,double,double,int,string);
+	vector<vector<pair<int,double>>> getPyramidWeights(int,int,bool);
+	vector<double> getPyramidLevel(const vector<vector<vector<double>>>&,int,bool,bool,int,int&,
+		int&);
+	void exportFieldPyramid(string,double,double,double,int,int);
 
 	// Constructor
 	dataProcessing(vector<vector<int>>,vector<vector<int>>,vector<vector<int>>,
 		vector<vector<double>>,vector<vector<double>>,vector<vector<double>>,string,string,double,
 		double);
+	dataProcessing(vector<vector<int>>,vector<vector<int>>,vector<vector<int>>,solutionHistory&,
+		string,string,double,double);
 
 	// Destructor
 	~dataProcessing();
@@ -93,6 +114,7 @@ dataProcessing::dataProcessing(vector<vector<int>> idU, vector<vector<int>> idV,
 	vector<vector<double>> pField, string myGridType, string myInterpScheme, double dx, double dy)
 {
 	aisleNo=pField[0].size();
+	timeStepsNo=aisleNo;
 	if(myGridType=="staggered") gridType=myGridType;
 	else if(myGridType=="collocated") gridType=myGridType+"+"+myInterpScheme;
 
@@ -103,8 +125,56 @@ dataProcessing::dataProcessing(vector<vector<int>> idU, vector<vector<int>> idV,
 	storeStrain3DField(idU,idV,idP,dx,dy,uField,vField);
 }
 
+dataProcessing::dataProcessing(vector<vector<int>> idU, vector<vector<int>> idV,
+	vector<vector<int>> idP, solutionHistory& myHistory, string myGridType, string myInterpScheme,
+	double dx, double dy)
+{
+	// The 3D fields hold a single time-step, decoded from the history when first accessed
+	aisleNo=1;
+	timeStepsNo=myHistory.snapshotsNo;
+	if(myGridType=="staggered") gridType=myGridType;
+	else if(myGridType=="collocated") gridType=myGridType+"+"+myInterpScheme;
+
+	history=&myHistory;
+	historyIdU=idU;
+	historyIdV=idV;
+	historyIdP=idP;
+	historyDx=dx;
+	historyDy=dy;
+	storedTimeStep=-1;
+
+	resize3DFields(idU,idV,idP);
+}
+
 dataProcessing::~dataProcessing(){}
 
+int dataProcessing::loadTimeStep(int timeStep)
+{
+	// Aisle of the 3D fields which holds the given time-step
+	vector<vector<double>> uField, vField, pField, pMField;
+
+	if(history==NULL) return timeStep;
+
+	if(timeStep!=storedTimeStep)
+	{
+		// Double porosity histories also hold the macro-pressure
+		if(history->blockSizes.size()>3)
+		{
+			history->splitSnapshot(history->getSnapshotView(timeStep),uField,vField,pField,
+				pMField);
+			storeMacroPressure3DField(historyIdP,pMField);
+		}
+		else history->splitSnapshot(history->getSnapshotView(timeStep),uField,vField,pField);
+		storeUDisplacem3DField(historyIdU,uField);
+		storeVDisplacem3DField(historyIdV,vField);
+		storePressure3DField(historyIdP,pField);
+		storeStrain3DField(historyIdU,historyIdV,historyIdP,historyDx,historyDy,uField,vField);
+		storedTimeStep=timeStep;
+	}
+
+	return 0;
+}
+
 void dataProcessing::resize3DFields(vector<vector<int>> idU, vector<vector<int>> idV,
 	vector<vector<int>> idP)
 {
@@ -326,6 +396,7 @@ void dataProcessing::export1DFieldToTxt(vector<double> my1DField, string fieldNa
 void dataProcessing::exportSealedColumnNumericalSolution(double dy, double dt, double Ly,
 	int timeStep, string pairName)
 {
+	int aisle=loadTimeStep(timeStep);
 	string fieldName;
 	vector<double> yCoordP;yCoordP.resize(pressure3DField.size());
 	vector<double> pField;pField.resize(pressure3DField.size());
@@ -346,15 +417,15 @@ void dataProcessing::exportSealedColumnNumericalSolution(double dy, double dt, d
 		{
 			int midCols=pressure3DField[0].size()/2;
 			pField[i]=0;
-			pField[i]+=pressure3DField[i][midCols][timeStep]/2;
-			pField[i]+=pressure3DField[i][midCols-1][timeStep]/2;
+			pField[i]+=pressure3DField[i][midCols][aisle]/2;
+			pField[i]+=pressure3DField[i][midCols-1][aisle]/2;
 		}
 	else
 		for(int i=0; i<pField.size(); i++)
 		{
 			int midCols=pressure3DField[0].size()/2;
 			pField[i]=0;
-			pField[i]+=pressure3DField[i][midCols][timeStep];
+			pField[i]+=pressure3DField[i][midCols][aisle];
 		}
 	fieldName="sealedColumn_"+pairName+"_PNumeric_dt="+to_string(dt)+"_timeStep="+
 		to_string(timeStep);
@@ -372,15 +443,15 @@ void dataProcessing::exportSealedColumnNumericalSolution(double dy, double dt, d
 		{
 			int midCols=vDisplacement3DField[0].size()/2;
 			vField[i]=0;
-			vField[i]+=vDisplacement3DField[i][midCols][timeStep]/2;
-			vField[i]+=vDisplacement3DField[i][midCols-1][timeStep]/2;
+			vField[i]+=vDisplacement3DField[i][midCols][aisle]/2;
+			vField[i]+=vDisplacement3DField[i][midCols-1][aisle]/2;
 		}
 	else
 		for(int i=0; i<vField.size(); i++)
 		{
 			int midCols=vDisplacement3DField[0].size()/2;
 			vField[i]=0;
-			vField[i]+=vDisplacement3DField[i][midCols][timeStep];
+			vField[i]+=vDisplacement3DField[i][midCols][aisle];
 		}
 	fieldName="sealedColumn_"+pairName+"_VNumeric_dt="+to_string(dt)+"_timeStep="+
 		to_string(timeStep);
@@ -442,6 +513,7 @@ void dataProcessing::exportSealedColumnAnalyticalSolution(double Ly, double alph
 void dataProcessing::exportTerzaghiNumericalSolution(double dy, double dt, double Ly, int timeStep,
 	string pairName)
 {
+	int aisle=loadTimeStep(timeStep);
 	string fieldName;
 	vector<double> yCoordP;yCoordP.resize(pressure3DField.size());
 	vector<double> pField;pField.resize(pressure3DField.size());
@@ -464,15 +536,15 @@ void dataProcessing::exportTerzaghiNumericalSolution(double dy, double dt, doubl
 		{
 			int midCols=pressure3DField[0].size()/2;
 			pField[i]=0;
-			pField[i]+=pressure3DField[i][midCols][timeStep]/2;
-			pField[i]+=pressure3DField[i][midCols-1][timeStep]/2;
+			pField[i]+=pressure3DField[i][midCols][aisle]/2;
+			pField[i]+=pressure3DField[i][midCols-1][aisle]/2;
 		}
 	else
 		for(int i=0; i<pField.size(); i++)
 		{
 			int midCols=pressure3DField[0].size()/2;
 			pField[i]=0;
-			pField[i]+=pressure3DField[i][midCols][timeStep];
+			pField[i]+=pressure3DField[i][midCols][aisle];
 		}
 	fieldName="terzaghi_"+pairName+"_PNumeric_dt="+to_string(dt)+"_timeStep="+to_string(timeStep);
 	if(gridType=="staggered") pField.insert(pField.begin(),0);
@@ -487,19 +559,19 @@ void dataProcessing::exportTerzaghiNumericalSolution(double dy, double dt, doubl
 
 	// Exports eField
 	if(strain3DField[0].size()%2==0)
-		for(int i=0; i<pField.size(); i++)
+		for(int i=0; i<eField.size(); i++)
 		{
 			int midCols=strain3DField[0].size()/2;
 			eField[i]=0;
-			eField[i]+=strain3DField[i][midCols][timeStep]/2;
-			eField[i]+=strain3DField[i][midCols-1][timeStep]/2;
+			eField[i]+=strain3DField[i][midCols][aisle]/2;
+			eField[i]+=strain3DField[i][midCols-1][aisle]/2;
 		}
 	else
 		for(int i=0; i<eField.size(); i++)
 		{
 			int midCols=strain3DField[0].size()/2;
 			eField[i]=0;
-			eField[i]+=strain3DField[i][midCols][timeStep];
+			eField[i]+=strain3DField[i][midCols][aisle];
 		}
 	fieldName="terzaghi_"+pairName+"_ENumeric_dt="+to_string(dt)+"_timeStep="+to_string(timeStep);
 	export1DFieldToTxt(eField,fieldName);
@@ -515,15 +587,15 @@ void dataProcessing::exportTerzaghiNumericalSolution(double dy, double dt, doubl
 		{
 			int midCols=vDisplacement3DField[0].size()/2;
 			vField[i]=0;
-			vField[i]+=vDisplacement3DField[i][midCols][timeStep]/2;
-			vField[i]+=vDisplacement3DField[i][midCols-1][timeStep]/2;
+			vField[i]+=vDisplacement3DField[i][midCols][aisle]/2;
+			vField[i]+=vDisplacement3DField[i][midCols-1][aisle]/2;
 		}
 	else
 		for(int i=0; i<vField.size(); i++)
 		{
 			int midCols=vDisplacement3DField[0].size()/2;
 			vField[i]=0;
-			vField[i]+=vDisplacement3DField[i][midCols][timeStep];
+			vField[i]+=vDisplacement3DField[i][midCols][aisle];
 		}
 	fieldName="terzaghi_"+pairName+"_VNumeric_dt="+to_string(dt)+"_timeStep="+to_string(timeStep);
 	export1DFieldToTxt(vField,fieldName);
@@ -638,7 +710,8 @@ void dataProcessing::getTerzaghiErrorNorm(double dy, double dt, double h, double
 	myErrorNorm.v=0;
 	int rowNo=pressure3DField.size();
 	int colNo=pressure3DField[0].size();
-	double time=(pressure3DField[0][0].size()-1)*dt;
+	int aisle=loadTimeStep(timeStepsNo-1);
+	double time=(timeStepsNo-1)*dt;
 	double pExact;
 	double pNumeric;
 	double vExact;
@@ -657,7 +730,7 @@ void dataProcessing::getTerzaghiErrorNorm(double dy, double dt, double h, double
 		for(int j=0; j<colNo; j++)
 		{
 			pExact=terzaghiPAnalyticalSolution(yValue,time,Ly,sigmab,M,alpha,Q,rho,g,rho_f,c);
-			pNumeric=pressure3DField[i][j][aisleNo-1];
+			pNumeric=pressure3DField[i][j][aisle];
 			dividend+=pow((pExact-pNumeric)*h,2);
 			divisor+=pow(h,2);
 		}
@@ -678,7 +751,7 @@ void dataProcessing::getTerzaghiErrorNorm(double dy, double dt, double h, double
 		for(int j=0; j<colNo; j++)
 		{
 			vExact=terzaghiVAnalyticalSolution(yValue,time,Ly,sigmab,M,alpha,Q,rho,g,rho_f,c);
-			vNumeric=vDisplacement3DField[i][j][aisleNo-1];
+			vNumeric=vDisplacement3DField[i][j][aisle];
 			dividend+=pow((vExact-vNumeric)*h,2);
 			divisor+=pow(h,2);
 		}
@@ -721,6 +794,7 @@ void dataProcessing::saveTerzaghiErrorNorm(double dt, double h, double pError, d
 void dataProcessing::exportMandelNumericalSolution(double dx, double dy, double dt, double Lx,
 	double Ly, int timeStep, string pairName)
 {
+	int aisle=loadTimeStep(timeStep);
 	string fieldName;
 	vector<double> xCoordP;xCoordP.resize(pressure3DField[0].size());
 	vector<double> pField;pField.resize(pressure3DField[0].size());
@@ -745,15 +819,15 @@ void dataProcessing::exportMandelNumericalSolution(double dx, double dy, double
 		{
 			int midRows=pressure3DField.size()/2;
 			pField[i]=0;
-			pField[i]+=pressure3DField[midRows][i][timeStep]/2;
-			pField[i]+=pressure3DField[midRows-1][i][timeStep]/2;
+			pField[i]+=pressure3DField[midRows][i][aisle]/2;
+			pField[i]+=pressure3DField[midRows-1][i][aisle]/2;
 		}
 	else
 		for(int i=0; i<pField.size(); i++)
 		{
 			int midRows=pressure3DField.size()/2;
 			pField[i]=0;
-			pField[i]+=pressure3DField[midRows][i][timeStep];
+			pField[i]+=pressure3DField[midRows][i][aisle];
 		}
 	fieldName="mandel_"+pairName+"_PNumeric_dt="+to_string(dt)+"_timeStep="+to_string(timeStep);
 	if(gridType=="staggered") pField.insert(pField.end(),0);
@@ -772,15 +846,15 @@ void dataProcessing::exportMandelNumericalSolution(double dx, double dy, double
 		{
 			int midRows=strain3DField.size()/2;
 			eField[i]=0;
-			eField[i]+=strain3DField[midRows][i][timeStep]/2;
-			eField[i]+=strain3DField[midRows-1][i][timeStep]/2;
+			eField[i]+=strain3DField[midRows][i][aisle]/2;
+			eField[i]+=strain3DField[midRows-1][i][aisle]/2;
 		}
 	else
 		for(int i=0; i<eField.size(); i++)
 		{
 			int midRows=strain3DField.size()/2;
 			eField[i]=0;
-			eField[i]+=strain3DField[midRows][i][timeStep];
+			eField[i]+=strain3DField[midRows][i][aisle];
 		}
 	fieldName="mandel_"+pairName+"_ENumeric_dt="+to_string(dt)+"_timeStep="+to_string(timeStep);
 	export1DFieldToTxt(eField,fieldName);
@@ -796,15 +870,15 @@ void dataProcessing::exportMandelNumericalSolution(double dx, double dy, double
 		{
 			int midRows=uDisplacement3DField.size()/2;
 			uField[i]=0;
-			uField[i]+=uDisplacement3DField[midRows][i][timeStep]/2;
-			uField[i]+=uDisplacement3DField[midRows-1][i][timeStep]/2;
+			uField[i]+=uDisplacement3DField[midRows][i][aisle]/2;
+			uField[i]+=uDisplacement3DField[midRows-1][i][aisle]/2;
 		}
 	else
 		for(int i=0; i<uField.size(); i++)
 		{
 			int midRows=uDisplacement3DField.size()/2;
 			uField[i]=0;
-			uField[i]+=uDisplacement3DField[midRows][i][timeStep];
+			uField[i]+=uDisplacement3DField[midRows][i][aisle];
 		}
 	fieldName="mandel_"+pairName+"_UNumeric_dt="+to_string(dt)+"_timeStep="+to_string(timeStep);
 	export1DFieldToTxt(uField,fieldName);
@@ -820,15 +894,15 @@ void dataProcessing::exportMandelNumericalSolution(double dx, double dy, double
 		{
 			int midCols=vDisplacement3DField[0].size()/2;
 			vField[i]=0;
-			vField[i]+=vDisplacement3DField[i][midCols][timeStep]/2;
-			vField[i]+=vDisplacement3DField[i][midCols-1][timeStep]/2;
+			vField[i]+=vDisplacement3DField[i][midCols][aisle]/2;
+			vField[i]+=vDisplacement3DField[i][midCols-1][aisle]/2;
 		}
 	else
 		for(int i=0; i<vField.size(); i++)
 		{
 			int midCols=vDisplacement3DField[0].size()/2;
 			vField[i]=0;
-			vField[i]+=vDisplacement3DField[i][midCols][timeStep];
+			vField[i]+=vDisplacement3DField[i][midCols][aisle];
 		}
 	fieldName="mandel_"+pairName+"_VNumeric_dt="+to_string(dt)+"_timeStep="+to_string(timeStep);
 	export1DFieldToTxt(vField,fieldName);
@@ -1062,6 +1136,7 @@ void dataProcessing::storeMacroPressure3DField(vector<vector<int>> idP,
 void dataProcessing::exportMacroPressureHSolution(double dy, double h, double Ly, int timeStep,
 	string pairName)
 {
+	int aisle=loadTimeStep(timeStep);
 	string fieldName;
 	vector<double> yCoordP;yCoordP.resize(pressure3DField.size());
 	vector<double> pField;pField.resize(pressure3DField.size());
@@ -1081,15 +1156,15 @@ void dataProcessing::exportMacroPressureHSolution(double dy, double h, double Ly
 		{
 			int midCols=pressure3DField[0].size()/2;
 			pField[i]=0;
-			pField[i]+=pressure3DField[i][midCols][timeStep]/2;
-			pField[i]+=pressure3DField[i][midCols-1][timeStep]/2;
+			pField[i]+=pressure3DField[i][midCols][aisle]/2;
+			pField[i]+=pressure3DField[i][midCols-1][aisle]/2;
 		}
 	else
 		for(int i=0; i<pField.size(); i++)
 		{
 			int midCols=pressure3DField[0].size()/2;
 			pField[i]=0;
-			pField[i]+=pressure3DField[i][midCols][timeStep];
+			pField[i]+=pressure3DField[i][midCols][aisle];
 		}
 	fieldName="terzaghi_"+pairName+"_PNumeric_h="+to_string(h)+"_timeStep="+to_string(timeStep);
 	// if(gridType=="staggered") pField.insert(pField.begin(),0);
@@ -1101,15 +1176,15 @@ void dataProcessing::exportMacroPressureHSolution(double dy, double h, double Ly
 		{
 			int midCols=macroPressure3DField[0].size()/2;
 			pMField[i]=0;
-			pMField[i]+=macroPressure3DField[i][midCols][timeStep]/2;
-			pMField[i]+=macroPressure3DField[i][midCols-1][timeStep]/2;
+			pMField[i]+=macroPressure3DField[i][midCols][aisle]/2;
+			pMField[i]+=macroPressure3DField[i][midCols-1][aisle]/2;
 		}
 	else
 		for(int i=0; i<pMField.size(); i++)
 		{
 			int midCols=macroPressure3DField[0].size()/2;
 			pMField[i]=0;
-			pMField[i]+=macroPressure3DField[i][midCols][timeStep];
+			pMField[i]+=macroPressure3DField[i][midCols][aisle];
 		}
 	fieldName="terzaghi_"+pairName+"_MacroPNumeric_h="+to_string(h)+"_timeStep="+
 		to_string(timeStep);
@@ -1122,6 +1197,7 @@ void dataProcessing::exportMacroPressureHSolution(double dy, double h, double Ly
 void dataProcessing::exportMacroPressureTSolution(double dy, double dt, double Ly, int timeStep,
 	string pairName)
 {
+	int aisle=loadTimeStep(timeStep);
 	string fieldName;
 	vector<double> yCoordP;yCoordP.resize(pressure3DField.size());
 	vector<double> pField;pField.resize(pressure3DField.size());
@@ -1141,15 +1217,15 @@ void dataProcessing::exportMacroPressureTSolution(double dy, double dt, double L
 		{
 			int midCols=pressure3DField[0].size()/2;
 			pField[i]=0;
-			pField[i]+=pressure3DField[i][midCols][timeStep]/2;
-			pField[i]+=pressure3DField[i][midCols-1][timeStep]/2;
+			pField[i]+=pressure3DField[i][midCols][aisle]/2;
+			pField[i]+=pressure3DField[i][midCols-1][aisle]/2;
 		}
 	else
 		for(int i=0; i<pField.size(); i++)
 		{
 			int midCols=pressure3DField[0].size()/2;
 			pField[i]=0;
-			pField[i]+=pressure3DField[i][midCols][timeStep];
+			pField[i]+=pressure3DField[i][midCols][aisle];
 		}
 	fieldName="terzaghi_"+pairName+"_PNumeric_dt="+to_string(dt)+"_timeStep="+to_string(timeStep);
 	// if(gridType=="staggered") pField.insert(pField.begin(),0);
@@ -1161,15 +1237,15 @@ void dataProcessing::exportMacroPressureTSolution(double dy, double dt, double L
 		{
 			int midCols=macroPressure3DField[0].size()/2;
 			pMField[i]=0;
-			pMField[i]+=macroPressure3DField[i][midCols][timeStep]/2;
-			pMField[i]+=macroPressure3DField[i][midCols-1][timeStep]/2;
+			pMField[i]+=macroPressure3DField[i][midCols][aisle]/2;
+			pMField[i]+=macroPressure3DField[i][midCols-1][aisle]/2;
 		}
 	else
 		for(int i=0; i<pMField.size(); i++)
 		{
 			int midCols=macroPressure3DField[0].size()/2;
 			pMField[i]=0;
-			pMField[i]+=macroPressure3DField[i][midCols][timeStep];
+			pMField[i]+=macroPressure3DField[i][midCols][aisle];
 		}
 	fieldName="terzaghi_"+pairName+"_MacroPNumeric_dt="+to_string(dt)+"_timeStep="+
 		to_string(timeStep);
@@ -1182,6 +1258,7 @@ void dataProcessing::exportMacroPressureTSolution(double dy, double dt, double L
 void dataProcessing::exportStripfootTSolution(double dx, double dy, double dt, double Ly,
 	int timeStep, string pairName)
 {
+	int aisle=loadTimeStep(timeStep);
 	string fileName;
 	vector<vector<double>> xCoord, yCoord;
 	double position;
@@ -1246,9 +1323,9 @@ void dataProcessing::exportStripfootTSolution(double dx, double dy, double dt, d
 		{
 			for(int j=0; j<colNo; j++)
 			{
-				pFile << pressure3DField[i][j][timeStep];
+				pFile << pressure3DField[i][j][aisle];
 				pFile << "\t";
-				pMFile << macroPressure3DField[i][j][timeStep];
+				pMFile << macroPressure3DField[i][j][aisle];
 				pMFile << "\t";
 			}
 
@@ -1266,6 +1343,7 @@ void dataProcessing::exportStripfootTSolution(double dx, double dy, double dt, d
 void dataProcessing::exportStripfootHSolution(double dx, double dy, double h, double Ly,
 	int timeStep, string pairName)
 {
+	int aisle=loadTimeStep(timeStep);
 	string fileName;
 	vector<vector<double>> xCoord, yCoord;
 	double position;
@@ -1330,9 +1408,9 @@ void dataProcessing::exportStripfootHSolution(double dx, double dy, double h, do
 		{
 			for(int j=0; j<colNo; j++)
 			{
-				pFile << pressure3DField[i][j][timeStep];
+				pFile << pressure3DField[i][j][aisle];
 				pFile << "\t";
-				pMFile << macroPressure3DField[i][j][timeStep];
+				pMFile << macroPressure3DField[i][j][aisle];
 				pMFile << "\t";
 			}
 
@@ -1345,4 +1423,138 @@ void dataProcessing::exportStripfootHSolution(double dx, double dy, double h, do
 	}
 
 	return;
-}
\ No newline at end of file
+}
+
+vector<vector<pair<int,double>>> dataProcessing::getPyramidWeights(int fineNo, int factor,
+	bool isNode)
+{
+	// Fine FV and weights of each coarse FV along one direction
+	vector<vector<pair<int,double>>> weights;
+
+	if(!isNode)
+	{
+		weights.resize((fineNo+factor-1)/factor);
+		for(int k=0; k<fineNo; k++) weights[k/factor].push_back(make_pair(k,1.0));
+	}
+	else
+	{
+		weights.resize((fineNo-1)/factor+1);
+		for(int K=0; K<weights.size(); K++)
+			for(int d=-factor/2; d<=factor/2; d++)
+				if(K*factor+d>=0 && K*factor+d<fineNo) weights[K].push_back(make_pair(K*factor+d,
+					(2*abs(d)==factor) ? 0.5 : 1.0));
+	}
+
+	return weights;
+}
+
+vector<double> dataProcessing::getPyramidLevel(const vector<vector<vector<double>>>& my3DField,
+	int aisle, bool isNodeRow, bool isNodeColumn, int factor, int& rowNo, int& colNo)
+{
+	vector<vector<pair<int,double>>> rowWeights=getPyramidWeights(my3DField.size(),factor,
+		isNodeRow);
+	vector<vector<pair<int,double>>> colWeights=getPyramidWeights(my3DField[0].size(),factor,
+		isNodeColumn);
+	vector<double> level;
+	double sum, weightSum;
+
+	rowNo=rowWeights.size();
+	colNo=colWeights.size();
+	level.resize(rowNo*colNo);
+	for(int I=0; I<rowNo; I++)
+	{
+		for(int J=0; J<colNo; J++)
+		{
+			sum=0;
+			weightSum=0;
+			for(int a=0; a<rowWeights[I].size(); a++)
+				for(int b=0; b<colWeights[J].size(); b++)
+				{
+					sum+=rowWeights[I][a].second*colWeights[J][b].second*
+						my3DField[rowWeights[I][a].first][colWeights[J][b].first][aisle];
+					weightSum+=rowWeights[I][a].second*colWeights[J][b].second;
+				}
+			level[I*colNo+J]=sum/weightSum;
+		}
+	}
+
+	return level;
+}
+
+void dataProcessing::exportFieldPyramid(string fileName, double dx, double dy, double Ly,
+	int timeStep, int levelsNo)
+{
+	// Header of headerBytes: the magic, fieldsNo and levelsNo, the field names (8 characters) and,
+	// per field and level, factor, rowNo, colNo and offset of the values, then x0, y0, dx and dy of
+	// the first coarse FV (the rows go downwards from y0); the values follow, row by row
+	const int headerBytes=4096;
+	int aisle=loadTimeStep(timeStep);
+	bool isStaggered=(gridType=="staggered");
+	vector<string> fieldNames={"p","pM","eps","u","v"};
+	vector<vector<vector<vector<double>>>*> fields={&pressure3DField,&macroPressure3DField,
+		&strain3DField,&uDisplacement3DField,&vDisplacement3DField};
+	vector<bool> isNodeRow={!isStaggered,!isStaggered,!isStaggered,!isStaggered,true};
+	vector<bool> isNodeColumn={!isStaggered,!isStaggered,!isStaggered,true,!isStaggered};
+	vector<char> header(headerBytes,0);
+	int64_t headerValues[]={0,(int64_t)fields.size(),(int64_t)min(levelsNo,8)};
+	int64_t levelValues[4];
+	double levelCoordinates[4];
+	int64_t offset=headerBytes;
+	int position=sizeof(headerValues);
+	int rowNo, colNo, factor;
+
+	// Single porosity histories have no macro-pressure, whose level is left out
+	if(history!=NULL && history->blockSizes.size()<=3)
+	{
+		fieldNames.erase(fieldNames.begin()+1);
+		fields.erase(fields.begin()+1);
+		isNodeRow.erase(isNodeRow.begin()+1);
+		isNodeColumn.erase(isNodeColumn.begin()+1);
+		headerValues[1]=fields.size();
+	}
+
+	levelsNo=headerValues[2];
+	if(levelsNo<1) return;
+	ofstream myFile(fileName,ios::binary);
+	if(!myFile.is_open()) return;
+
+	memcpy(&headerValues[0],"GFVPYR1",8);
+	memcpy(header.data(),headerValues,sizeof(headerValues));
+	for(int f=0; f<fields.size(); f++)
+	{
+		strncpy(&header[position],fieldNames[f].c_str(),7);
+		position+=8;
+	}
+	myFile.seekp(headerBytes);
+
+	for(int f=0; f<fields.size(); f++)
+	{
+		for(int l=1; l<=levelsNo; l++)
+		{
+			factor=1<<l;
+			vector<double> level=getPyramidLevel(*fields[f],aisle,isNodeRow[f],isNodeColumn[f],
+				factor,rowNo,colNo);
+			myFile.write((char*)level.data(),level.size()*sizeof(double));
+
+			levelValues[0]=factor;
+			levelValues[1]=rowNo;
+			levelValues[2]=colNo;
+			levelValues[3]=offset;
+			levelCoordinates[0]=isNodeColumn[f] ? 0 : factor*dx/2;
+			levelCoordinates[1]=isNodeRow[f] ? Ly : Ly-factor*dy/2;
+			levelCoordinates[2]=factor*dx;
+			levelCoordinates[3]=factor*dy;
+			memcpy(&header[position],levelValues,sizeof(levelValues));
+			memcpy(&header[position+sizeof(levelValues)],levelCoordinates,
+				sizeof(levelCoordinates));
+			position+=sizeof(levelValues)+sizeof(levelCoordinates);
+			offset+=level.size()*sizeof(double);
+		}
+	}
+
+	myFile.seekp(0);
+	myFile.write(header.data(),headerBytes);
+	myFile.close();
+
+	return;
+}
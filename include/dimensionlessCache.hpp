@@ -0,0 +1,155 @@
+/*
+	This header is part of the development of a master's thesis entitled "Analysis of Numerical
+	Schemes in Collocated and Staggered Grids for Problems of Poroelasticity". The class defined
+	here stores solutions of the nondimensionalized consolidation problem, keyed by the
+	dimensionless groups of the discrete system, so that any medium whose groups match a stored
+	solution is served by rescaling instead of being solved again.
+
+	With p*=alpha*p/sigma, u*=M*u/sigma and t*=t/dt the discrete homogeneous problem (without
+	gravity) depends only on the grid, the interpolation scheme, the number of time-steps and
+	the groups alpha^2*Q/M, G/M and K*M*dt/(mu_f*alpha^2).
+
+ 	Written by FERREIRA, C. A. S.
+
+ 	Florianópolis, 2019.
+*/
+
+#include <fstream>
+#include <iostream>
+#include <math.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class dimensionlessCache
+{
+public:
+	// Class variables
+	string cacheDirectory;
+	int significantDigits;
+	int hitsNo;
+	int missesNo;
+
+	// Class functions
+	string getKey(string,string,int,int,double,double,double);
+	string formatGroup(double);
+	bool lookUpSolution(string,vector<vector<double>>&,vector<vector<double>>&,
+		vector<vector<double>>&);
+	void storeSolution(string,vector<vector<double>>,vector<vector<double>>,
+		vector<vector<double>>);
+	void readField(ifstream&,vector<vector<double>>&);
+	void writeField(ofstream&,vector<vector<double>>);
+
+	// Constructor
+	dimensionlessCache(string,double);
+
+	// Destructor
+	~dimensionlessCache();
+};
+
+dimensionlessCache::dimensionlessCache(string myCacheDirectory, double relativeTolerance)
+{
+	cacheDirectory=myCacheDirectory;
+	significantDigits=ceil(-log10(relativeTolerance));
+	if(significantDigits<1) significantDigits=1;
+	hitsNo=0;
+	missesNo=0;
+}
+
+dimensionlessCache::~dimensionlessCache(){}
+
+string dimensionlessCache::getKey(string gridType, string interpScheme, int meshSize, int Nt,
+	double storageGroup, double shearGroup, double mobilityGroup)
+{
+	string key=gridType+"_"+interpScheme+"_mesh="+to_string(meshSize)+"_Nt="+to_string(Nt);
+
+	key+="_S="+formatGroup(storageGroup);
+	key+="_G="+formatGroup(shearGroup);
+	key+="_K="+formatGroup(mobilityGroup);
+
+	return key;
+}
+
+string dimensionlessCache::formatGroup(double value)
+{
+	// Groups are rounded to the significant digits given by the cache tolerance
+	char buffer[64];
+
+	snprintf(buffer,sizeof(buffer),"%.*e",significantDigits-1,value);
+
+	return string(buffer);
+}
+
+bool dimensionlessCache::lookUpSolution(string key, vector<vector<double>>& uField,
+	vector<vector<double>>& vField, vector<vector<double>>& pField)
+{
+	string fileName=cacheDirectory+"dimlessCache_"+key+".bin";
+
+	ifstream myFile(fileName,ios::binary);
+	if(!myFile.is_open())
+	{
+		missesNo++;
+
+		return false;
+	}
+
+	readField(myFile,uField);
+	readField(myFile,vField);
+	readField(myFile,pField);
+	myFile.close();
+
+	hitsNo++;
+
+	return true;
+}
+
+void dimensionlessCache::storeSolution(string key, vector<vector<double>> uField,
+	vector<vector<double>> vField, vector<vector<double>> pField)
+{
+	string fileName=cacheDirectory+"dimlessCache_"+key+".bin";
+
+	ofstream myFile(fileName,ios::binary);
+	if(myFile.is_open())
+	{
+		writeField(myFile,uField);
+		writeField(myFile,vField);
+		writeField(myFile,pField);
+
+		myFile.close();
+	}
+
+	return;
+}
+
+void dimensionlessCache::readField(ifstream& myFile, vector<vector<double>>& myField)
+{
+	int rowNo, colNo;
+
+	myFile.read((char*)&rowNo,sizeof(int));
+	myFile.read((char*)&colNo,sizeof(int));
+
+	myField.resize(rowNo);
+	for(int i=0; i<rowNo; i++)
+	{
+		myField[i].resize(colNo);
+		myFile.read((char*)myField[i].data(),colNo*sizeof(double));
+	}
+
+	return;
+}
+
+void dimensionlessCache::writeField(ofstream& myFile, vector<vector<double>> myField)
+{
+	int rowNo=myField.size();
+	int colNo=0;
+	if(rowNo>0) colNo=myField[0].size();
+
+	myFile.write((char*)&rowNo,sizeof(int));
+	myFile.write((char*)&colNo,sizeof(int));
+
+	for(int i=0; i<rowNo; i++)
+		myFile.write((char*)myField[i].data(),colNo*sizeof(double));
+
+	return;
+}
@@ -23,6 +23,7 @@ class doubleDataProcessing
 public:
 	// Class variables
 	int aisleNo;
+	int timeStepsNo;
 	vector<vector<vector<double>>> uDisplacement3DField;
 	vector<vector<vector<double>>> vDisplacement3DField;
 	vector<vector<vector<double>>> pressure3DField;
@@ -31,6 +32,10 @@ public:
 	string gridType;
 	vector<double> mandelRoots;
 	double mandelTransCoef;
+	solutionHistory* history=NULL;
+	vector<vector<int>> historyIdU, historyIdV, historyIdP;
+	double historyDx, historyDy;
+	int storedTimeStep;
 
 	// Class structures
 	struct errorNorm
@@ -42,6 +47,7 @@ public:
 	} myErrorNorm;
 
 	// Class functions
+	int loadTimeStep(int);
 	void resize3DFields(vector<vector<int>>,vector<vector<int>>,vector<vector<int>>);
 	void storeUDisplacem3DField(vector<vector<int>>,vector<vector<double>>);
 	void storeVDisplacem3DField(vector<vector<int>>,vector<vector<double>>);
@@ -69,6 +75,8 @@ public:
 	doubleDataProcessing(vector<vector<int>>,vector<vector<int>>,vector<vector<int>>,
 		vector<vector<double>>,vector<vector<double>>,vector<vector<double>>,string,string,double,
 		double);
+	doubleDataProcessing(vector<vector<int>>,vector<vector<int>>,vector<vector<int>>,
+		solutionHistory&,string,string,double,double);
 
 	// Destructor
 	~doubleDataProcessing();
@@ -79,6 +87,7 @@ doubleDataProcessing::doubleDataProcessing(vector<vector<int>> idU, vector<vecto
 	vector<vector<double>> pField, string myGridType, string myInterpScheme, double dx, double dy)
 {
 	aisleNo=pField[0].size();
+	timeStepsNo=aisleNo;
 	if(myGridType=="staggered") gridType=myGridType;
 	else if(myGridType=="collocated") gridType=myGridType+"+"+myInterpScheme;
 
@@ -89,8 +98,50 @@ doubleDataProcessing::doubleDataProcessing(vector<vector<int>> idU, vector<vecto
 	storeStrain3DField(idU,idV,idP,dx,dy,uField,vField);
 }
 
+doubleDataProcessing::doubleDataProcessing(vector<vector<int>> idU, vector<vector<int>> idV,
+	vector<vector<int>> idP, solutionHistory& myHistory, string myGridType,
+	string myInterpScheme, double dx, double dy)
+{
+	// The 3D fields hold a single time-step, decoded from the history when first accessed
+	aisleNo=1;
+	timeStepsNo=myHistory.snapshotsNo;
+	if(myGridType=="staggered") gridType=myGridType;
+	else if(myGridType=="collocated") gridType=myGridType+"+"+myInterpScheme;
+
+	history=&myHistory;
+	historyIdU=idU;
+	historyIdV=idV;
+	historyIdP=idP;
+	historyDx=dx;
+	historyDy=dy;
+	storedTimeStep=-1;
+
+	resize3DFields(idU,idV,idP);
+}
+
 doubleDataProcessing::~doubleDataProcessing(){}
 
+int doubleDataProcessing::loadTimeStep(int timeStep)
+{
+	// Aisle of the 3D fields which holds the given time-step
+	vector<vector<double>> uField, vField, pField, pMField;
+
+	if(history==NULL) return timeStep;
+
+	if(timeStep!=storedTimeStep)
+	{
+		history->splitSnapshot(history->getSnapshotView(timeStep),uField,vField,pField,pMField);
+		storeUDisplacem3DField(historyIdU,uField);
+		storeVDisplacem3DField(historyIdV,vField);
+		storePressure3DField(historyIdP,pField);
+		storeMacroPressure3DField(historyIdP,pMField);
+		storeStrain3DField(historyIdU,historyIdV,historyIdP,historyDx,historyDy,uField,vField);
+		storedTimeStep=timeStep;
+	}
+
+	return 0;
+}
+
 void doubleDataProcessing::resize3DFields(vector<vector<int>> idU, vector<vector<int>> idV,
 	vector<vector<int>> idP)
 {
@@ -340,6 +391,7 @@ void doubleDataProcessing::storeMacroPressure3DField(vector<vector<int>> idP,
 void doubleDataProcessing::exportSealedDoubleNumericalSolution(double dy, double dt, double Ly,
 	int timeStep, string pairName)
 {
+	int aisle=loadTimeStep(timeStep);
 	string fieldName;
 	vector<double> yCoordP;yCoordP.resize(pressure3DField.size());
 	vector<double> pField;pField.resize(pressure3DField.size());
@@ -360,15 +412,15 @@ void doubleDataProcessing::exportSealedDoubleNumericalSolution(double dy, double
 		{
 			int midCols=pressure3DField[0].size()/2;
 			pField[i]=0;
-			pField[i]+=pressure3DField[i][midCols][timeStep]/2;
-			pField[i]+=pressure3DField[i][midCols-1][timeStep]/2;
+			pField[i]+=pressure3DField[i][midCols][aisle]/2;
+			pField[i]+=pressure3DField[i][midCols-1][aisle]/2;
 		}
 	else
 		for(int i=0; i<pField.size(); i++)
 		{
 			int midCols=pressure3DField[0].size()/2;
 			pField[i]=0;
-			pField[i]+=pressure3DField[i][midCols][timeStep];
+			pField[i]+=pressure3DField[i][midCols][aisle];
 		}
 	fieldName="sealedDouble_"+pairName+"_PPoreNumeric_dt="+to_string(dt)+"_timeStep="+
 		to_string(timeStep);
@@ -380,15 +432,15 @@ void doubleDataProcessing::exportSealedDoubleNumericalSolution(double dy, double
 		{
 			int midCols=macroPressure3DField[0].size()/2;
 			pField[i]=0;
-			pField[i]+=macroPressure3DField[i][midCols][timeStep]/2;
-			pField[i]+=macroPressure3DField[i][midCols-1][timeStep]/2;
+			pField[i]+=macroPressure3DField[i][midCols][aisle]/2;
+			pField[i]+=macroPressure3DField[i][midCols-1][aisle]/2;
 		}
 	else
 		for(int i=0; i<pField.size(); i++)
 		{
 			int midCols=macroPressure3DField[0].size()/2;
 			pField[i]=0;
-			pField[i]+=macroPressure3DField[i][midCols][timeStep];
+			pField[i]+=macroPressure3DField[i][midCols][aisle];
 		}
 	fieldName="sealedDouble_"+pairName+"_PFracNumeric_dt="+to_string(dt)+"_timeStep="+
 		to_string(timeStep);
@@ -406,15 +458,15 @@ void doubleDataProcessing::exportSealedDoubleNumericalSolution(double dy, double
 		{
 			int midCols=vDisplacement3DField[0].size()/2;
 			vField[i]=0;
-			vField[i]+=vDisplacement3DField[i][midCols][timeStep]/2;
-			vField[i]+=vDisplacement3DField[i][midCols-1][timeStep]/2;
+			vField[i]+=vDisplacement3DField[i][midCols][aisle]/2;
+			vField[i]+=vDisplacement3DField[i][midCols-1][aisle]/2;
 		}
 	else
 		for(int i=0; i<vField.size(); i++)
 		{
 			int midCols=vDisplacement3DField[0].size()/2;
 			vField[i]=0;
-			vField[i]+=vDisplacement3DField[i][midCols][timeStep];
+			vField[i]+=vDisplacement3DField[i][midCols][aisle];
 		}
 	fieldName="sealedDouble_"+pairName+"_VNumeric_dt="+to_string(dt)+"_timeStep="+
 		to_string(timeStep);
@@ -470,6 +522,7 @@ void doubleDataProcessing::exportSealedDoubleAnalyticalSolution(double Ly, doubl
 void doubleDataProcessing::exportDrainedDoubleNumericalSolution(double dy, double dt, double Ly,
 	int timeStep, string pairName)
 {
+	int aisle=loadTimeStep(timeStep);
 	string fieldName;
 	vector<double> yCoordP;yCoordP.resize(pressure3DField.size());
 	vector<double> pField;pField.resize(pressure3DField.size());
@@ -490,15 +543,15 @@ void doubleDataProcessing::exportDrainedDoubleNumericalSolution(double dy, doubl
 		{
 			int midCols=pressure3DField[0].size()/2;
 			pField[i]=0;
-			pField[i]+=pressure3DField[i][midCols][timeStep]/2;
-			pField[i]+=pressure3DField[i][midCols-1][timeStep]/2;
+			pField[i]+=pressure3DField[i][midCols][aisle]/2;
+			pField[i]+=pressure3DField[i][midCols-1][aisle]/2;
 		}
 	else
 		for(int i=0; i<pField.size(); i++)
 		{
 			int midCols=pressure3DField[0].size()/2;
 			pField[i]=0;
-			pField[i]+=pressure3DField[i][midCols][timeStep];
+			pField[i]+=pressure3DField[i][midCols][aisle];
 		}
 	fieldName="drainedDouble_"+pairName+"_PPoreNumeric_dt="+to_string(dt)+"_timeStep="+
 		to_string(timeStep);
@@ -511,15 +564,15 @@ void doubleDataProcessing::exportDrainedDoubleNumericalSolution(double dy, doubl
 		{
 			int midCols=macroPressure3DField[0].size()/2;
 			pMField[i]=0;
-			pMField[i]+=macroPressure3DField[i][midCols][timeStep]/2;
-			pMField[i]+=macroPressure3DField[i][midCols-1][timeStep]/2;
+			pMField[i]+=macroPressure3DField[i][midCols][aisle]/2;
+			pMField[i]+=macroPressure3DField[i][midCols-1][aisle]/2;
 		}
 	else
 		for(int i=0; i<pMField.size(); i++)
 		{
 			int midCols=macroPressure3DField[0].size()/2;
 			pMField[i]=0;
-			pMField[i]+=macroPressure3DField[i][midCols][timeStep];
+			pMField[i]+=macroPressure3DField[i][midCols][aisle];
 		}
 	fieldName="drainedDouble_"+pairName+"_PFracNumeric_dt="+to_string(dt)+"_timeStep="+
 		to_string(timeStep);
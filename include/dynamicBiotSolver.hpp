@@ -0,0 +1,468 @@
+/*
+	This header is part of the development of a master's thesis entitled "Analysis of Numerical
+	Schemes in Collocated and Staggered Grids for Problems of Poroelasticity". The class defined
+	here solves the dynamic Biot equations [1], for the propagation of waves in the saturated medium
+	under seismic or impact loads, with explicit time-steps on the staggered grid, as in the
+	velocity-stress scheme of Virieux [2] extended to the poroelastic case [3]. The unknowns are the
+	solid velocity (vx, vy), the filtration velocity q=phi*(v_f-v), the total stresses (positive in
+	tension) and the pore pressure:
+
+		rho*dv/dt+rho_f*dq/dt=div(sigma)
+		rho_f*dv/dt+m*dq/dt+(mu_f/K)*q=-grad(p)
+		dsigma/dt=G*(grad(v)+grad(v)^T)+(lambda_u*div(v)+alpha*Q*div(q))*I
+		dp/dt=-Q*(alpha*div(v)+div(q))
+
+	with lambda_u=lambda+alpha^2*Q and m=T*rho_f/phi, T the tortuosity. The pressure and the normal
+	stresses are at the centroids, vx and qx at the position of u, vy and qy at the position of v
+	and the shear stress at the vertices. The velocities and stresses are leapfrogged, the drag of
+	the fluid is implicit, for it is much faster than the waves, and the time-step is the CFL limit
+	of the fast compressional wave. The top is a drained free surface loaded on a strip by a Ricker
+	pulse and the other boundaries absorb the waves in a layer of exponential damping [4].
+
+	The fields are flat arrays, row by row from the top of the grid, and each kernel sweeps whole
+	rows with unit stride through restrict pointers, so that the compiler vectorizes it. A time-step
+	streams about bytesPerCellUpdate bytes per centroid, so that the throughput is compared to the
+	triad bandwidth of the machine.
+
+ 	Written by FERREIRA, C. A. S.
+
+ 	Florianópolis, 2019.
+
+ 	[1] BIOT, M. A. Theory of Propagation of Elastic Waves in a Fluid-Saturated Porous Solid.
+ 	Journal of the Acoustical Society of America, 28, 1956.
+ 	[2] VIRIEUX, J. P-SV Wave Propagation in Heterogeneous Media: Velocity-Stress Finite-Difference
+ 	Method. Geophysics, 51, 1986.
+ 	[3] CARCIONE, J. M. et al. Computational Poroelasticity - A Review. Geophysics, 75, 2010.
+ 	[4] CERJAN, C. et al. A Nonreflecting Boundary Condition for Discrete Acoustic and Elastic
+ 	Wave Equations. Geophysics, 50, 1985.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <math.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class dynamicBiotSolver
+{
+public:
+	// Class variables
+	static const int bytesPerCellUpdate=224;
+	int Nx;
+	int Ny;
+	double dx;
+	double dy;
+	double dt;
+	double Lx;
+	double Ly;
+	double G;
+	double lambda;
+	double alpha;
+	double Q;
+	double phi;
+	double rho;
+	double rho_f;
+	double m;
+	double drag;
+	double fastVelocity;
+	double slowVelocity;
+	double shearVelocity;
+	double sigmab;
+	double frequency;
+	double delay;
+	int stripStart;
+	int stripEnd;
+	int stepsNo=0;
+	vector<double> vx, qx; // Ny x (Nx+1)
+	vector<double> vy, qy; // (Ny+1) x Nx
+	vector<double> sxx, syy, p; // Ny x Nx
+	vector<double> sxy; // (Ny+1) x (Nx+1)
+	vector<double> dampXCentroid, dampXFace, dampYCentroid, dampYFace;
+	vector<double> surfaceVelocity;
+	double qOld, qForce, qGrad;
+	double vForce, vGrad, vDrag;
+	double stepSeconds=0;
+
+	// Class functions
+	void computeWaveVelocities();
+	void computeTimeStep(double);
+	double getDampingFactor(double,double,double);
+	void buildAbsorbingLayers(int);
+	double getSourceLoad(double);
+	void updateVelocities(double);
+	void updateStresses();
+	void step();
+	double getMaxVelocity();
+	double measureTriadBandwidth();
+	void exportCentroidFields(string,string);
+	void exportSurfaceVelocity(string,int);
+
+	// Constructor
+	dynamicBiotSolver(int,int,double,double,double,double,double,double,double,double,double,double,
+		double,double,double,double,double,int,double);
+
+	// Destructor
+	~dynamicBiotSolver();
+};
+
+dynamicBiotSolver::dynamicBiotSolver(int numberOfXFV, int numberOfYFV, double deltax,
+	double deltay, double shearModulus, double lames1stParameter, double biotCoefficient,
+	double biotModulus, double porosity, double solidDensity, double fluidDensity,
+	double fluidViscosity, double permeability, double tortuosity, double stripLoad,
+	double pulseFrequency, double courantNumber, int absorbingLayerWidth, double stripWidth)
+{
+	Nx=numberOfXFV;
+	Ny=numberOfYFV;
+	dx=deltax;
+	dy=deltay;
+	Lx=Nx*dx;
+	Ly=Ny*dy;
+	G=shearModulus;
+	lambda=lames1stParameter;
+	alpha=biotCoefficient;
+	Q=biotModulus;
+	phi=porosity;
+	rho_f=fluidDensity;
+	rho=phi*rho_f+(1-phi)*solidDensity;
+	m=tortuosity*rho_f/phi;
+	drag=fluidViscosity/permeability;
+	sigmab=stripLoad;
+
+	// Strip centered on the top
+	stripStart=max((int)round((Lx-stripWidth)/(2*dx)),0);
+	stripEnd=min((int)round((Lx+stripWidth)/(2*dx)),Nx);
+
+	computeWaveVelocities();
+	computeTimeStep(courantNumber);
+	buildAbsorbingLayers(absorbingLayerWidth);
+
+	// Ricker pulse resolved by about 20 FV per shear wavelength when no frequency is given
+	frequency=(pulseFrequency>0) ? pulseFrequency : shearVelocity/(20*max(dx,dy));
+	delay=1.2/frequency;
+
+	vx.assign(Ny*(Nx+1),0);
+	qx.assign(Ny*(Nx+1),0);
+	vy.assign((Ny+1)*Nx,0);
+	qy.assign((Ny+1)*Nx,0);
+	sxx.assign(Ny*Nx,0);
+	syy.assign(Ny*Nx,0);
+	p.assign(Ny*Nx,0);
+	sxy.assign((Ny+1)*(Nx+1),0);
+
+	// Coefficients of the velocity update, with the drag implicit in q
+	double D=rho*m-rho_f*rho_f;
+	qOld=1/(1+dt*rho*drag/D);
+	qForce=-dt*rho_f/D*qOld;
+	qGrad=-dt*rho/D*qOld;
+	vForce=dt*m/D;
+	vGrad=dt*rho_f/D;
+	vDrag=dt*rho_f*drag/D;
+}
+
+dynamicBiotSolver::~dynamicBiotSolver(){}
+
+void dynamicBiotSolver::computeWaveVelocities()
+{
+	// Roots of det(H-v^2*R)=0, H the undrained stiffness and R the density matrix [1]
+	double H=lambda+alpha*alpha*Q+2*G;
+	double a=rho*m-rho_f*rho_f;
+	double b=-(H*m+Q*rho-2*alpha*Q*rho_f);
+	double c=H*Q-alpha*alpha*Q*Q;
+	double root=sqrt(max(b*b-4*a*c,0.));
+
+	fastVelocity=sqrt((-b+root)/(2*a));
+	slowVelocity=sqrt(max((-b-root)/(2*a),0.));
+	shearVelocity=sqrt(G/(rho-rho_f*rho_f/m));
+
+	return;
+}
+
+void dynamicBiotSolver::computeTimeStep(double courantNumber)
+{
+	dt=courantNumber/(fastVelocity*sqrt(1/(dx*dx)+1/(dy*dy)));
+
+	return;
+}
+
+double dynamicBiotSolver::getDampingFactor(double position, double length, double layerLength)
+{
+	// Decays from 1 at the inner edge of the layer to exp(-0.3^2) at the boundary, as in [4]
+	double depth=max(layerLength-position,position-(length-layerLength));
+
+	if(depth<=0) return 1;
+
+	return exp(-pow(0.3*depth/layerLength,2));
+}
+
+void dynamicBiotSolver::buildAbsorbingLayers(int layerWidth)
+{
+	double layerX=layerWidth*dx;
+	double layerY=layerWidth*dy;
+
+	dampXCentroid.resize(Nx);
+	dampXFace.resize(Nx+1);
+	dampYCentroid.resize(Ny);
+	dampYFace.resize(Ny+1);
+	for(int j=0; j<Nx; j++) dampXCentroid[j]=getDampingFactor((j+0.5)*dx,Lx,layerX);
+	for(int j=0; j<=Nx; j++) dampXFace[j]=getDampingFactor(j*dx,Lx,layerX);
+
+	// No layer at the free surface, the rows are numbered from the top
+	for(int i=0; i<Ny; i++) dampYCentroid[i]=getDampingFactor(Ly-(i+0.5)*dy,2*Ly,layerY);
+	for(int i=0; i<=Ny; i++) dampYFace[i]=getDampingFactor(Ly-i*dy,2*Ly,layerY);
+
+	return;
+}
+
+double dynamicBiotSolver::getSourceLoad(double time)
+{
+	double arg=pow(M_PI*frequency*(time-delay),2);
+
+	return sigmab*(1-2*arg)*exp(-arg);
+}
+
+void dynamicBiotSolver::updateVelocities(double time)
+{
+	const double rdx=1/dx, rdy=1/dy;
+	const double topLoad=getSourceLoad(time);
+	const int NxU=Nx+1;
+	double* __restrict__ myVx=vx.data();
+	double* __restrict__ myQx=qx.data();
+	double* __restrict__ myVy=vy.data();
+	double* __restrict__ myQy=qy.data();
+	const double* __restrict__ mySxx=sxx.data();
+	const double* __restrict__ mySyy=syy.data();
+	const double* __restrict__ mySxy=sxy.data();
+	const double* __restrict__ myP=p.data();
+
+	// vx and qx, rigid at the lateral boundaries
+	for(int i=0; i<Ny; i++)
+	{
+		const double* sxxRow=mySxx+i*Nx;
+		const double* pRow=myP+i*Nx;
+		const double* sxyUp=mySxy+i*NxU;
+		const double* sxyDown=mySxy+(i+1)*NxU;
+		double* vRow=myVx+i*NxU;
+		double* qRow=myQx+i*NxU;
+		const double dampY=dampYCentroid[i];
+
+		for(int j=1; j<Nx; j++)
+		{
+			double force=(sxxRow[j]-sxxRow[j-1])*rdx+(sxyUp[j]-sxyDown[j])*rdy;
+			double grad=(pRow[j]-pRow[j-1])*rdx;
+			double q=qOld*qRow[j]+qForce*force+qGrad*grad;
+			double damp=dampY*dampXFace[j];
+
+			vRow[j]=(vRow[j]+vForce*force+vGrad*grad+vDrag*q)*damp;
+			qRow[j]=q*damp;
+		}
+	}
+
+	// vy and qy, the first row on the loaded and drained free surface
+	for(int i=0; i<Ny; i++)
+	{
+		const double* syyDown=mySyy+i*Nx;
+		const double* pDown=myP+i*Nx;
+		const double* sxyRow=mySxy+i*NxU;
+		double* vRow=myVy+i*Nx;
+		double* qRow=myQy+i*Nx;
+		const double dampY=dampYFace[i];
+
+		if(i==0)
+		{
+			for(int j=0; j<Nx; j++)
+			{
+				double load=(j>=stripStart && j<stripEnd) ? topLoad : 0;
+				double force=(sxyRow[j+1]-sxyRow[j])*rdx+(load-syyDown[j])*2*rdy;
+				double grad=-pDown[j]*2*rdy;
+				double q=qOld*qRow[j]+qForce*force+qGrad*grad;
+
+				vRow[j]=(vRow[j]+vForce*force+vGrad*grad+vDrag*q)*dampXCentroid[j];
+				qRow[j]=q*dampXCentroid[j];
+			}
+
+			continue;
+		}
+
+		const double* syyUp=mySyy+(i-1)*Nx;
+		const double* pUp=myP+(i-1)*Nx;
+
+		for(int j=0; j<Nx; j++)
+		{
+			double force=(sxyRow[j+1]-sxyRow[j])*rdx+(syyUp[j]-syyDown[j])*rdy;
+			double grad=(pUp[j]-pDown[j])*rdy;
+			double q=qOld*qRow[j]+qForce*force+qGrad*grad;
+			double damp=dampY*dampXCentroid[j];
+
+			vRow[j]=(vRow[j]+vForce*force+vGrad*grad+vDrag*q)*damp;
+			qRow[j]=q*damp;
+		}
+	}
+
+	return;
+}
+
+void dynamicBiotSolver::updateStresses()
+{
+	const double rdx=1/dx, rdy=1/dy;
+	const double lambda_u=lambda+alpha*alpha*Q;
+	const double cL=dt*(lambda_u+2*G), cLambda=dt*lambda_u, cQ=dt*alpha*Q;
+	const double cP=-dt*Q, cG=dt*G;
+	const int NxU=Nx+1;
+	double* __restrict__ mySxx=sxx.data();
+	double* __restrict__ mySyy=syy.data();
+	double* __restrict__ mySxy=sxy.data();
+	double* __restrict__ myP=p.data();
+	const double* __restrict__ myVx=vx.data();
+	const double* __restrict__ myQx=qx.data();
+	const double* __restrict__ myVy=vy.data();
+	const double* __restrict__ myQy=qy.data();
+
+	// Normal stresses and pressure at the centroids
+	for(int i=0; i<Ny; i++)
+	{
+		const double* vxRow=myVx+i*NxU;
+		const double* qxRow=myQx+i*NxU;
+		const double* vyUp=myVy+i*Nx;
+		const double* vyDown=myVy+(i+1)*Nx;
+		const double* qyUp=myQy+i*Nx;
+		const double* qyDown=myQy+(i+1)*Nx;
+		double* sxxRow=mySxx+i*Nx;
+		double* syyRow=mySyy+i*Nx;
+		double* pRow=myP+i*Nx;
+		const double dampY=dampYCentroid[i];
+
+		for(int j=0; j<Nx; j++)
+		{
+			double dvx=(vxRow[j+1]-vxRow[j])*rdx;
+			double dvy=(vyUp[j]-vyDown[j])*rdy;
+			double divQ=(qxRow[j+1]-qxRow[j])*rdx+(qyUp[j]-qyDown[j])*rdy;
+			double damp=dampY*dampXCentroid[j];
+
+			sxxRow[j]=(sxxRow[j]+cL*dvx+cLambda*dvy+cQ*divQ)*damp;
+			syyRow[j]=(syyRow[j]+cLambda*dvx+cL*dvy+cQ*divQ)*damp;
+			pRow[j]=(pRow[j]+cP*(alpha*(dvx+dvy)+divQ))*damp;
+		}
+	}
+
+	// Shear stress at the inner vertices, null on the free surface
+	for(int i=1; i<Ny; i++)
+	{
+		const double* vxUp=myVx+(i-1)*NxU;
+		const double* vxDown=myVx+i*NxU;
+		const double* vyRow=myVy+i*Nx;
+		double* sxyRow=mySxy+i*NxU;
+		const double dampY=dampYFace[i];
+
+		for(int j=1; j<Nx; j++)
+		{
+			double strain=(vxUp[j]-vxDown[j])*rdy+(vyRow[j]-vyRow[j-1])*rdx;
+
+			sxyRow[j]=(sxyRow[j]+cG*strain)*dampY*dampXFace[j];
+		}
+	}
+
+	return;
+}
+
+void dynamicBiotSolver::step()
+{
+	chrono::steady_clock::time_point start=chrono::steady_clock::now();
+
+	// Velocities at (n+1/2)*dt, then stresses at (n+1)*dt
+	updateVelocities((stepsNo+0.5)*dt);
+	updateStresses();
+	stepSeconds+=chrono::duration<double>(chrono::steady_clock::now()-start).count();
+	stepsNo++;
+
+	// Vertical velocity of the surface under the center of the strip
+	surfaceVelocity.push_back(vy[Nx/2]);
+
+	return;
+}
+
+double dynamicBiotSolver::getMaxVelocity()
+{
+	double maxVelocity=0;
+
+	for(double value : vy) maxVelocity=max(maxVelocity,fabs(value));
+	for(double value : vx) maxVelocity=max(maxVelocity,fabs(value));
+
+	return maxVelocity;
+}
+
+double dynamicBiotSolver::measureTriadBandwidth()
+{
+	// a=b+s*c over arrays as large as the eight fields, best of 5 [bytes/s]
+	int n=8*(Nx+1)*(Ny+1)/3;
+	vector<double> a(n,0), b(n,1), c(n,2);
+	double bestSeconds=1e300;
+
+	for(int repetition=0; repetition<5; repetition++)
+	{
+		chrono::steady_clock::time_point start=chrono::steady_clock::now();
+		double* __restrict__ myA=a.data();
+		const double* __restrict__ myB=b.data();
+		const double* __restrict__ myC=c.data();
+		for(int k=0; k<n; k++) myA[k]=myB[k]+0.5*myC[k];
+		bestSeconds=min(bestSeconds,
+			chrono::duration<double>(chrono::steady_clock::now()-start).count());
+		b[repetition]=a[n-1-repetition];
+	}
+
+	return 3.*8*n/bestSeconds;
+}
+
+void dynamicBiotSolver::exportCentroidFields(string pairName, string label)
+{
+	string fileName;
+
+	fileName="../export/dynamic_"+pairName+"_PNumeric_"+label+"_staggered-grid.txt";
+	ofstream pFile(fileName);
+	fileName="../export/dynamic_"+pairName+"_VyNumeric_"+label+"_staggered-grid.txt";
+	ofstream vFile(fileName);
+	if(pFile.is_open() && vFile.is_open())
+	{
+		for(int i=0; i<Ny; i++)
+		{
+			for(int j=0; j<Nx; j++)
+			{
+				pFile << p[i*Nx+j];
+				pFile << "\t";
+				vFile << 0.5*(vy[i*Nx+j]+vy[(i+1)*Nx+j]);
+				vFile << "\t";
+			}
+
+			pFile << "\n";
+			vFile << "\n";
+		}
+
+		pFile.close();
+		vFile.close();
+	}
+
+	return;
+}
+
+void dynamicBiotSolver::exportSurfaceVelocity(string pairName, int meshSize)
+{
+	string fileName="../export/dynamic_"+pairName+"_surfaceVelocity_mesh="+to_string(meshSize)+
+		"_staggered-grid.txt";
+	ofstream myFile(fileName);
+
+	if(myFile.is_open())
+	{
+		for(int timeStep=0; timeStep<surfaceVelocity.size(); timeStep++)
+		{
+			myFile << (timeStep+0.5)*dt << "\t" << getSourceLoad((timeStep+0.5)*dt) << "\t" <<
+				surfaceVelocity[timeStep] << "\n";
+		}
+
+		myFile.close();
+	}
+
+	return;
+}
@@ -0,0 +1,229 @@
+/*
+	This header is part of the development of a master's thesis entitled "Analysis of Numerical
+	Schemes in Collocated and Staggered Grids for Problems of Poroelasticity". The class defined
+	here accumulates, one realization at a time, the statistics of time series produced by an
+	ensemble of simulations: mean and variance with Welford's algorithm [1] and quantiles with the
+	P-square algorithm [2], so that no realization has to be stored.
+
+ 	Written by FERREIRA, C. A. S.
+
+ 	Florianópolis, 2019.
+
+ 	[1] WELFORD, B. P. Note on a Method for Calculating Corrected Sums of Squares and Products.
+ 	Technometrics, v. 4, pp. 419-420, 1962.
+ 	[2] JAIN, R.; CHLAMTAC, I. The P2 Algorithm for Dynamic Calculation of Quantiles and
+ 	Histograms Without Storing Observations. Communications of the ACM, v. 28, pp. 1076-1085, 1985.
+*/
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <math.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class ensembleStatistics
+{
+public:
+	// Class variables
+	vector<string> seriesNames;
+	vector<double> quantileLevels;
+	int Nt;
+	int samplesNo;
+	vector<vector<double>> meanValues;
+	vector<vector<double>> squaredDeviations;
+	vector<vector<vector<vector<double>>>> markerHeights;
+	vector<vector<vector<vector<double>>>> markerPositions;
+	vector<vector<vector<vector<double>>>> desiredPositions;
+
+	// Class functions
+	void addSample(vector<vector<double>>);
+	void addQuantileSample(double,vector<double>&,vector<double>&,vector<double>&,double);
+	double getParabolicHeight(vector<double>&,vector<double>&,int,double);
+	double getVariance(int,int);
+	double getQuantile(int,int,int);
+	void exportStatistics(string,double);
+
+	// Constructor
+	ensembleStatistics(vector<string>,vector<double>,int);
+
+	// Destructor
+	~ensembleStatistics();
+};
+
+ensembleStatistics::ensembleStatistics(vector<string> mySeriesNames,
+	vector<double> myQuantileLevels, int myNt)
+{
+	seriesNames=mySeriesNames;
+	quantileLevels=myQuantileLevels;
+	Nt=myNt;
+	samplesNo=0;
+
+	int seriesNo=seriesNames.size();
+	int quantilesNo=quantileLevels.size();
+
+	meanValues.assign(seriesNo,vector<double>(Nt,0));
+	squaredDeviations.assign(seriesNo,vector<double>(Nt,0));
+	markerHeights.assign(seriesNo,vector<vector<vector<double>>>(Nt,
+		vector<vector<double>>(quantilesNo)));
+	markerPositions=markerHeights;
+	desiredPositions=markerHeights;
+}
+
+ensembleStatistics::~ensembleStatistics(){}
+
+void ensembleStatistics::addSample(vector<vector<double>> series)
+{
+	// series[s][t] holds the value of series s at time-step t of one realization
+	double delta;
+
+	samplesNo++;
+
+	for(int s=0; s<seriesNames.size(); s++)
+		for(int t=0; t<Nt; t++)
+		{
+			delta=series[s][t]-meanValues[s][t];
+			meanValues[s][t]+=delta/samplesNo;
+			squaredDeviations[s][t]+=delta*(series[s][t]-meanValues[s][t]);
+
+			for(int q=0; q<quantileLevels.size(); q++)
+				addQuantileSample(quantileLevels[q],markerHeights[s][t][q],
+					markerPositions[s][t][q],desiredPositions[s][t][q],series[s][t]);
+		}
+
+	return;
+}
+
+void ensembleStatistics::addQuantileSample(double level, vector<double>& height,
+	vector<double>& position, vector<double>& desired, double x)
+{
+	vector<double> increment={0,level/2,level,(1+level)/2,1};
+	int k, step;
+	double d, newHeight;
+
+	// The first five observations initialize the markers
+	if(height.size()<5)
+	{
+		height.push_back(x);
+		if(height.size()==5)
+		{
+			sort(height.begin(),height.end());
+			position={1,2,3,4,5};
+			desired={1,1+2*level,1+4*level,3+2*level,5};
+		}
+
+		return;
+	}
+
+	// Cell k of the observation, extreme markers follow the minimum and maximum
+	if(x<height[0])
+	{
+		height[0]=x;
+		k=0;
+	}
+	else if(x>=height[4])
+	{
+		height[4]=x;
+		k=3;
+	}
+	else
+	{
+		k=0;
+		while(x>=height[k+1]) k++;
+	}
+
+	for(int i=k+1; i<5; i++) position[i]++;
+	for(int i=0; i<5; i++) desired[i]+=increment[i];
+
+	// Middle markers are moved by one position when off their desired positions
+	for(int i=1; i<4; i++)
+	{
+		d=desired[i]-position[i];
+		if((d>=1 && position[i+1]-position[i]>1) || (d<=-1 && position[i-1]-position[i]<-1))
+		{
+			step=(d>0) ? 1 : -1;
+
+			newHeight=getParabolicHeight(height,position,i,step);
+			if(height[i-1]<newHeight && newHeight<height[i+1]) height[i]=newHeight;
+			else height[i]+=step*(height[i+step]-height[i])/(position[i+step]-position[i]);
+
+			position[i]+=step;
+		}
+	}
+
+	return;
+}
+
+double ensembleStatistics::getParabolicHeight(vector<double>& height, vector<double>& position,
+	int i, double d)
+{
+	double newHeight;
+
+	newHeight=height[i]+d/(position[i+1]-position[i-1])*
+		((position[i]-position[i-1]+d)*(height[i+1]-height[i])/(position[i+1]-position[i])+
+		(position[i+1]-position[i]-d)*(height[i]-height[i-1])/(position[i]-position[i-1]));
+
+	return newHeight;
+}
+
+double ensembleStatistics::getVariance(int s, int t)
+{
+	if(samplesNo<2) return 0;
+
+	return squaredDeviations[s][t]/(samplesNo-1);
+}
+
+double ensembleStatistics::getQuantile(int s, int t, int q)
+{
+	vector<double> height=markerHeights[s][t][q];
+	int rank;
+
+	if(height.empty()) return 0;
+	if(height.size()==5 && samplesNo>=5) return height[2];
+
+	// Too few samples for the markers, the quantile is taken from the sorted observations
+	sort(height.begin(),height.end());
+	rank=round(quantileLevels[q]*(height.size()-1));
+
+	return height[rank];
+}
+
+void ensembleStatistics::exportStatistics(string fileName, double dt)
+{
+	ofstream myFile(fileName);
+
+	if(!myFile.is_open())
+	{
+		cout << "Unable to open " << fileName << "\n";
+
+		return;
+	}
+
+	myFile << "# realizations=" << samplesNo << "\n";
+	myFile << "# t";
+	for(int s=0; s<seriesNames.size(); s++)
+	{
+		myFile << " " << seriesNames[s] << "_mean " << seriesNames[s] << "_std";
+		for(int q=0; q<quantileLevels.size(); q++)
+			myFile << " " << seriesNames[s] << "_q" << quantileLevels[q];
+	}
+	myFile << "\n";
+
+	for(int t=0; t<Nt; t++)
+	{
+		myFile << t*dt;
+		for(int s=0; s<seriesNames.size(); s++)
+		{
+			myFile << " " << meanValues[s][t] << " " << sqrt(getVariance(s,t));
+			for(int q=0; q<quantileLevels.size(); q++)
+				myFile << " " << getQuantile(s,t,q);
+		}
+		myFile << "\n";
+	}
+
+	myFile.close();
+
+	return;
+}
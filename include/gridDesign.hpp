@@ -4,11 +4,19 @@
 	here contains the functions for creation of the grid for discretizing the poroelasticity 
 	problem.
 
+	The FV are numbered row by row. With the cellOrdering morton or hilbert the active FV of each
+	field are renumbered along the Morton (Z) or the Hilbert curve within square tiles of
+	orderingTile FV, the tiles taken row by row (a single tile covers the grid if orderingTile is 0),
+	so that the N and S neighbours of a FV are close to it in the unknowns. The indexes and the
+	coordinates of the FV are renumbered, which carries the ordering to the assembly, the solver
+	and the exports, and the permutations keep the row by row position of each FV.
+
  	Written by FERREIRA, C. A. S.
 
  	Florianópolis, 2019.
 */
 
+#include <algorithm>
 #include <iostream>
 #include <math.h>
 #include <string>
@@ -48,6 +56,11 @@ public:
 	vector<vector<double>> uDisplacementField;
 	vector<vector<double>> vDisplacementField;
 	vector<vector<double>> pressureField;
+	string cellOrdering; // rowmajor, morton or hilbert
+	int orderingTile; // FV on the side of the tiles, 0 for a single tile
+	vector<int> generalFVPermutation; // Row by row position of the FV of each position
+	vector<int> uDisplacementFVPermutation;
+	vector<int> vDisplacementFVPermutation;
 
 	// Class functions
 	void buildGrid(string);
@@ -60,9 +73,13 @@ public:
 	void buildUDisplacementFVIndexes(string);
 	void buildVDisplacementFVIndexes(string);
 	void buildFieldVectors();
+	long long getCurveKey(int,int);
+	void orderFVIndexes(vector<vector<int>>&,vector<vector<int>>&,vector<int>&);
+	void toRowMajorOrder(vector<double>&);
 
 	// Constructor
-	gridDesign(int,int,int,double,double,double,string,vector<vector<double>>);
+	gridDesign(int,int,int,double,double,double,string,vector<vector<double>>,string="rowmajor",
+		int=0);
 
 	// Destructor
 	~gridDesign();
@@ -70,7 +87,7 @@ public:
 
 gridDesign::gridDesign(int numberOfXFV, int numberOfYFV, int numberOfTimeSteps, double gridSizeX, 
 	double gridSizeY, double totalSimulationTime, string myGridType,
-	vector<vector<double>> coordinatesOfSurfacePoints)
+	vector<vector<double>> coordinatesOfSurfacePoints, string myCellOrdering, int myOrderingTile)
 {
 	Nx=numberOfXFV;
 	Ny=numberOfYFV;
@@ -80,6 +97,8 @@ gridDesign::gridDesign(int numberOfXFV, int numberOfYFV, int numberOfTimeSteps,
 	Lt=totalSimulationTime;
 	gridType=myGridType;
 	sCoordinates=coordinatesOfSurfacePoints;
+	cellOrdering=myCellOrdering;
+	orderingTile=myOrderingTile;
 	buildGrid(gridType);
 }
 
@@ -92,6 +111,7 @@ void gridDesign::buildGrid(string gridType)
 	computeCentroidCoordinates();
 	buildGeneralFVIndexes();
 	buildFaces();
+	orderFVIndexes(generalFVIndex,generalFVCoordinates,generalFVPermutation);
 	buildUDisplacementFVIndexes(gridType);
 	buildVDisplacementFVIndexes(gridType);
 	buildFieldVectors();
@@ -323,6 +343,7 @@ void gridDesign::buildUDisplacementFVIndexes(string gridType)
 	{
 		uDisplacementFVIndex=generalFVIndex;
 		uDisplacementFVCoordinates=generalFVCoordinates;
+		uDisplacementFVPermutation=generalFVPermutation;
 		numberOfActiveUDisplacementFV=numberOfActiveGeneralFV;
 
 		return;
@@ -348,6 +369,7 @@ void gridDesign::buildUDisplacementFVIndexes(string gridType)
 	}
 
 	numberOfActiveUDisplacementFV=ct;
+	orderFVIndexes(uDisplacementFVIndex,uDisplacementFVCoordinates,uDisplacementFVPermutation);
 
 	return;
 }
@@ -361,6 +383,7 @@ void gridDesign::buildVDisplacementFVIndexes(string gridType)
 	{
 		vDisplacementFVIndex=generalFVIndex;
 		vDisplacementFVCoordinates=generalFVCoordinates;
+		vDisplacementFVPermutation=generalFVPermutation;
 		numberOfActiveVDisplacementFV=numberOfActiveGeneralFV;
 
 		return;
@@ -386,40 +409,130 @@ void gridDesign::buildVDisplacementFVIndexes(string gridType)
 	}
 	
 	numberOfActiveVDisplacementFV=ct;
+	orderFVIndexes(vDisplacementFVIndex,vDisplacementFVCoordinates,vDisplacementFVPermutation);
 
 	return;
 }
 
 void gridDesign::buildFieldVectors()
 {
-	int rowNo, colNo;
+	int Nu, Nv, NP;
+
+	// Rows of the fields zeroed by the threads which own their unknowns, numbered u, v and P
+	Nu=numberOfActiveUDisplacementFV;
+	Nv=numberOfActiveVDisplacementFV;
+	NP=numberOfActiveGeneralFV;
+	numaPlacement::firstTouch(uDisplacementField,Nu,Nt,0,Nu+Nv+NP);
+	numaPlacement::firstTouch(vDisplacementField,Nv,Nt,Nu,Nu+Nv+NP);
+	numaPlacement::firstTouch(pressureField,NP,Nt,Nu+Nv,Nu+Nv+NP);
+
+	return;
+}
 
-	// Resize uDisplacementField
-	rowNo=numberOfActiveUDisplacementFV;
-	colNo=Nt;
-	uDisplacementField.resize(rowNo);
-	for(int i=0; i<rowNo; i++)
+long long gridDesign::getCurveKey(int i, int j)
+{
+	// Tiles row by row, then the position along the curve within the tile
+	int tileSize=(orderingTile>0) ? orderingTile : max(Nx,Ny)+1;
+	int tilesPerRow=(Nx+1)/tileSize+1;
+	int levelsNo=0;
+	long long curveKey=0;
+	long long tileKey=(long long)(i/tileSize)*tilesPerRow+j/tileSize;
+	int x=j%tileSize;
+	int y=i%tileSize;
+
+	while((1<<levelsNo)<tileSize) levelsNo++;
+
+	if(cellOrdering=="morton")
+	{
+		// Bits of y and x interleaved
+		for(int b=0; b<levelsNo; b++)
+			curveKey|=((long long)((x>>b)&1)<<(2*b))|((long long)((y>>b)&1)<<(2*b+1));
+	}
+	else if(cellOrdering=="hilbert")
 	{
-		uDisplacementField[i].resize(colNo);
+		// Quadrant of each level, the lower levels rotated to keep the curve continuous
+		int rx, ry, t;
+		for(int s=(1<<levelsNo)/2; s>0; s/=2)
+		{
+			rx=(x&s)>0;
+			ry=(y&s)>0;
+			curveKey+=(long long)s*s*((3*rx)^ry);
+			if(ry==0)
+			{
+				if(rx==1)
+				{
+					x=s-1-x%s;
+					y=s-1-y%s;
+				}
+				t=x;
+				x=y;
+				y=t;
+			}
+			x=x%s;
+			y=y%s;
+		}
 	}
 
-	// Resize vDisplacementField
-	rowNo=numberOfActiveVDisplacementFV;
-	colNo=Nt;
-	vDisplacementField.resize(rowNo);
-	for(int i=0; i<rowNo; i++)
+	return (tileKey<<(2*levelsNo))|curveKey;
+}
+
+void gridDesign::orderFVIndexes(vector<vector<int>>& FVIndex, vector<vector<int>>& FVCoordinates,
+	vector<int>& FVPermutation)
+{
+	vector<pair<long long,int>> curveKeys; // Key and row by row position of the active FV
+	vector<int> newPosition;
+
+	for(int i=0; i<FVIndex.size(); i++)
+		for(int j=0; j<FVIndex[i].size(); j++)
+			if(FVIndex[i][j]!=0) curveKeys.push_back(make_pair(getCurveKey(i,j),FVIndex[i][j]-1));
+
+	// Row by row, the permutation is the identity
+	FVPermutation.resize(curveKeys.size());
+	for(int k=0; k<FVPermutation.size(); k++) FVPermutation[k]=k;
+	if(cellOrdering!="morton" && cellOrdering!="hilbert") return;
+
+	sort(curveKeys.begin(),curveKeys.end());
+	newPosition.resize(curveKeys.size());
+	for(int k=0; k<curveKeys.size(); k++)
 	{
-		vDisplacementField[i].resize(colNo);
+		FVPermutation[k]=curveKeys[k].second;
+		newPosition[curveKeys[k].second]=k;
 	}
 
-	// Resize pressureField
-	rowNo=numberOfActiveGeneralFV;
-	colNo=Nt;
-	pressureField.resize(rowNo);
-	for(int i=0; i<rowNo; i++)
+	for(int i=0; i<FVIndex.size(); i++)
 	{
-		pressureField[i].resize(colNo);
+		for(int j=0; j<FVIndex[i].size(); j++)
+		{
+			if(FVIndex[i][j]!=0)
+			{
+				FVIndex[i][j]=newPosition[FVIndex[i][j]-1]+1;
+				FVCoordinates[FVIndex[i][j]-1][0]=i+1;
+				FVCoordinates[FVIndex[i][j]-1][1]=j+1;
+			}
+		}
 	}
 
 	return;
-}
\ No newline at end of file
+}
+
+void gridDesign::toRowMajorOrder(vector<double>& solutionArray)
+{
+	// Array of the unknowns (u, v and P, in this order) back to the row by row numbering
+	vector<double> orderedArray(solutionArray.size());
+	int Nu=uDisplacementFVPermutation.size();
+	int Nv=vDisplacementFVPermutation.size();
+	int NP=generalFVPermutation.size();
+
+	for(int k=0; k<Nu; k++) orderedArray[uDisplacementFVPermutation[k]]=solutionArray[k];
+	for(int k=0; k<Nv; k++) orderedArray[Nu+vDisplacementFVPermutation[k]]=solutionArray[Nu+k];
+	for(int k=0; k<NP; k++)
+		orderedArray[Nu+Nv+generalFVPermutation[k]]=solutionArray[Nu+Nv+k];
+
+	// Macro-pressures follow the numbering of the pressures, other unknowns are kept
+	if(solutionArray.size()==Nu+Nv+2*NP) for(int k=0; k<NP; k++)
+		orderedArray[Nu+Nv+NP+generalFVPermutation[k]]=solutionArray[Nu+Nv+NP+k];
+	else for(int k=Nu+Nv+NP; k<solutionArray.size(); k++) orderedArray[k]=solutionArray[k];
+	swap(solutionArray,orderedArray);
+
+	return;
+}
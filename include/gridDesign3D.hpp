@@ -0,0 +1,182 @@
+/*
+	This header is part of the development of a master's thesis entitled "Analysis of Numerical
+	Schemes in Collocated and Staggered Grids for Problems of Poroelasticity". The class defined
+	here is the three-dimensional counterpart of gridDesign, for a Cartesian box of Nx x Ny x Nz FV.
+	In the staggered grid the pressure is at the centroids and the displacements u, v and w at the
+	centers of the faces normal to x, y and z, while in the collocated grid all of them are at the
+	vertices. The layers are numbered from the top, as the rows of gridDesign, and each field is a
+	flat array with x as the fastest index, so no index table is stored and the grid of 128^3 FV
+	costs no memory beyond its fields. The coarse grids of the geometric multigrid are found by
+	halving the number of FV in every direction.
+
+ 	Written by FERREIRA, C. A. S.
+
+ 	Florianópolis, 2019.
+*/
+
+#include <iostream>
+#include <math.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class gridDesign3D
+{
+public:
+	// Class variables
+	int Nx; // No of FV in x
+	int Ny; // No of FV in y
+	int Nz; // No of FV in z
+	string gridType;
+	double Lx; // Grid size in x [m]
+	double Ly; // Grid size in y [m]
+	double Lz; // Grid size in z [m]
+	double dx, dy, dz; // FV sizes in x, y and z [m]
+	double dt; // Time-step [s]
+	double h; // Characteristic length [m]
+	double Lt; // Total simulation time [s]
+	int Nt; // No of time-steps + 1 (initial condition)
+	int Nu; // No of u-displacement positions
+	int Nv; // No of v-displacement positions
+	int Nw; // No of w-displacement positions
+	int NP; // No of pressure positions
+
+	// Class functions
+	void computeFVMesh();
+	void computePositionsNo();
+	int getUIndex(int,int,int);
+	int getVIndex(int,int,int);
+	int getWIndex(int,int,int);
+	int getPIndex(int,int,int);
+	vector<double> getUCoordinates(int,int,int);
+	vector<double> getVCoordinates(int,int,int);
+	vector<double> getWCoordinates(int,int,int);
+	vector<double> getPCoordinates(int,int,int);
+	bool isCoarsenable();
+	gridDesign3D getCoarseGrid();
+
+	// Constructor
+	gridDesign3D(int,int,int,int,double,double,double,double,string);
+
+	// Destructor
+	~gridDesign3D();
+};
+
+gridDesign3D::gridDesign3D(int numberOfXFV, int numberOfYFV, int numberOfZFV,
+	int numberOfTimeSteps, double gridSizeX, double gridSizeY, double gridSizeZ,
+	double totalSimulationTime, string myGridType)
+{
+	Nx=numberOfXFV;
+	Ny=numberOfYFV;
+	Nz=numberOfZFV;
+	Nt=numberOfTimeSteps;
+	Lx=gridSizeX;
+	Ly=gridSizeY;
+	Lz=gridSizeZ;
+	Lt=totalSimulationTime;
+	gridType=myGridType;
+	computeFVMesh();
+	computePositionsNo();
+}
+
+gridDesign3D::~gridDesign3D(){}
+
+void gridDesign3D::computeFVMesh()
+{
+	dx=Lx/Nx;
+	dy=Ly/Ny;
+	dz=Lz/Nz;
+	dt=Lt/(Nt-1);
+	h=cbrt(dx*dy*dz);
+
+	return;
+}
+
+void gridDesign3D::computePositionsNo()
+{
+	if(gridType=="staggered")
+	{
+		Nu=(Nx+1)*Ny*Nz;
+		Nv=Nx*(Ny+1)*Nz;
+		Nw=Nx*Ny*(Nz+1);
+		NP=Nx*Ny*Nz;
+	}
+	else
+	{
+		Nu=(Nx+1)*(Ny+1)*(Nz+1);
+		Nv=Nu;
+		Nw=Nu;
+		NP=Nu;
+	}
+
+	return;
+}
+
+// The indexes are zero-based, k is the layer counted from the top
+
+int gridDesign3D::getUIndex(int i, int j, int k)
+{
+	if(gridType=="staggered") return (k*Ny+j)*(Nx+1)+i;
+
+	return (k*(Ny+1)+j)*(Nx+1)+i;
+}
+
+int gridDesign3D::getVIndex(int i, int j, int k)
+{
+	if(gridType=="staggered") return (k*(Ny+1)+j)*Nx+i;
+
+	return (k*(Ny+1)+j)*(Nx+1)+i;
+}
+
+int gridDesign3D::getWIndex(int i, int j, int k)
+{
+	if(gridType=="staggered") return (k*Ny+j)*Nx+i;
+
+	return (k*(Ny+1)+j)*(Nx+1)+i;
+}
+
+int gridDesign3D::getPIndex(int i, int j, int k)
+{
+	if(gridType=="staggered") return (k*Ny+j)*Nx+i;
+
+	return (k*(Ny+1)+j)*(Nx+1)+i;
+}
+
+vector<double> gridDesign3D::getUCoordinates(int i, int j, int k)
+{
+	if(gridType=="staggered") return {i*dx,(j+0.5)*dy,Lz-(k+0.5)*dz};
+
+	return {i*dx,j*dy,Lz-k*dz};
+}
+
+vector<double> gridDesign3D::getVCoordinates(int i, int j, int k)
+{
+	if(gridType=="staggered") return {(i+0.5)*dx,j*dy,Lz-(k+0.5)*dz};
+
+	return {i*dx,j*dy,Lz-k*dz};
+}
+
+vector<double> gridDesign3D::getWCoordinates(int i, int j, int k)
+{
+	if(gridType=="staggered") return {(i+0.5)*dx,(j+0.5)*dy,Lz-k*dz};
+
+	return {i*dx,j*dy,Lz-k*dz};
+}
+
+vector<double> gridDesign3D::getPCoordinates(int i, int j, int k)
+{
+	if(gridType=="staggered") return {(i+0.5)*dx,(j+0.5)*dy,Lz-(k+0.5)*dz};
+
+	return {i*dx,j*dy,Lz-k*dz};
+}
+
+bool gridDesign3D::isCoarsenable()
+{
+	return Nx%2==0 && Ny%2==0 && Nz%2==0 && Nx>=4 && Ny>=4 && Nz>=4;
+}
+
+gridDesign3D gridDesign3D::getCoarseGrid()
+{
+	return gridDesign3D(Nx/2,Ny/2,Nz/2,Nt,Lx,Ly,Lz,Lt,gridType);
+}
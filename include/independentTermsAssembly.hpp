@@ -2,26 +2,30 @@
 	This header is part of the development of a master's thesis entitled "Analysis of Numerical
 	Schemes in Collocated and Staggered Grids for Problems of Poroelasticity". The class defined 
 	here contains the functions for assembly of the independent terms of the linear system which
-	represents the discretized problem of poroelasticity.
+	represents the discretized problem of poroelasticity. The class is templated on the scalar type
+	of the array and of the fields it is assembled from, independentTermsAssembly being the double
+	precision one.
 
  	Written by FERREIRA, C. A. S.
 
  	Florianópolis, 2019.
 */
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <vector>
 
 using namespace std;
 
-class independentTermsAssembly
+template<class scalar>
+class basicIndependentTermsAssembly
 {
 public:
 	// Class variables
-	vector<double> independentTermsArray;
+	vector<scalar> independentTermsArray;
 	vector<vector<int>> boundaryConditionType;
-	vector<vector<double>> boundaryConditionValue;
+	vector<vector<scalar>> boundaryConditionValue;
 	int Nu, Nv, NP, NPM;
 	vector<vector<int>> uDisplacementFVIndex;
 	vector<vector<int>> vDisplacementFVIndex;
@@ -33,6 +37,9 @@ public:
 	vector<vector<int>> verticalFacesStatus;	
 	string gridType;
 	string interpScheme;
+	vector<scalar> previousStepOperatorRow;
+	vector<scalar> previousStepOperatorColumn;
+	vector<scalar> previousStepOperatorValue;
 
 	// Class functions
 	void resizeIndependentTermsArray();
@@ -42,71 +49,77 @@ public:
 	int getMacroPressureFVPosition(int,int);
 	int getFVPosition(int,int,int);
 	void zeroIndependentTermsArray();
-	void assemblyIndependentTermsArray(double,double,double,double,double,double,double,double,
-		double,double,double,vector<vector<double>>,vector<vector<double>>,vector<vector<double>>,
+	void assemblyIndependentTermsArray(scalar,scalar,scalar,scalar,scalar,scalar,scalar,scalar,
+		scalar,scalar,scalar,vector<vector<scalar>>,vector<vector<scalar>>,vector<vector<scalar>>,
 		int);
-	void addUDisplacement(double,double,double,double);
-	void addVDisplacement(double,double,double,double,double,double);
-	void addPressure(double,double,double,double,double,double,double,vector<vector<double>>,
-		vector<vector<double>>,vector<vector<double>>,int,double,double);
+	void addUDisplacement(scalar,scalar,scalar,scalar);
+	void addVDisplacement(scalar,scalar,scalar,scalar,scalar,scalar);
+	void addPressure(scalar,scalar,scalar,scalar,scalar,scalar,scalar,vector<vector<scalar>>,
+		vector<vector<scalar>>,vector<vector<scalar>>,int,scalar,scalar);
 	void addBC(int);
-	void addStaggeredUDisplacement(double,double,double,double);
-	void addStaggeredVDisplacement(double,double,double,double,double,double);
-	void addStaggeredPressure(double,double,double,double,double,double,double,
-		vector<vector<double>>,vector<vector<double>>,vector<vector<double>>,int);
-	void addCollocatedUDisplacement(double,double,double,double);
-	void addCollocatedVDisplacement(double,double,double,double,double,double);
-	void addCollocatedPressure(double,double,double,double,double,double,double,
-		vector<vector<double>>,vector<vector<double>>,vector<vector<double>>,int,double,double);
-	void addCDSDisplacement(double,double,double,double,vector<vector<double>>,
-		vector<vector<double>>,int);
-	void add1DPISPressure(double,double,double,double,double,double,vector<vector<double>>,int);
-	void addI2DPISDisplacement(double,double,double,double,vector<vector<double>>,
-		vector<vector<double>>,int);
-	void addI2DPISPressure(double,double,double,double,double,vector<vector<double>>,int);
-	void addC2DPISDisplacement(double,double,double,double,double,double,vector<vector<double>>,
-		vector<vector<double>>,int);
-	void addC2DPISPressure(double,double,double,double,double,double,vector<vector<double>>,int);
+	void addStaggeredUDisplacement(scalar,scalar,scalar,scalar);
+	void addStaggeredVDisplacement(scalar,scalar,scalar,scalar,scalar,scalar);
+	void addStaggeredPressure(scalar,scalar,scalar,scalar,scalar,scalar,scalar,
+		vector<vector<scalar>>,vector<vector<scalar>>,vector<vector<scalar>>,int);
+	void addCollocatedUDisplacement(scalar,scalar,scalar,scalar);
+	void addCollocatedVDisplacement(scalar,scalar,scalar,scalar,scalar,scalar);
+	void addCollocatedPressure(scalar,scalar,scalar,scalar,scalar,scalar,scalar,
+		vector<vector<scalar>>,vector<vector<scalar>>,vector<vector<scalar>>,int,scalar,scalar);
+	void addCDSDisplacement(scalar,scalar,scalar,scalar,vector<vector<scalar>>,
+		vector<vector<scalar>>,int);
+	void add1DPISPressure(scalar,scalar,scalar,scalar,scalar,scalar,vector<vector<scalar>>,int);
+	void addI2DPISDisplacement(scalar,scalar,scalar,scalar,vector<vector<scalar>>,
+		vector<vector<scalar>>,int);
+	void addI2DPISPressure(scalar,scalar,scalar,scalar,scalar,vector<vector<scalar>>,int);
+	void addC2DPISDisplacement(scalar,scalar,scalar,scalar,scalar,scalar,vector<vector<scalar>>,
+		vector<vector<scalar>>,int);
+	void addC2DPISPressure(scalar,scalar,scalar,scalar,scalar,scalar,vector<vector<scalar>>,int);
 	void addDirichletBC(int,int);
 	void increaseMandelIndependentTermsArray();
-	void assemblyMandelIndependentTermsArray(double,double);
+	void assemblyMandelIndependentTermsArray(scalar,scalar);
 	void addMandelRigidMotion();
-	void addMandelForce(double,double);
-	void addStripfootBC(int,double,double);
-	void assemblyMacroIndependentTermsArray(double,double,double,double,double,double,double,
-		double,double,double,double,vector<vector<double>>,vector<vector<double>>,
-		vector<vector<double>>,vector<vector<double>>,int,double,double,double,double,double);
+	void addMandelForce(scalar,scalar);
+	void addStripfootBC(int,scalar,scalar);
+	void assemblyMacroIndependentTermsArray(scalar,scalar,scalar,scalar,scalar,scalar,scalar,
+		scalar,scalar,scalar,scalar,vector<vector<scalar>>,vector<vector<scalar>>,
+		vector<vector<scalar>>,vector<vector<scalar>>,int,scalar,scalar,scalar,scalar,scalar);
 	void increaseMacroIndependentTermsArray();
-	void addMacroPressure(double,double,double,double,double,double,double,double,double,
-		vector<vector<double>>,vector<vector<double>>,vector<vector<double>>,
-		vector<vector<double>>,int,double,double);
-	void addStaggeredMacroPressure(double,double,double,double,double,double,double,double,
-		vector<vector<double>>,vector<vector<double>>,vector<vector<double>>,
-		vector<vector<double>>,int);
-	void addCollocatedMacroPressure(double,double,double,double,double,double,double,double,double,
-		vector<vector<double>>,vector<vector<double>>,vector<vector<double>>,
-		vector<vector<double>>,int,double,double);
-	void addCDSMacroDisplacement(double,double,double,double,vector<vector<double>>,
-		vector<vector<double>>,int);
-	void addI2DPISMacroDisplacement(double,double,double,double,vector<vector<double>>,
-		vector<vector<double>>,int);
-	void addI2DPISPressureToMicro(double,double,double,double,double,double,vector<vector<double>>,
+	void addMacroPressure(scalar,scalar,scalar,scalar,scalar,scalar,scalar,scalar,scalar,
+		vector<vector<scalar>>,vector<vector<scalar>>,vector<vector<scalar>>,
+		vector<vector<scalar>>,int,scalar,scalar);
+	void addStaggeredMacroPressure(scalar,scalar,scalar,scalar,scalar,scalar,scalar,scalar,
+		vector<vector<scalar>>,vector<vector<scalar>>,vector<vector<scalar>>,
+		vector<vector<scalar>>,int);
+	void addCollocatedMacroPressure(scalar,scalar,scalar,scalar,scalar,scalar,scalar,scalar,scalar,
+		vector<vector<scalar>>,vector<vector<scalar>>,vector<vector<scalar>>,
+		vector<vector<scalar>>,int,scalar,scalar);
+	void addCDSMacroDisplacement(scalar,scalar,scalar,scalar,vector<vector<scalar>>,
+		vector<vector<scalar>>,int);
+	void addI2DPISMacroDisplacement(scalar,scalar,scalar,scalar,vector<vector<scalar>>,
+		vector<vector<scalar>>,int);
+	void addI2DPISPressureToMicro(scalar,scalar,scalar,scalar,scalar,scalar,vector<vector<scalar>>,
 		int);
-	void assignFakePressure(double,double);
-	void addMacroStripfootBC(int,double,double);
+	void assignFakePressure(scalar,scalar);
+	void addMacroStripfootBC(int,scalar,scalar);
+	void assemblyPreviousStepOperator(scalar,scalar,scalar,scalar,scalar,scalar,scalar,scalar,
+		scalar,scalar,scalar,vector<scalar>,vector<scalar>);
+	vector<scalar> getPreviousStepTransposeProduct(vector<scalar>);
 
 	// Constructor
-	independentTermsAssembly(vector<vector<int>>,vector<vector<double>>,int,int,int,
+	basicIndependentTermsAssembly(vector<vector<int>>,vector<vector<scalar>>,int,int,int,
 		vector<vector<int>>,vector<vector<int>>,vector<vector<int>>,vector<vector<int>>,
 		vector<vector<int>>,vector<vector<int>>,vector<vector<int>>,vector<vector<int>>,string,
 		string);
 
 	// Destructor
-	~independentTermsAssembly();
+	~basicIndependentTermsAssembly();
 };
 
-independentTermsAssembly::independentTermsAssembly(vector<vector<int>> bcType,
-	vector<vector<double>> bcValue, int numberOfActiveUDisplacementFV,
+typedef basicIndependentTermsAssembly<double> independentTermsAssembly;
+
+template<class scalar>
+basicIndependentTermsAssembly<scalar>::basicIndependentTermsAssembly(vector<vector<int>> bcType,
+	vector<vector<scalar>> bcValue, int numberOfActiveUDisplacementFV,
 	int numberOfActiveVDisplacementFV, int numberOfActivePressureFV, vector<vector<int>> idU,
 	vector<vector<int>> idV, vector<vector<int>> idP, vector<vector<int>> cooU,
 	vector<vector<int>> cooV, vector<vector<int>> cooP, vector<vector<int>> horFStatus,
@@ -131,9 +144,11 @@ independentTermsAssembly::independentTermsAssembly(vector<vector<int>> bcType,
 	resizeIndependentTermsArray();
 }
 
-independentTermsAssembly::~independentTermsAssembly(){}
+template<class scalar>
+basicIndependentTermsAssembly<scalar>::~basicIndependentTermsAssembly(){}
 
-void independentTermsAssembly::resizeIndependentTermsArray()
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::resizeIndependentTermsArray()
 {
 	int rowNo, colNo;
 
@@ -143,7 +158,8 @@ void independentTermsAssembly::resizeIndependentTermsArray()
 	return;
 }
 
-int independentTermsAssembly::getUDisplacementFVPosition(int x, int y)
+template<class scalar>
+int basicIndependentTermsAssembly<scalar>::getUDisplacementFVPosition(int x, int y)
 {
 	int uDisplacementFVPosition;
 
@@ -152,7 +168,8 @@ int independentTermsAssembly::getUDisplacementFVPosition(int x, int y)
 	return uDisplacementFVPosition;
 }
 
-int independentTermsAssembly::getVDisplacementFVPosition(int x, int y)
+template<class scalar>
+int basicIndependentTermsAssembly<scalar>::getVDisplacementFVPosition(int x, int y)
 {
 	int vDisplacementFVPosition;
 
@@ -161,7 +178,8 @@ int independentTermsAssembly::getVDisplacementFVPosition(int x, int y)
 	return vDisplacementFVPosition;
 }
 
-int independentTermsAssembly::getPressureFVPosition(int x, int y)
+template<class scalar>
+int basicIndependentTermsAssembly<scalar>::getPressureFVPosition(int x, int y)
 {
 	int pressureFVPosition;
 
@@ -170,7 +188,8 @@ int independentTermsAssembly::getPressureFVPosition(int x, int y)
 	return pressureFVPosition;
 }
 
-int independentTermsAssembly::getMacroPressureFVPosition(int x, int y)
+template<class scalar>
+int basicIndependentTermsAssembly<scalar>::getMacroPressureFVPosition(int x, int y)
 {
 	int pressureFVPosition;
 
@@ -179,7 +198,8 @@ int independentTermsAssembly::getMacroPressureFVPosition(int x, int y)
 	return pressureFVPosition;
 }
 
-int independentTermsAssembly::getFVPosition(int variable, int i, int j)
+template<class scalar>
+int basicIndependentTermsAssembly<scalar>::getFVPosition(int variable, int i, int j)
 {
 	switch(variable)
 	{
@@ -203,7 +223,8 @@ int independentTermsAssembly::getFVPosition(int variable, int i, int j)
 	return 0;
 }
 
-void independentTermsAssembly::zeroIndependentTermsArray()
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::zeroIndependentTermsArray()
 {
 	int rowNo=independentTermsArray.size();
 
@@ -215,9 +236,11 @@ void independentTermsAssembly::zeroIndependentTermsArray()
 	return;
 }
 
-void independentTermsAssembly::assemblyIndependentTermsArray(double dx, double dy, double dt,
-	double G, double lambda, double alpha, double K, double mu_f, double Q, double rho, double g,
-	vector<vector<double>> uField, vector<vector<double>> vField, vector<vector<double>> pField,
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::assemblyIndependentTermsArray(scalar dx, scalar dy,
+	scalar dt,
+	scalar G, scalar lambda, scalar alpha, scalar K, scalar mu_f, scalar Q, scalar rho, scalar g,
+	vector<vector<scalar>> uField, vector<vector<scalar>> vField, vector<vector<scalar>> pField,
 	int timeStep)
 {
 	zeroIndependentTermsArray();
@@ -229,7 +252,9 @@ void independentTermsAssembly::assemblyIndependentTermsArray(double dx, double d
 	return;
 }
 
-void independentTermsAssembly::addUDisplacement(double dx, double dy, double G, double lambda)
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::addUDisplacement(scalar dx, scalar dy, scalar G,
+	scalar lambda)
 {
 	if(gridType=="staggered") addStaggeredUDisplacement(dx,dy,G,lambda);
 	else if(gridType=="collocated") addCollocatedUDisplacement(dx,dy,G,lambda);
@@ -237,8 +262,10 @@ void independentTermsAssembly::addUDisplacement(double dx, double dy, double G,
 	return;
 }
 
-void independentTermsAssembly::addVDisplacement(double dx, double dy, double G, double lambda,
-	double rho, double g)
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::addVDisplacement(scalar dx, scalar dy, scalar G,
+	scalar lambda,
+	scalar rho, scalar g)
 {
 	if(gridType=="staggered") addStaggeredVDisplacement(dx,dy,G,lambda,rho,g);
 	else if(gridType=="collocated") addCollocatedVDisplacement(dx,dy,G,lambda,rho,g);
@@ -246,9 +273,11 @@ void independentTermsAssembly::addVDisplacement(double dx, double dy, double G,
 	return;
 }
 
-void independentTermsAssembly::addPressure(double Q, double dx, double dy, double dt, double K,
-	double mu_f, double alpha, vector<vector<double>> uField, vector<vector<double>> vField,
-	vector<vector<double>> pField, int timeStep, double G, double lambda)
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::addPressure(scalar Q, scalar dx, scalar dy, scalar dt,
+	scalar K,
+	scalar mu_f, scalar alpha, vector<vector<scalar>> uField, vector<vector<scalar>> vField,
+	vector<vector<scalar>> pField, int timeStep, scalar G, scalar lambda)
 {
 	if(gridType=="staggered") addStaggeredPressure(Q,dx,dy,dt,K,mu_f,alpha,uField,vField,pField,
 		timeStep);
@@ -258,7 +287,8 @@ void independentTermsAssembly::addPressure(double Q, double dx, double dy, doubl
 	return;
 }
 
-void independentTermsAssembly::addBC(int var)
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::addBC(int var)
 {
 	if(gridType=="collocated")
 	{
@@ -270,14 +300,16 @@ void independentTermsAssembly::addBC(int var)
 	return;
 }
 
-void independentTermsAssembly::addStaggeredUDisplacement(double dx, double dy, double G,
-	double lambda)
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::addStaggeredUDisplacement(scalar dx, scalar dy,
+	scalar G,
+	scalar lambda)
 {
 	int u_P;
 	int FVCounter;
 	int i, j;
 	int bcType;
-	double bcValue;
+	scalar bcValue;
 
 	for(FVCounter=0; FVCounter<Nu; FVCounter++)
 	{
@@ -328,15 +360,17 @@ void independentTermsAssembly::addStaggeredUDisplacement(double dx, double dy, d
 	return;
 }
 
-void independentTermsAssembly::addStaggeredVDisplacement(double dx, double dy, double G,
-	double lambda, double rho, double g)
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::addStaggeredVDisplacement(scalar dx, scalar dy,
+	scalar G,
+	scalar lambda, scalar rho, scalar g)
 {
 	int v_P;
 	int FVCounter;
 	int i, j;
 	int borderCounter;
 	int bcType;
-	double bcValue;
+	scalar bcValue;
 
 	for(FVCounter=0; FVCounter<Nv; FVCounter++)
 	{
@@ -395,17 +429,19 @@ void independentTermsAssembly::addStaggeredVDisplacement(double dx, double dy, d
 	return;
 }
 
-void independentTermsAssembly::addStaggeredPressure(double Q, double dx, double dy, double dt,
-	double K, double mu_f, double alpha, vector<vector<double>> uField,
-	vector<vector<double>> vField, vector<vector<double>> pField, int timeStep)
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::addStaggeredPressure(scalar Q, scalar dx, scalar dy,
+	scalar dt,
+	scalar K, scalar mu_f, scalar alpha, vector<vector<scalar>> uField,
+	vector<vector<scalar>> vField, vector<vector<scalar>> pField, int timeStep)
 {
 	int u_P, u_E, v_P, v_S, P_P;
-	double uP, uE, vP, vS, PP;
+	scalar uP, uE, vP, vS, PP;
 	int FVCounter;
 	int i, j;
 	int bcType;
-	double bcValue;
-	double MP=(1/Q)*(dx*dy)/dt;
+	scalar bcValue;
+	scalar MP=(1/Q)*(dx*dy)/dt;
 
 	for(FVCounter=0; FVCounter<NP; FVCounter++)
 	{
@@ -472,15 +508,17 @@ void independentTermsAssembly::addStaggeredPressure(double Q, double dx, double
 	return;
 }
 
-void independentTermsAssembly::addCollocatedUDisplacement(double dx, double dy, double G,
-	double lambda)
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::addCollocatedUDisplacement(scalar dx, scalar dy,
+	scalar G,
+	scalar lambda)
 {
 	int u_P;
 	int FVCounter;
 	int i, j;
 	int bcType;
-	double bcValue;
-	double value=1;
+	scalar bcValue;
+	scalar value=1;
 
 	for(FVCounter=0; FVCounter<Nu; FVCounter++)
 	{
@@ -537,15 +575,17 @@ void independentTermsAssembly::addCollocatedUDisplacement(double dx, double dy,
 	return;
 }
 
-void independentTermsAssembly::addCollocatedVDisplacement(double dx, double dy, double G,
-	double lambda, double rho, double g)
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::addCollocatedVDisplacement(scalar dx, scalar dy,
+	scalar G,
+	scalar lambda, scalar rho, scalar g)
 {
 	int v_P;
 	int FVCounter;
 	int i, j;
 	int bcType;
-	double bcValue;
-	double value=1;
+	scalar bcValue;
+	scalar value=1;
 	int borderCounter=0;
 	
 	for(FVCounter=0; FVCounter<Nv; FVCounter++)
@@ -610,20 +650,22 @@ void independentTermsAssembly::addCollocatedVDisplacement(double dx, double dy,
 	return;
 }
 
-void independentTermsAssembly::addCollocatedPressure(double Q, double dx, double dy, double dt,
-	double K, double mu_f, double alpha, vector<vector<double>> uField,
-	vector<vector<double>> vField, vector<vector<double>> pField, int timeStep, double G,
-	double lambda)
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::addCollocatedPressure(scalar Q, scalar dx, scalar dy,
+	scalar dt,
+	scalar K, scalar mu_f, scalar alpha, vector<vector<scalar>> uField,
+	vector<vector<scalar>> vField, vector<vector<scalar>> pField, int timeStep, scalar G,
+	scalar lambda)
 {
 	int P_P;
-	double PP;
+	scalar PP;
 	int FVCounter;
 	int i, j;
-	double MP=(1/Q)*(dx*dy)/dt;
+	scalar MP=(1/Q)*(dx*dy)/dt;
 	int borderCounter=0;
-	double sizeFV=1;
+	scalar sizeFV=1;
 	int bcType;
-	double bcValue;
+	scalar bcValue;
 	
 	for(FVCounter=0; FVCounter<NP; FVCounter++)
 	{
@@ -682,17 +724,19 @@ void independentTermsAssembly::addCollocatedPressure(double Q, double dx, double
 	return;
 }
 
-void independentTermsAssembly::addCDSDisplacement(double dx, double dy, double dt, double alpha,
-	vector<vector<double>> uField, vector<vector<double>> vField, int timeStep)
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::addCDSDisplacement(scalar dx, scalar dy, scalar dt,
+	scalar alpha,
+	vector<vector<scalar>> uField, vector<vector<scalar>> vField, int timeStep)
 {
 	int P_P;
 	int u_P, u_E, u_W;
 	int v_P, v_N, v_S;
-	double uP, uE, uW;
-	double vP, vN, vS;
+	scalar uP, uE, uW;
+	scalar vP, vN, vS;
 	int FVCounter;
 	int i, j;
-	double value=1;
+	scalar value=1;
 
 	for(FVCounter=0; FVCounter<NP; FVCounter++)
 	{
@@ -797,14 +841,16 @@ void independentTermsAssembly::addCDSDisplacement(double dx, double dy, double d
 	return;
 }
 
-void independentTermsAssembly::add1DPISPressure(double dx, double dy, double dt, double alpha,
-	double G, double lambda, vector<vector<double>> pField, int timeStep)
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::add1DPISPressure(scalar dx, scalar dy, scalar dt,
+	scalar alpha,
+	scalar G, scalar lambda, vector<vector<scalar>> pField, int timeStep)
 {
 	int P_P, P_E, P_W, P_N, P_S;
-	double PP, PE, PW, PN, PS;
+	scalar PP, PE, PW, PN, PS;
 	int FVCounter;
 	int i, j;
-	double value=1;
+	scalar value=1;
 
 	for(FVCounter=0; FVCounter<NP; FVCounter++)
 	{
@@ -916,17 +962,18 @@ void independentTermsAssembly::add1DPISPressure(double dx, double dy, double dt,
 	return;
 }
 
-void independentTermsAssembly::addI2DPISDisplacement(double dx, double dy, double dt,
-	double alpha, vector<vector<double>> uField, vector<vector<double>> vField, int timeStep)
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::addI2DPISDisplacement(scalar dx, scalar dy, scalar dt,
+	scalar alpha, vector<vector<scalar>> uField, vector<vector<scalar>> vField, int timeStep)
 {
 	int P_P;
 	int u_P, u_E, u_W, u_N, u_S, u_NE, u_NW, u_SE, u_SW;
 	int v_P, v_E, v_W, v_N, v_S, v_NE, v_NW, v_SE, v_SW;
-	double uP, uE, uW, uN, uS, uNE, uNW, uSE, uSW;
-	double vP, vE, vW, vN, vS, vNE, vNW, vSE, vSW;
+	scalar uP, uE, uW, uN, uS, uNE, uNW, uSE, uSW;
+	scalar vP, vE, vW, vN, vS, vNE, vNW, vSE, vSW;
 	int FVCounter;
 	int i, j;
-	double value=1;
+	scalar value=1;
 	
 	for(FVCounter=0; FVCounter<NP; FVCounter++)
 	{
@@ -1178,11 +1225,13 @@ void independentTermsAssembly::addI2DPISDisplacement(double dx, double dy, doubl
 	return;
 }
 
-void independentTermsAssembly::addI2DPISPressure(double dx, double dy, double dt, double alpha,
-	double G, vector<vector<double>> pField, int timeStep)
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::addI2DPISPressure(scalar dx, scalar dy, scalar dt,
+	scalar alpha,
+	scalar G, vector<vector<scalar>> pField, int timeStep)
 {
 	int P_P, P_E, P_W, P_N, P_S;
-	double PP, PE, PW, PN, PS;
+	scalar PP, PE, PW, PN, PS;
 	int FVCounter;
 	int i, j;
 
@@ -1341,18 +1390,19 @@ void independentTermsAssembly::addI2DPISPressure(double dx, double dy, double dt
 	return;
 }
 
-void independentTermsAssembly::addC2DPISDisplacement(double dx, double dy, double dt,
-	double alpha, double G, double lambda, vector<vector<double>> uField,
-	vector<vector<double>> vField, int timeStep)
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::addC2DPISDisplacement(scalar dx, scalar dy, scalar dt,
+	scalar alpha, scalar G, scalar lambda, vector<vector<scalar>> uField,
+	vector<vector<scalar>> vField, int timeStep)
 {
 	int P_P;
 	int u_P, u_E, u_W, u_N, u_S, u_NE, u_NW, u_SE, u_SW;
 	int v_P, v_E, v_W, v_N, v_S, v_NE, v_NW, v_SE, v_SW;
-	double uP, uE, uW, uN, uS, uNE, uNW, uSE, uSW;
-	double vP, vE, vW, vN, vS, vNE, vNW, vSE, vSW;
+	scalar uP, uE, uW, uN, uS, uNE, uNW, uSE, uSW;
+	scalar vP, vE, vW, vN, vS, vNE, vNW, vSE, vSW;
 	int FVCounter;
 	int i, j;
-	double value=1;
+	scalar value=1;
 	
 	for(FVCounter=0; FVCounter<NP; FVCounter++)
 	{
@@ -1688,11 +1738,13 @@ void independentTermsAssembly::addC2DPISDisplacement(double dx, double dy, doubl
 	return;
 }
 
-void independentTermsAssembly::addC2DPISPressure(double dx, double dy, double dt, double alpha,
-	double G, double lambda, vector<vector<double>> pField, int timeStep)
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::addC2DPISPressure(scalar dx, scalar dy, scalar dt,
+	scalar alpha,
+	scalar G, scalar lambda, vector<vector<scalar>> pField, int timeStep)
 {
 	int P_P, P_E, P_W, P_N, P_S;
-	double PP, PE, PW, PN, PS;
+	scalar PP, PE, PW, PN, PS;
 	int FVCounter;
 	int i, j;
 
@@ -1851,10 +1903,11 @@ void independentTermsAssembly::addC2DPISPressure(double dx, double dy, double dt
 	return;
 }
 
-void independentTermsAssembly::addDirichletBC(int border, int variable)
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::addDirichletBC(int border, int variable)
 {	
 	int bcType, var, i, j;
-	double bcValue;
+	scalar bcValue;
 	vector<vector<int>> FVIndex;
 
 	bcType=boundaryConditionType[border][variable];
@@ -1924,7 +1977,8 @@ void independentTermsAssembly::addDirichletBC(int border, int variable)
 	return;
 }
 
-void independentTermsAssembly::increaseMandelIndependentTermsArray()
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::increaseMandelIndependentTermsArray()
 {
 	int rowNo=independentTermsArray.size()+1;
 
@@ -1933,7 +1987,8 @@ void independentTermsAssembly::increaseMandelIndependentTermsArray()
 	return;
 }
 
-void independentTermsAssembly::assemblyMandelIndependentTermsArray(double F, double L)
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::assemblyMandelIndependentTermsArray(scalar F, scalar L)
 {
 	addMandelRigidMotion();
 	addMandelForce(F,L);
@@ -1941,7 +1996,8 @@ void independentTermsAssembly::assemblyMandelIndependentTermsArray(double F, dou
 	return;	
 }
 
-void independentTermsAssembly::addMandelRigidMotion()
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::addMandelRigidMotion()
 {
 	int i, j;
 	int v_P;
@@ -1960,14 +2016,16 @@ void independentTermsAssembly::addMandelRigidMotion()
 	return;
 }
 
-void independentTermsAssembly::addMandelForce(double F, double L)
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::addMandelForce(scalar F, scalar L)
 {
 	independentTermsArray[independentTermsArray.size()-1]+=F*L;
 
 	return;
 }
 
-void independentTermsAssembly::addStripfootBC(int strip, double dx, double stripLoad)
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::addStripfootBC(int strip, scalar dx, scalar stripLoad)
 {
 	int v_P, P_P;
 	int j;
@@ -2001,7 +2059,8 @@ void independentTermsAssembly::addStripfootBC(int strip, double dx, double strip
 	return;
 }
 
-void independentTermsAssembly::increaseMacroIndependentTermsArray()
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::increaseMacroIndependentTermsArray()
 {
 	NPM=NP;
 
@@ -2012,14 +2071,16 @@ void independentTermsAssembly::increaseMacroIndependentTermsArray()
 	return;
 }
 
-void independentTermsAssembly::assemblyMacroIndependentTermsArray(double dx, double dy, double dt,
-	double G, double lambda, double alpha, double K, double mu_f, double A11, double rho, double g,
-	vector<vector<double>> uField, vector<vector<double>> vField, vector<vector<double>> pField,
-	vector<vector<double>> pMField, int timeStep, double phi, double phiM, double KM, double A12,
-	double A22)
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::assemblyMacroIndependentTermsArray(scalar dx,
+	scalar dy, scalar dt,
+	scalar G, scalar lambda, scalar alpha, scalar K, scalar mu_f, scalar A11, scalar rho, scalar g,
+	vector<vector<scalar>> uField, vector<vector<scalar>> vField, vector<vector<scalar>> pField,
+	vector<vector<scalar>> pMField, int timeStep, scalar phi, scalar phiM, scalar KM, scalar A12,
+	scalar A22)
 {
-	double alpham=alpha*phi/(phi+phiM);
-	double alphaM=alpha*phiM/(phi+phiM);
+	scalar alpham=alpha*phi/(phi+phiM);
+	scalar alphaM=alpha*phiM/(phi+phiM);
 
 	zeroIndependentTermsArray();
 	addUDisplacement(dx,dy,G,lambda);
@@ -2033,10 +2094,12 @@ void independentTermsAssembly::assemblyMacroIndependentTermsArray(double dx, dou
 	return;
 }
 
-void independentTermsAssembly::addMacroPressure(double A12, double A22, double dx, double dy,
-	double dt, double K, double mu_f, double alpham, double alphaM, vector<vector<double>> uField,
-	vector<vector<double>> vField, vector<vector<double>> pField, vector<vector<double>> pMField,
-	int timeStep, double G, double lambda)
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::addMacroPressure(scalar A12, scalar A22, scalar dx,
+	scalar dy,
+	scalar dt, scalar K, scalar mu_f, scalar alpham, scalar alphaM, vector<vector<scalar>> uField,
+	vector<vector<scalar>> vField, vector<vector<scalar>> pField, vector<vector<scalar>> pMField,
+	int timeStep, scalar G, scalar lambda)
 {
 	if(gridType=="staggered") addStaggeredMacroPressure(A12,A22,dx,dy,dt,K,mu_f,alphaM,uField,
 		vField,pField,pMField,timeStep);
@@ -2046,19 +2109,21 @@ void independentTermsAssembly::addMacroPressure(double A12, double A22, double d
 	return;
 }
 
-void independentTermsAssembly::addStaggeredMacroPressure(double A12, double A22, double dx,
-	double dy, double dt, double K, double mu_f, double alpha, vector<vector<double>> uField,
-	vector<vector<double>> vField, vector<vector<double>> pField,
-	vector<vector<double>> pMField, int timeStep)
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::addStaggeredMacroPressure(scalar A12, scalar A22,
+	scalar dx,
+	scalar dy, scalar dt, scalar K, scalar mu_f, scalar alpha, vector<vector<scalar>> uField,
+	vector<vector<scalar>> vField, vector<vector<scalar>> pField,
+	vector<vector<scalar>> pMField, int timeStep)
 {
 	int u_P, u_E, v_P, v_S, P_P, PM_P;
-	double uP, uE, vP, vS, PP, PMP;
+	scalar uP, uE, vP, vS, PP, PMP;
 	int FVCounter;
 	int i, j;
 	int bcType;
-	double bcValue;
-	double MP12=(A12)*(dx*dy)/dt;
-	double MP22=(A22)*(dx*dy)/dt;
+	scalar bcValue;
+	scalar MP12=(A12)*(dx*dy)/dt;
+	scalar MP22=(A22)*(dx*dy)/dt;
 
 	for(FVCounter=0; FVCounter<NP; FVCounter++)
 	{
@@ -2129,21 +2194,23 @@ void independentTermsAssembly::addStaggeredMacroPressure(double A12, double A22,
 	return;
 }
 
-void independentTermsAssembly::addCollocatedMacroPressure(double A12, double A22, double dx,
-	double dy, double dt, double K, double mu_f, double alpham, double alphaM,
-	vector<vector<double>> uField, vector<vector<double>> vField, vector<vector<double>> pField,
-	vector<vector<double>> pMField, int timeStep, double G, double lambda)
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::addCollocatedMacroPressure(scalar A12, scalar A22,
+	scalar dx,
+	scalar dy, scalar dt, scalar K, scalar mu_f, scalar alpham, scalar alphaM,
+	vector<vector<scalar>> uField, vector<vector<scalar>> vField, vector<vector<scalar>> pField,
+	vector<vector<scalar>> pMField, int timeStep, scalar G, scalar lambda)
 {
 	int P_P, PM_P;
-	double PP, PMP;
+	scalar PP, PMP;
 	int FVCounter;
 	int i, j;
-	double MP12=(A12)*(dx*dy)/dt;
-	double MP22=(A22)*(dx*dy)/dt;
+	scalar MP12=(A12)*(dx*dy)/dt;
+	scalar MP22=(A22)*(dx*dy)/dt;
 	int borderCounter=0;
-	double sizeFV=1;
+	scalar sizeFV=1;
 	int bcType;
-	double bcValue;
+	scalar bcValue;
 	
 	for(FVCounter=0; FVCounter<NP; FVCounter++)
 	{
@@ -2197,17 +2264,18 @@ void independentTermsAssembly::addCollocatedMacroPressure(double A12, double A22
 	return;
 }
 
-void independentTermsAssembly::addCDSMacroDisplacement(double dx, double dy, double dt,
-	double alpha, vector<vector<double>> uField, vector<vector<double>> vField, int timeStep)
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::addCDSMacroDisplacement(scalar dx, scalar dy, scalar dt,
+	scalar alpha, vector<vector<scalar>> uField, vector<vector<scalar>> vField, int timeStep)
 {
 	int P_P;
 	int u_P, u_E, u_W;
 	int v_P, v_N, v_S;
-	double uP, uE, uW;
-	double vP, vN, vS;
+	scalar uP, uE, uW;
+	scalar vP, vN, vS;
 	int FVCounter;
 	int i, j;
-	double value=1;
+	scalar value=1;
 
 	for(FVCounter=0; FVCounter<NP; FVCounter++)
 	{
@@ -2312,17 +2380,19 @@ void independentTermsAssembly::addCDSMacroDisplacement(double dx, double dy, dou
 	return;
 }
 
-void independentTermsAssembly::addI2DPISMacroDisplacement(double dx, double dy, double dt,
-	double alpha, vector<vector<double>> uField, vector<vector<double>> vField, int timeStep)
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::addI2DPISMacroDisplacement(scalar dx, scalar dy,
+	scalar dt,
+	scalar alpha, vector<vector<scalar>> uField, vector<vector<scalar>> vField, int timeStep)
 {
 	int P_P;
 	int u_P, u_E, u_W, u_N, u_S, u_NE, u_NW, u_SE, u_SW;
 	int v_P, v_E, v_W, v_N, v_S, v_NE, v_NW, v_SE, v_SW;
-	double uP, uE, uW, uN, uS, uNE, uNW, uSE, uSW;
-	double vP, vE, vW, vN, vS, vNE, vNW, vSE, vSW;
+	scalar uP, uE, uW, uN, uS, uNE, uNW, uSE, uSW;
+	scalar vP, vE, vW, vN, vS, vNE, vNW, vSE, vSW;
 	int FVCounter;
 	int i, j;
-	double value=1;
+	scalar value=1;
 	
 	for(FVCounter=0; FVCounter<NP; FVCounter++)
 	{
@@ -2574,11 +2644,13 @@ void independentTermsAssembly::addI2DPISMacroDisplacement(double dx, double dy,
 	return;
 }
 
-void independentTermsAssembly::addI2DPISPressureToMicro(double dx, double dy, double dt, 
-	double alpham, double alphaM, double G, vector<vector<double>> pField, int timeStep)
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::addI2DPISPressureToMicro(scalar dx, scalar dy,
+	scalar dt, 
+	scalar alpham, scalar alphaM, scalar G, vector<vector<scalar>> pField, int timeStep)
 {
 	int P_P, P_E, P_W, P_N, P_S;
-	double PP, PE, PW, PN, PS;
+	scalar PP, PE, PW, PN, PS;
 	int FVCounter;
 	int i, j;
 
@@ -2737,7 +2809,8 @@ void independentTermsAssembly::addI2DPISPressureToMicro(double dx, double dy, do
 	return;
 }
 
-void independentTermsAssembly::assignFakePressure(double phi, double phiM)
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::assignFakePressure(scalar phi, scalar phiM)
 {
 	int P_P;
 	int FVCounter;
@@ -2771,7 +2844,9 @@ void independentTermsAssembly::assignFakePressure(double phi, double phiM)
 	return;
 }
 
-void independentTermsAssembly::addMacroStripfootBC(int strip, double dx, double stripLoad)
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::addMacroStripfootBC(int strip, scalar dx,
+	scalar stripLoad)
 {
 	int v_P, P_P;
 	int j;
@@ -2803,4 +2878,109 @@ void independentTermsAssembly::addMacroStripfootBC(int strip, double dx, double
 	}
 
 	return;
-}
\ No newline at end of file
+}
+
+template<class scalar>
+void basicIndependentTermsAssembly<scalar>::assemblyPreviousStepOperator(scalar dx, scalar dy,
+	scalar dt,
+	scalar G, scalar lambda, scalar alpha, scalar K, scalar mu_f, scalar Q, scalar rho, scalar g,
+	vector<scalar> patternRow, vector<scalar> patternColumn)
+{
+	// The independent terms are affine in the fields of the previous time-step, b=B*x(n)+c, and
+	// the matrix B is recovered by probing the assembly with unit fields. The previous time-step
+	// only enters through the time derivatives, so the pattern of B is contained in the one of
+	// the coefficients matrix, and columns which share no row of that pattern are probed together
+	int n=Nu+Nv+NP;
+	int nonZeroEntries=patternRow.size();
+	int colorsNo=0;
+	vector<vector<int>> patternRowColumns(n), patternColumnRows(n);
+	vector<int> columnColor(n,-1), colorUsage;
+	vector<vector<scalar>> uField(Nu,vector<scalar>(1,0));
+	vector<vector<scalar>> vField(Nv,vector<scalar>(1,0));
+	vector<vector<scalar>> pField(NP,vector<scalar>(1,0));
+	vector<scalar> affineArray;
+
+	for(int k=0; k<nonZeroEntries; k++)
+	{
+		patternRowColumns[patternRow[k]].push_back(patternColumn[k]);
+		patternColumnRows[patternColumn[k]].push_back(patternRow[k]);
+	}
+
+	// Greedy coloring of the columns
+	for(int j=0; j<n; j++)
+	{
+		colorUsage.assign(colorsNo+1,0);
+		for(int a=0; a<patternColumnRows[j].size(); a++)
+		{
+			int i=patternColumnRows[j][a];
+
+			for(int b=0; b<patternRowColumns[i].size(); b++)
+			{
+				int l=patternRowColumns[i][b];
+
+				if(columnColor[l]>=0) colorUsage[columnColor[l]]=1;
+			}
+		}
+
+		columnColor[j]=find(colorUsage.begin(),colorUsage.end(),0)-colorUsage.begin();
+		if(columnColor[j]==colorsNo) colorsNo++;
+	}
+
+	// Affine part, c
+	assemblyIndependentTermsArray(dx,dy,dt,G,lambda,alpha,K,mu_f,Q,rho,g,uField,vField,pField,0);
+	affineArray=independentTermsArray;
+
+	previousStepOperatorRow.clear();
+	previousStepOperatorColumn.clear();
+	previousStepOperatorValue.clear();
+
+	for(int color=0; color<colorsNo; color++)
+	{
+		for(int j=0; j<n; j++)
+		{
+			scalar value=(columnColor[j]==color) ? 1 : 0;
+
+			if(j<Nu) uField[j][0]=value;
+			else if(j<Nu+Nv) vField[j-Nu][0]=value;
+			else pField[j-Nu-Nv][0]=value;
+		}
+
+		assemblyIndependentTermsArray(dx,dy,dt,G,lambda,alpha,K,mu_f,Q,rho,g,uField,vField,pField,
+			0);
+
+		for(int j=0; j<n; j++)
+		{
+			if(columnColor[j]!=color) continue;
+
+			for(int a=0; a<patternColumnRows[j].size(); a++)
+			{
+				int i=patternColumnRows[j][a];
+				scalar value=independentTermsArray[i]-affineArray[i];
+
+				if(value!=0)
+				{
+					previousStepOperatorRow.push_back(i);
+					previousStepOperatorColumn.push_back(j);
+					previousStepOperatorValue.push_back(value);
+				}
+			}
+		}
+	}
+
+	independentTermsArray=affineArray;
+
+	return;
+}
+
+template<class scalar>
+vector<scalar> basicIndependentTermsAssembly<scalar>::getPreviousStepTransposeProduct(
+	vector<scalar> myArray)
+{
+	vector<scalar> productArray(Nu+Nv+NP,0);
+
+	for(int k=0; k<previousStepOperatorValue.size(); k++)
+		productArray[previousStepOperatorColumn[k]]+=previousStepOperatorValue[k]*
+			myArray[previousStepOperatorRow[k]];
+
+	return productArray;
+}
@@ -0,0 +1,350 @@
+/*
+	This header is part of the development of a master's thesis entitled "Analysis of Numerical
+	Schemes in Collocated and Staggered Grids for Problems of Poroelasticity". The class defined
+	here renders maps of the fields during the time-steps, for the monitoring of long runs without
+	exporting the full fields: every -render_interval time-steps (and at the last one) the fields
+	of the current time-step are copied and a background thread computes the strain, colours the
+	FV of each field of -render_fields (p, u, v and eps; p, v and eps by default) with a colormap
+	scaled to the range of the field and writes the image, in -render_format ppm or png, without
+	external libraries. Each FV takes -render_scale x -render_scale pixels and inactive FV are grey.
+
+	The copies wait in a queue of -render_queue entries, so the solver only waits for the renderer
+	when the queue is full. The images are written to ../export/render_<run>_<field>_timeStep=<n>.
+	Without -render_interval nothing is rendered.
+
+ 	Written by FERREIRA, C. A. S.
+
+ 	Florianópolis, 2019.
+*/
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <math.h>
+#include <mutex>
+#include <petscksp.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+class insituRenderer
+{
+public:
+	// Class structures
+	struct renderJob
+	{
+		int timeStep;
+		vector<vector<double>> uField;
+		vector<vector<double>> vField;
+		vector<vector<double>> pField;
+	};
+
+	// Class variables
+	bool enabled=false;
+	string runName;
+	string gridType;
+	string interpScheme;
+	vector<string> fieldNames;
+	string imageFormat;
+	PetscInt interval=0;
+	PetscInt scale=4;
+	PetscInt maxQueuedNo=4;
+	int totalStepsNo;
+	double dx, dy;
+	vector<vector<int>> idU, idV, idP;
+	deque<renderJob> jobs;
+	mutex jobsMutex;
+	condition_variable jobsCondition;
+	bool finished=false;
+	thread renderThread;
+
+	// Class functions
+	template<class scalar> void update(int,const vector<vector<scalar>>&,
+		const vector<vector<scalar>>&,const vector<vector<scalar>>&);
+	void renderJobs();
+	void renderField(const vector<vector<vector<double>>>&,const vector<vector<int>>&,string,int);
+	void getColor(double,unsigned char*);
+	void writePPM(string,int,int,const vector<unsigned char>&);
+	void writePNG(string,int,int,const vector<unsigned char>&);
+	static uint32_t getCRC(const unsigned char*,size_t,uint32_t=0);
+
+	// Constructor
+	insituRenderer(string,string,string,string,int,double,double,vector<vector<int>>,
+		vector<vector<int>>,vector<vector<int>>);
+
+	// Destructor
+	~insituRenderer();
+};
+
+insituRenderer::insituRenderer(string problemName, string pairName, string myGridType,
+	string myInterpScheme, int myTotalStepsNo, double myDx, double myDy, vector<vector<int>> myIdU,
+	vector<vector<int>> myIdV, vector<vector<int>> myIdP)
+{
+	char myFields[PETSC_MAX_PATH_LEN]="p,v,eps";
+	char myFormat[PETSC_MAX_PATH_LEN]="png";
+
+	PetscOptionsGetInt(NULL,NULL,"-render_interval",&interval,NULL);
+	PetscOptionsGetString(NULL,NULL,"-render_fields",myFields,sizeof(myFields),NULL);
+	PetscOptionsGetString(NULL,NULL,"-render_format",myFormat,sizeof(myFormat),NULL);
+	PetscOptionsGetInt(NULL,NULL,"-render_scale",&scale,NULL);
+	PetscOptionsGetInt(NULL,NULL,"-render_queue",&maxQueuedNo,NULL);
+	if(interval<=0) return;
+
+	enabled=true;
+	gridType=myGridType;
+	interpScheme=myInterpScheme;
+	runName=problemName+"_"+pairName+"_"+gridType+((gridType=="staggered") ? "" :
+		"+"+interpScheme);
+	imageFormat=myFormat;
+	scale=max(scale,(PetscInt)1);
+	maxQueuedNo=max(maxQueuedNo,(PetscInt)1);
+	totalStepsNo=myTotalStepsNo;
+	dx=myDx;
+	dy=myDy;
+	idU=myIdU;
+	idV=myIdV;
+	idP=myIdP;
+
+	string fields=myFields;
+	for(size_t start=0, end; start<fields.size(); start=end+1)
+	{
+		end=fields.find(',',start);
+		if(end==string::npos) end=fields.size();
+		if(end>start) fieldNames.push_back(fields.substr(start,end-start));
+	}
+
+	renderThread=thread(&insituRenderer::renderJobs,this);
+}
+
+insituRenderer::~insituRenderer()
+{
+	// The queued time-steps are rendered before the run ends
+	if(!enabled) return;
+
+	{
+		lock_guard<mutex> lock(jobsMutex);
+		finished=true;
+	}
+	jobsCondition.notify_all();
+	renderThread.join();
+}
+
+template<class scalar>
+void insituRenderer::update(int timeStep, const vector<vector<scalar>>& uField,
+	const vector<vector<scalar>>& vField, const vector<vector<scalar>>& pField)
+{
+	// Fields of the current time-step (their first column) are copied into the queue
+	renderJob myJob;
+
+	if(!enabled || (timeStep%interval!=0 && timeStep!=totalStepsNo)) return;
+
+	myJob.timeStep=timeStep;
+	myJob.uField.resize(uField.size());
+	myJob.vField.resize(vField.size());
+	myJob.pField.resize(pField.size());
+	for(int i=0; i<uField.size(); i++) myJob.uField[i].assign(1,uField[i][0]);
+	for(int i=0; i<vField.size(); i++) myJob.vField[i].assign(1,vField[i][0]);
+	for(int i=0; i<pField.size(); i++) myJob.pField[i].assign(1,pField[i][0]);
+
+	unique_lock<mutex> lock(jobsMutex);
+	jobsCondition.wait(lock,[this](){return jobs.size()<maxQueuedNo;});
+	jobs.push_back(move(myJob));
+	lock.unlock();
+	jobsCondition.notify_all();
+
+	return;
+}
+
+void insituRenderer::renderJobs()
+{
+	while(true)
+	{
+		unique_lock<mutex> lock(jobsMutex);
+		jobsCondition.wait(lock,[this](){return finished || !jobs.empty();});
+		if(jobs.empty()) return;
+		renderJob myJob=move(jobs.front());
+		lock.unlock();
+
+		// The 3D fields of a single time-step, with the strain, as in the exports
+		dataProcessing myDataProcessing(idU,idV,idP,myJob.uField,myJob.vField,myJob.pField,
+			gridType,interpScheme,dx,dy);
+		for(int f=0; f<fieldNames.size(); f++)
+		{
+			if(fieldNames[f]=="p") renderField(myDataProcessing.pressure3DField,idP,"p",
+				myJob.timeStep);
+			else if(fieldNames[f]=="u") renderField(myDataProcessing.uDisplacement3DField,idU,
+				"u",myJob.timeStep);
+			else if(fieldNames[f]=="v") renderField(myDataProcessing.vDisplacement3DField,idV,
+				"v",myJob.timeStep);
+			else if(fieldNames[f]=="eps") renderField(myDataProcessing.strain3DField,idP,"eps",
+				myJob.timeStep);
+		}
+
+		// The entry is released once rendered, so the queue bounds the copies held
+		lock.lock();
+		jobs.pop_front();
+		lock.unlock();
+		jobsCondition.notify_all();
+	}
+}
+
+void insituRenderer::renderField(const vector<vector<vector<double>>>& my3DField,
+	const vector<vector<int>>& myIndex, string fieldName, int timeStep)
+{
+	int rowNo=my3DField.size();
+	int colNo=my3DField[0].size();
+	int width=colNo*scale;
+	int height=rowNo*scale;
+	vector<unsigned char> pixels(3*width*height);
+	unsigned char color[3];
+	double minValue=INFINITY;
+	double maxValue=-INFINITY;
+	double value;
+
+	for(int i=0; i<rowNo; i++)
+		for(int j=0; j<colNo; j++)
+			if(myIndex[i][j]!=0 && isfinite(my3DField[i][j][0]))
+			{
+				minValue=min(minValue,my3DField[i][j][0]);
+				maxValue=max(maxValue,my3DField[i][j][0]);
+			}
+
+	for(int i=0; i<rowNo; i++)
+	{
+		for(int j=0; j<colNo; j++)
+		{
+			value=my3DField[i][j][0];
+			if(myIndex[i][j]==0 || !isfinite(value)) color[0]=color[1]=color[2]=128;
+			else getColor((maxValue>minValue) ? (value-minValue)/(maxValue-minValue) : 0.5,color);
+
+			for(int a=0; a<scale; a++)
+				for(int b=0; b<scale; b++)
+					for(int c=0; c<3; c++)
+						pixels[3*((i*scale+a)*width+j*scale+b)+c]=color[c];
+		}
+	}
+
+	string fileName="../export/render_"+runName+"_"+fieldName+"_timeStep="+to_string(timeStep);
+	if(imageFormat=="ppm") writePPM(fileName+".ppm",width,height,pixels);
+	else writePNG(fileName+".png",width,height,pixels);
+
+	return;
+}
+
+void insituRenderer::getColor(double value, unsigned char* color)
+{
+	// Colormap close to viridis, linear between its colours at 0, 0.25, 0.5, 0.75 and 1
+	const double stops[5][3]=
+	{
+		{68,1,84},
+		{59,82,139},
+		{33,145,140},
+		{94,201,98},
+		{253,231,37}
+	};
+	double position=min(max(value,0.0),1.0)*4;
+	int k=min((int)position,3);
+	double weight=position-k;
+
+	for(int c=0; c<3; c++)
+		color[c]=(unsigned char)(stops[k][c]+weight*(stops[k+1][c]-stops[k][c])+0.5);
+
+	return;
+}
+
+void insituRenderer::writePPM(string fileName, int width, int height,
+	const vector<unsigned char>& pixels)
+{
+	ofstream myFile(fileName,ios::binary);
+	if(!myFile.is_open()) return;
+
+	myFile << "P6\n" << width << " " << height << "\n255\n";
+	myFile.write((const char*)pixels.data(),pixels.size());
+	myFile.close();
+
+	return;
+}
+
+uint32_t insituRenderer::getCRC(const unsigned char* data, size_t size, uint32_t crc)
+{
+	// CRC-32 of the PNG chunks, continued from crc
+	crc=~crc;
+	for(size_t i=0; i<size; i++)
+	{
+		crc^=data[i];
+		for(int b=0; b<8; b++) crc=(crc>>1)^(0xEDB88320u&(0u-(crc&1)));
+	}
+
+	return ~crc;
+}
+
+void insituRenderer::writePNG(string fileName, int width, int height,
+	const vector<unsigned char>& pixels)
+{
+	// The image data is a zlib stream of stored (uncompressed) deflate blocks, each row preceded by
+	// the filter type 0
+	vector<unsigned char> rows, data;
+	uint32_t adlerA=1, adlerB=0;
+	size_t rowBytes=3*width;
+
+	for(int i=0; i<height; i++)
+	{
+		rows.push_back(0);
+		rows.insert(rows.end(),pixels.begin()+i*rowBytes,pixels.begin()+(i+1)*rowBytes);
+	}
+	for(size_t i=0; i<rows.size(); i++)
+	{
+		adlerA=(adlerA+rows[i])%65521;
+		adlerB=(adlerB+adlerA)%65521;
+	}
+
+	data.push_back(0x78);
+	data.push_back(0x01);
+	for(size_t start=0; start<rows.size(); start+=65535)
+	{
+		size_t blockSize=min(rows.size()-start,(size_t)65535);
+		data.push_back(start+blockSize>=rows.size());
+		data.push_back(blockSize&0xFF);
+		data.push_back(blockSize>>8);
+		data.push_back(~blockSize&0xFF);
+		data.push_back((~blockSize>>8)&0xFF);
+		data.insert(data.end(),rows.begin()+start,rows.begin()+start+blockSize);
+	}
+	for(int s=24; s>=0; s-=8) data.push_back((((adlerB<<16)|adlerA)>>s)&0xFF);
+
+	ofstream myFile(fileName,ios::binary);
+	if(!myFile.is_open()) return;
+
+	auto writeChunk=[&myFile](const char* type, const vector<unsigned char>& chunk)
+	{
+		unsigned char length[4]={(unsigned char)(chunk.size()>>24),
+			(unsigned char)(chunk.size()>>16),(unsigned char)(chunk.size()>>8),
+			(unsigned char)chunk.size()};
+		uint32_t crc=getCRC((const unsigned char*)type,4);
+		crc=getCRC(chunk.data(),chunk.size(),crc);
+		unsigned char crcBytes[4]={(unsigned char)(crc>>24),(unsigned char)(crc>>16),
+			(unsigned char)(crc>>8),(unsigned char)crc};
+
+		myFile.write((const char*)length,4);
+		myFile.write(type,4);
+		myFile.write((const char*)chunk.data(),chunk.size());
+		myFile.write((const char*)crcBytes,4);
+	};
+
+	vector<unsigned char> header=
+	{
+		(unsigned char)(width>>24),(unsigned char)(width>>16),(unsigned char)(width>>8),
+		(unsigned char)width,(unsigned char)(height>>24),(unsigned char)(height>>16),
+		(unsigned char)(height>>8),(unsigned char)height,8,2,0,0,0
+	};
+	myFile.write("\x89PNG\r\n\x1a\n",8);
+	writeChunk("IHDR",header);
+	writeChunk("IDAT",data);
+	writeChunk("IEND",vector<unsigned char>());
+	myFile.close();
+
+	return;
+}
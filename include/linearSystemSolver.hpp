@@ -3,16 +3,51 @@
 	Schemes in Collocated and Staggered Grids for Problems of Poroelasticity". The class defined 
 	here contains the functions for the solution of the linear system which represents the 
 	discretized problem of poroelasticity. The linear system of equations is solved with LU 
-	Factorization found in PETSc [1].
+	Factorization found in PETSc [1]. Systems which differ from the factorized one by a few rows are
+	solved with the Sherman-Morrison-Woodbury identity, reusing the LU factors. Sequences of
+	matrices sharing one nonzero pattern reuse the ordering and the symbolic factorization, only
+	the numeric factorization being repeated.
+
+	With -linear_solver gcr the matrix is not factorized and the systems are solved by the
+	Generalized Conjugate Residual method [2], applied to the symmetrically diagonally scaled
+	system and left preconditioned by ILU, as in the solvers with Krylov subspace recycling [3]: the
+	search directions of a solve, and their preconditioned products by the matrix, are kept and the
+	next solves start by the projection onto them. The initial guess is the polynomial
+	extrapolation of the last time levels. The fill reducing ordering of the LU factorization is
+	given by -lu_ordering rcm|nd|qmd|natural.
+
+	With -linear_solver autotune the candidates of -autotune_candidates (lu_rcm, lu_nd, lu_qmd and
+	gcr) are each set up on a solver of their own and solve the systems of the first
+	-autotune_steps time-steps, the run going on with the solution of the first one. The one of
+	least setup time plus mean time per solve, extrapolated to the Nt-1 time-steps, is kept and the
+	others are dropped. The choice is recorded in the results manifest and reused by the next runs
+	of the same case without trials.
+
+	With -operator_export the linear systems are written for the offline benchmarks of the solvers:
+	the coefficients matrix, with the boundary conditions applied, and the independent terms arrays
+	of some time-steps, each in the binary format of PETSc and in the MatrixMarket format [4], and
+	the field and the FV of each unknown.
 	
  	Written by FERREIRA, C. A. S.
 
  	Florianópolis, 2019.
 
  	[1] BALAY et al. PETSc User Manual. Technical Report, Argonne National Laboratory, 2017.
+ 	[2] EISENSTAT, S. C.; ELMAN, H. C.; SCHULTZ, M. H. Variational Iterative Methods for
+ 	Nonsymmetric Systems of Linear Equations. SIAM Journal on Numerical Analysis, v. 20,
+ 	pp. 345-357, 1983.
+ 	[3] PARKS, M. L. et al. Recycling Krylov Subspaces for Sequences of Linear Systems. SIAM
+ 	Journal on Scientific Computing, v. 28, pp. 1651-1674, 2006.
+	[4] BOISVERT, R. F.; POZO, R.; REMINGTON, K. A. The Matrix Market Exchange Formats: Initial
+	Design. NISTIR 5935, National Institute of Standards and Technology, 1996.
 */
 
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <math.h>
 #include <petscksp.h>
 #include <string>
 #include <vector>
@@ -43,27 +78,82 @@ public:
 	vector<vector<int>> vDisplacementFVCoordinates;
 	vector<vector<int>> pressureFVCoordinates;
 	PetscErrorCode ierr;
-	Mat coefficientsMatrixPETSc;
+	Mat coefficientsMatrixPETSc=NULL;
+	Mat operatorMatrixPETSc=NULL;
 	Vec independentTermsArrayPETSc;
 	Vec linearSystemSolutionPETSc;
 	IS perm, iperm;
 	MatFactorInfo info;
+	PetscInt maxLowRank=32;
+	bool lowRankRefactored;
+	vector<int> lowRankRows;
+	vector<vector<int>> lowRankColumns;
+	vector<vector<double>> lowRankValues;
+	vector<vector<double>> lowRankSolutions;
+	vector<vector<double>> capacitanceMatrix;
+	vector<int> capacitancePivots;
+	string solverType;
+	string orderingType="rcm";
+	PetscInt autotuneStepsNo=3;
+	vector<string> autotuneCandidates;
+	vector<linearSystemSolver*> trialSolvers;
+	vector<double> trialSetupSeconds;
+	vector<double> trialSolveSeconds;
+	int trialStepsNo=0;
+	PC preconditionerPETSc=NULL;
+	Vec scalingPETSc=NULL;
+	PetscReal relativeTolerance=1e-12;
+	PetscInt maxIterationNo=1000;
+	PetscInt restartNo=50;
+	PetscInt maxRecycledNo=20;
+	PetscInt extrapolationOrder=2;
+	bool keepTimeLevels=true;
+	vector<Vec> recycledDirections;
+	vector<Vec> recycledProducts;
+	vector<Vec> timeLevels;
+	vector<int> iterationsNo;
+	double lastSolveSeconds=0;
+	PetscReal lastSolutionNorm=0;
+	double lastRelativeResidual=-1;
 
 	// Class functions
 	int getUDisplacementFVPosition(int,int);
 	int getVDisplacementFVPosition(int,int);
 	int getPressureFVPosition(int,int);
+	MatOrderingType getOrderingType();
+	void setConfiguration(string);
 	int coefficientsMatrixLUFactorization();
+	int coefficientsMatrixSymbolicFactorization();
+	int coefficientsMatrixNumericFactorization(vector<double>,vector<double>,vector<double>);
+	int setOperatorMatrixValues();
 	int createPETScArrays();
 	int zeroPETScArrays();
-	int setRHSValue(vector<double>);
+	template<class scalar> int setRHSValue(const vector<scalar>&);
 	int solveLinearSystem();
+	int solveTransposeLinearSystem();
 	int setFieldValue(int);
+	int getSolutionArray(vector<double>&);
+	int exportOperator(string);
+	int exportIndependentTerms(string,int);
 	double mandelErrorCalculation(string,double,double,int,double,double,double,double);
 	double mandelStaggeredErrorCalculation(double,double,int,double,double,double,double);
 	double mandelCollocatedErrorCalculation(double,double,int,double,double,double,double);
 	int createMacroPressureField(vector<vector<double>>);
 	int setMacroFieldValue(int);
+	int createLowRankUpdate(vector<double>,vector<double>,vector<double>);
+	int solveLowRankLinearSystem();
+	void clearLowRankUpdate();
+	void capacitanceLUFactorization();
+	void capacitanceLUSolve(vector<double>&);
+	int createPreconditioner();
+	int solveRecycledLinearSystem();
+	int extrapolateInitialGuess();
+	int updateTimeLevels();
+	int clearRecycledSpace();
+	void printIterationSummary();
+	int createTrialSolvers();
+	int solveTrialLinearSystem();
+	int selectTrialSolver();
 
 	// Constructor
 	linearSystemSolver(vector<vector<double>>,vector<double>,vector<double>,vector<double>,
@@ -101,12 +191,48 @@ linearSystemSolver::linearSystemSolver(vector<vector<double>> myCoefficientsMatr
 	vDisplacementFVCoordinates=cooV;
 	pressureFVCoordinates=cooP;
 
+	PetscOptionsGetInt(NULL,NULL,"-lowrank_max_rank",&maxLowRank,NULL);
+
+	// -linear_solver lu|gcr|autotune, the remaining options only apply to gcr
+	char mySolverType[PETSC_MAX_PATH_LEN]="lu";
+	char myOrderingType[PETSC_MAX_PATH_LEN]="rcm";
+	char myCandidates[PETSC_MAX_PATH_LEN]="lu_rcm,lu_nd,lu_qmd,gcr";
+	PetscOptionsGetString(NULL,NULL,"-linear_solver",mySolverType,PETSC_MAX_PATH_LEN,NULL);
+	PetscOptionsGetString(NULL,NULL,"-lu_ordering",myOrderingType,PETSC_MAX_PATH_LEN,NULL);
+	PetscOptionsGetString(NULL,NULL,"-autotune_candidates",myCandidates,PETSC_MAX_PATH_LEN,
+		NULL);
+	PetscOptionsGetInt(NULL,NULL,"-autotune_steps",&autotuneStepsNo,NULL);
+	PetscOptionsGetReal(NULL,NULL,"-linear_solver_rtol",&relativeTolerance,NULL);
+	PetscOptionsGetInt(NULL,NULL,"-linear_solver_max_it",&maxIterationNo,NULL);
+	PetscOptionsGetInt(NULL,NULL,"-linear_solver_restart",&restartNo,NULL);
+	PetscOptionsGetInt(NULL,NULL,"-recycle_size",&maxRecycledNo,NULL);
+	PetscOptionsGetInt(NULL,NULL,"-extrapolation_order",&extrapolationOrder,NULL);
+	solverType=mySolverType;
+	orderingType=myOrderingType;
+	extrapolationOrder=min(max(extrapolationOrder,(PetscInt)-1),(PetscInt)2);
+
+	string candidates=myCandidates;
+	for(size_t start=0, end; start<candidates.size(); start=end+1)
+	{
+		end=candidates.find(',',start);
+		if(end==string::npos) end=candidates.size();
+		if(end>start) autotuneCandidates.push_back(candidates.substr(start,end-start));
+	}
+
 	return;
 }
 
 linearSystemSolver::~linearSystemSolver()
 {
+	if(!iterationsNo.empty()) printIterationSummary();
+
+	for(int c=0; c<trialSolvers.size(); c++) delete trialSolvers[c];
+	clearRecycledSpace();
+	for(int l=0; l<timeLevels.size(); l++) VecDestroy(&timeLevels[l]);
+	PCDestroy(&preconditionerPETSc);
+	VecDestroy(&scalingPETSc);
 	MatDestroy(&coefficientsMatrixPETSc);
+	MatDestroy(&operatorMatrixPETSc);
 	VecDestroy(&independentTermsArrayPETSc);
 	VecDestroy(&linearSystemSolutionPETSc);
 }
@@ -138,6 +264,28 @@ int linearSystemSolver::getPressureFVPosition(int x, int y)
 	return pressureFVPosition;
 }
 
+MatOrderingType linearSystemSolver::getOrderingType()
+{
+	if(orderingType=="nd") return MATORDERINGND;
+	if(orderingType=="qmd") return MATORDERINGQMD;
+	if(orderingType=="natural") return MATORDERINGNATURAL;
+
+	return MATORDERINGRCM;
+}
+
+void linearSystemSolver::setConfiguration(string configuration)
+{
+	// gcr, or lu_ followed by the ordering
+	if(configuration.compare(0,3,"lu_")==0)
+	{
+		solverType="lu";
+		orderingType=configuration.substr(3);
+	}
+	else solverType=configuration;
+
+	return;
+}
+
 int linearSystemSolver::coefficientsMatrixLUFactorization()
 {
 	PetscInt n=coefficientsMatrix.size();
@@ -145,7 +293,25 @@ int linearSystemSolver::coefficientsMatrixLUFactorization()
 	PetscInt rowNo, colNo;
 	PetscScalar value;
 
-	ierr=MatCreate(PETSC_COMM_WORLD,&coefficientsMatrixPETSc);CHKERRQ(ierr);
+	// The candidates are set up on solvers of their own, unless the case has a recorded choice
+	if(solverType=="autotune")
+	{
+		string configuration=resultsManifest::getCachedSetting("linearSolver");
+
+		if(configuration.empty())
+		{
+			ierr=createTrialSolvers();CHKERRQ(ierr);
+
+			return ierr;
+		}
+
+		cout << "Autotune: " << configuration << ", recorded in the results manifest\n";
+		resultsManifest::recordSetting("linearSolver",configuration.c_str());
+		setConfiguration(configuration);
+	}
+
+	// The objects are sequential, so that each rank of a task farm solves its own cases
+	ierr=MatCreate(PETSC_COMM_SELF,&coefficientsMatrixPETSc);CHKERRQ(ierr);
 	ierr=MatSetSizes(coefficientsMatrixPETSc,PETSC_DECIDE,PETSC_DECIDE,n,n);CHKERRQ(ierr);
 	ierr=MatSetFromOptions(coefficientsMatrixPETSc);CHKERRQ(ierr);
 	ierr=MatSetUp(coefficientsMatrixPETSc);CHKERRQ(ierr);
@@ -162,7 +328,15 @@ int linearSystemSolver::coefficientsMatrixLUFactorization()
 	ierr=MatAssemblyBegin(coefficientsMatrixPETSc,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
 	ierr=MatAssemblyEnd(coefficientsMatrixPETSc,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
 
-	ierr=MatGetOrdering(coefficientsMatrixPETSc,MATORDERINGRCM,&perm,&iperm);CHKERRQ(ierr);
+	// The iterative solver keeps the assembled matrix, ordering and factors are not needed
+	if(solverType=="gcr")
+	{
+		ierr=createPreconditioner();CHKERRQ(ierr);
+
+		return ierr;
+	}
+
+	ierr=MatGetOrdering(coefficientsMatrixPETSc,getOrderingType(),&perm,&iperm);CHKERRQ(ierr);
 
 	ierr=MatFactorInfoInitialize(&info);CHKERRQ(ierr);
 	info.fill=1.0;
@@ -176,6 +350,88 @@ int linearSystemSolver::coefficientsMatrixLUFactorization()
 	return ierr;
 }
 
+int linearSystemSolver::coefficientsMatrixSymbolicFactorization()
+{
+	// Keeps the assembled matrix in operatorMatrixPETSc and its factors in coefficientsMatrixPETSc,
+	// so that the solution functions are unchanged
+	PetscInt n=coefficientsMatrix.size();
+
+	ierr=MatCreate(PETSC_COMM_SELF,&operatorMatrixPETSc);CHKERRQ(ierr);
+	ierr=MatSetSizes(operatorMatrixPETSc,PETSC_DECIDE,PETSC_DECIDE,n,n);CHKERRQ(ierr);
+	ierr=MatSetFromOptions(operatorMatrixPETSc);CHKERRQ(ierr);
+	ierr=MatSetUp(operatorMatrixPETSc);CHKERRQ(ierr);
+	ierr=setOperatorMatrixValues();CHKERRQ(ierr);
+
+	ierr=MatGetOrdering(operatorMatrixPETSc,getOrderingType(),&perm,&iperm);CHKERRQ(ierr);
+
+	ierr=MatFactorInfoInitialize(&info);CHKERRQ(ierr);
+	info.fill=1.0;
+	info.dt=0;
+	info.dtcol=0;
+	info.zeropivot=0;
+	info.pivotinblocks=0;
+
+	ierr=MatGetFactor(operatorMatrixPETSc,MATSOLVERPETSC,MAT_FACTOR_LU,&coefficientsMatrixPETSc);
+		CHKERRQ(ierr);
+	ierr=MatLUFactorSymbolic(coefficientsMatrixPETSc,operatorMatrixPETSc,perm,iperm,&info);
+		CHKERRQ(ierr);
+	ierr=MatLUFactorNumeric(coefficientsMatrixPETSc,operatorMatrixPETSc,&info);CHKERRQ(ierr);
+
+	return ierr;
+}
+
+int linearSystemSolver::coefficientsMatrixNumericFactorization(vector<double> newRow,
+	vector<double> newColumn, vector<double> newValue)
+{
+	// A matrix with a different nonzero pattern requires a new symbolic factorization
+	if(operatorMatrixPETSc==NULL || newRow!=sparseCoefficientsRow ||
+		newColumn!=sparseCoefficientsColumn)
+	{
+		sparseCoefficientsRow=newRow;
+		sparseCoefficientsColumn=newColumn;
+		sparseCoefficientsValue=newValue;
+
+		if(operatorMatrixPETSc!=NULL)
+		{
+			ierr=MatDestroy(&coefficientsMatrixPETSc);CHKERRQ(ierr);
+			ierr=MatDestroy(&operatorMatrixPETSc);CHKERRQ(ierr);
+			ierr=ISDestroy(&perm);CHKERRQ(ierr);
+			ierr=ISDestroy(&iperm);CHKERRQ(ierr);
+		}
+		ierr=coefficientsMatrixSymbolicFactorization();CHKERRQ(ierr);
+
+		return ierr;
+	}
+
+	sparseCoefficientsValue=newValue;
+
+	ierr=MatZeroEntries(operatorMatrixPETSc);CHKERRQ(ierr);
+	ierr=setOperatorMatrixValues();CHKERRQ(ierr);
+	ierr=MatLUFactorNumeric(coefficientsMatrixPETSc,operatorMatrixPETSc,&info);CHKERRQ(ierr);
+
+	return ierr;
+}
+
+int linearSystemSolver::setOperatorMatrixValues()
+{
+	PetscInt nonZeroEntries=sparseCoefficientsValue.size();
+	PetscInt rowNo, colNo;
+	PetscScalar value;
+
+	for(int i=0; i<nonZeroEntries; i++)
+	{	
+		rowNo=sparseCoefficientsRow[i];
+		colNo=sparseCoefficientsColumn[i];
+		value=sparseCoefficientsValue[i];
+		ierr=MatSetValue(operatorMatrixPETSc,rowNo,colNo,value,ADD_VALUES);CHKERRQ(ierr);
+	}
+
+	ierr=MatAssemblyBegin(operatorMatrixPETSc,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+	ierr=MatAssemblyEnd(operatorMatrixPETSc,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+	return ierr;
+}
+
 int linearSystemSolver::createPETScArrays()
 {
 	PetscInt n=coefficientsMatrix.size();
@@ -201,8 +457,10 @@ int linearSystemSolver::zeroPETScArrays()
 	return ierr;
 }
 
-int linearSystemSolver::setRHSValue(vector<double> independentTermsArray)
+template<class scalar>
+int linearSystemSolver::setRHSValue(const vector<scalar>& independentTermsArray)
 {
+	// Arrays of any scalar type are converted to the scalar type of PETSc
 	PetscInt n=independentTermsArray.size();
 	PetscScalar value;
 
@@ -220,8 +478,36 @@ int linearSystemSolver::setRHSValue(vector<double> independentTermsArray)
 
 int linearSystemSolver::solveLinearSystem()
 {	
-	ierr=MatSolve(coefficientsMatrixPETSc,independentTermsArrayPETSc,linearSystemSolutionPETSc);
-		CHKERRQ(ierr);
+	// The wall time and the largest unknown of the solve are kept for the live metrics
+	chrono::steady_clock::time_point start=chrono::steady_clock::now();
+
+	// Only matrices factorized by coefficientsMatrixLUFactorization are solved iteratively
+	if(!trialSolvers.empty())
+	{
+		ierr=solveTrialLinearSystem();CHKERRQ(ierr);
+	}
+	else if(preconditionerPETSc!=NULL)
+	{
+		ierr=solveRecycledLinearSystem();CHKERRQ(ierr);
+	}
+	else
+	{
+		ierr=MatSolve(coefficientsMatrixPETSc,independentTermsArrayPETSc,
+			linearSystemSolutionPETSc);CHKERRQ(ierr);
+		ierr=VecAssemblyBegin(linearSystemSolutionPETSc);CHKERRQ(ierr);
+		ierr=VecAssemblyEnd(linearSystemSolutionPETSc);CHKERRQ(ierr);
+	}
+
+	lastSolveSeconds=chrono::duration<double>(chrono::steady_clock::now()-start).count();
+	ierr=VecNorm(linearSystemSolutionPETSc,NORM_INFINITY,&lastSolutionNorm);CHKERRQ(ierr);
+
+	return ierr;
+}
+
+int linearSystemSolver::solveTransposeLinearSystem()
+{	
+	ierr=MatSolveTranspose(coefficientsMatrixPETSc,independentTermsArrayPETSc,
+		linearSystemSolutionPETSc);CHKERRQ(ierr);
 	ierr=VecAssemblyBegin(linearSystemSolutionPETSc);CHKERRQ(ierr);
 	ierr=VecAssemblyEnd(linearSystemSolutionPETSc);CHKERRQ(ierr);
 
@@ -253,6 +539,99 @@ int linearSystemSolver::setFieldValue(int timeStep)
 	return ierr;
 }
 
+int linearSystemSolver::getSolutionArray(vector<double>& solutionArray)
+{
+	PetscInt n=coefficientsMatrix.size();
+	const PetscScalar *solution;
+
+	ierr=VecGetArrayRead(linearSystemSolutionPETSc,&solution);CHKERRQ(ierr);
+	solutionArray.assign(solution,solution+n);
+	ierr=VecRestoreArrayRead(linearSystemSolutionPETSc,&solution);CHKERRQ(ierr);
+
+	return ierr;
+}
+
+int linearSystemSolver::exportOperator(string fileName)
+{
+	// The matrix is assembled again from the sparse arrays, the one of the solver may be factorized
+	PetscInt n=coefficientsMatrix.size();
+	PetscInt nonZeroEntries=sparseCoefficientsValue.size();
+	Mat exportMatrixPETSc;
+	PetscViewer myViewer;
+
+	ierr=MatCreate(PETSC_COMM_SELF,&exportMatrixPETSc);CHKERRQ(ierr);
+	ierr=MatSetSizes(exportMatrixPETSc,PETSC_DECIDE,PETSC_DECIDE,n,n);CHKERRQ(ierr);
+	ierr=MatSetType(exportMatrixPETSc,MATSEQAIJ);CHKERRQ(ierr);
+	ierr=MatSetUp(exportMatrixPETSc);CHKERRQ(ierr);
+	for(int i=0; i<nonZeroEntries; i++)
+	{
+		ierr=MatSetValue(exportMatrixPETSc,(PetscInt)sparseCoefficientsRow[i],
+			(PetscInt)sparseCoefficientsColumn[i],sparseCoefficientsValue[i],ADD_VALUES);
+			CHKERRQ(ierr);
+	}
+	ierr=MatAssemblyBegin(exportMatrixPETSc,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+	ierr=MatAssemblyEnd(exportMatrixPETSc,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+	ierr=PetscViewerBinaryOpen(PETSC_COMM_SELF,(fileName+"_A.petsc").c_str(),FILE_MODE_WRITE,
+		&myViewer);CHKERRQ(ierr);
+	ierr=MatView(exportMatrixPETSc,myViewer);CHKERRQ(ierr);
+	ierr=PetscViewerDestroy(&myViewer);CHKERRQ(ierr);
+	ierr=MatDestroy(&exportMatrixPETSc);CHKERRQ(ierr);
+
+	// MatrixMarket coordinate format, indexes starting from 1
+	ofstream matrixFile(fileName+"_A.mtx");
+	matrixFile << "%%MatrixMarket matrix coordinate real general\n";
+	matrixFile << n << " " << n << " " << nonZeroEntries << "\n";
+	matrixFile << setprecision(17);
+	for(int i=0; i<nonZeroEntries; i++)
+		matrixFile << (int)sparseCoefficientsRow[i]+1 << " " << (int)sparseCoefficientsColumn[i]+1 <<
+			" " << sparseCoefficientsValue[i] << "\n";
+	matrixFile.close();
+
+	// Field of each unknown (u, v, P and, with double porosity, pM) and the row and column of its FV
+	ofstream fieldsFile(fileName+"_fields.txt");
+	for(int k=0; k<n; k++)
+	{
+		if(k<Nu) fieldsFile << "u " << uDisplacementFVCoordinates[k][0] << " " <<
+			uDisplacementFVCoordinates[k][1] << "\n";
+		else if(k<Nu+Nv) fieldsFile << "v " << vDisplacementFVCoordinates[k-Nu][0] << " " <<
+			vDisplacementFVCoordinates[k-Nu][1] << "\n";
+		else if(k<Nu+Nv+NP) fieldsFile << "P " << pressureFVCoordinates[k-Nu-Nv][0] << " " <<
+			pressureFVCoordinates[k-Nu-Nv][1] << "\n";
+		else fieldsFile << "pM " << pressureFVCoordinates[k-Nu-Nv-NP][0] << " " <<
+			pressureFVCoordinates[k-Nu-Nv-NP][1] << "\n";
+	}
+	fieldsFile.close();
+
+	return ierr;
+}
+
+int linearSystemSolver::exportIndependentTerms(string fileName, int timeStep)
+{
+	// The independent terms array set for the solve of the time-step
+	PetscInt n=coefficientsMatrix.size();
+	const PetscScalar *independentTerms;
+	PetscViewer myViewer;
+	string arrayName=fileName+"_b_timeStep="+to_string(timeStep);
+
+	ierr=PetscViewerBinaryOpen(PETSC_COMM_SELF,(arrayName+".petsc").c_str(),FILE_MODE_WRITE,
+		&myViewer);CHKERRQ(ierr);
+	ierr=VecView(independentTermsArrayPETSc,myViewer);CHKERRQ(ierr);
+	ierr=PetscViewerDestroy(&myViewer);CHKERRQ(ierr);
+
+	// MatrixMarket array format, a single column
+	ofstream arrayFile(arrayName+".mtx");
+	arrayFile << "%%MatrixMarket matrix array real general\n";
+	arrayFile << n << " 1\n";
+	arrayFile << setprecision(17);
+	ierr=VecGetArrayRead(independentTermsArrayPETSc,&independentTerms);CHKERRQ(ierr);
+	for(int i=0; i<n; i++) arrayFile << independentTerms[i] << "\n";
+	ierr=VecRestoreArrayRead(independentTermsArrayPETSc,&independentTerms);CHKERRQ(ierr);
+	arrayFile.close();
+
+	return ierr;
+}
+
 double linearSystemSolver::mandelErrorCalculation(string gridType, double dx, double dy,
 	int timeStep, double M, double lambda, double alpha, double F)
 {
@@ -379,4 +758,538 @@ int linearSystemSolver::setMacroFieldValue(int timeStep)
 	}
 
 	return ierr;
-}
\ No newline at end of file
+}
+
+int linearSystemSolver::createLowRankUpdate(vector<double> updateRow, vector<double> updateColumn,
+	vector<double> updateValue)
+{
+	// Replaces the previous update by A'=A+U*D, where U gathers the unit vectors of the modified
+	// rows and D their increments. Solutions then follow from x=y-Z*C^-1*D*y, with y=A^-1*b,
+	// Z=A^-1*U and the capacitance matrix C=I+D*Z.
+	PetscInt n=coefficientsMatrix.size();
+	PetscInt rowNo;
+	const PetscScalar *solution;
+	int k, position;
+
+	clearLowRankUpdate();
+	lowRankRefactored=false;
+
+	for(int i=0; i<updateValue.size(); i++)
+	{
+		rowNo=updateRow[i];
+		position=find(lowRankRows.begin(),lowRankRows.end(),rowNo)-lowRankRows.begin();
+		if(position==lowRankRows.size())
+		{
+			lowRankRows.push_back(rowNo);
+			lowRankColumns.push_back(vector<int>());
+			lowRankValues.push_back(vector<double>());
+		}
+		lowRankColumns[position].push_back(updateColumn[i]);
+		lowRankValues[position].push_back(updateValue[i]);
+	}
+
+	k=lowRankRows.size();
+	if(k==0) return ierr;
+
+	// Rank too large, the modified matrix becomes the new factorized operator
+	if(k>maxLowRank)
+	{
+		sparseCoefficientsRow.insert(sparseCoefficientsRow.end(),updateRow.begin(),updateRow.end());
+		sparseCoefficientsColumn.insert(sparseCoefficientsColumn.end(),updateColumn.begin(),
+			updateColumn.end());
+		sparseCoefficientsValue.insert(sparseCoefficientsValue.end(),updateValue.begin(),
+			updateValue.end());
+		clearLowRankUpdate();
+
+		ierr=MatDestroy(&coefficientsMatrixPETSc);CHKERRQ(ierr);
+		if(solverType!="gcr")
+		{
+			ierr=ISDestroy(&perm);CHKERRQ(ierr);
+			ierr=ISDestroy(&iperm);CHKERRQ(ierr);
+		}
+		ierr=coefficientsMatrixLUFactorization();CHKERRQ(ierr);
+		lowRankRefactored=true;
+
+		return ierr;
+	}
+
+	// Z=A^-1*U, one triangular solve per modified row, which are not time levels
+	lowRankSolutions.resize(k);
+	keepTimeLevels=false;
+	for(int a=0; a<k; a++)
+	{
+		ierr=VecZeroEntries(independentTermsArrayPETSc);CHKERRQ(ierr);
+		ierr=VecSetValue(independentTermsArrayPETSc,lowRankRows[a],1.0,INSERT_VALUES);
+			CHKERRQ(ierr);
+		ierr=VecAssemblyBegin(independentTermsArrayPETSc);CHKERRQ(ierr);
+		ierr=VecAssemblyEnd(independentTermsArrayPETSc);CHKERRQ(ierr);
+		ierr=solveLinearSystem();CHKERRQ(ierr);
+
+		ierr=VecGetArrayRead(linearSystemSolutionPETSc,&solution);CHKERRQ(ierr);
+		lowRankSolutions[a].assign(solution,solution+n);
+		ierr=VecRestoreArrayRead(linearSystemSolutionPETSc,&solution);CHKERRQ(ierr);
+	}
+	keepTimeLevels=true;
+
+	// C=I+D*Z
+	capacitanceMatrix.assign(k,vector<double>(k,0));
+	for(int a=0; a<k; a++)
+	{
+		for(int b=0; b<k; b++)
+		{
+			for(int c=0; c<lowRankColumns[a].size(); c++)
+				capacitanceMatrix[a][b]+=lowRankValues[a][c]*
+					lowRankSolutions[b][lowRankColumns[a][c]];
+		}
+		capacitanceMatrix[a][a]+=1;
+	}
+	capacitanceLUFactorization();
+
+	ierr=zeroPETScArrays();CHKERRQ(ierr);
+
+	return ierr;
+}
+
+int linearSystemSolver::solveLowRankLinearSystem()
+{
+	int k=lowRankRows.size();
+	PetscScalar *solution;
+	vector<double> correction(k);
+
+	ierr=solveLinearSystem();CHKERRQ(ierr);
+	if(k==0) return ierr;
+
+	ierr=VecGetArray(linearSystemSolutionPETSc,&solution);CHKERRQ(ierr);
+
+	for(int a=0; a<k; a++)
+	{
+		correction[a]=0;
+		for(int c=0; c<lowRankColumns[a].size(); c++)
+			correction[a]+=lowRankValues[a][c]*solution[lowRankColumns[a][c]];
+	}
+
+	capacitanceLUSolve(correction);
+
+	for(int b=0; b<k; b++)
+	{
+		for(int i=0; i<lowRankSolutions[b].size(); i++)
+			solution[i]-=lowRankSolutions[b][i]*correction[b];
+	}
+
+	ierr=VecRestoreArray(linearSystemSolutionPETSc,&solution);CHKERRQ(ierr);
+
+	return ierr;
+}
+
+void linearSystemSolver::clearLowRankUpdate()
+{
+	lowRankRows.clear();
+	lowRankColumns.clear();
+	lowRankValues.clear();
+	lowRankSolutions.clear();
+	capacitanceMatrix.clear();
+	capacitancePivots.clear();
+
+	return;
+}
+
+void linearSystemSolver::capacitanceLUFactorization()
+{
+	// In-place LU factorization with partial pivoting of the (small and dense) capacitance matrix
+	int k=capacitanceMatrix.size();
+	int pivot;
+
+	capacitancePivots.resize(k);
+
+	for(int j=0; j<k; j++)
+	{
+		pivot=j;
+		for(int i=j+1; i<k; i++)
+			if(fabs(capacitanceMatrix[i][j])>fabs(capacitanceMatrix[pivot][j])) pivot=i;
+
+		capacitancePivots[j]=pivot;
+		swap(capacitanceMatrix[j],capacitanceMatrix[pivot]);
+
+		for(int i=j+1; i<k; i++)
+		{
+			capacitanceMatrix[i][j]/=capacitanceMatrix[j][j];
+			for(int l=j+1; l<k; l++)
+				capacitanceMatrix[i][l]-=capacitanceMatrix[i][j]*capacitanceMatrix[j][l];
+		}
+	}
+
+	return;
+}
+
+void linearSystemSolver::capacitanceLUSolve(vector<double>& b)
+{
+	int k=capacitanceMatrix.size();
+
+	for(int j=0; j<k; j++)
+		swap(b[j],b[capacitancePivots[j]]);
+
+	for(int i=1; i<k; i++)
+		for(int j=0; j<i; j++)
+			b[i]-=capacitanceMatrix[i][j]*b[j];
+
+	for(int i=k-1; i>=0; i--)
+	{
+		for(int j=i+1; j<k; j++)
+			b[i]-=capacitanceMatrix[i][j]*b[j];
+		b[i]/=capacitanceMatrix[i][i];
+	}
+
+	return;
+}
+
+int linearSystemSolver::createPreconditioner()
+{
+	// A new matrix invalidates the products kept for recycling, the time levels still hold
+	ierr=clearRecycledSpace();CHKERRQ(ierr);
+	ierr=PCDestroy(&preconditionerPETSc);CHKERRQ(ierr);
+	ierr=VecDestroy(&scalingPETSc);CHKERRQ(ierr);
+
+	// Symmetric scaling by S=|diag(A)|^-1/2, which brings displacements and pressures, whose
+	// magnitudes differ by orders, to comparable scales in the solved system S*A*S*y=S*b
+	ierr=MatCreateVecs(coefficientsMatrixPETSc,&scalingPETSc,NULL);CHKERRQ(ierr);
+	ierr=MatGetDiagonal(coefficientsMatrixPETSc,scalingPETSc);CHKERRQ(ierr);
+	ierr=VecSqrtAbs(scalingPETSc);CHKERRQ(ierr);
+	ierr=VecReciprocal(scalingPETSc);CHKERRQ(ierr);
+	ierr=MatDiagonalScale(coefficientsMatrixPETSc,scalingPETSc,scalingPETSc);CHKERRQ(ierr);
+
+	ierr=PCCreate(PETSC_COMM_SELF,&preconditionerPETSc);CHKERRQ(ierr);
+	ierr=PCSetType(preconditionerPETSc,PCILU);CHKERRQ(ierr);
+	ierr=PCFactorSetShiftType(preconditionerPETSc,MAT_SHIFT_NONZERO);CHKERRQ(ierr);
+	ierr=PCSetOperators(preconditionerPETSc,coefficientsMatrixPETSc,coefficientsMatrixPETSc);
+		CHKERRQ(ierr);
+	ierr=PCSetFromOptions(preconditionerPETSc);CHKERRQ(ierr);
+	ierr=PCSetUp(preconditionerPETSc);CHKERRQ(ierr);
+
+	return ierr;
+}
+
+int linearSystemSolver::solveRecycledLinearSystem()
+{
+	// Left preconditioned GCR on the scaled system, M^-1*S*A*S*y=M^-1*S*b with x=S*y. Every
+	// direction u is orthogonalized so that the products c=M^-1*S*A*S*u of the recycled and of
+	// the new directions are orthonormal, then y+=u*(c,z) and z-=c*(c,z) minimize the
+	// preconditioned residual z over all of them. The preconditioned residual does not bound the
+	// error of x, so the solve only stops once the true residual |b-A*x|/|b| is below the
+	// tolerance: otherwise the tolerance of z is lowered by the ratio missed and the iterations go
+	// on from the true residual.
+	Vec y=linearSystemSolutionPETSc;
+	Vec b, r, z, u, c;
+	PetscReal independentTermsNorm, residualNorm, productNorm;
+	PetscReal trueIndependentTermsNorm, trueResidualNorm;
+	PetscReal preconditionedTolerance=relativeTolerance;
+	PetscScalar projection;
+	int firstNewDirection=recycledDirections.size();
+	int iterationNo=0;
+	int passIterationNo;
+
+	ierr=VecDuplicate(y,&b);CHKERRQ(ierr);
+	ierr=VecDuplicate(y,&r);CHKERRQ(ierr);
+	ierr=VecDuplicate(y,&z);CHKERRQ(ierr);
+	ierr=VecPointwiseMult(b,scalingPETSc,independentTermsArrayPETSc);CHKERRQ(ierr);
+	ierr=PCApply(preconditionerPETSc,b,z);CHKERRQ(ierr);
+	ierr=VecNorm(z,NORM_2,&independentTermsNorm);CHKERRQ(ierr);
+	ierr=VecNorm(independentTermsArrayPETSc,NORM_2,&trueIndependentTermsNorm);CHKERRQ(ierr);
+
+	// z=M^-1*(S*b-S*A*S*y(0)), with y(0)=S^-1*x(0)
+	ierr=extrapolateInitialGuess();CHKERRQ(ierr);
+	ierr=VecPointwiseDivide(y,y,scalingPETSc);CHKERRQ(ierr);
+	ierr=MatMult(coefficientsMatrixPETSc,y,r);CHKERRQ(ierr);
+	ierr=VecAYPX(r,-1.0,b);CHKERRQ(ierr);
+	ierr=PCApply(preconditionerPETSc,r,z);CHKERRQ(ierr);
+
+	// Projection onto the recycled space
+	for(int j=0; j<recycledDirections.size(); j++)
+	{
+		ierr=VecDot(recycledProducts[j],z,&projection);CHKERRQ(ierr);
+		ierr=VecAXPY(y,projection,recycledDirections[j]);CHKERRQ(ierr);
+		ierr=VecAXPY(z,-projection,recycledProducts[j]);CHKERRQ(ierr);
+	}
+	ierr=VecNorm(z,NORM_2,&residualNorm);CHKERRQ(ierr);
+
+	while(true)
+	{
+		passIterationNo=0;
+		while(residualNorm>preconditionedTolerance*independentTermsNorm &&
+			iterationNo<maxIterationNo)
+		{
+			// Restart, only the directions of this solve are dropped
+			if(recycledDirections.size()-firstNewDirection==restartNo)
+			{
+				for(int j=firstNewDirection; j<recycledDirections.size(); j++)
+				{
+					ierr=VecDestroy(&recycledDirections[j]);CHKERRQ(ierr);
+					ierr=VecDestroy(&recycledProducts[j]);CHKERRQ(ierr);
+				}
+				recycledDirections.resize(firstNewDirection);
+				recycledProducts.resize(firstNewDirection);
+			}
+
+			ierr=VecDuplicate(y,&u);CHKERRQ(ierr);
+			ierr=VecDuplicate(y,&c);CHKERRQ(ierr);
+			ierr=VecCopy(z,u);CHKERRQ(ierr);
+			ierr=MatMult(coefficientsMatrixPETSc,u,r);CHKERRQ(ierr);
+			ierr=PCApply(preconditionerPETSc,r,c);CHKERRQ(ierr);
+
+			for(int j=0; j<recycledDirections.size(); j++)
+			{
+				ierr=VecDot(recycledProducts[j],c,&projection);CHKERRQ(ierr);
+				ierr=VecAXPY(c,-projection,recycledProducts[j]);CHKERRQ(ierr);
+				ierr=VecAXPY(u,-projection,recycledDirections[j]);CHKERRQ(ierr);
+			}
+
+			ierr=VecNorm(c,NORM_2,&productNorm);CHKERRQ(ierr);
+			if(productNorm==0)
+			{
+				ierr=VecDestroy(&u);CHKERRQ(ierr);
+				ierr=VecDestroy(&c);CHKERRQ(ierr);
+
+				break;
+			}
+			ierr=VecScale(c,1.0/productNorm);CHKERRQ(ierr);
+			ierr=VecScale(u,1.0/productNorm);CHKERRQ(ierr);
+
+			ierr=VecDot(c,z,&projection);CHKERRQ(ierr);
+			ierr=VecAXPY(y,projection,u);CHKERRQ(ierr);
+			ierr=VecAXPY(z,-projection,c);CHKERRQ(ierr);
+			ierr=VecNorm(z,NORM_2,&residualNorm);CHKERRQ(ierr);
+
+			recycledDirections.push_back(u);
+			recycledProducts.push_back(c);
+			iterationNo++;
+			passIterationNo++;
+		}
+
+		// True residual, S^-1*(S*A*S)*y being A*x
+		ierr=MatMult(coefficientsMatrixPETSc,y,r);CHKERRQ(ierr);
+		ierr=VecPointwiseDivide(r,r,scalingPETSc);CHKERRQ(ierr);
+		ierr=VecAYPX(r,-1.0,independentTermsArrayPETSc);CHKERRQ(ierr);
+		ierr=VecNorm(r,NORM_2,&trueResidualNorm);CHKERRQ(ierr);
+		if(trueResidualNorm<=relativeTolerance*trueIndependentTermsNorm ||
+			iterationNo>=maxIterationNo || passIterationNo==0) break;
+
+		// z=M^-1*S*(b-A*x), with a tolerance lowered by the ratio missed
+		preconditionedTolerance*=0.5*relativeTolerance*trueIndependentTermsNorm/trueResidualNorm;
+		ierr=VecPointwiseMult(r,scalingPETSc,r);CHKERRQ(ierr);
+		ierr=PCApply(preconditionerPETSc,r,z);CHKERRQ(ierr);
+		ierr=VecNorm(z,NORM_2,&residualNorm);CHKERRQ(ierr);
+	}
+
+	if(trueResidualNorm>relativeTolerance*trueIndependentTermsNorm) cout << "GCR did not " <<
+		"converge in " << iterationNo << " iterations (true relative residual " <<
+		trueResidualNorm/trueIndependentTermsNorm << ")\n";
+
+	// x=S*y
+	ierr=VecPointwiseMult(y,y,scalingPETSc);CHKERRQ(ierr);
+
+	// The most recent directions are carried to the next solve
+	while(recycledDirections.size()>maxRecycledNo)
+	{
+		ierr=VecDestroy(&recycledDirections.front());CHKERRQ(ierr);
+		ierr=VecDestroy(&recycledProducts.front());CHKERRQ(ierr);
+		recycledDirections.erase(recycledDirections.begin());
+		recycledProducts.erase(recycledProducts.begin());
+	}
+
+	ierr=VecDestroy(&b);CHKERRQ(ierr);
+	ierr=VecDestroy(&r);CHKERRQ(ierr);
+	ierr=VecDestroy(&z);CHKERRQ(ierr);
+	iterationsNo.push_back(iterationNo);
+	lastRelativeResidual=(trueIndependentTermsNorm>0) ?
+		trueResidualNorm/trueIndependentTermsNorm : 0;
+	if(keepTimeLevels)
+	{
+		ierr=updateTimeLevels();CHKERRQ(ierr);
+	}
+
+	return ierr;
+}
+
+int linearSystemSolver::extrapolateInitialGuess()
+{
+	// x(0) from the polynomial through the last time levels, x(n), 2x(n)-x(n-1) or
+	// 3x(n)-3x(n-1)+x(n-2), and zero without them
+	vector<vector<double>> weights={{1},{2,-1},{3,-3,1}};
+	int levelsNo=min((int)timeLevels.size(),(int)extrapolationOrder+1);
+
+	ierr=VecZeroEntries(linearSystemSolutionPETSc);CHKERRQ(ierr);
+
+	for(int l=0; l<levelsNo; l++)
+	{
+		ierr=VecAXPY(linearSystemSolutionPETSc,weights[levelsNo-1][l],timeLevels[l]);
+			CHKERRQ(ierr);
+	}
+
+	return ierr;
+}
+
+int linearSystemSolver::updateTimeLevels()
+{
+	// Most recent first, the oldest level is reused for the new one
+	Vec level;
+
+	if(extrapolationOrder<0) return ierr;
+
+	if(timeLevels.size()<extrapolationOrder+1)
+	{
+		ierr=VecDuplicate(linearSystemSolutionPETSc,&level);CHKERRQ(ierr);
+	}
+	else
+	{
+		level=timeLevels.back();
+		timeLevels.pop_back();
+	}
+
+	ierr=VecCopy(linearSystemSolutionPETSc,level);CHKERRQ(ierr);
+	timeLevels.insert(timeLevels.begin(),level);
+
+	return ierr;
+}
+
+int linearSystemSolver::clearRecycledSpace()
+{
+	for(int j=0; j<recycledDirections.size(); j++)
+	{
+		ierr=VecDestroy(&recycledDirections[j]);CHKERRQ(ierr);
+		ierr=VecDestroy(&recycledProducts[j]);CHKERRQ(ierr);
+	}
+	recycledDirections.clear();
+	recycledProducts.clear();
+
+	return ierr;
+}
+
+void linearSystemSolver::printIterationSummary()
+{
+	// Iterations of the first solves, where the recycled space is built, and mean of the others
+	int firstSolvesNo=min((int)iterationsNo.size(),5);
+	double meanIterationNo=0;
+
+	cout << "GCR iterations per solve:";
+	for(int k=0; k<firstSolvesNo; k++) cout << " " << iterationsNo[k];
+	if(iterationsNo.size()>firstSolvesNo)
+	{
+		for(int k=firstSolvesNo; k<iterationsNo.size(); k++) meanIterationNo+=iterationsNo[k];
+		meanIterationNo/=iterationsNo.size()-firstSolvesNo;
+		cout << " ..., mean of the other " << iterationsNo.size()-firstSolvesNo << " solves " <<
+			meanIterationNo;
+	}
+	cout << " (" << recycledDirections.size() << " recycled directions)\n";
+
+	return;
+}
+
+int linearSystemSolver::createTrialSolvers()
+{
+	// The trial solvers only hold the sparse matrix, their dense matrix is n empty rows
+	PetscInt n=coefficientsMatrix.size();
+	vector<vector<double>> noField;
+	vector<vector<int>> noIndex;
+
+	for(int c=0; c<autotuneCandidates.size(); c++)
+	{
+		chrono::steady_clock::time_point start=chrono::steady_clock::now();
+		linearSystemSolver* trialSolver=new linearSystemSolver(vector<vector<double>>(n),
+			sparseCoefficientsRow,sparseCoefficientsColumn,sparseCoefficientsValue,noField,noField,
+			noField,Nu,Nv,NP,Nt,noIndex,noIndex,noIndex,noIndex,noIndex,noIndex);
+
+		trialSolver->setConfiguration(autotuneCandidates[c]);
+		ierr=trialSolver->coefficientsMatrixLUFactorization();CHKERRQ(ierr);
+		ierr=trialSolver->createPETScArrays();CHKERRQ(ierr);
+		trialSolvers.push_back(trialSolver);
+		trialSetupSeconds.push_back(chrono::duration<double>(chrono::steady_clock::now()-
+			start).count());
+		trialSolveSeconds.push_back(0);
+	}
+	trialStepsNo=0;
+
+	return ierr;
+}
+
+int linearSystemSolver::solveTrialLinearSystem()
+{
+	// Every candidate solves the system, the run goes on with the solution of the first one which
+	// converged, by the test of selectTrialSolver, or else with the one of smallest residual
+	int chosenCandidate=-1;
+
+	for(int c=0; c<trialSolvers.size(); c++)
+	{
+		ierr=VecCopy(independentTermsArrayPETSc,trialSolvers[c]->independentTermsArrayPETSc);
+			CHKERRQ(ierr);
+		ierr=trialSolvers[c]->solveLinearSystem();CHKERRQ(ierr);
+
+		// The first solve of each candidate is not counted, it builds the recycled space of gcr
+		if(trialStepsNo>0 || autotuneStepsNo<2)
+			trialSolveSeconds[c]+=trialSolvers[c]->lastSolveSeconds;
+
+		if(chosenCandidate>=0 && trialSolvers[chosenCandidate]->lastRelativeResidual<=
+			10*relativeTolerance) continue;
+		if(chosenCandidate<0 || trialSolvers[c]->lastRelativeResidual<
+			trialSolvers[chosenCandidate]->lastRelativeResidual) chosenCandidate=c;
+	}
+	ierr=VecCopy(trialSolvers[chosenCandidate]->linearSystemSolutionPETSc,
+		linearSystemSolutionPETSc);CHKERRQ(ierr);
+	lastRelativeResidual=trialSolvers[chosenCandidate]->lastRelativeResidual;
+	trialStepsNo++;
+
+	if(trialStepsNo>=autotuneStepsNo || trialStepsNo>=Nt-1)
+	{
+		ierr=selectTrialSolver();CHKERRQ(ierr);
+	}
+
+	return ierr;
+}
+
+int linearSystemSolver::selectTrialSolver()
+{
+	// Setup plus the mean time per solve over the Nt-1 time-steps, candidates which did not
+	// converge are left out
+	int countedStepsNo=(trialStepsNo>1 && autotuneStepsNo>=2) ? trialStepsNo-1 : trialStepsNo;
+	int bestCandidate=0;
+	double bestSeconds=INFINITY;
+
+	cout << "Autotune over " << trialStepsNo << " time-steps, predicted for " << Nt-1 << ":";
+	for(int c=0; c<trialSolvers.size(); c++)
+	{
+		double solveSeconds=trialSolveSeconds[c]/countedStepsNo;
+		double totalSeconds=trialSetupSeconds[c]+solveSeconds*(Nt-1);
+		bool isConverged=trialSolvers[c]->lastRelativeResidual<=10*relativeTolerance;
+
+		cout << " " << autotuneCandidates[c] << " " << trialSetupSeconds[c] << "+" <<
+			solveSeconds << "*" << Nt-1 << "=" << totalSeconds << " s";
+		if(!isConverged) cout << " (not converged)";
+		if(!isConverged || totalSeconds>=bestSeconds) continue;
+
+		bestSeconds=totalSeconds;
+		bestCandidate=c;
+	}
+	cout << "; chosen " << autotuneCandidates[bestCandidate] << "\n";
+	resultsManifest::recordSetting("linearSolver",autotuneCandidates[bestCandidate].c_str());
+
+	// The factors, preconditioner and time levels of the winner are taken over
+	linearSystemSolver* winner=trialSolvers[bestCandidate];
+	setConfiguration(autotuneCandidates[bestCandidate]);
+	swap(coefficientsMatrixPETSc,winner->coefficientsMatrixPETSc);
+	swap(perm,winner->perm);
+	swap(iperm,winner->iperm);
+	swap(info,winner->info);
+	swap(preconditionerPETSc,winner->preconditionerPETSc);
+	swap(scalingPETSc,winner->scalingPETSc);
+	swap(recycledDirections,winner->recycledDirections);
+	swap(recycledProducts,winner->recycledProducts);
+	swap(timeLevels,winner->timeLevels);
+	swap(iterationsNo,winner->iterationsNo);
+
+	for(int c=0; c<trialSolvers.size(); c++)
+	{
+		trialSolvers[c]->iterationsNo.clear();
+		delete trialSolvers[c];
+	}
+	trialSolvers.clear();
+
+	return ierr;
+}
@@ -0,0 +1,151 @@
+/*
+	This header is part of the development of a master's thesis entitled "Analysis of Numerical
+	Schemes in Collocated and Staggered Grids for Problems of Poroelasticity". The class defined
+	here writes the progress of a run to a small JSON file, for the monitoring of long runs: the
+	current time-step and simulated time, the rate of time-steps, the wall time of the solves, the
+	estimated time to completion, the memory in use and indicators of the stability of the solution
+	(its largest unknown, the growth of it since the last update and whether it is finite) and, for
+	the iterative solver, the iterations and relative residual of the last solve.
+
+	The file given by -metrics_file is rewritten every -metrics_interval time-steps (10 by default)
+	and at the last one. Each update is written to a temporary file in the same directory which is
+	then renamed over the metrics file, so a monitor reads either the previous or the new update,
+	never a partial one. Without -metrics_file nothing is written.
+
+ 	Written by FERREIRA, C. A. S.
+
+ 	Florianópolis, 2019.
+*/
+
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <math.h>
+#include <petscksp.h>
+#include <string>
+#include <sys/resource.h>
+
+using namespace std;
+
+class liveMetrics
+{
+public:
+	// Class variables
+	bool enabled=false;
+	string fileName;
+	string temporaryName;
+	string runName;
+	PetscInt interval=10;
+	int totalStepsNo;
+	double dt;
+	chrono::steady_clock::time_point runStart;
+	chrono::steady_clock::time_point intervalStart;
+	int intervalFirstStep=0;
+	int intervalSolvesNo=0;
+	double intervalSolveSeconds=0;
+	double maxSolveSeconds=0;
+	double previousSolutionNorm=0;
+
+	// Class functions
+	int update(int,linearSystemSolver&);
+	int writeMetrics(int,linearSystemSolver&);
+
+	// Constructor
+	liveMetrics(string,string,string,int,double);
+
+	// Destructor
+	~liveMetrics();
+};
+
+liveMetrics::liveMetrics(string problemName, string gridType, string interpScheme,
+	int myTotalStepsNo, double myDt)
+{
+	char myFileName[PETSC_MAX_PATH_LEN]="";
+	PetscBool isSet=PETSC_FALSE;
+
+	PetscOptionsGetString(NULL,NULL,"-metrics_file",myFileName,sizeof(myFileName),&isSet);
+	PetscOptionsGetInt(NULL,NULL,"-metrics_interval",&interval,NULL);
+	if(!isSet || myFileName[0]=='\0') return;
+
+	enabled=true;
+	fileName=myFileName;
+	temporaryName=fileName+".tmp";
+	runName=problemName+" "+gridType+((gridType=="staggered") ? "" : " "+interpScheme);
+	interval=max(interval,(PetscInt)1);
+	totalStepsNo=myTotalStepsNo;
+	dt=myDt;
+	runStart=chrono::steady_clock::now();
+	intervalStart=runStart;
+}
+
+liveMetrics::~liveMetrics(){}
+
+int liveMetrics::update(int step, linearSystemSolver& mySolver)
+{
+	// Called after the solve of each time-step
+	if(!enabled) return 0;
+
+	intervalSolvesNo++;
+	intervalSolveSeconds+=mySolver.lastSolveSeconds;
+	maxSolveSeconds=max(maxSolveSeconds,mySolver.lastSolveSeconds);
+	if(step%interval!=0 && step!=totalStepsNo) return 0;
+
+	return writeMetrics(step,mySolver);
+}
+
+int liveMetrics::writeMetrics(int step, linearSystemSolver& mySolver)
+{
+	chrono::steady_clock::time_point now=chrono::steady_clock::now();
+	double elapsed=chrono::duration<double>(now-runStart).count();
+	double intervalElapsed=chrono::duration<double>(now-intervalStart).count();
+	double stepsPerSecond=(elapsed>0) ? step/elapsed : 0;
+	double recentStepsPerSecond=(intervalElapsed>0) ?
+		(step-intervalFirstStep)/intervalElapsed : 0;
+	double remaining=(recentStepsPerSecond>0) ? (totalStepsNo-step)/recentStepsPerSecond : -1;
+	double solutionNorm=mySolver.lastSolutionNorm;
+	double growth=(previousSolutionNorm>0) ? solutionNorm/previousSolutionNorm : 0;
+	int iterationNo=mySolver.iterationsNo.empty() ? -1 : mySolver.iterationsNo.back();
+	PetscLogDouble residentBytes=0;
+	struct rusage usage;
+	char buffer[2048];
+	FILE* myFile;
+	int length;
+
+	PetscMemoryGetCurrentUsage(&residentBytes);
+	getrusage(RUSAGE_SELF,&usage);
+
+	length=snprintf(buffer,sizeof(buffer),"{\"run\":\"%s\",\"status\":\"%s\",\"step\":%d,"
+		"\"steps\":%d,\"simulatedTime\":%.9g,\"finalTime\":%.9g,\"elapsed\":%.6g,"
+		"\"stepsPerSecond\":%.6g,\"recentStepsPerSecond\":%.6g,\"meanSolveLatency\":%.6g,"
+		"\"maxSolveLatency\":%.6g,\"remaining\":%.6g,\"residentMB\":%.6g,\"peakResidentMB\":%.6g,"
+		"\"solutionNorm\":%.9g,\"solutionGrowth\":%.6g,\"finite\":%s,\"iterations\":%d,"
+		"\"relativeResidual\":%.6g,\"updated\":%lld}\n",runName.c_str(),
+		(step>=totalStepsNo) ? "finished" : "running",step,totalStepsNo,step*dt,totalStepsNo*dt,
+		elapsed,stepsPerSecond,recentStepsPerSecond,intervalSolveSeconds/max(intervalSolvesNo,1),
+		maxSolveSeconds,remaining,residentBytes/1048576,usage.ru_maxrss/1024.0,
+		isfinite(solutionNorm) ? solutionNorm : -1,isfinite(growth) ? growth : -1,
+		isfinite(solutionNorm) ? "true" : "false",iterationNo,mySolver.lastRelativeResidual,
+		(long long)time(NULL));
+
+	// Written aside and renamed, so the metrics file is replaced at once
+	myFile=fopen(temporaryName.c_str(),"w");
+	if(myFile==NULL)
+	{
+		cout << "Unable to open " << temporaryName << "\n";
+		enabled=false;
+
+		return 0;
+	}
+	fwrite(buffer,1,min(length,(int)sizeof(buffer)-1),myFile);
+	fclose(myFile);
+	rename(temporaryName.c_str(),fileName.c_str());
+
+	intervalStart=now;
+	intervalFirstStep=step;
+	intervalSolvesNo=0;
+	intervalSolveSeconds=0;
+	maxSolveSeconds=0;
+	previousSolutionNorm=solutionNorm;
+
+	return 0;
+}
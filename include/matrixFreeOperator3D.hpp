@@ -0,0 +1,420 @@
+/*
+	This header is part of the development of a master's thesis entitled "Analysis of Numerical
+	Schemes in Collocated and Staggered Grids for Problems of Poroelasticity". The class defined
+	here applies, without assembling any matrix, the operators of the three-dimensional
+	consolidation problem in the staggered grid of gridDesign3D, split as in the fixed-stress
+	scheme [1]:
+
+		momentum: -div(G*(grad(d)+grad(d)^T)+lambda*div(d)*I)=-alpha*grad(p)
+		continuity: (1/Q+alpha^2/K_dr)*p-dt*div(K/mu_f*grad(p))=f
+
+	with d=(u,v,w) and K_dr=lambda+2*G/3. Both are multiplied by the volume of the FV, so that they
+	are symmetric and positive definite. The momentum operator is the gradient of the discrete
+	strain energy: the normal stresses are found at the centroids and the shear stresses at the
+	edges, then their divergence at the faces. The boundaries follow the stripfoot problem: the top
+	is drained and free of shear, with the load on the footing, and the sides and the bottom are
+	impermeable rollers. The fixed displacements, normal to the rollers, have identity rows.
+
+	The sweeps run over tiles of tileSize rows in y, every layer of a tile before the next tile,
+	so that the layers above and below the current one are still in cache when they are read. A
+	Jacobi sweep is fused with the application of the operator. The class is templated on the
+	scalar type of the stresses and of the fields it is applied to, matrixFreeOperator3D being the
+	double precision one.
+
+ 	Written by FERREIRA, C. A. S.
+
+ 	Florianópolis, 2019.
+
+ 	[1] KIM, J.; TCHELEPI, H. A.; JUANES, R. Stability and Convergence of Sequential Methods for
+ 	Coupled Flow and Geomechanics: Fixed-Stress and Fixed-Strain Splits. Computer Methods in
+ 	Applied Mechanics and Engineering, 200, 2011.
+*/
+
+#include <algorithm>
+#include <math.h>
+#include <vector>
+
+using namespace std;
+
+template<class scalar>
+class basicMatrixFreeOperator3D
+{
+public:
+	// Class variables
+	int Nx, Ny, Nz;
+	scalar dx, dy, dz;
+	scalar G;
+	scalar lambda;
+	scalar storage; // 1/Q+alpha^2/K_dr [Pa^-1]
+	scalar mobilityDt; // dt*K/mu_f [m^2/Pa]
+	int tileSize;
+	int Nu, Nv, Nw, NP;
+	int mechanicsSize;
+	vector<scalar> sxx, syy, szz; // Centroids
+	vector<scalar> sxy; // Edges along z, (Nx+1) x (Ny+1) x Nz
+	vector<scalar> sxz; // Edges along y, (Nx+1) x Ny x (Nz+1)
+	vector<scalar> syz; // Edges along x, Nx x (Ny+1) x (Nz+1)
+	vector<scalar> mechanicsInverseDiagonal;
+	vector<scalar> pressureInverseDiagonal;
+	vector<scalar> zeroRow;
+
+	// Class functions
+	int uIndex(int i, int j, int k){return (k*Ny+j)*(Nx+1)+i;};
+	int vIndex(int i, int j, int k){return (k*(Ny+1)+j)*Nx+i;};
+	int wIndex(int i, int j, int k){return (k*Ny+j)*Nx+i;};
+	int pIndex(int i, int j, int k){return (k*Ny+j)*Nx+i;};
+	int xyIndex(int i, int j, int k){return (k*(Ny+1)+j)*(Nx+1)+i;};
+	int xzIndex(int i, int j, int k){return (k*Ny+j)*(Nx+1)+i;};
+	int yzIndex(int i, int j, int k){return (k*(Ny+1)+j)*Nx+i;};
+	void buildMechanicsDiagonal();
+	void buildPressureDiagonal();
+	void computeStresses(const scalar*);
+	void sweepMechanics(const scalar*,const scalar*,scalar*,scalar);
+	void sweepPressure(const scalar*,const scalar*,scalar*,scalar);
+	void assemblyMomentumRHS(const vector<scalar>&,const vector<scalar>&,scalar,vector<scalar>&);
+	void computeVolumetricStrain(const vector<scalar>&,vector<scalar>&);
+
+	// Constructor
+	basicMatrixFreeOperator3D(gridDesign3D&,scalar,scalar,scalar,scalar,int);
+
+	// Destructor
+	~basicMatrixFreeOperator3D();
+};
+
+typedef basicMatrixFreeOperator3D<double> matrixFreeOperator3D;
+
+template<class scalar>
+basicMatrixFreeOperator3D<scalar>::basicMatrixFreeOperator3D(gridDesign3D& myGrid,
+	scalar shearModulus, scalar lames1stParameter, scalar fixedStressStorage, scalar dtMobility,
+	int myTileSize)
+{
+	Nx=myGrid.Nx;
+	Ny=myGrid.Ny;
+	Nz=myGrid.Nz;
+	dx=myGrid.dx;
+	dy=myGrid.dy;
+	dz=myGrid.dz;
+	G=shearModulus;
+	lambda=lames1stParameter;
+	storage=fixedStressStorage;
+	mobilityDt=dtMobility;
+	tileSize=max(myTileSize,1);
+	Nu=myGrid.Nu;
+	Nv=myGrid.Nv;
+	Nw=myGrid.Nw;
+	NP=myGrid.NP;
+	mechanicsSize=Nu+Nv+Nw;
+
+	// The shear stresses on the boundaries are null and never written
+	sxx.assign(NP,0);
+	syy.assign(NP,0);
+	szz.assign(NP,0);
+	sxy.assign((Nx+1)*(Ny+1)*Nz,0);
+	sxz.assign((Nx+1)*Ny*(Nz+1),0);
+	syz.assign(Nx*(Ny+1)*(Nz+1),0);
+	zeroRow.assign(Nx,0);
+	buildMechanicsDiagonal();
+	buildPressureDiagonal();
+}
+
+template<class scalar>
+basicMatrixFreeOperator3D<scalar>::~basicMatrixFreeOperator3D(){}
+
+template<class scalar>
+void basicMatrixFreeOperator3D<scalar>::buildMechanicsDiagonal()
+{
+	scalar M=lambda+2*G;
+	int interiorNo;
+
+	mechanicsInverseDiagonal.assign(mechanicsSize,1);
+	for(int k=0; k<Nz; k++)
+	for(int j=0; j<Ny; j++)
+	for(int i=1; i<Nx; i++)
+	{
+		interiorNo=(j>0)+(j<Ny-1);
+		scalar diagonal=2*M*dy*dz/dx+G*dx*dz/dy*interiorNo;
+		interiorNo=(k>0)+(k<Nz-1);
+		diagonal+=G*dx*dy/dz*interiorNo;
+		mechanicsInverseDiagonal[uIndex(i,j,k)]=1/diagonal;
+	}
+
+	for(int k=0; k<Nz; k++)
+	for(int j=1; j<Ny; j++)
+	for(int i=0; i<Nx; i++)
+	{
+		interiorNo=(i>0)+(i<Nx-1);
+		scalar diagonal=2*M*dx*dz/dy+G*dy*dz/dx*interiorNo;
+		interiorNo=(k>0)+(k<Nz-1);
+		diagonal+=G*dx*dy/dz*interiorNo;
+		mechanicsInverseDiagonal[Nu+vIndex(i,j,k)]=1/diagonal;
+	}
+
+	// The top faces have half a FV and no shear
+	for(int k=0; k<Nz; k++)
+	for(int j=0; j<Ny; j++)
+	for(int i=0; i<Nx; i++)
+	{
+		scalar diagonal=M*dx*dy/dz*((k==0) ? 1 : 2);
+		if(k>0) diagonal+=G*dy*dz/dx*((i>0)+(i<Nx-1))+G*dx*dz/dy*((j>0)+(j<Ny-1));
+		mechanicsInverseDiagonal[Nu+Nv+wIndex(i,j,k)]=1/diagonal;
+	}
+
+	return;
+}
+
+template<class scalar>
+void basicMatrixFreeOperator3D<scalar>::buildPressureDiagonal()
+{
+	scalar cx=mobilityDt*dy*dz/dx;
+	scalar cy=mobilityDt*dx*dz/dy;
+	scalar cz=mobilityDt*dx*dy/dz;
+
+	pressureInverseDiagonal.resize(NP);
+	for(int k=0; k<Nz; k++)
+	for(int j=0; j<Ny; j++)
+	for(int i=0; i<Nx; i++)
+	{
+		scalar diagonal=storage*dx*dy*dz+cx*((i>0)+(i<Nx-1))+cy*((j>0)+(j<Ny-1))+
+			cz*((k==0) ? 2 : 1)+cz*(k<Nz-1);
+		pressureInverseDiagonal[pIndex(i,j,k)]=1/diagonal;
+	}
+
+	return;
+}
+
+template<class scalar>
+void basicMatrixFreeOperator3D<scalar>::computeStresses(const scalar* x)
+{
+	const scalar rdx=1/dx, rdy=1/dy, rdz=1/dz;
+	const scalar M=lambda+2*G;
+	const scalar* u=x;
+	const scalar* v=x+Nu;
+	const scalar* w=x+Nu+Nv;
+
+	for(int jStart=0; jStart<Ny+1; jStart+=tileSize)
+	for(int k=0; k<Nz+1; k++)
+	for(int j=jStart; j<min(jStart+tileSize,Ny+1); j++)
+	{
+		// Normal stresses of the layer k
+		if(k<Nz && j<Ny)
+		{
+			const scalar* __restrict__ uRow=u+uIndex(0,j,k);
+			const scalar* __restrict__ vSouth=v+vIndex(0,j,k);
+			const scalar* __restrict__ vNorth=v+vIndex(0,j+1,k);
+			const scalar* __restrict__ wTop=w+wIndex(0,j,k);
+			const scalar* __restrict__ wBottom=w+wIndex(0,j,k+1);
+			scalar* __restrict__ sxxRow=sxx.data()+pIndex(0,j,k);
+			scalar* __restrict__ syyRow=syy.data()+pIndex(0,j,k);
+			scalar* __restrict__ szzRow=szz.data()+pIndex(0,j,k);
+
+			for(int i=0; i<Nx; i++)
+			{
+				scalar exx=(uRow[i+1]-uRow[i])*rdx;
+				scalar eyy=(vNorth[i]-vSouth[i])*rdy;
+				scalar ezz=(wTop[i]-wBottom[i])*rdz;
+				sxxRow[i]=M*exx+lambda*(eyy+ezz);
+				syyRow[i]=M*eyy+lambda*(exx+ezz);
+				szzRow[i]=M*ezz+lambda*(exx+eyy);
+			}
+		}
+
+		// Shear stresses on the edges along z of the layer k
+		if(k<Nz && j>0 && j<Ny)
+		{
+			const scalar* __restrict__ uNorth=u+uIndex(0,j,k);
+			const scalar* __restrict__ uSouth=u+uIndex(0,j-1,k);
+			const scalar* __restrict__ vRow=v+vIndex(0,j,k);
+			scalar* __restrict__ sxyRow=sxy.data()+xyIndex(0,j,k);
+
+			for(int i=1; i<Nx; i++)
+				sxyRow[i]=G*((uNorth[i]-uSouth[i])*rdy+(vRow[i]-vRow[i-1])*rdx);
+		}
+
+		// Shear stresses on the edges along y and x of the inner face k
+		if(k>0 && k<Nz && j<Ny)
+		{
+			const scalar* __restrict__ uAbove=u+uIndex(0,j,k-1);
+			const scalar* __restrict__ uBelow=u+uIndex(0,j,k);
+			const scalar* __restrict__ wRow=w+wIndex(0,j,k);
+			scalar* __restrict__ sxzRow=sxz.data()+xzIndex(0,j,k);
+
+			for(int i=1; i<Nx; i++)
+				sxzRow[i]=G*((uAbove[i]-uBelow[i])*rdz+(wRow[i]-wRow[i-1])*rdx);
+		}
+		if(k>0 && k<Nz && j>0 && j<Ny)
+		{
+			const scalar* __restrict__ vAbove=v+vIndex(0,j,k-1);
+			const scalar* __restrict__ vBelow=v+vIndex(0,j,k);
+			const scalar* __restrict__ wNorth=w+wIndex(0,j,k);
+			const scalar* __restrict__ wSouth=w+wIndex(0,j-1,k);
+			scalar* __restrict__ syzRow=syz.data()+yzIndex(0,j,k);
+
+			for(int i=0; i<Nx; i++)
+				syzRow[i]=G*((vAbove[i]-vBelow[i])*rdz+(wNorth[i]-wSouth[i])*rdy);
+		}
+	}
+
+	return;
+}
+
+template<class scalar>
+void basicMatrixFreeOperator3D<scalar>::sweepMechanics(const scalar* x, const scalar* b, scalar* y,
+	scalar omega)
+{
+	// y=A*x without b, otherwise the Jacobi sweep y=x+omega*D^-1*(b-A*x)
+	const scalar Axx=dy*dz, Axy=dx*dz, Axz=dx*dy;
+	const scalar* invD=mechanicsInverseDiagonal.data();
+
+	computeStresses(x);
+
+	for(int jStart=0; jStart<Ny+1; jStart+=tileSize)
+	for(int k=0; k<Nz+1; k++)
+	for(int j=jStart; j<min(jStart+tileSize,Ny+1); j++)
+	{
+		if(k<Nz && j<Ny)
+		{
+			// u
+			int n0=uIndex(0,j,k);
+			const scalar* __restrict__ sxxRow=sxx.data()+pIndex(0,j,k);
+			const scalar* __restrict__ sxySouth=sxy.data()+xyIndex(0,j,k);
+			const scalar* __restrict__ sxyNorth=sxy.data()+xyIndex(0,j+1,k);
+			const scalar* __restrict__ sxzTop=sxz.data()+xzIndex(0,j,k);
+			const scalar* __restrict__ sxzBottom=sxz.data()+xzIndex(0,j,k+1);
+			y[n0]=x[n0];
+			y[n0+Nx]=x[n0+Nx];
+			for(int i=1; i<Nx; i++)
+			{
+				scalar Ax=-(Axx*(sxxRow[i]-sxxRow[i-1])+Axy*(sxyNorth[i]-sxySouth[i])+
+					Axz*(sxzTop[i]-sxzBottom[i]));
+				y[n0+i]=(b==NULL) ? Ax : x[n0+i]+omega*invD[n0+i]*(b[n0+i]-Ax);
+			}
+
+			// w
+			n0=Nu+Nv+wIndex(0,j,k);
+			const scalar* __restrict__ szzAbove=(k>0) ? szz.data()+pIndex(0,j,k-1) : zeroRow.data();
+			const scalar* __restrict__ szzBelow=szz.data()+pIndex(0,j,k);
+			const scalar* __restrict__ sxzRow=sxz.data()+xzIndex(0,j,k);
+			const scalar* __restrict__ syzSouth=syz.data()+yzIndex(0,j,k);
+			const scalar* __restrict__ syzNorth=syz.data()+yzIndex(0,j+1,k);
+			for(int i=0; i<Nx; i++)
+			{
+				scalar Ax=-(Axz*(szzAbove[i]-szzBelow[i])+Axx*(sxzRow[i+1]-sxzRow[i])+
+					Axy*(syzNorth[i]-syzSouth[i]));
+				y[n0+i]=(b==NULL) ? Ax : x[n0+i]+omega*invD[n0+i]*(b[n0+i]-Ax);
+			}
+		}
+
+		// v
+		if(k<Nz)
+		{
+			int n0=Nu+vIndex(0,j,k);
+			if(j==0 || j==Ny)
+			{
+				for(int i=0; i<Nx; i++) y[n0+i]=x[n0+i];
+			}
+			else
+			{
+				const scalar* __restrict__ syyNorth=syy.data()+pIndex(0,j,k);
+				const scalar* __restrict__ syySouth=syy.data()+pIndex(0,j-1,k);
+				const scalar* __restrict__ sxyRow=sxy.data()+xyIndex(0,j,k);
+				const scalar* __restrict__ syzTop=syz.data()+yzIndex(0,j,k);
+				const scalar* __restrict__ syzBottom=syz.data()+yzIndex(0,j,k+1);
+				for(int i=0; i<Nx; i++)
+				{
+					scalar Ax=-(Axy*(syyNorth[i]-syySouth[i])+Axx*(sxyRow[i+1]-sxyRow[i])+
+						Axz*(syzTop[i]-syzBottom[i]));
+					y[n0+i]=(b==NULL) ? Ax : x[n0+i]+omega*invD[n0+i]*(b[n0+i]-Ax);
+				}
+			}
+		}
+
+		// Fixed w at the bottom
+		if(k==Nz && j<Ny)
+		{
+			int n0=Nu+Nv+wIndex(0,j,k);
+			for(int i=0; i<Nx; i++) y[n0+i]=x[n0+i];
+		}
+	}
+
+	return;
+}
+
+template<class scalar>
+void basicMatrixFreeOperator3D<scalar>::sweepPressure(const scalar* x, const scalar* b, scalar* y,
+	scalar omega)
+{
+	// y=A*x without b, otherwise the Jacobi sweep y=x+omega*D^-1*(b-A*x)
+	const scalar cx=mobilityDt*dy*dz/dx;
+	const scalar cy=mobilityDt*dx*dz/dy;
+	const scalar cz=mobilityDt*dx*dy/dz;
+	const scalar mass=storage*dx*dy*dz;
+	const scalar* invD=pressureInverseDiagonal.data();
+
+	for(int jStart=0; jStart<Ny; jStart+=tileSize)
+	for(int k=0; k<Nz; k++)
+	for(int j=jStart; j<min(jStart+tileSize,Ny); j++)
+	{
+		// Missing neighbours are replaced by the FV itself (no flux), the top by -p (drained)
+		int n0=pIndex(0,j,k);
+		const scalar* __restrict__ row=x+n0;
+		const scalar* __restrict__ south=(j>0) ? row-Nx : row;
+		const scalar* __restrict__ north=(j<Ny-1) ? row+Nx : row;
+		const scalar* __restrict__ above=(k>0) ? row-Nx*Ny : zeroRow.data();
+		const scalar* __restrict__ below=(k<Nz-1) ? row+Nx*Ny : row;
+		const scalar cAbove=(k>0) ? cz : 2*cz;
+
+		for(int i=0; i<Nx; i++)
+		{
+			scalar west=(i>0) ? row[i-1] : row[i];
+			scalar east=(i<Nx-1) ? row[i+1] : row[i];
+			scalar Ax=mass*row[i]+cx*(2*row[i]-west-east)+cy*(2*row[i]-south[i]-north[i])+
+				cAbove*(row[i]-above[i])+cz*(row[i]-below[i]);
+			y[n0+i]=(b==NULL) ? Ax : row[i]+omega*invD[n0+i]*(b[n0+i]-Ax);
+		}
+	}
+
+	return;
+}
+
+template<class scalar>
+void basicMatrixFreeOperator3D<scalar>::assemblyMomentumRHS(const vector<scalar>& p,
+	const vector<scalar>& topLoad, scalar alpha, vector<scalar>& b)
+{
+	// -alpha*grad(p) times the volume, and the load on the top faces
+	b.assign(mechanicsSize,0);
+	for(int k=0; k<Nz; k++)
+	for(int j=0; j<Ny; j++)
+	{
+		for(int i=1; i<Nx; i++)
+			b[uIndex(i,j,k)]=-alpha*dy*dz*(p[pIndex(i,j,k)]-p[pIndex(i-1,j,k)]);
+		if(j>0) for(int i=0; i<Nx; i++)
+			b[Nu+vIndex(i,j,k)]=-alpha*dx*dz*(p[pIndex(i,j,k)]-p[pIndex(i,j-1,k)]);
+		for(int i=0; i<Nx; i++)
+		{
+			scalar above=(k>0) ? alpha*p[pIndex(i,j,k-1)] : -topLoad[j*Nx+i];
+			b[Nu+Nv+wIndex(i,j,k)]=-dx*dy*(above-alpha*p[pIndex(i,j,k)]);
+		}
+	}
+
+	return;
+}
+
+template<class scalar>
+void basicMatrixFreeOperator3D<scalar>::computeVolumetricStrain(const vector<scalar>& x,
+	vector<scalar>& strain)
+{
+	const scalar* u=x.data();
+	const scalar* v=x.data()+Nu;
+	const scalar* w=x.data()+Nu+Nv;
+
+	strain.resize(NP);
+	for(int k=0; k<Nz; k++)
+	for(int j=0; j<Ny; j++)
+	for(int i=0; i<Nx; i++)
+	{
+		strain[pIndex(i,j,k)]=(u[uIndex(i+1,j,k)]-u[uIndex(i,j,k)])/dx+
+			(v[vIndex(i,j+1,k)]-v[vIndex(i,j,k)])/dy+(w[wIndex(i,j,k)]-w[wIndex(i,j,k+1)])/dz;
+	}
+
+	return;
+}
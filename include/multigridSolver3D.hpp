@@ -0,0 +1,336 @@
+/*
+	This header is part of the development of a master's thesis entitled "Analysis of Numerical
+	Schemes in Collocated and Staggered Grids for Problems of Poroelasticity". The class defined
+	here solves the momentum and the continuity operators of matrixFreeOperator3D with the
+	Conjugate Gradient method preconditioned by one V-cycle of geometric multigrid [1]. The coarse
+	grids halve the FV in every direction and rediscretize the operators. The fields are prolonged
+	linearly: the pressure between the centroids, each displacement between the faces along its own
+	direction and between the centers of the faces along the others, and restricted by the
+	transpose. The smoother is the weighted Jacobi method, the same before and after the coarse
+	correction, and the coarsest grid gets a fixed number of Jacobi sweeps, so that the V-cycle is
+	a symmetric preconditioner.
+
+	The operators, the work fields of the levels and the Conjugate Gradient take about 40 values
+	per FV of the finest grid, so that, with the fields of the problem, a grid of 128^3 FV is
+	solved within 1 GB in double precision. The class is templated on the scalar type of the
+	levels, multigridSolver3D being the double precision one; the inner products and the step
+	lengths of the Conjugate Gradient are accumulated in double precision for either type.
+
+ 	Written by FERREIRA, C. A. S.
+
+ 	Florianópolis, 2019.
+
+ 	[1] TROTTENBERG, U.; OOSTERLEE, C. W.; SCHÜLLER, A. Multigrid. Academic Press, 2001.
+*/
+
+#include <math.h>
+#include <vector>
+
+using namespace std;
+
+template<class scalar>
+class basicMultigridSolver3D
+{
+public:
+	// Class variables
+	static const int mechanicsField=0;
+	static const int pressureField=1;
+	vector<basicMatrixFreeOperator3D<scalar>> levels;
+	vector<vector<scalar>> xLevels, bLevels, rLevels, tmpLevels;
+	vector<scalar> r, z, d, Ad;
+	PetscInt smoothingSweeps=2;
+	int coarsestSweeps=20;
+	scalar mechanicsOmega=0.6;
+	scalar pressureOmega=0.8;
+
+	// Class functions
+	int getSize(int,int);
+	void sweep(int,int,const scalar*,const scalar*,scalar*);
+	void transferField(int,int,int,int,bool,const scalar*,scalar*);
+	void restrictField(int,int);
+	void prolongField(int,int);
+	void vCycle(int,int);
+	double dot(const vector<scalar>&,const vector<scalar>&,int);
+	int solve(int,const vector<scalar>&,vector<scalar>&,double,int);
+
+	// Constructor
+	basicMultigridSolver3D(gridDesign3D,scalar,scalar,scalar,scalar,int);
+
+	// Destructor
+	~basicMultigridSolver3D();
+};
+
+typedef basicMultigridSolver3D<double> multigridSolver3D;
+
+template<class scalar>
+basicMultigridSolver3D<scalar>::basicMultigridSolver3D(gridDesign3D myGrid, scalar G,
+	scalar lambda, scalar storage, scalar mobilityDt, int tileSize)
+{
+	PetscInt levelsNo=20;
+
+	PetscOptionsGetInt(NULL,NULL,"-mg_levels",&levelsNo,NULL);
+	PetscOptionsGetInt(NULL,NULL,"-mg_smoothing_sweeps",&smoothingSweeps,NULL);
+
+	levels.push_back(basicMatrixFreeOperator3D<scalar>(myGrid,G,lambda,storage,mobilityDt,
+		tileSize));
+	while(myGrid.isCoarsenable() && levels.size()<levelsNo)
+	{
+		myGrid=myGrid.getCoarseGrid();
+		levels.push_back(basicMatrixFreeOperator3D<scalar>(myGrid,G,lambda,storage,mobilityDt,
+			tileSize));
+	}
+
+	// The work fields of each level fit both operators
+	for(int level=0; level<levels.size(); level++)
+	{
+		int size=levels[level].mechanicsSize;
+		xLevels.push_back(vector<scalar>(size,0));
+		bLevels.push_back(vector<scalar>(size,0));
+		rLevels.push_back(vector<scalar>(size,0));
+		tmpLevels.push_back(vector<scalar>(size,0));
+	}
+	r.resize(levels[0].mechanicsSize);
+	z.resize(levels[0].mechanicsSize);
+	d.resize(levels[0].mechanicsSize);
+	Ad.resize(levels[0].mechanicsSize);
+}
+
+template<class scalar>
+basicMultigridSolver3D<scalar>::~basicMultigridSolver3D(){}
+
+template<class scalar>
+int basicMultigridSolver3D<scalar>::getSize(int field, int level)
+{
+	return (field==mechanicsField) ? levels[level].mechanicsSize : levels[level].NP;
+}
+
+template<class scalar>
+void basicMultigridSolver3D<scalar>::sweep(int field, int level, const scalar* x, const scalar* b,
+	scalar* y)
+{
+	if(field==mechanicsField)
+		levels[level].sweepMechanics(x,b,y,mechanicsOmega);
+	else
+		levels[level].sweepPressure(x,b,y,pressureOmega);
+
+	return;
+}
+
+template<class scalar>
+void basicMultigridSolver3D<scalar>::transferField(int Nx, int Ny, int Nz, int direction,
+	bool isRestriction, const scalar* from, scalar* to)
+{
+	// Faces normal to direction (0 x, 1 y, 2 z), or centroids if it is -1, of the coarse grid of
+	// Nx x Ny x Nz FV
+	int coarseNo[3]={Nx+(direction==0),Ny+(direction==1),Nz+(direction==2)};
+	int fineNo[3]={2*Nx+(direction==0),2*Ny+(direction==1),2*Nz+(direction==2)};
+	int fine[3], coarse[3][2], weightsNo[3];
+	scalar weight[3][2];
+
+	if(isRestriction) fill(to,to+coarseNo[0]*coarseNo[1]*coarseNo[2],0.);
+
+	for(fine[2]=0; fine[2]<fineNo[2]; fine[2]++)
+	for(fine[1]=0; fine[1]<fineNo[1]; fine[1]++)
+	for(fine[0]=0; fine[0]<fineNo[0]; fine[0]++)
+	{
+		int fineIndex=(fine[2]*fineNo[1]+fine[1])*fineNo[0]+fine[0];
+
+		for(int d=0; d<3; d++)
+		{
+			int c=fine[d]/2;
+			int neighbour=(fine[d]%2==0) ? c-1 : c+1;
+
+			// Linear along the normal to the faces, the odd ones between two coarse faces
+			if(d==direction)
+			{
+				coarse[d][0]=c;
+				weight[d][0]=(fine[d]%2==0) ? 1 : 0.5;
+				coarse[d][1]=c+1;
+				weight[d][1]=0.5;
+				weightsNo[d]=(fine[d]%2==0) ? 1 : 2;
+			}
+
+			// Linear between the centers of the coarse FV, constant next to the boundaries
+			else if(neighbour<0 || neighbour>=coarseNo[d])
+			{
+				coarse[d][0]=c;
+				weight[d][0]=1;
+				weightsNo[d]=1;
+			}
+			else
+			{
+				coarse[d][0]=c;
+				weight[d][0]=0.75;
+				coarse[d][1]=neighbour;
+				weight[d][1]=0.25;
+				weightsNo[d]=2;
+			}
+		}
+
+		for(int c=0; c<weightsNo[2]; c++)
+		for(int b=0; b<weightsNo[1]; b++)
+		for(int a=0; a<weightsNo[0]; a++)
+		{
+			int coarseIndex=(coarse[2][c]*coarseNo[1]+coarse[1][b])*coarseNo[0]+coarse[0][a];
+			scalar myWeight=weight[0][a]*weight[1][b]*weight[2][c];
+
+			if(isRestriction) to[coarseIndex]+=myWeight*from[fineIndex];
+			else to[fineIndex]+=myWeight*from[coarseIndex];
+		}
+	}
+
+	return;
+}
+
+template<class scalar>
+void basicMultigridSolver3D<scalar>::restrictField(int field, int level)
+{
+	// Residual of level to the independent terms of level+1
+	basicMatrixFreeOperator3D<scalar>& coarse=levels[level+1];
+	const basicMatrixFreeOperator3D<scalar>& myFine=levels[level];
+	const scalar* fine=rLevels[level].data();
+	scalar* b=bLevels[level+1].data();
+
+	if(field==pressureField)
+	{
+		transferField(coarse.Nx,coarse.Ny,coarse.Nz,-1,true,fine,b);
+
+		return;
+	}
+
+	transferField(coarse.Nx,coarse.Ny,coarse.Nz,0,true,fine,b);
+	transferField(coarse.Nx,coarse.Ny,coarse.Nz,1,true,fine+myFine.Nu,b+coarse.Nu);
+	transferField(coarse.Nx,coarse.Ny,coarse.Nz,2,true,fine+myFine.Nu+myFine.Nv,
+		b+coarse.Nu+coarse.Nv);
+
+	// Fixed displacements
+	for(int k=0; k<coarse.Nz; k++)
+	for(int j=0; j<coarse.Ny; j++)
+	{
+		b[coarse.uIndex(0,j,k)]=0;
+		b[coarse.uIndex(coarse.Nx,j,k)]=0;
+	}
+	for(int k=0; k<coarse.Nz; k++)
+	for(int i=0; i<coarse.Nx; i++)
+	{
+		b[coarse.Nu+coarse.vIndex(i,0,k)]=0;
+		b[coarse.Nu+coarse.vIndex(i,coarse.Ny,k)]=0;
+	}
+	for(int j=0; j<coarse.Ny; j++)
+	for(int i=0; i<coarse.Nx; i++)
+		b[coarse.Nu+coarse.Nv+coarse.wIndex(i,j,coarse.Nz)]=0;
+
+	return;
+}
+
+template<class scalar>
+void basicMultigridSolver3D<scalar>::prolongField(int field, int level)
+{
+	// Correction of level+1 added to the solution of level
+	basicMatrixFreeOperator3D<scalar>& coarse=levels[level+1];
+	const basicMatrixFreeOperator3D<scalar>& myFine=levels[level];
+	const scalar* x=xLevels[level+1].data();
+	scalar* fine=xLevels[level].data();
+
+	if(field==pressureField)
+	{
+		transferField(coarse.Nx,coarse.Ny,coarse.Nz,-1,false,x,fine);
+
+		return;
+	}
+
+	transferField(coarse.Nx,coarse.Ny,coarse.Nz,0,false,x,fine);
+	transferField(coarse.Nx,coarse.Ny,coarse.Nz,1,false,x+coarse.Nu,fine+myFine.Nu);
+	transferField(coarse.Nx,coarse.Ny,coarse.Nz,2,false,x+coarse.Nu+coarse.Nv,
+		fine+myFine.Nu+myFine.Nv);
+
+	return;
+}
+
+template<class scalar>
+void basicMultigridSolver3D<scalar>::vCycle(int field, int level)
+{
+	int size=getSize(field,level);
+	scalar* x=xLevels[level].data();
+	scalar* tmp=tmpLevels[level].data();
+	const scalar* b=bLevels[level].data();
+	bool isCoarsest=(level==levels.size()-1);
+	int sweepsNo=isCoarsest ? coarsestSweeps : smoothingSweeps;
+
+	// Pre-smoothing from a null guess
+	fill(x,x+size,0.);
+	for(int sweepNo=0; sweepNo<sweepsNo; sweepNo++)
+	{
+		sweep(field,level,x,b,tmp);
+		swap(xLevels[level],tmpLevels[level]);
+		x=xLevels[level].data();
+		tmp=tmpLevels[level].data();
+	}
+	if(isCoarsest) return;
+
+	// Coarse grid correction
+	sweep(field,level,x,NULL,rLevels[level].data());
+	for(int n=0; n<size; n++) rLevels[level][n]=b[n]-rLevels[level][n];
+	restrictField(field,level);
+	vCycle(field,level+1);
+	prolongField(field,level);
+
+	// Post-smoothing
+	for(int sweepNo=0; sweepNo<sweepsNo; sweepNo++)
+	{
+		sweep(field,level,xLevels[level].data(),b,tmpLevels[level].data());
+		swap(xLevels[level],tmpLevels[level]);
+	}
+
+	return;
+}
+
+template<class scalar>
+double basicMultigridSolver3D<scalar>::dot(const vector<scalar>& a, const vector<scalar>& b,
+	int size)
+{
+	double sum=0;
+
+	for(int n=0; n<size; n++) sum+=a[n]*b[n];
+
+	return sum;
+}
+
+template<class scalar>
+int basicMultigridSolver3D<scalar>::solve(int field, const vector<scalar>& rhs, vector<scalar>& x,
+	double tolerance, int maxIterationsNo)
+{
+	// Conjugate Gradient preconditioned by a V-cycle, x holds the initial guess
+	int size=getSize(field,0);
+	double rz, rzOld, rhsNorm, step;
+	int iterationNo;
+
+	sweep(field,0,x.data(),NULL,Ad.data());
+	for(int n=0; n<size; n++) r[n]=rhs[n]-Ad[n];
+	rhsNorm=sqrt(dot(rhs,rhs,size));
+	if(rhsNorm==0) rhsNorm=1;
+
+	for(iterationNo=0; iterationNo<maxIterationsNo; iterationNo++)
+	{
+		if(sqrt(dot(r,r,size))<=tolerance*rhsNorm) break;
+
+		copy(r.begin(),r.begin()+size,bLevels[0].begin());
+		vCycle(field,0);
+		copy(xLevels[0].begin(),xLevels[0].begin()+size,z.begin());
+
+		rz=dot(r,z,size);
+		if(iterationNo==0) copy(z.begin(),z.begin()+size,d.begin());
+		else for(int n=0; n<size; n++) d[n]=z[n]+(rz/rzOld)*d[n];
+		rzOld=rz;
+
+		sweep(field,0,d.data(),NULL,Ad.data());
+		step=rz/dot(d,Ad,size);
+		for(int n=0; n<size; n++)
+		{
+			x[n]+=step*d[n];
+			r[n]-=step*Ad[n];
+		}
+	}
+
+	return iterationNo;
+}
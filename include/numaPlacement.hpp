@@ -0,0 +1,233 @@
+/*
+	This header is part of the development of a master's thesis entitled "Analysis of Numerical
+	Schemes in Collocated and Staggered Grids for Problems of Poroelasticity". The class defined
+	here places the large arrays of a run in the memory of the socket of the threads which use
+	them. The threaded kernels split the unknowns in -numa_threads contiguous ranges (the static
+	partition of getStaticRange) and the arrays with a row per unknown (the coefficients matrix and
+	the fields) are allocated and zeroed by the thread of the range of the row, so that, under the
+	first touch policy of the operating system, their pages are in the memory of the socket of the
+	thread which later reads them. With -numa_pin 1 thread t of the kernels is bound to the t-th
+	core allowed to the process, the cores ordered by socket, so the ranges of a socket are
+	contiguous. With -numa_report 1 the bytes read by the threaded kernels and the time they took
+	are summed per socket and the bandwidth achieved is printed at the end of the run.
+
+	With more than one thread the rows are taken from malloc rather than from the run arena, whose
+	blocks are handed out to all the threads from a single range and kept between runs; the tables
+	of the class, which outlive the runs, are never allocated in the arena. A single thread, the
+	default, does everything in the calling thread, as before.
+
+ 	Written by FERREIRA, C. A. S.
+
+ 	Florianópolis, 2019.
+*/
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <petscksp.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+class numaPlacement
+{
+public:
+	// Class variables
+	static bool configured;
+	static PetscInt threadsNo;
+	static PetscInt pinThreads;
+	static PetscInt report;
+	static vector<int> cores;
+	static vector<int> coreSockets;
+	static vector<int> socketOfCore;
+	static mutex reportMutex;
+	static vector<double> socketBytes;
+	static vector<double> socketBandwidth;
+	static int recordsNo;
+
+	// Class functions
+	static void configure();
+	static int getSocket(int);
+	static void getStaticRange(int,int,int,int&,int&);
+	static void pinThread(int);
+	static void parallelFor(int,function<void(int,int,int)>);
+	template<class scalar> static void firstTouch(vector<vector<scalar>>&,int,int,int=0,int=-1);
+	static void recordBandwidth(double,double);
+	static void printBandwidthReport();
+};
+
+bool numaPlacement::configured=false;
+PetscInt numaPlacement::threadsNo=1;
+PetscInt numaPlacement::pinThreads=0;
+PetscInt numaPlacement::report=0;
+vector<int> numaPlacement::cores;
+vector<int> numaPlacement::coreSockets;
+vector<int> numaPlacement::socketOfCore;
+mutex numaPlacement::reportMutex;
+vector<double> numaPlacement::socketBytes;
+vector<double> numaPlacement::socketBandwidth;
+int numaPlacement::recordsNo=0;
+
+void numaPlacement::configure()
+{
+	// Options are read on the first use, after PetscInitialize, and the tables are sized once,
+	// outside the run arena
+	runArenaBypass myBypass;
+	cpu_set_t allowedCores;
+	vector<pair<int,int>> orderedCores;
+	int socketsNo=1;
+
+	if(configured) return;
+	configured=true;
+
+	PetscOptionsGetInt(NULL,NULL,"-numa_threads",&threadsNo,NULL);
+	PetscOptionsGetInt(NULL,NULL,"-numa_pin",&pinThreads,NULL);
+	PetscOptionsGetInt(NULL,NULL,"-numa_report",&report,NULL);
+	threadsNo=max(threadsNo,(PetscInt)1);
+
+	// Cores allowed to the process, ordered by socket
+	CPU_ZERO(&allowedCores);
+	if(sched_getaffinity(0,sizeof(allowedCores),&allowedCores)==0)
+		for(int core=0; core<CPU_SETSIZE; core++)
+			if(CPU_ISSET(core,&allowedCores)) orderedCores.push_back(make_pair(getSocket(core),
+				core));
+	sort(orderedCores.begin(),orderedCores.end());
+	socketOfCore.assign(CPU_SETSIZE,0);
+	for(int c=0; c<orderedCores.size(); c++)
+	{
+		cores.push_back(orderedCores[c].second);
+		coreSockets.push_back(orderedCores[c].first);
+		socketOfCore[orderedCores[c].second]=orderedCores[c].first;
+		socketsNo=max(socketsNo,orderedCores[c].first+1);
+	}
+	socketBytes.assign(socketsNo,0);
+	socketBandwidth.assign(socketsNo,0);
+
+	return;
+}
+
+int numaPlacement::getSocket(int core)
+{
+	int socket=0;
+	ifstream socketFile("/sys/devices/system/cpu/cpu"+to_string(core)+
+		"/topology/physical_package_id");
+
+	if(socketFile.is_open()) socketFile >> socket;
+
+	return max(socket,0);
+}
+
+void numaPlacement::getStaticRange(int itemsNo, int rangesNo, int rangeNo, int& begin, int& end)
+{
+	begin=(long long)itemsNo*rangeNo/rangesNo;
+	end=(long long)itemsNo*(rangeNo+1)/rangesNo;
+
+	return;
+}
+
+void numaPlacement::pinThread(int threadNo)
+{
+	cpu_set_t core;
+
+	if(!pinThreads || cores.empty()) return;
+
+	CPU_ZERO(&core);
+	CPU_SET(cores[threadNo%cores.size()],&core);
+	pthread_setaffinity_np(pthread_self(),sizeof(core),&core);
+
+	return;
+}
+
+void numaPlacement::parallelFor(int itemsNo, function<void(int,int,int)> body)
+{
+	// body(threadNo,begin,end) on the static partition of itemsNo
+	vector<thread> myThreads;
+
+	configure();
+	if(threadsNo==1)
+	{
+		body(0,0,itemsNo);
+
+		return;
+	}
+
+	for(int threadNo=0; threadNo<threadsNo; threadNo++)
+		myThreads.push_back(thread([&,threadNo]()
+		{
+			// Allocations of the threads are served by malloc, so that the pages of a thread are
+			// first touched by it and not shared with the blocks of the arena of other threads
+			runArenaBypass myBypass;
+			int threadBegin, threadEnd;
+
+			pinThread(threadNo);
+			getStaticRange(itemsNo,threadsNo,threadNo,threadBegin,threadEnd);
+			body(threadNo,threadBegin,threadEnd);
+		}));
+	for(int threadNo=0; threadNo<threadsNo; threadNo++) myThreads[threadNo].join();
+
+	return;
+}
+
+template<class scalar>
+void numaPlacement::firstTouch(vector<vector<scalar>>& rows, int rowNo, int colNo,
+	int firstUnknown, int unknownsNo)
+{
+	// Rows firstUnknown, firstUnknown+1, ... of the unknowns, allocated and zeroed by the thread
+	// of their range
+	if(unknownsNo<0) unknownsNo=firstUnknown+rowNo;
+
+	rows.resize(rowNo);
+	parallelFor(unknownsNo,[&](int, int begin, int end)
+	{
+		for(int i=max(begin-firstUnknown,0); i<min(end-firstUnknown,rowNo); i++)
+			rows[i].assign(colNo,0);
+	});
+
+	return;
+}
+
+void numaPlacement::recordBandwidth(double bytes, double seconds)
+{
+	// Bytes read by the calling thread of a threaded kernel, summed in the socket of its core
+	int core, socket;
+
+	if(!report || seconds<=0) return;
+	core=sched_getcpu();
+	socket=(core>=0 && core<socketOfCore.size()) ? socketOfCore[core] : 0;
+
+	lock_guard<mutex> lock(reportMutex);
+	socketBytes[socket]+=bytes;
+	socketBandwidth[socket]+=bytes/seconds;
+	recordsNo++;
+
+	return;
+}
+
+void numaPlacement::printBandwidthReport()
+{
+	// Bandwidth of a socket as the sum over its threads, averaged over the calls of the kernels,
+	// every thread recording once per call
+	double callsNo;
+
+	if(!report || recordsNo==0) return;
+
+	lock_guard<mutex> lock(reportMutex);
+	callsNo=(double)recordsNo/threadsNo;
+	for(int socket=0; socket<socketBytes.size(); socket++)
+	{
+		if(socketBytes[socket]==0) continue;
+		cout << "Socket " << socket << ": " << socketBytes[socket]/1e9 << " GB read by the " <<
+			"threaded kernels at " << socketBandwidth[socket]/callsNo/1e9 << " GB/s\n";
+	}
+	fill(socketBytes.begin(),socketBytes.end(),0);
+	fill(socketBandwidth.begin(),socketBandwidth.end(),0);
+	recordsNo=0;
+
+	return;
+}
@@ -0,0 +1,209 @@
+/*
+	This header is part of the development of a master's thesis entitled "Analysis of Numerical
+	Schemes in Collocated and Staggered Grids for Problems of Poroelasticity". The class defined
+	here contains the functions for the generation of stationary Gaussian random fields on the
+	cells of a regular grid, with exponential covariance exp(-r/l), by circulant embedding [1].
+
+	The covariance is embedded in a periodic grid of power of two dimensions, whose covariance
+	matrix is diagonalized by the 2D FFT. Each sample of complex white noise gives two independent
+	fields (its real and imaginary parts). Negative eigenvalues of the embedding, if any, are
+	clipped to zero.
+
+ 	Written by FERREIRA, C. A. S.
+
+ 	Florianópolis, 2019.
+
+ 	[1] DIETRICH, C. R.; NEWSAM, G. N. Fast and Exact Simulation of Stationary Gaussian Processes
+ 	through Circulant Embedding of the Covariance Matrix. SIAM Journal on Scientific Computing,
+ 	v. 18, pp. 1088-1107, 1997.
+*/
+
+#include <complex>
+#include <math.h>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+class randomFieldGenerator
+{
+public:
+	// Class variables
+	int Nx, Ny;
+	int Mx, My;
+	double dx, dy;
+	double correlationLength;
+	int negativeEigenvaluesNo;
+	vector<vector<double>> embeddingEigenvalues;
+
+	// Class functions
+	int getEmbeddingSize(int);
+	double getCovariance(int,int);
+	void assemblyEmbeddingEigenvalues();
+	void getFFT(vector<complex<double>>&);
+	void getFFT2D(vector<vector<complex<double>>>&);
+	void getGaussianFields(unsigned long long,vector<vector<double>>&,vector<vector<double>>&);
+	vector<vector<double>> getLognormalField(vector<vector<double>>,double,double);
+
+	// Constructor
+	randomFieldGenerator(int,int,double,double,double);
+
+	// Destructor
+	~randomFieldGenerator();
+};
+
+randomFieldGenerator::randomFieldGenerator(int myNx, int myNy, double myDx, double myDy,
+	double myCorrelationLength)
+{
+	Nx=myNx;
+	Ny=myNy;
+	dx=myDx;
+	dy=myDy;
+	correlationLength=myCorrelationLength;
+
+	Mx=getEmbeddingSize(Nx);
+	My=getEmbeddingSize(Ny);
+
+	assemblyEmbeddingEigenvalues();
+}
+
+randomFieldGenerator::~randomFieldGenerator(){}
+
+int randomFieldGenerator::getEmbeddingSize(int N)
+{
+	// Smallest power of two which holds the periodic extension of N cells
+	int M=1;
+
+	while(M<2*N) M*=2;
+
+	return M;
+}
+
+double randomFieldGenerator::getCovariance(int a, int b)
+{
+	// Covariance between cells a rows and b columns apart in the periodic grid
+	double ry=min(a,My-a)*dy;
+	double rx=min(b,Mx-b)*dx;
+
+	return exp(-sqrt(rx*rx+ry*ry)/correlationLength);
+}
+
+void randomFieldGenerator::assemblyEmbeddingEigenvalues()
+{
+	vector<vector<complex<double>>> firstRow(My,vector<complex<double>>(Mx));
+
+	for(int a=0; a<My; a++)
+		for(int b=0; b<Mx; b++)
+			firstRow[a][b]=getCovariance(a,b);
+
+	// The circulant matrix is symmetric, so its eigenvalues are real
+	getFFT2D(firstRow);
+
+	negativeEigenvaluesNo=0;
+	embeddingEigenvalues.assign(My,vector<double>(Mx));
+	for(int a=0; a<My; a++)
+		for(int b=0; b<Mx; b++)
+		{
+			embeddingEigenvalues[a][b]=firstRow[a][b].real();
+			if(embeddingEigenvalues[a][b]<0)
+			{
+				embeddingEigenvalues[a][b]=0;
+				negativeEigenvaluesNo++;
+			}
+		}
+
+	return;
+}
+
+void randomFieldGenerator::getFFT(vector<complex<double>>& x)
+{
+	// Iterative radix-2 Cooley-Tukey transform, in place
+	int n=x.size();
+
+	for(int i=1, j=0; i<n; i++)
+	{
+		int bit=n>>1;
+		for(; j&bit; bit>>=1) j^=bit;
+		j^=bit;
+		if(i<j) swap(x[i],x[j]);
+	}
+
+	for(int length=2; length<=n; length<<=1)
+	{
+		complex<double> root=polar(1.0,-2*M_PI/length);
+		for(int i=0; i<n; i+=length)
+		{
+			complex<double> w=1;
+			for(int k=0; k<length/2; k++)
+			{
+				complex<double> even=x[i+k];
+				complex<double> odd=w*x[i+k+length/2];
+				x[i+k]=even+odd;
+				x[i+k+length/2]=even-odd;
+				w*=root;
+			}
+		}
+	}
+
+	return;
+}
+
+void randomFieldGenerator::getFFT2D(vector<vector<complex<double>>>& x)
+{
+	vector<complex<double>> column(x.size());
+
+	for(int a=0; a<x.size(); a++) getFFT(x[a]);
+
+	for(int b=0; b<x[0].size(); b++)
+	{
+		for(int a=0; a<x.size(); a++) column[a]=x[a][b];
+		getFFT(column);
+		for(int a=0; a<x.size(); a++) x[a][b]=column[a];
+	}
+
+	return;
+}
+
+void randomFieldGenerator::getGaussianFields(unsigned long long seed,
+	vector<vector<double>>& firstField, vector<vector<double>>& secondField)
+{
+	// Two independent zero mean and unit variance fields on the Ny x Nx cells
+	mt19937_64 generator(seed);
+	normal_distribution<double> normal(0,1);
+	vector<vector<complex<double>>> noise(My,vector<complex<double>>(Mx));
+	double scale;
+
+	for(int a=0; a<My; a++)
+		for(int b=0; b<Mx; b++)
+		{
+			scale=sqrt(embeddingEigenvalues[a][b]/(Mx*My));
+			noise[a][b]=complex<double>(scale*normal(generator),scale*normal(generator));
+		}
+
+	getFFT2D(noise);
+
+	firstField.assign(Ny,vector<double>(Nx));
+	secondField.assign(Ny,vector<double>(Nx));
+	for(int i=0; i<Ny; i++)
+		for(int j=0; j<Nx; j++)
+		{
+			firstField[i][j]=noise[i][j].real();
+			secondField[i][j]=noise[i][j].imag();
+		}
+
+	return;
+}
+
+vector<vector<double>> randomFieldGenerator::getLognormalField(
+	vector<vector<double>> gaussianField, double meanValue, double logDeviation)
+{
+	// exp(s*Y-s^2/2) has unit mean, so the field keeps the mean value of the property
+	vector<vector<double>> lognormalField=gaussianField;
+
+	for(int i=0; i<lognormalField.size(); i++)
+		for(int j=0; j<lognormalField[i].size(); j++)
+			lognormalField[i][j]=meanValue*exp(logDeviation*gaussianField[i][j]-
+				0.5*logDeviation*logDeviation);
+
+	return lognormalField;
+}
@@ -0,0 +1,230 @@
+/*
+	This header is part of the development of a master's thesis entitled "Analysis of Numerical
+	Schemes in Collocated and Staggered Grids for Problems of Poroelasticity". The class defined
+	here advances a linear problem one time-step per incoming load reading, for the coupling of the
+	solver to field sensors. The independent terms are affine in the previous time-step and in the
+	load, b=B*x(n)+c+load*l, so that, once B, c and l are assembled and the coefficients matrix is
+	factorized, a time-step is only the product by B, the triangular solves and the copy of the
+	solution. Every array is allocated at the setup and no time-step allocates memory.
+
+	The wall time of each time-step is kept in a histogram of logarithmic buckets, with
+	bucketsPerOctave buckets per power of two, from which the quantiles of the latency are read
+	with a relative resolution of 2^(1/bucketsPerOctave)-1.
+
+ 	Written by FERREIRA, C. A. S.
+
+ 	Florianópolis, 2019.
+*/
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <math.h>
+#include <petscksp.h>
+#include <string>
+#include <sys/mman.h>
+#include <vector>
+
+using namespace std;
+
+class realTimeStepper
+{
+public:
+	// Class variables
+	static const int bucketsPerOctave=16;
+	static const int octavesNo=48;
+	int n;
+	vector<int> operatorRowStart;
+	vector<int> operatorColumn;
+	vector<double> operatorValue;
+	vector<double> constantArray;
+	vector<double> loadArray;
+	vector<double> solutionArray;
+	Mat factorMatrixPETSc;
+	Vec independentTermsArrayPETSc;
+	Vec linearSystemSolutionPETSc;
+	PetscErrorCode ierr;
+	vector<long long> latencyBuckets;
+	long long stepsNo=0;
+	double totalLatency=0;
+	double maxLatency=0;
+
+	// Class functions
+	int lockMemory();
+	int step(double);
+	void recordLatency(double);
+	double getLatencyQuantile(double);
+	double getMeanLatency();
+	void exportLatencyHistogram(string);
+
+	// Constructor
+	realTimeStepper(vector<double>,vector<double>,vector<double>,vector<double>,vector<double>,
+		vector<double>,Mat,Vec,Vec);
+
+	// Destructor
+	~realTimeStepper();
+};
+
+realTimeStepper::realTimeStepper(vector<double> previousStepOperatorRow,
+	vector<double> previousStepOperatorColumn, vector<double> previousStepOperatorValue,
+	vector<double> myConstantArray, vector<double> myLoadArray, vector<double> initialSolution,
+	Mat factorMatrix, Vec independentTermsArray, Vec linearSystemSolution)
+{
+	// The factors and the arrays belong to the linear system solver, which must outlive the
+	// stepper
+	int nonZeroEntries=previousStepOperatorValue.size();
+	vector<int> position;
+
+	n=initialSolution.size();
+	constantArray=myConstantArray;
+	loadArray=myLoadArray;
+	solutionArray=initialSolution;
+	factorMatrixPETSc=factorMatrix;
+	independentTermsArrayPETSc=independentTermsArray;
+	linearSystemSolutionPETSc=linearSystemSolution;
+	latencyBuckets.assign(octavesNo*bucketsPerOctave,0);
+
+	// Compressed rows of B, so that its product is a single pass over contiguous arrays
+	operatorRowStart.assign(n+1,0);
+	operatorColumn.resize(nonZeroEntries);
+	operatorValue.resize(nonZeroEntries);
+	for(int k=0; k<nonZeroEntries; k++) operatorRowStart[previousStepOperatorRow[k]+1]++;
+	for(int i=0; i<n; i++) operatorRowStart[i+1]+=operatorRowStart[i];
+
+	position.assign(operatorRowStart.begin(),operatorRowStart.end()-1);
+	for(int k=0; k<nonZeroEntries; k++)
+	{
+		int i=previousStepOperatorRow[k];
+
+		operatorColumn[position[i]]=previousStepOperatorColumn[k];
+		operatorValue[position[i]]=previousStepOperatorValue[k];
+		position[i]++;
+	}
+}
+
+realTimeStepper::~realTimeStepper(){}
+
+int realTimeStepper::lockMemory()
+{
+	// Keeps the arrays touched by a time-step resident, so that no time-step waits on a page
+	// fault. Only a warning is given when the limit of locked memory is too low.
+	PetscScalar *independentTerms, *solution;
+	int failuresNo=0;
+
+	ierr=VecGetArray(independentTermsArrayPETSc,&independentTerms);CHKERRQ(ierr);
+	ierr=VecGetArray(linearSystemSolutionPETSc,&solution);CHKERRQ(ierr);
+
+	failuresNo+=mlock(independentTerms,n*sizeof(PetscScalar))!=0;
+	failuresNo+=mlock(solution,n*sizeof(PetscScalar))!=0;
+	failuresNo+=mlock(operatorRowStart.data(),operatorRowStart.size()*sizeof(int))!=0;
+	failuresNo+=mlock(operatorColumn.data(),operatorColumn.size()*sizeof(int))!=0;
+	failuresNo+=mlock(operatorValue.data(),operatorValue.size()*sizeof(double))!=0;
+	failuresNo+=mlock(constantArray.data(),n*sizeof(double))!=0;
+	failuresNo+=mlock(loadArray.data(),n*sizeof(double))!=0;
+	failuresNo+=mlock(solutionArray.data(),n*sizeof(double))!=0;
+	failuresNo+=mlock(latencyBuckets.data(),latencyBuckets.size()*sizeof(long long))!=0;
+
+	ierr=VecRestoreArray(linearSystemSolutionPETSc,&solution);CHKERRQ(ierr);
+	ierr=VecRestoreArray(independentTermsArrayPETSc,&independentTerms);CHKERRQ(ierr);
+
+	if(failuresNo>0) cout << "Unable to lock " << failuresNo << " arrays of the real-time " <<
+		"stepper in memory\n";
+
+	return ierr;
+}
+
+int realTimeStepper::step(double load)
+{
+	chrono::steady_clock::time_point start=chrono::steady_clock::now();
+	PetscScalar *independentTerms;
+	const PetscScalar *solution;
+	double value;
+
+	// b=c+load*l+B*x(n), written in place in the right-hand side of the solver
+	ierr=VecGetArray(independentTermsArrayPETSc,&independentTerms);CHKERRQ(ierr);
+	for(int i=0; i<n; i++)
+	{
+		value=constantArray[i]+load*loadArray[i];
+		for(int k=operatorRowStart[i]; k<operatorRowStart[i+1]; k++)
+			value+=operatorValue[k]*solutionArray[operatorColumn[k]];
+		independentTerms[i]=value;
+	}
+	ierr=VecRestoreArray(independentTermsArrayPETSc,&independentTerms);CHKERRQ(ierr);
+
+	ierr=MatSolve(factorMatrixPETSc,independentTermsArrayPETSc,linearSystemSolutionPETSc);
+		CHKERRQ(ierr);
+
+	ierr=VecGetArrayRead(linearSystemSolutionPETSc,&solution);CHKERRQ(ierr);
+	copy(solution,solution+n,solutionArray.begin());
+	ierr=VecRestoreArrayRead(linearSystemSolutionPETSc,&solution);CHKERRQ(ierr);
+
+	recordLatency(chrono::duration<double>(chrono::steady_clock::now()-start).count());
+
+	return ierr;
+}
+
+void realTimeStepper::recordLatency(double latency)
+{
+	// Buckets start at 1 ns, latencies below it fall into the first one and above 2^48 ns into
+	// the last one
+	int bucket=floor(log2(max(latency*1e9,1.0))*bucketsPerOctave);
+
+	bucket=min(bucket,(int)latencyBuckets.size()-1);
+	latencyBuckets[bucket]++;
+	stepsNo++;
+	totalLatency+=latency;
+	maxLatency=max(maxLatency,latency);
+
+	return;
+}
+
+double realTimeStepper::getLatencyQuantile(double level)
+{
+	// Upper edge of the bucket holding the quantile, bounded by the maximum
+	long long rank=ceil(level*stepsNo);
+	long long count=0;
+
+	if(stepsNo==0) return 0;
+
+	for(int bucket=0; bucket<latencyBuckets.size(); bucket++)
+	{
+		count+=latencyBuckets[bucket];
+		if(count>=max(rank,1LL))
+			return min(pow(2,(bucket+1.0)/bucketsPerOctave)*1e-9,maxLatency);
+	}
+
+	return maxLatency;
+}
+
+double realTimeStepper::getMeanLatency()
+{
+	return (stepsNo>0) ? totalLatency/stepsNo : 0;
+}
+
+void realTimeStepper::exportLatencyHistogram(string fileName)
+{
+	ofstream myFile(fileName);
+
+	if(!myFile.is_open())
+	{
+		cout << "Unable to open " << fileName << "\n";
+
+		return;
+	}
+
+	myFile << "# steps=" << stepsNo << " mean=" << getMeanLatency() << " p50=" <<
+		getLatencyQuantile(0.5) << " p99=" << getLatencyQuantile(0.99) << " max=" << maxLatency <<
+		"\n";
+	myFile << "# lower[s] upper[s] count\n";
+	for(int bucket=0; bucket<latencyBuckets.size(); bucket++)
+	{
+		if(latencyBuckets[bucket]==0) continue;
+
+		myFile << pow(2,(double)bucket/bucketsPerOctave)*1e-9 << " " <<
+			pow(2,(bucket+1.0)/bucketsPerOctave)*1e-9 << " " << latencyBuckets[bucket] << "\n";
+	}
+
+	myFile.close();
+
+	return;
+}
@@ -0,0 +1,540 @@
+/*
+	This header is part of the development of a master's thesis entitled "Analysis of Numerical
+	Schemes in Collocated and Staggered Grids for Problems of Poroelasticity". The class defined
+	here keeps an index of the cases solved by the sweeps (problem, grid, interpolation scheme,
+	medium, mesh, time-step and version of the code), so that a sweep which is interrupted or run
+	again only solves the cases which are not yet complete.
+
+	Each case is identified by a 64 bits FNV-1a hash [1] of its key. The index is the file
+	manifest.jsonl of the export directory, to which a line is appended when a case starts and
+	another one when it completes, holding its wall time, the values reported by the run (error
+	norms), the settings chosen within it (the solver picked by the autotune, which the next runs of
+	the case reuse) and the size and hash of every file it exported; the last line of a hash wins,
+	so a case whose run was interrupted is solved again. A complete case is only skipped while its
+	files are unchanged, since most exports are named after the problem and the time-step only and
+	are overwritten by the cases of other grids. The lines a run appends to the files which are only
+	appended to (the run info files read by the plots and the error norms) are kept instead, and
+	appended again when the case is skipped.
+
+	The options -results_manifest 0 disables the index, -results_force 1 solves every case again
+	and -results_tag adds a label to the key, for runs which differ only in the options given.
+
+ 	Written by FERREIRA, C. A. S.
+
+ 	Florianópolis, 2019.
+
+ 	[1] FOWLER, G.; NOLL, L. C.; VO, K.-P.; EASTLAKE, D. The FNV Non-Cryptographic Hash
+ 	Algorithm. IETF Internet-Draft, 2019.
+*/
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <dirent.h>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <petscksp.h>
+#include <sstream>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+#ifndef GEOMEC_VERSION
+#define GEOMEC_VERSION "unknown"
+#endif
+
+using namespace std;
+
+struct exportedFile
+{
+	long long bytes;
+	long long modificationTime;
+};
+
+class resultsManifest
+{
+public:
+	// Class variables
+	static const int maxValuesNo=16;
+	static const int maxValueNameLength=32;
+	static const int maxSettingsNo=4;
+	static resultsManifest* openManifest;
+	string exportDirectory="../export/";
+	string manifestName="manifest.jsonl";
+	vector<string> appendedFiles={"RunInfo","ErrorNorm"};
+	string tag;
+	bool enabled=true;
+	bool forced=false;
+	map<string,string> lastRecords;
+	string caseHash;
+	string caseRecord;
+	map<string,exportedFile> filesBefore;
+	chrono::steady_clock::time_point caseStart;
+	char valueNames[maxValuesNo][maxValueNameLength];
+	double values[maxValuesNo];
+	int valuesNo=0;
+	char settingNames[maxSettingsNo][maxValueNameLength];
+	char settings[maxSettingsNo][maxValueNameLength];
+	int settingsNo=0;
+	int skippedNo=0;
+	int solvedNo=0;
+
+	// Class functions
+	string getCaseKey(string,string,string,string,int,int,double,string="");
+	bool beginCase(string,string,string,string,int,int,double,string="");
+	void completeCase();
+	static void recordValue(const char*,double);
+	static void recordSetting(const char*,const char*);
+	static string getCachedSetting(string);
+	static string getHash(string);
+	static string getFileHash(string,long long&);
+	static string escape(string);
+	static string readString(const string&,size_t&);
+	static string getField(const string&,string);
+	static double getNumber(const string&,string);
+	map<string,exportedFile> listExportedFiles();
+	bool isAppendedFile(string);
+	bool isUnchanged(const string&);
+	void replayAppends(const string&);
+	void appendRecord(string);
+
+	// Constructor
+	resultsManifest();
+
+	// Destructor
+	~resultsManifest();
+};
+
+resultsManifest* resultsManifest::openManifest=NULL;
+
+resultsManifest::resultsManifest()
+{
+	PetscInt manifestEnabled=1;
+	PetscInt forceEnabled=0;
+	char myTag[PETSC_MAX_PATH_LEN]="";
+	ifstream inFile;
+	string line;
+
+	PetscOptionsGetInt(NULL,NULL,"-results_manifest",&manifestEnabled,NULL);
+	PetscOptionsGetInt(NULL,NULL,"-results_force",&forceEnabled,NULL);
+	PetscOptionsGetString(NULL,NULL,"-results_tag",myTag,sizeof(myTag),NULL);
+	enabled=manifestEnabled!=0;
+	forced=forceEnabled!=0;
+	tag=myTag;
+	if(!enabled) return;
+
+	// Later lines of a hash replace the earlier ones
+	inFile.open(exportDirectory+manifestName);
+	while(getline(inFile,line))
+	{
+		string hash=getField(line,"hash");
+
+		if(!hash.empty()) lastRecords[hash]=line;
+	}
+	inFile.close();
+}
+
+resultsManifest::~resultsManifest()
+{
+	if(openManifest==this) openManifest=NULL;
+	if(enabled && skippedNo>0) cout << "Cases skipped as complete in " << manifestName << ": " <<
+		skippedNo << " (" << solvedNo << " solved)\n";
+}
+
+string resultsManifest::getHash(string key)
+{
+	uint64_t hash=14695981039346656037ULL;
+	char hexHash[17];
+
+	for(unsigned char c : key)
+	{
+		hash^=c;
+		hash*=1099511628211ULL;
+	}
+	snprintf(hexHash,sizeof(hexHash),"%016llx",(unsigned long long)hash);
+
+	return hexHash;
+}
+
+string resultsManifest::getFileHash(string fileName, long long& bytes)
+{
+	uint64_t hash=14695981039346656037ULL;
+	char buffer[1<<16];
+	char hexHash[17];
+	FILE* myFile=fopen(fileName.c_str(),"rb");
+	size_t readBytes;
+
+	bytes=-1;
+	if(myFile==NULL) return "";
+
+	bytes=0;
+	while((readBytes=fread(buffer,1,sizeof(buffer),myFile))>0)
+	{
+		for(size_t i=0; i<readBytes; i++)
+		{
+			hash^=(unsigned char)buffer[i];
+			hash*=1099511628211ULL;
+		}
+		bytes+=readBytes;
+	}
+	fclose(myFile);
+	snprintf(hexHash,sizeof(hexHash),"%016llx",(unsigned long long)hash);
+
+	return hexHash;
+}
+
+string resultsManifest::escape(string text)
+{
+	string escaped;
+	char code[7];
+
+	for(unsigned char c : text)
+	{
+		if(c=='"' || c=='\\')
+		{
+			escaped+='\\';
+			escaped+=c;
+		}
+		else if(c=='\n') escaped+="\\n";
+		else if(c<0x20)
+		{
+			snprintf(code,sizeof(code),"\\u%04x",c);
+			escaped+=code;
+		}
+		else escaped+=c;
+	}
+
+	return escaped;
+}
+
+string resultsManifest::readString(const string& line, size_t& position)
+{
+	// Reads the string opened by the quote at position and leaves position after its closing quote
+	string text;
+
+	for(position++; position<line.size() && line[position]!='"'; position++)
+	{
+		if(line[position]!='\\')
+		{
+			text+=line[position];
+			continue;
+		}
+
+		position++;
+		if(position>=line.size()) break;
+		if(line[position]=='n') text+='\n';
+		else if(line[position]=='u')
+		{
+			text+=(char)stoi(line.substr(position+1,4),NULL,16);
+			position+=4;
+		}
+		else text+=line[position];
+	}
+	position++;
+
+	return text;
+}
+
+string resultsManifest::getField(const string& line, string name)
+{
+	// Top level string fields are written before the arrays, whose strings never hold a quoted
+	// field name
+	size_t position=line.find("\""+name+"\":\"");
+
+	if(position==string::npos) return "";
+	position+=name.size()+3;
+
+	return readString(line,position);
+}
+
+double resultsManifest::getNumber(const string& line, string name)
+{
+	// Numeric fields and the values reported by the run, NAN when missing or null
+	size_t position=line.find("\""+name+"\":");
+	char* end;
+	double value;
+
+	if(position==string::npos) return NAN;
+	position+=name.size()+3;
+	value=strtod(line.c_str()+position,&end);
+
+	return (end==line.c_str()+position) ? NAN : value;
+}
+
+map<string,exportedFile> resultsManifest::listExportedFiles()
+{
+	map<string,exportedFile> files;
+	DIR* myDirectory=opendir(exportDirectory.c_str());
+	struct dirent* entry;
+	struct stat status;
+
+	if(myDirectory==NULL) return files;
+
+	while((entry=readdir(myDirectory))!=NULL)
+	{
+		string name=entry->d_name;
+
+		if(name==manifestName) continue;
+		if(stat((exportDirectory+name).c_str(),&status)!=0 || !S_ISREG(status.st_mode)) continue;
+
+		files[name].bytes=status.st_size;
+		files[name].modificationTime=(long long)status.st_mtim.tv_sec*1000000000LL+
+			status.st_mtim.tv_nsec;
+	}
+	closedir(myDirectory);
+
+	return files;
+}
+
+bool resultsManifest::isAppendedFile(string fileName)
+{
+	for(int i=0; i<appendedFiles.size(); i++)
+		if(fileName.find(appendedFiles[i])!=string::npos) return true;
+
+	return false;
+}
+
+bool resultsManifest::isUnchanged(const string& record)
+{
+	size_t position=record.find("\"outputs\":[");
+	long long bytes;
+
+	if(position==string::npos) return false;
+	position+=11;
+
+	while(position<record.size() && record[position]=='{')
+	{
+		string fileName,hash;
+		long long recordedBytes;
+
+		position=record.find("\"file\":\"",position)+7;
+		fileName=readString(record,position);
+		position=record.find("\"bytes\":",position)+8;
+		recordedBytes=stoll(record.substr(position,20));
+		position=record.find("\"hash\":\"",position)+7;
+		hash=readString(record,position);
+		position++;
+		if(position<record.size() && record[position]==',') position++;
+
+		if(getFileHash(exportDirectory+fileName,bytes)!=hash || bytes!=recordedBytes)
+			return false;
+	}
+
+	return true;
+}
+
+void resultsManifest::replayAppends(const string& record)
+{
+	size_t position=record.find("\"appends\":[");
+
+	if(position==string::npos) return;
+	position+=11;
+
+	while(position<record.size() && record[position]=='{')
+	{
+		string fileName,text;
+
+		position=record.find("\"file\":\"",position)+7;
+		fileName=readString(record,position);
+		position=record.find("\"text\":\"",position)+7;
+		text=readString(record,position);
+		position++;
+		if(position<record.size() && record[position]==',') position++;
+
+		ofstream myFile(exportDirectory+fileName,fstream::app);
+		if(myFile.is_open())
+		{
+			myFile << text;
+
+			myFile.close();
+		}
+	}
+
+	return;
+}
+
+void resultsManifest::appendRecord(string record)
+{
+	ofstream myFile(exportDirectory+manifestName,fstream::app);
+
+	if(!myFile.is_open())
+	{
+		cout << "Unable to open " << exportDirectory+manifestName << "\n";
+
+		return;
+	}
+
+	myFile << record << "\n";
+	myFile.close();
+
+	return;
+}
+
+string resultsManifest::getCaseKey(string problemName, string gridType, string interpScheme,
+	string medium, int meshSize, int Nt, double dt, string parameters)
+{
+	ostringstream key;
+
+	key << "problem=" << problemName << ";grid=" << gridType << ";scheme=" << interpScheme <<
+		";medium=" << medium << ";mesh=" << meshSize << ";Nt=" << Nt << ";dt=" << scientific <<
+		setprecision(12) << dt << ";parameters=" << parameters << ";version=" << GEOMEC_VERSION <<
+		";tag=" << tag;
+
+	return key.str();
+}
+
+bool resultsManifest::beginCase(string problemName, string gridType, string interpScheme,
+	string medium, int meshSize, int Nt, double dt, string parameters)
+{
+	// False when the case is complete and its files unchanged, in which case it is not solved
+	ostringstream fields;
+	map<string,string>::iterator lastRecord;
+	string key;
+
+	valuesNo=0;
+	settingsNo=0;
+	if(!enabled) return true;
+
+	key=getCaseKey(problemName,gridType,interpScheme,medium,meshSize,Nt,dt,parameters);
+	caseHash=getHash(key);
+
+	lastRecord=lastRecords.find(caseHash);
+	if(!forced && lastRecord!=lastRecords.end() &&
+		getField(lastRecord->second,"status")=="complete" && isUnchanged(lastRecord->second))
+	{
+		replayAppends(lastRecord->second);
+		cout << "Skipped " << problemName << " (mesh=" << meshSize << ", dt=" << dt <<
+			"), complete in " << manifestName << "\n";
+		skippedNo++;
+
+		return false;
+	}
+
+	fields << "\"hash\":\"" << caseHash << "\",\"key\":\"" << escape(key) <<
+		"\",\"problem\":\"" << escape(problemName) << "\",\"grid\":\"" << escape(gridType) <<
+		"\",\"scheme\":\"" << escape(interpScheme) << "\",\"medium\":\"" << escape(medium) <<
+		"\",\"mesh\":" << meshSize << ",\"Nt\":" << Nt << ",\"dt\":" << scientific <<
+		setprecision(12) << dt << ",\"parameters\":\"" << escape(parameters) <<
+		"\",\"version\":\"" << GEOMEC_VERSION << "\",\"tag\":\"" << escape(tag) << "\"";
+	caseRecord=fields.str();
+	appendRecord("{"+caseRecord+",\"status\":\"running\"}");
+
+	filesBefore=listExportedFiles();
+	openManifest=this;
+	caseStart=chrono::steady_clock::now();
+
+	return true;
+}
+
+void resultsManifest::completeCase()
+{
+	double seconds=chrono::duration<double>(chrono::steady_clock::now()-caseStart).count();
+	map<string,exportedFile> filesAfter;
+	ostringstream record, outputs, appends;
+	long long bytes;
+
+	openManifest=NULL;
+	if(!enabled) return;
+
+	// Files new or changed since the start of the case
+	filesAfter=listExportedFiles();
+	for(map<string,exportedFile>::iterator file=filesAfter.begin(); file!=filesAfter.end(); file++)
+	{
+		map<string,exportedFile>::iterator before=filesBefore.find(file->first);
+		bool isNew=(before==filesBefore.end());
+
+		if(!isNew && before->second.bytes==file->second.bytes &&
+			before->second.modificationTime==file->second.modificationTime) continue;
+
+		if(isAppendedFile(file->first) && (isNew || file->second.bytes>before->second.bytes))
+		{
+			long long offset=isNew ? 0 : before->second.bytes;
+			ifstream inFile(exportDirectory+file->first,ios::binary);
+			string text;
+
+			inFile.seekg(offset);
+			text.assign(istreambuf_iterator<char>(inFile),istreambuf_iterator<char>());
+			if(appends.tellp()>0) appends << ",";
+			appends << "{\"file\":\"" << escape(file->first) << "\",\"text\":\"" <<
+				escape(text) << "\"}";
+			continue;
+		}
+
+		string hash=getFileHash(exportDirectory+file->first,bytes);
+		if(outputs.tellp()>0) outputs << ",";
+		outputs << "{\"file\":\"" << escape(file->first) << "\",\"bytes\":" << bytes <<
+			",\"hash\":\"" << hash << "\"}";
+	}
+
+	record << "{" << caseRecord << ",\"status\":\"complete\",\"seconds\":" << seconds <<
+		",\"finished\":" << (long long)time(NULL) << ",\"values\":{";
+	for(int i=0; i<valuesNo; i++)
+	{
+		record << (i>0 ? "," : "") << "\"" << escape(valueNames[i]) << "\":";
+		if(isfinite(values[i])) record << setprecision(12) << values[i];
+		else record << "null";
+	}
+	record << "},\"settings\":{";
+	for(int i=0; i<settingsNo; i++) record << (i>0 ? "," : "") << "\"" <<
+		escape(settingNames[i]) << "\":\"" << escape(settings[i]) << "\"";
+	record << "},\"outputs\":[" << outputs.str() << "],\"appends\":[" << appends.str() << "]}";
+
+	appendRecord(record.str());
+	lastRecords[caseHash]=record.str();
+	solvedNo++;
+
+	return;
+}
+
+void resultsManifest::recordValue(const char* name, double value)
+{
+	// Called from within the runs, whose allocations the run arena drops at their end, so it
+	// only writes into the fixed arrays of the open case
+	resultsManifest* myManifest=openManifest;
+
+	if(myManifest==NULL || myManifest->valuesNo>=maxValuesNo) return;
+
+	strncpy(myManifest->valueNames[myManifest->valuesNo],name,maxValueNameLength-1);
+	myManifest->valueNames[myManifest->valuesNo][maxValueNameLength-1]='\0';
+	myManifest->values[myManifest->valuesNo]=value;
+	myManifest->valuesNo++;
+
+	return;
+}
+
+void resultsManifest::recordSetting(const char* name, const char* setting)
+{
+	// As recordValue, for the choices made within the run
+	resultsManifest* myManifest=openManifest;
+
+	if(myManifest==NULL || myManifest->settingsNo>=maxSettingsNo) return;
+
+	strncpy(myManifest->settingNames[myManifest->settingsNo],name,maxValueNameLength-1);
+	myManifest->settingNames[myManifest->settingsNo][maxValueNameLength-1]='\0';
+	strncpy(myManifest->settings[myManifest->settingsNo],setting,maxValueNameLength-1);
+	myManifest->settings[myManifest->settingsNo][maxValueNameLength-1]='\0';
+	myManifest->settingsNo++;
+
+	return;
+}
+
+string resultsManifest::getCachedSetting(string name)
+{
+	// Setting of the last complete run of the open case, empty without one
+	resultsManifest* myManifest=openManifest;
+	map<string,string>::iterator lastRecord;
+
+	if(myManifest==NULL) return "";
+
+	lastRecord=myManifest->lastRecords.find(myManifest->caseHash);
+	if(lastRecord==myManifest->lastRecords.end() ||
+		getField(lastRecord->second,"status")!="complete") return "";
+
+	return getField(lastRecord->second,name);
+}
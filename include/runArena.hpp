@@ -0,0 +1,342 @@
+/*
+	This header is part of the development of a master's thesis entitled "Analysis of Numerical
+	Schemes in Collocated and Staggered Grids for Problems of Poroelasticity". The class defined
+	here is an arena from which all the objects of a run (grid, parameters, assemblies, solver and
+	data processing) are allocated, so that sweeps over many runs do not spend their time in the
+	general purpose allocator nor fragment the heap.
+
+	The arena is a single range of reserved address space. While a run is open, the global
+	operator new takes blocks from its end (rounded to size classes spaced by powers of two and
+	one and a half times powers of two) and operator delete keeps freed blocks in a list per
+	class, to be reused by the next allocation of the class. When the run is closed all the blocks
+	are dropped at once; the pages up to retainedBytes are kept for the next run, saving their page
+	faults, and the ones beyond are given back to the system. Larger blocks, allocations
+	made while no run is open and allocations which do not fit in the reserved range are served by
+	malloc, as before.
+
+	Objects which must outlive a run must therefore be created before it is opened, and the code
+	of a run which writes into them (the observers which pass results to their caller) opens a
+	runArenaBypass, so that the allocations of its thread are served by malloc; blocks of a closed
+	run which are still deleted afterwards are recognized by a generation number and ignored.
+
+ 	Written by FERREIRA, C. A. S.
+
+ 	Florianópolis, 2019.
+*/
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <petscksp.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace std;
+
+class runArena
+{
+public:
+	// Class variables
+	static const size_t headerBytes=16;
+	static const size_t minBlockBytes=32;
+	static const size_t maxBlockBytes=1<<20;
+	static const int sizeClassesNo=64;
+	unsigned char* base=NULL;
+	size_t reservedBytes=0;
+	size_t retainedBytes=0;
+	size_t usedBytes=0;
+	size_t peakBytes=0;
+	size_t allocationsNo=0;
+	size_t reusesNo=0;
+	uint32_t generation=1;
+	int depth=0;
+	atomic<bool> active{false};
+	static thread_local int bypassDepth;
+	void* freeLists[sizeClassesNo]={};
+	mutex arenaMutex;
+
+	// Class functions
+	static runArena& getArena();
+	bool reserve(size_t,size_t);
+	void open();
+	void close();
+	bool contains(void*);
+	int getSizeClass(size_t);
+	size_t getClassBytes(int);
+	void* allocate(size_t);
+	bool deallocate(void*);
+
+	// Constructor
+	runArena();
+
+	// Destructor
+	~runArena();
+};
+
+thread_local int runArena::bypassDepth=0;
+
+runArena::runArena(){}
+
+runArena::~runArena(){}
+
+runArena& runArena::getArena()
+{
+	// Never destroyed, since blocks may be deleted during the static destruction
+	static runArena* myArena=new(malloc(sizeof(runArena))) runArena();
+
+	return *myArena;
+}
+
+bool runArena::reserve(size_t bytes, size_t myRetainedBytes)
+{
+	// Address space only, pages are committed when first touched
+	lock_guard<mutex> myLock(arenaMutex);
+	void* range;
+
+	retainedBytes=myRetainedBytes;
+	if(base!=NULL) return true;
+
+	range=mmap(NULL,bytes,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS|MAP_NORESERVE,-1,0);
+	if(range==MAP_FAILED) return false;
+
+	base=(unsigned char*)range;
+	reservedBytes=bytes;
+
+	return true;
+}
+
+void runArena::open()
+{
+	lock_guard<mutex> myLock(arenaMutex);
+
+	depth++;
+	if(depth==1 && base!=NULL) active=true;
+
+	return;
+}
+
+void runArena::close()
+{
+	// Only the outermost run gives the arena back
+	lock_guard<mutex> myLock(arenaMutex);
+	size_t pageBytes=sysconf(_SC_PAGESIZE);
+	size_t firstByte=(retainedBytes+pageBytes-1)/pageBytes*pageBytes;
+	size_t lastByte=(usedBytes+pageBytes-1)/pageBytes*pageBytes;
+
+	depth--;
+	if(depth>0 || !active) return;
+
+	active=false;
+	if(lastByte>firstByte) madvise(base+firstByte,lastByte-firstByte,MADV_DONTNEED);
+	usedBytes=0;
+	for(int c=0; c<sizeClassesNo; c++) freeLists[c]=NULL;
+	generation++;
+
+	return;
+}
+
+bool runArena::contains(void* pointer)
+{
+	unsigned char* address=(unsigned char*)pointer;
+
+	return base!=NULL && address>=base && address<base+reservedBytes;
+}
+
+int runArena::getSizeClass(size_t bytes)
+{
+	// Bytes between minBlockBytes*2^power and twice that fall into the class of 1.5 or 2 times
+	// minBlockBytes*2^power
+	int power;
+
+	if(bytes<=minBlockBytes) return 0;
+
+	power=63-__builtin_clzll((bytes-1)/minBlockBytes);
+
+	return (bytes<=(minBlockBytes+minBlockBytes/2)<<power) ? 2*power+1 : 2*power+2;
+}
+
+size_t runArena::getClassBytes(int sizeClass)
+{
+	// 32, 48, 64, 96, 128, ...
+	size_t power=minBlockBytes<<(sizeClass/2);
+
+	return (sizeClass%2==0) ? power : power+power/2;
+}
+
+void* runArena::allocate(size_t bytes)
+{
+	unsigned char* block;
+	int sizeClass;
+
+	if(!active || bypassDepth>0 || bytes+headerBytes>maxBlockBytes) return NULL;
+
+	sizeClass=getSizeClass(bytes+headerBytes);
+
+	lock_guard<mutex> myLock(arenaMutex);
+	if(!active) return NULL;
+
+	if(freeLists[sizeClass]!=NULL)
+	{
+		block=(unsigned char*)freeLists[sizeClass];
+		freeLists[sizeClass]=*(void**)block;
+		reusesNo++;
+	}
+	else
+	{
+		if(usedBytes+getClassBytes(sizeClass)>reservedBytes) return NULL;
+		block=base+usedBytes;
+		usedBytes+=getClassBytes(sizeClass);
+		peakBytes=max(peakBytes,usedBytes);
+	}
+	allocationsNo++;
+
+	// Header: size class and generation of the run
+	((uint32_t*)block)[0]=sizeClass;
+	((uint32_t*)block)[1]=generation;
+
+	return block+headerBytes;
+}
+
+bool runArena::deallocate(void* pointer)
+{
+	// False when the block does not belong to the arena
+	unsigned char* block=(unsigned char*)pointer-headerBytes;
+	uint32_t sizeClass;
+
+	if(!contains(pointer)) return false;
+
+	lock_guard<mutex> myLock(arenaMutex);
+	if(!active || ((uint32_t*)block)[1]!=generation) return true;
+
+	sizeClass=((uint32_t*)block)[0];
+	*(void**)block=freeLists[sizeClass];
+	freeLists[sizeClass]=block;
+
+	return true;
+}
+
+class runArenaScope
+{
+public:
+	// Class variables
+	bool opened=false;
+
+	// Constructor
+	runArenaScope();
+
+	// Destructor
+	~runArenaScope();
+};
+
+runArenaScope::runArenaScope()
+{
+	// -run_arena 0 disables the arena, -run_arena_size sets the reserved space in GiB and
+	// -run_arena_retain the memory kept between runs in MiB
+	PetscInt arenaEnabled=1;
+	PetscInt arenaGiB=64;
+	PetscInt retainedMiB=1024;
+
+	PetscOptionsGetInt(NULL,NULL,"-run_arena",&arenaEnabled,NULL);
+	PetscOptionsGetInt(NULL,NULL,"-run_arena_size",&arenaGiB,NULL);
+	PetscOptionsGetInt(NULL,NULL,"-run_arena_retain",&retainedMiB,NULL);
+	if(!arenaEnabled) return;
+
+	if(!runArena::getArena().reserve((size_t)arenaGiB<<30,(size_t)retainedMiB<<20))
+	{
+		cout << "Unable to reserve " << arenaGiB << " GiB for the run arena\n";
+
+		return;
+	}
+
+	runArena::getArena().open();
+	opened=true;
+}
+
+runArenaScope::~runArenaScope()
+{
+	if(opened) runArena::getArena().close();
+}
+
+class runArenaBypass
+{
+public:
+	// Constructor
+	runArenaBypass();
+
+	// Destructor
+	~runArenaBypass();
+};
+
+runArenaBypass::runArenaBypass()
+{
+	// Only the allocations of the calling thread leave the arena
+	runArena::bypassDepth++;
+}
+
+runArenaBypass::~runArenaBypass()
+{
+	runArena::bypassDepth--;
+}
+
+void* operator new(size_t bytes)
+{
+	void* pointer=runArena::getArena().allocate(bytes);
+
+	if(pointer==NULL) pointer=malloc(bytes>0 ? bytes : 1);
+	if(pointer==NULL) throw bad_alloc();
+
+	return pointer;
+}
+
+void* operator new[](size_t bytes)
+{
+	return operator new(bytes);
+}
+
+void* operator new(size_t bytes, const nothrow_t&) noexcept
+{
+	void* pointer=runArena::getArena().allocate(bytes);
+
+	if(pointer==NULL) pointer=malloc(bytes>0 ? bytes : 1);
+
+	return pointer;
+}
+
+void* operator new[](size_t bytes, const nothrow_t& tag) noexcept
+{
+	return operator new(bytes,tag);
+}
+
+void operator delete(void* pointer) noexcept
+{
+	if(pointer==NULL) return;
+	if(!runArena::getArena().deallocate(pointer)) free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+	operator delete(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+	operator delete(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+	operator delete(pointer);
+}
+
+void operator delete(void* pointer, const nothrow_t&) noexcept
+{
+	operator delete(pointer);
+}
+
+void operator delete[](void* pointer, const nothrow_t&) noexcept
+{
+	operator delete(pointer);
+}
@@ -0,0 +1,376 @@
+/*
+	This header is part of the development of a master's thesis entitled "Analysis of Numerical
+	Schemes in Collocated and Staggered Grids for Problems of Poroelasticity". The class defined
+	here contains the functions for the tangent-linear (forward) sensitivity analysis of the
+	discretized problem of poroelasticity with respect to the parameters K, G, alpha and Q.
+
+	Differentiating A(p)*x(n+1)=b(p,x(n)) gives, for each parameter, the sensitivity system
+
+		A*s(n+1)=db/dp+(db/dx)*s(n)-(dA/dp)*x(n+1),
+
+	whose coefficients matrix is the one already factorized for the solution, so each parameter
+	costs one extra pair of triangular solves per time-step. The derivatives of the assembly
+	kernels are taken with central differences of the kernels themselves, dA/dp once for the whole
+	run and db/dp together with (db/dx)*s(n) at each time-step, with one assembly of the
+	independent terms built with the class and reused for every parameter and time-step. The
+	drained bulk modulus is kept constant when G is perturbed. The sensitivities are stored for the
+	first levelsNo time levels, all of them for the forward analysis and only the initial one when
+	the class serves the derivatives of the residual to the adjoint.
+
+ 	Written by FERREIRA, C. A. S.
+
+ 	Florianópolis, 2019.
+*/
+
+#include <fstream>
+#include <iostream>
+#include <math.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class sensitivityAnalysis
+{
+public:
+	// Class variables
+	vector<vector<int>> boundaryConditionType;
+	vector<vector<double>> boundaryConditionValue;
+	int Nu, Nv, NP, Nt, levelsNo;
+	vector<vector<int>> uDisplacementFVIndex;
+	vector<vector<int>> vDisplacementFVIndex;
+	vector<vector<int>> pressureFVIndex;
+	vector<vector<int>> uDisplacementFVCoordinates;
+	vector<vector<int>> vDisplacementFVCoordinates;
+	vector<vector<int>> pressureFVCoordinates;
+	vector<vector<int>> horizontalFacesStatus;
+	vector<vector<int>> verticalFacesStatus;
+	string gridType;
+	string interpScheme;
+	vector<string> parameterNames;
+	vector<double> parameterValues;
+	double lambda, mu_f, rho, g;
+	PetscReal relativeStep=1e-6;
+	vector<vector<double>> matrixDerivativeRow;
+	vector<vector<double>> matrixDerivativeColumn;
+	vector<vector<double>> matrixDerivativeValue;
+	vector<vector<vector<double>>> uSensitivityField;
+	vector<vector<vector<double>>> vSensitivityField;
+	vector<vector<vector<double>>> pSensitivityField;
+	independentTermsAssembly perturbedIndependentTerms;
+
+	// Class functions
+	double getParameterStep(int);
+	void getPerturbedParameters(int,double,double&,double&,double&,double&,double&);
+	void assemblyMatrixDerivatives(double,double,double);
+	void setTerzaghiInitialSensitivity(problemParameters);
+	vector<double> assemblySensitivityRHS(int,double,double,double,const vector<vector<double>>&,
+		const vector<vector<double>>&,const vector<vector<double>>&,int);
+	vector<double> assemblyDerivativeRHS(int,double,double,double,const vector<vector<double>>&,
+		const vector<vector<double>>&,const vector<vector<double>>&,int,double);
+	vector<double> getSolutionArray(const vector<vector<double>>&,const vector<vector<double>>&,
+		const vector<vector<double>>&,int);
+	void setSensitivityValue(int,int,const vector<double>&);
+	double getCentralValue(const vector<vector<int>>&,const vector<vector<double>>&,int,int);
+	void exportTerzaghiSensitivityHistory(double,string);
+
+	// Constructor
+	sensitivityAnalysis(vector<vector<int>>,vector<vector<double>>,int,int,int,int,
+		vector<vector<int>>,vector<vector<int>>,vector<vector<int>>,vector<vector<int>>,
+		vector<vector<int>>,vector<vector<int>>,vector<vector<int>>,vector<vector<int>>,string,
+		string,double,double,double,double,double,double,double,double,int);
+
+	// Destructor
+	~sensitivityAnalysis();
+};
+
+sensitivityAnalysis::sensitivityAnalysis(vector<vector<int>> bcType, vector<vector<double>> bcValue,
+	int myNu, int myNv, int myNP, int myNt, vector<vector<int>> idU, vector<vector<int>> idV,
+	vector<vector<int>> idP, vector<vector<int>> cooU, vector<vector<int>> cooV,
+	vector<vector<int>> cooP, vector<vector<int>> horFaceStatus,
+	vector<vector<int>> verFaceStatus, string myGridType, string myInterpScheme, double K,
+	double G, double alpha, double Q, double myLambda, double myMu_f, double myRho, double myG,
+	int myLevelsNo)
+	: perturbedIndependentTerms(bcType,bcValue,myNu,myNv,myNP,idU,idV,idP,cooU,cooV,cooP,
+		horFaceStatus,verFaceStatus,myGridType,myInterpScheme)
+{
+	boundaryConditionType=bcType;
+	boundaryConditionValue=bcValue;
+	Nu=myNu;
+	Nv=myNv;
+	NP=myNP;
+	Nt=myNt;
+	levelsNo=myLevelsNo;
+	uDisplacementFVIndex=idU;
+	vDisplacementFVIndex=idV;
+	pressureFVIndex=idP;
+	uDisplacementFVCoordinates=cooU;
+	vDisplacementFVCoordinates=cooV;
+	pressureFVCoordinates=cooP;
+	horizontalFacesStatus=horFaceStatus;
+	verticalFacesStatus=verFaceStatus;
+	gridType=myGridType;
+	interpScheme=myInterpScheme;
+	lambda=myLambda;
+	mu_f=myMu_f;
+	rho=myRho;
+	g=myG;
+
+	parameterNames={"K","G","alpha","Q"};
+	parameterValues={K,G,alpha,Q};
+
+	PetscOptionsGetReal(NULL,NULL,"-sensitivity_step",&relativeStep,NULL);
+
+	int parametersNo=parameterNames.size();
+	matrixDerivativeRow.resize(parametersNo);
+	matrixDerivativeColumn.resize(parametersNo);
+	matrixDerivativeValue.resize(parametersNo);
+	uSensitivityField.assign(parametersNo,vector<vector<double>>(Nu,vector<double>(levelsNo,0)));
+	vSensitivityField.assign(parametersNo,vector<vector<double>>(Nv,vector<double>(levelsNo,0)));
+	pSensitivityField.assign(parametersNo,vector<vector<double>>(NP,vector<double>(levelsNo,0)));
+}
+
+sensitivityAnalysis::~sensitivityAnalysis(){}
+
+double sensitivityAnalysis::getParameterStep(int parameter)
+{
+	double step=relativeStep*fabs(parameterValues[parameter]);
+
+	return step;
+}
+
+void sensitivityAnalysis::getPerturbedParameters(int parameter, double sign, double& K, double& G,
+	double& alpha, double& Q, double& myLambda)
+{
+	double step=sign*getParameterStep(parameter);
+
+	K=parameterValues[0];
+	G=parameterValues[1];
+	alpha=parameterValues[2];
+	Q=parameterValues[3];
+	myLambda=lambda;
+
+	if(parameter==0) K+=step;
+	else if(parameter==1)
+	{
+		G+=step;
+		myLambda-=2*step/3;
+	}
+	else if(parameter==2) alpha+=step;
+	else if(parameter==3) Q+=step;
+
+	return;
+}
+
+void sensitivityAnalysis::assemblyMatrixDerivatives(double dx, double dy, double dt)
+{
+	double K, G, alpha, Q, myLambda, value;
+	vector<vector<double>> plusMatrix, minusMatrix;
+
+	for(int parameter=0; parameter<parameterNames.size(); parameter++)
+	{
+		coefficientsAssembly plusCoefficients(boundaryConditionType,Nu,Nv,NP,uDisplacementFVIndex,
+			vDisplacementFVIndex,pressureFVIndex,uDisplacementFVCoordinates,
+			vDisplacementFVCoordinates,pressureFVCoordinates,horizontalFacesStatus,
+			verticalFacesStatus,gridType,interpScheme);
+		coefficientsAssembly minusCoefficients=plusCoefficients;
+
+		getPerturbedParameters(parameter,1,K,G,alpha,Q,myLambda);
+		plusCoefficients.assemblyCoefficientsMatrix(dx,dy,dt,G,myLambda,alpha,K,mu_f,Q,rho,g);
+		swap(plusMatrix,plusCoefficients.coefficientsMatrix);
+
+		getPerturbedParameters(parameter,-1,K,G,alpha,Q,myLambda);
+		minusCoefficients.assemblyCoefficientsMatrix(dx,dy,dt,G,myLambda,alpha,K,mu_f,Q,rho,g);
+		swap(minusMatrix,minusCoefficients.coefficientsMatrix);
+
+		matrixDerivativeRow[parameter].clear();
+		matrixDerivativeColumn[parameter].clear();
+		matrixDerivativeValue[parameter].clear();
+
+		for(int i=0; i<plusMatrix.size(); i++)
+			for(int j=0; j<plusMatrix[i].size(); j++)
+			{
+				value=plusMatrix[i][j]-minusMatrix[i][j];
+				if(value!=0)
+				{
+					matrixDerivativeRow[parameter].push_back(i);
+					matrixDerivativeColumn[parameter].push_back(j);
+					matrixDerivativeValue[parameter].push_back(value/
+						(2*getParameterStep(parameter)));
+				}
+			}
+	}
+
+	return;
+}
+
+void sensitivityAnalysis::setTerzaghiInitialSensitivity(problemParameters myProblem)
+{
+	double K, G, alpha, Q, myLambda;
+	double step;
+
+	for(int parameter=0; parameter<parameterNames.size(); parameter++)
+	{
+		problemParameters plusProblem=myProblem;
+		problemParameters minusProblem=myProblem;
+		step=getParameterStep(parameter);
+
+		getPerturbedParameters(parameter,1,K,G,alpha,Q,myLambda);
+		plusProblem.K=K;plusProblem.G=G;plusProblem.lambda=myLambda;
+		plusProblem.alpha=alpha;plusProblem.Q=Q;plusProblem.M=2*G+myLambda;
+		plusProblem.applyTerzaghiInitialConditions();
+
+		getPerturbedParameters(parameter,-1,K,G,alpha,Q,myLambda);
+		minusProblem.K=K;minusProblem.G=G;minusProblem.lambda=myLambda;
+		minusProblem.alpha=alpha;minusProblem.Q=Q;minusProblem.M=2*G+myLambda;
+		minusProblem.applyTerzaghiInitialConditions();
+
+		for(int i=0; i<Nu; i++) uSensitivityField[parameter][i][0]=
+			(plusProblem.uDisplacementField[i][0]-minusProblem.uDisplacementField[i][0])/(2*step);
+		for(int i=0; i<Nv; i++) vSensitivityField[parameter][i][0]=
+			(plusProblem.vDisplacementField[i][0]-minusProblem.vDisplacementField[i][0])/(2*step);
+		for(int i=0; i<NP; i++) pSensitivityField[parameter][i][0]=
+			(plusProblem.pressureField[i][0]-minusProblem.pressureField[i][0])/(2*step);
+	}
+
+	return;
+}
+
+vector<double> sensitivityAnalysis::assemblySensitivityRHS(int parameter, double dx, double dy,
+	double dt, const vector<vector<double>>& uField, const vector<vector<double>>& vField,
+	const vector<vector<double>>& pField, int timeStep)
+{
+	vector<double> sensitivityRHS=assemblyDerivativeRHS(parameter,dx,dy,dt,uField,vField,pField,
+		timeStep,1);
+
+	return sensitivityRHS;
+}
+
+vector<double> sensitivityAnalysis::assemblyDerivativeRHS(int parameter, double dx, double dy,
+	double dt, const vector<vector<double>>& uField, const vector<vector<double>>& vField,
+	const vector<vector<double>>& pField, int timeStep, double sensitivityWeight)
+{
+	// The independent terms are affine in the fields of the previous time-step, so perturbing
+	// both the parameter and the fields (along the weighted sensitivity) gives
+	// db/dp+w*(db/dx)*s(n). With w=0 this is the derivative of the residual of the time-step and
+	// the sensitivities, which may not be stored for the time-step, are not read
+	double K, G, alpha, Q, myLambda;
+	double step=getParameterStep(parameter);
+	double fieldStep=sensitivityWeight*step;
+	vector<vector<double>> uPlus(Nu,vector<double>(1)), uMinus(Nu,vector<double>(1));
+	vector<vector<double>> vPlus(Nv,vector<double>(1)), vMinus(Nv,vector<double>(1));
+	vector<vector<double>> pPlus(NP,vector<double>(1)), pMinus(NP,vector<double>(1));
+	vector<double> plusArray, minusArray, sensitivityRHS, currentSolution;
+	double shift=0;
+
+	for(int i=0; i<Nu; i++)
+	{
+		if(fieldStep!=0) shift=fieldStep*uSensitivityField[parameter][i][timeStep];
+		uPlus[i][0]=uField[i][timeStep]+shift;
+		uMinus[i][0]=uField[i][timeStep]-shift;
+	}
+	for(int i=0; i<Nv; i++)
+	{
+		if(fieldStep!=0) shift=fieldStep*vSensitivityField[parameter][i][timeStep];
+		vPlus[i][0]=vField[i][timeStep]+shift;
+		vMinus[i][0]=vField[i][timeStep]-shift;
+	}
+	for(int i=0; i<NP; i++)
+	{
+		if(fieldStep!=0) shift=fieldStep*pSensitivityField[parameter][i][timeStep];
+		pPlus[i][0]=pField[i][timeStep]+shift;
+		pMinus[i][0]=pField[i][timeStep]-shift;
+	}
+
+	getPerturbedParameters(parameter,1,K,G,alpha,Q,myLambda);
+	perturbedIndependentTerms.assemblyIndependentTermsArray(dx,dy,dt,G,myLambda,alpha,K,mu_f,Q,
+		rho,g,uPlus,vPlus,pPlus,0);
+	plusArray=perturbedIndependentTerms.independentTermsArray;
+
+	getPerturbedParameters(parameter,-1,K,G,alpha,Q,myLambda);
+	perturbedIndependentTerms.assemblyIndependentTermsArray(dx,dy,dt,G,myLambda,alpha,K,mu_f,Q,
+		rho,g,uMinus,vMinus,pMinus,0);
+	minusArray=perturbedIndependentTerms.independentTermsArray;
+
+	sensitivityRHS.resize(plusArray.size());
+	for(int i=0; i<plusArray.size(); i++)
+		sensitivityRHS[i]=(plusArray[i]-minusArray[i])/(2*step);
+
+	// -(dA/dp)*x(n+1)
+	currentSolution=getSolutionArray(uField,vField,pField,timeStep+1);
+	for(int k=0; k<matrixDerivativeValue[parameter].size(); k++)
+		sensitivityRHS[matrixDerivativeRow[parameter][k]]-=matrixDerivativeValue[parameter][k]*
+			currentSolution[matrixDerivativeColumn[parameter][k]];
+
+	return sensitivityRHS;
+}
+
+vector<double> sensitivityAnalysis::getSolutionArray(const vector<vector<double>>& uField,
+	const vector<vector<double>>& vField, const vector<vector<double>>& pField, int timeStep)
+{
+	vector<double> solutionArray(Nu+Nv+NP);
+
+	for(int i=0; i<Nu; i++) solutionArray[i]=uField[i][timeStep];
+	for(int i=0; i<Nv; i++) solutionArray[i+Nu]=vField[i][timeStep];
+	for(int i=0; i<NP; i++) solutionArray[i+Nu+Nv]=pField[i][timeStep];
+
+	return solutionArray;
+}
+
+void sensitivityAnalysis::setSensitivityValue(int parameter, int timeStep,
+	const vector<double>& sensitivityArray)
+{
+	for(int i=0; i<Nu; i++) uSensitivityField[parameter][i][timeStep]=sensitivityArray[i];
+	for(int i=0; i<Nv; i++) vSensitivityField[parameter][i][timeStep]=sensitivityArray[i+Nu];
+	for(int i=0; i<NP; i++) pSensitivityField[parameter][i][timeStep]=sensitivityArray[i+Nu+Nv];
+
+	return;
+}
+
+double sensitivityAnalysis::getCentralValue(const vector<vector<int>>& myIndex,
+	const vector<vector<double>>& myField, int row, int timeStep)
+{
+	// Value at the centerline of the column, averaged if it lies between two FV
+	int midCols=myIndex[row].size()/2;
+	double value;
+
+	if(myIndex[row].size()%2==0)
+		value=(myField[myIndex[row][midCols]-1][timeStep]+
+			myField[myIndex[row][midCols-1]-1][timeStep])/2;
+	else
+		value=myField[myIndex[row][midCols]-1][timeStep];
+
+	return value;
+}
+
+void sensitivityAnalysis::exportTerzaghiSensitivityHistory(double dt, string pairName)
+{
+	// Exports the sensitivities of the settlement (top displacement) and of the pore pressure at
+	// the base of the column, scaled by the parameter value to share the units of the output
+	string gridName=gridType;
+	if(gridType=="collocated") gridName+="+"+interpScheme;
+	int bottomRow=pressureFVIndex.size()-1;
+
+	for(int parameter=0; parameter<parameterNames.size(); parameter++)
+	{
+		string fileName="../export/terzaghi_"+pairName+"_sensitivity_"+
+			parameterNames[parameter]+"_"+gridName+"-grid.txt";
+
+		ofstream myFile(fileName);
+		if(myFile.is_open())
+		{
+			for(int timeStep=0; timeStep<levelsNo; timeStep++)
+			{
+				myFile << timeStep*dt << " ";
+				myFile << parameterValues[parameter]*getCentralValue(vDisplacementFVIndex,
+					vSensitivityField[parameter],0,timeStep) << " ";
+				myFile << parameterValues[parameter]*getCentralValue(pressureFVIndex,
+					pSensitivityField[parameter],bottomRow,timeStep) << "\n";
+			}
+
+			myFile.close();
+		}
+	}
+
+	return;
+}
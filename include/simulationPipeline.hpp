@@ -0,0 +1,614 @@
+/*
+	This header is part of the development of a master's thesis entitled "Analysis of Numerical
+	Schemes in Collocated and Staggered Grids for Problems of Poroelasticity". The structures and
+	the function defined here describe a consolidation problem declaratively and solve any such
+	description with a single pipeline.
+
+	A problemDescriptor holds what tells the benchmarking problems apart: the geometry and mesh, the
+	boundary condition types and values, the load, whether the medium has double porosity, and
+	functors for the initial conditions, for the loads added to the coefficients matrix and to the
+	independent terms array, and for the exporters of the full fields (skipped with -field_export 0)
+	and the observers which process the solution. The pipeline then creates the grid, computes the
+	problem parameters, assembles and factorizes the coefficients matrix and advances the
+	time-steps, keeping the fields of the current time-step only and the solution of every
+	time-step in a solutionHistory. Features of the pipeline (run arena, NUMA placement, history
+	compression and spilling, live metrics, in-situ rendering, export of the linear systems, solver
+	options) so apply to every problem alike.
+
+	The functors receive the simulationState, which exposes the grid, the medium, the derived
+	parameters and, once the time-steps are done, the history to the observers.
+
+	The descriptor, the state and the pipeline are templated on the scalar type of the fields, of
+	the assembly, of the independent terms and of the raw blocks of the history, problemDescriptor
+	and simulationState being the double precision ones. The problem parameters and the LU
+	factorization of PETSc stay in double precision (the scalar type of PETSc is fixed when it is
+	configured), so that a single precision run converts the sparse triplets of the matrix, the
+	independent terms array and the solution at the boundary of the solver. The dense matrix is
+	released once its triplets are taken and the solver holds no fields, the history and the fields
+	of the current time-step being those of the run. After the time-steps the pipeline measures the
+	pressure oscillation of the last time-step, which tells the screening runs in single precision
+	whose result is close to the stability threshold.
+
+ 	Written by FERREIRA, C. A. S.
+
+ 	Florianópolis, 2019.
+*/
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <math.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+struct poroelasticProperties
+{
+	// Pair name
+	string pairName;
+
+	// Bulk parameters
+	double shearModulus;
+	double bulkModulus;
+	double porosity;
+	double permeability;
+	double macroPorosity;
+	double macroPermeability;
+
+	// Solid parameters
+	double solidBulkModulus;
+	double solidDensity;
+
+	// Fluid parameters
+	double fluidBulkModulus;
+	double fluidViscosity;
+	double fluidDensity;
+};
+
+template<class scalar> struct basicSimulationState;
+
+template<class scalar>
+struct basicProblemDescriptor
+{
+	// Name of the problem, used by the live metrics
+	string problemName;
+	bool doublePorosity=false;
+
+	// Geometry
+	int Nx;
+	int Ny;
+	double Lx; // [m]
+	double Ly; // [m]
+	int stripSize=0;
+
+	// BC types ({u,v,P} or {u,v,p-pore,p-frac} 1 for Dirichlet and 0 for Neumann, -1 for
+	// Stress/Fluid Flow, starts on "north" and follows counterclockwise) and values
+	vector<vector<int>> bcType;
+	vector<vector<double>> bcValue;
+
+	// Load (prescribed stress or force) and, for double porosity, the leak term coefficient and
+	// whether the transient terms are decoupled
+	double load=0;
+	double leakCoefficient=11;
+	bool decoupledStorage=false;
+
+	// Initial conditions, applied to the problem parameters object of the state
+	function<void(basicSimulationState<scalar>&)> initialConditions;
+
+	// Loads added to the coefficients matrix after its assembly, to the independent terms array
+	// once before the time-steps and at each time-step
+	function<void(basicSimulationState<scalar>&,basicCoefficientsAssembly<scalar>&)>
+		coefficientsLoad;
+	function<void(basicSimulationState<scalar>&,basicIndependentTermsAssembly<scalar>&)>
+		independentTermsSetup;
+	function<void(basicSimulationState<scalar>&,basicIndependentTermsAssembly<scalar>&)>
+		independentTermsLoad;
+
+	// Exporters of the full fields and observers, called in order once the time-steps are done;
+	// the exporters are skipped with -field_export 0
+	vector<function<void(basicSimulationState<scalar>&)>> exporters;
+	vector<function<void(basicSimulationState<scalar>&)>> observers;
+};
+
+template<class scalar>
+struct basicSimulationState
+{
+	// Run
+	const basicProblemDescriptor<scalar>* descriptor;
+	string gridType;
+	string interpScheme;
+	string pairName;
+	int Nt;
+
+	// Grid
+	int Nu, Nv, NP;
+	double Lx, Ly;
+	double dx, dy, dt, h;
+	vector<vector<int>> idU, idV, idP;
+	vector<vector<int>> cooU, cooV, cooP;
+	vector<vector<int>> horFaceStatus, verFaceStatus;
+
+	// Fields of the current time-step (of the initial conditions before the time-steps)
+	vector<vector<scalar>> uField, vField, pField, pMField;
+
+	// Medium
+	double G, lambda, phi, K, phiFrac, KFrac;
+	double c_s, rho_s, c_f, rho_f, mu_f, g, rho;
+
+	// Single porosity parameters
+	problemParameters* singleProblem=NULL;
+	double Q, alpha, longitudinalModulus, consolidationCoefficient, initialPressure;
+
+	// Double porosity parameters
+	problemDoubleParameters* doubleProblem=NULL;
+	double psiPore, psiFrac, S11, S12, S22, leak;
+
+	// Solution of every time-step and pressure oscillation of the last one
+	solutionHistory* history=NULL;
+	double pressureOscillation=0;
+};
+
+typedef basicProblemDescriptor<double> problemDescriptor;
+typedef basicSimulationState<double> simulationState;
+
+struct precisionScreening
+{
+	// Pressure oscillation of the last run of the pipeline, read by the screening runs
+	static double lastOscillation;
+};
+
+double precisionScreening::lastOscillation=0;
+
+template<class target, class source>
+vector<vector<target>> convertField(const vector<vector<source>>& myField)
+{
+	vector<vector<target>> convertedField(myField.size());
+
+	for(int i=0; i<myField.size(); i++)
+		convertedField[i].assign(myField[i].begin(),myField[i].end());
+
+	return convertedField;
+};
+
+template<class target, class source>
+void passField(vector<vector<target>>& toField, vector<vector<source>>& fromField)
+{
+	// Fields of another scalar type are converted, those of the same type are swapped
+	toField=convertField<target>(fromField);
+	vector<vector<source>>().swap(fromField);
+
+	return;
+};
+
+template<class scalar>
+void passField(vector<vector<scalar>>& toField, vector<vector<scalar>>& fromField)
+{
+	swap(toField,fromField);
+
+	return;
+};
+
+template<class target, class source>
+void passArray(vector<target>& toArray, vector<source>& fromArray)
+{
+	toArray.assign(fromArray.begin(),fromArray.end());
+	vector<source>().swap(fromArray);
+
+	return;
+};
+
+template<class scalar>
+void passArray(vector<scalar>& toArray, vector<scalar>& fromArray)
+{
+	swap(toArray,fromArray);
+
+	return;
+};
+
+template<class scalar>
+double getPressureOscillation(const vector<vector<scalar>>& pField, const vector<vector<int>>& idP)
+{
+	// Along each column of FV, the smaller of two consecutive pressure differences which change
+	// sign, summed and relative to the largest pressure; the largest over the columns
+	double maxPressure=0;
+	double oscillation=0;
+	double columnOscillation, difference, previousDifference;
+	int P_P, P_N;
+
+	for(int i=0; i<pField.size(); i++) maxPressure=max(maxPressure,fabs((double)pField[i][0]));
+	if(maxPressure==0 || idP.size()==0) return 0;
+
+	for(int j=0; j<idP[0].size(); j++)
+	{
+		columnOscillation=0;
+		previousDifference=0;
+		P_N=-1;
+		for(int i=0; i<idP.size(); i++)
+		{
+			if(idP[i][j]==0) continue;
+			P_P=idP[i][j]-1;
+			if(P_N>=0)
+			{
+				difference=(double)pField[P_P][0]-pField[P_N][0];
+				if(difference*previousDifference<0)
+					columnOscillation+=min(fabs(difference),fabs(previousDifference));
+				previousDifference=difference;
+			}
+			P_N=P_P;
+		}
+		oscillation=max(oscillation,columnOscillation);
+	}
+
+	return oscillation/maxPressure;
+};
+
+vector<int> getOperatorExportSteps(int stepsNo, int exportNo)
+{
+	// exportNo time-steps spread over the stepsNo ones, the first and the last included
+	vector<int> exportSteps;
+	int arraysNo=min(exportNo,stepsNo);
+
+	for(int k=0; k<arraysNo; k++)
+		exportSteps.push_back((arraysNo>1) ? (long long)k*(stepsNo-1)/(arraysNo-1) : 0);
+
+	return exportSteps;
+};
+
+template<class scalar>
+void exportOperatorManifest(const basicSimulationState<scalar>& myState, string fileName,
+	string cellOrdering, int unknownsNo, int nonZeroEntries, const vector<int>& exportSteps)
+{
+	// One "key value" pair per line, read by the replay of the systems
+	ofstream myFile(fileName+"_manifest.txt");
+
+	myFile << setprecision(17);
+	myFile << "problem " << myState.descriptor->problemName << "\n";
+	myFile << "gridType " << myState.gridType << "\n";
+	myFile << "interpScheme " << myState.interpScheme << "\n";
+	myFile << "medium " << myState.pairName << "\n";
+	myFile << "doublePorosity " << myState.descriptor->doublePorosity << "\n";
+	myFile << "cellOrdering " << cellOrdering << "\n";
+	myFile << "Nx " << myState.descriptor->Nx << "\n";
+	myFile << "Ny " << myState.descriptor->Ny << "\n";
+	myFile << "Lx " << myState.Lx << "\n";
+	myFile << "Ly " << myState.Ly << "\n";
+	myFile << "h " << myState.h << "\n";
+	myFile << "dt " << myState.dt << "\n";
+	myFile << "Nt " << myState.Nt << "\n";
+	myFile << "Nu " << myState.Nu << "\n";
+	myFile << "Nv " << myState.Nv << "\n";
+	myFile << "NP " << myState.NP << "\n";
+	myFile << "unknowns " << unknownsNo << "\n";
+	myFile << "nonzeros " << nonZeroEntries << "\n";
+	myFile << "matrix " << fileName.substr(fileName.rfind('/')+1) << "_A\n";
+	myFile << "fields " << fileName.substr(fileName.rfind('/')+1) << "_fields.txt\n";
+	for(int k=0; k<exportSteps.size(); k++)
+		myFile << "independentTerms " << fileName.substr(fileName.rfind('/')+1) <<
+			"_b_timeStep=" << exportSteps[k] << "\n";
+	myFile.close();
+
+	return;
+};
+
+template<class scalar>
+int runSimulationPipeline(const basicProblemDescriptor<scalar>& myDescriptor, string gridType,
+	string interpScheme, int Nt, double Lt, double g, poroelasticProperties myProperties)
+{
+	PetscErrorCode ierr;
+	basicSimulationState<scalar> myState;
+
+	// Objects of this run are allocated from the run arena
+	runArenaScope myRunArena;
+
+/*		ENTRY PARAMETERS
+	----------------------------------------------------------------*/
+
+	myState.descriptor=&myDescriptor;
+	myState.gridType=gridType;
+	myState.interpScheme=interpScheme;
+	myState.Nt=Nt;
+	myState.Lx=myDescriptor.Lx;
+	myState.Ly=myDescriptor.Ly;
+	bool isDouble=myDescriptor.doublePorosity;
+
+	vector<vector<double>> sCoordinates=
+	{
+		{myState.Lx,myState.Ly},
+		{0,myState.Ly},
+		{0,0},
+		{myState.Lx,0}
+	};
+
+	// Bulk properties
+	myState.pairName=myProperties.pairName;
+	myState.G=myProperties.shearModulus;
+	myState.lambda=myProperties.bulkModulus-2*myState.G/3;
+	myState.phi=myProperties.porosity;
+	myState.K=myProperties.permeability;
+	myState.phiFrac=myProperties.macroPorosity;
+	myState.KFrac=myProperties.macroPermeability;
+
+	// Solid properties
+	myState.c_s=1/myProperties.solidBulkModulus;
+	myState.rho_s=myProperties.solidDensity;
+
+	// Fluid properties
+	myState.c_f=1/myProperties.fluidBulkModulus;
+	myState.rho_f=myProperties.fluidDensity;
+	myState.mu_f=myProperties.fluidViscosity;
+	myState.g=g;
+	myState.rho=(myState.phi*myState.rho_f+(1-myState.phi)*myState.rho_s);
+
+	// Shorthands for the assembly
+	double& dx=myState.dx;
+	double& dy=myState.dy;
+	double& dt=myState.dt;
+	double& G=myState.G;
+	double& lambda=myState.lambda;
+	double& K=myState.K;
+	double& mu_f=myState.mu_f;
+
+/*		GRID CREATION
+	----------------------------------------------------------------*/
+
+	// Numbering of the FV, -cell_ordering rowmajor|morton|hilbert within tiles of -ordering_tile FV
+	char myCellOrdering[PETSC_MAX_PATH_LEN]="rowmajor";
+	PetscInt orderingTile=0;
+	PetscOptionsGetString(NULL,NULL,"-cell_ordering",myCellOrdering,PETSC_MAX_PATH_LEN,NULL);
+	PetscOptionsGetInt(NULL,NULL,"-ordering_tile",&orderingTile,NULL);
+	resultsManifest::recordSetting("cellOrdering",myCellOrdering);
+
+	// Constructor
+	gridDesign myGrid(myDescriptor.Nx,myDescriptor.Ny,Nt,myState.Lx,myState.Ly,Lt,gridType,
+		sCoordinates,myCellOrdering,orderingTile);
+
+	// Passing variables, the fields are in double precision until the initial conditions
+	vector<vector<double>> uField, vField, pField;
+	swap(myState.Nu,myGrid.numberOfActiveUDisplacementFV);
+	swap(myState.Nv,myGrid.numberOfActiveVDisplacementFV);
+	swap(myState.NP,myGrid.numberOfActiveGeneralFV);
+	swap(dx,myGrid.dx);
+	swap(dy,myGrid.dy);
+	swap(dt,myGrid.dt);
+	swap(myState.h,myGrid.h);
+	swap(myState.idU,myGrid.uDisplacementFVIndex);
+	swap(myState.idV,myGrid.vDisplacementFVIndex);
+	swap(myState.idP,myGrid.generalFVIndex);
+	swap(myState.cooU,myGrid.uDisplacementFVCoordinates);
+	swap(myState.cooV,myGrid.vDisplacementFVCoordinates);
+	swap(myState.cooP,myGrid.generalFVCoordinates);
+	swap(myState.horFaceStatus,myGrid.horizontalFacesStatus);
+	swap(myState.verFaceStatus,myGrid.verticalFacesStatus);
+	swap(uField,myGrid.uDisplacementField);
+	swap(vField,myGrid.vDisplacementField);
+	swap(pField,myGrid.pressureField);
+
+/*		PROBLEM PARAMETERS CALCULATION
+	----------------------------------------------------------------*/
+
+	if(!isDouble)
+	{
+		// Constructor
+		problemParameters myProblem(dx,dy,K,myState.phi,myState.rho_s,myState.c_s,mu_f,
+			myState.rho_f,myState.c_f,G,lambda,myDescriptor.load,myState.Lx,myState.Ly,uField,
+			vField,pField,myState.cooU,myState.cooV,myState.cooP,myState.idU,myState.idV,
+			myState.idP,g);
+
+		// Apply initial conditions
+		myState.singleProblem=&myProblem;
+		if(myDescriptor.initialConditions) myDescriptor.initialConditions(myState);
+		myState.singleProblem=NULL;
+
+		// Passing variables
+		myState.Q=myProblem.Q;
+		myState.alpha=myProblem.alpha;
+		myState.longitudinalModulus=myProblem.M;
+		myState.consolidationCoefficient=myProblem.c;
+		myState.initialPressure=myProblem.P0;
+		passField(myState.uField,myProblem.uDisplacementField);
+		passField(myState.vField,myProblem.vDisplacementField);
+		passField(myState.pField,myProblem.pressureField);
+	}
+	else
+	{
+		// Constructor
+		problemDoubleParameters myProblem(myState.phi,myState.phiFrac,myState.c_f,myState.c_s,G,
+			lambda,mu_f,K,myState.KFrac,myDescriptor.load,myState.cooV,myState.idV);
+
+		// Apply initial conditions
+		myState.pMField=convertField<scalar>(pField);
+		passField(myState.uField,uField);
+		passField(myState.vField,vField);
+		passField(myState.pField,pField);
+		myState.doubleProblem=&myProblem;
+		if(myDescriptor.initialConditions)
+		{
+			myDescriptor.initialConditions(myState);
+			passField(myState.vField,myProblem.vDisplacementField);
+			passField(myState.pField,myProblem.pressurePoreField);
+			passField(myState.pMField,myProblem.pressureFracField);
+		}
+		myState.doubleProblem=NULL;
+
+		// Passing variables
+		myState.psiPore=myProblem.psiPore;
+		myState.psiFrac=myProblem.psiFrac;
+		myState.alpha=myProblem.alpha;
+		myState.S11=myProblem.S11;
+		myState.S12=myProblem.S12;
+		myState.S22=myProblem.S22;
+		myState.leak=myProblem.computeLeakTerm(myDescriptor.leakCoefficient);
+		myState.consolidationCoefficient=myProblem.consolCoef;
+
+		// Forcing transient term decoupling
+		if(myDescriptor.decoupledStorage) myState.S12=-myState.psiPore*myState.alpha*
+			myState.psiFrac*myState.alpha/(2*G+lambda);
+	}
+
+/*		LINEAR SYSTEM'S COEFFICIENTS MATRIX ASSEMBLY
+	----------------------------------------------------------------*/
+
+	// Constructor
+	basicCoefficientsAssembly<scalar> myCoefficients(myDescriptor.bcType,myState.Nu,myState.Nv,
+		myState.NP,myState.idU,myState.idV,myState.idP,myState.cooU,myState.cooV,myState.cooP,
+		myState.horFaceStatus,myState.verFaceStatus,gridType,interpScheme);
+
+	// Coefficients matrix assembly
+	if(!isDouble) myCoefficients.assemblyCoefficientsMatrix(dx,dy,dt,G,lambda,myState.alpha,K,
+		mu_f,myState.Q,myState.rho,g);
+	else myCoefficients.assemblyDoublePorosityMatrix(dx,dy,dt,G,lambda,myState.alpha,K,
+		myState.KFrac,mu_f,myState.S11,myState.S12,myState.S22,myState.psiPore,myState.psiFrac,
+		myState.leak);
+	if(myDescriptor.coefficientsLoad) myDescriptor.coefficientsLoad(myState,myCoefficients);
+
+	// Passing variables, in the scalar type of PETSc; the solver only takes the number of rows of
+	// the dense matrix, which is released
+	vector<vector<double>> coefficientsMatrix(myCoefficients.coefficientsMatrix.size());
+	vector<vector<scalar>>().swap(myCoefficients.coefficientsMatrix);
+	vector<double> sparseCoefficientsRow;passArray(sparseCoefficientsRow,
+		myCoefficients.sparseCoefficientsRow);
+	vector<double> sparseCoefficientsColumn;passArray(sparseCoefficientsColumn,
+		myCoefficients.sparseCoefficientsColumn);
+	vector<double> sparseCoefficientsValue;passArray(sparseCoefficientsValue,
+		myCoefficients.sparseCoefficientsValue);
+
+/*		LINEAR SYSTEM SOLVER
+	----------------------------------------------------------------*/
+
+	// Variables declaration
+	int timeStep;
+	vector<double> solutionArray;
+
+	// Solution history, the fields only hold the current time-step
+	vector<int> blockSizes={myState.Nu,myState.Nv,myState.NP};
+	if(isDouble) blockSizes.push_back(myState.NP);
+	solutionHistory mySolutionHistory(blockSizes,Nt,sizeof(scalar)<sizeof(double));
+	if(!isDouble)
+	{
+		solutionArray=mySolutionHistory.joinFields(myState.uField,myState.vField,myState.pField,0);
+		mySolutionHistory.storeSnapshot(solutionArray);
+		mySolutionHistory.splitSnapshot(solutionArray.data(),myState.uField,myState.vField,
+			myState.pField);
+	}
+	else
+	{
+		solutionArray=mySolutionHistory.joinFields(myState.uField,myState.vField,myState.pField,
+			myState.pMField,0);
+		mySolutionHistory.storeSnapshot(solutionArray);
+		mySolutionHistory.splitSnapshot(solutionArray.data(),myState.uField,myState.vField,
+			myState.pField,myState.pMField);
+	}
+
+	// Constructors, the solver without fields, the solutions being taken as arrays
+	vector<vector<double>> noField;
+	basicIndependentTermsAssembly<scalar> myIndependentTerms(myDescriptor.bcType,
+		convertField<scalar>(myDescriptor.bcValue),myState.Nu,myState.Nv,myState.NP,myState.idU,
+		myState.idV,myState.idP,myState.cooU,myState.cooV,myState.cooP,myState.horFaceStatus,
+		myState.verFaceStatus,gridType,interpScheme);
+	linearSystemSolver myLinearSystemSolver(coefficientsMatrix,move(sparseCoefficientsRow),
+		move(sparseCoefficientsColumn),move(sparseCoefficientsValue),noField,noField,noField,
+		myState.Nu,myState.Nv,myState.NP,Nt,myState.idU,myState.idV,myState.idP,myState.cooU,
+		myState.cooV,myState.cooP);
+
+	// Increase the independent terms array
+	if(isDouble) myIndependentTerms.increaseMacroIndependentTermsArray();
+	if(myDescriptor.independentTermsSetup)
+		myDescriptor.independentTermsSetup(myState,myIndependentTerms);
+
+	// Linear systems written for the offline benchmarks of the solvers, -operator_export giving
+	// the number of independent terms arrays, spread over the time-steps
+	PetscInt operatorExportNo=0;
+	PetscOptionsGetInt(NULL,NULL,"-operator_export",&operatorExportNo,NULL);
+	vector<int> operatorExportSteps=getOperatorExportSteps(Nt-1,operatorExportNo);
+	string operatorName="../export/operator_"+myDescriptor.problemName+"_"+myState.pairName+
+		"_mesh="+to_string(myDescriptor.Ny)+"x"+to_string(myDescriptor.Nx)+"_dt="+to_string(dt)+
+		"_"+gridType+((gridType=="staggered") ? "" : "+"+interpScheme)+"-grid";
+	if(operatorExportNo>0)
+	{
+		ierr=myLinearSystemSolver.exportOperator(operatorName);CHKERRQ(ierr);
+	}
+
+	// LU Factorization of coefficientsMatrix
+	ierr=myLinearSystemSolver.coefficientsMatrixLUFactorization();CHKERRQ(ierr);
+
+	// Creation of arrays
+	ierr=myLinearSystemSolver.createPETScArrays();CHKERRQ(ierr);
+	ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
+
+	// Progress of the run written to -metrics_file and maps of the fields to images
+	liveMetrics myMetrics(myDescriptor.problemName,gridType,interpScheme,Nt-1,dt);
+	insituRenderer myRenderer(myDescriptor.problemName,myState.pairName,gridType,interpScheme,Nt-1,
+		dx,dy,myState.idU,myState.idV,myState.idP);
+
+	for(timeStep=0; timeStep<Nt-1; timeStep++)
+	{
+		// Assembly of the independent terms array
+		if(!isDouble) myIndependentTerms.assemblyIndependentTermsArray(dx,dy,dt,G,lambda,
+			myState.alpha,K,mu_f,myState.Q,myState.rho,g,myState.uField,myState.vField,
+			myState.pField,0);
+		else myIndependentTerms.assemblyMacroIndependentTermsArray(dx,dy,dt,G,lambda,
+			myState.alpha,K,mu_f,myState.S11,0,0,myState.uField,myState.vField,myState.pField,
+			myState.pMField,0,myState.phi,myState.phiFrac,myState.KFrac,myState.S12,myState.S22);
+		if(myDescriptor.independentTermsLoad)
+			myDescriptor.independentTermsLoad(myState,myIndependentTerms);
+
+		// Solution of the linear system
+		ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
+		ierr=myLinearSystemSolver.setRHSValue(myIndependentTerms.independentTermsArray);
+			CHKERRQ(ierr);
+		if(find(operatorExportSteps.begin(),operatorExportSteps.end(),timeStep)!=
+			operatorExportSteps.end())
+		{
+			ierr=myLinearSystemSolver.exportIndependentTerms(operatorName,timeStep);CHKERRQ(ierr);
+		}
+		ierr=myLinearSystemSolver.solveLinearSystem();CHKERRQ(ierr);
+		ierr=myLinearSystemSolver.getSolutionArray(solutionArray);CHKERRQ(ierr);
+
+		// Passing solutions
+		mySolutionHistory.storeSnapshot(solutionArray);
+		if(!isDouble) mySolutionHistory.splitSnapshot(solutionArray.data(),myState.uField,
+			myState.vField,myState.pField);
+		else mySolutionHistory.splitSnapshot(solutionArray.data(),myState.uField,myState.vField,
+			myState.pField,myState.pMField);
+		ierr=myLinearSystemSolver.zeroPETScArrays();CHKERRQ(ierr);
+
+		myMetrics.update(timeStep+1,myLinearSystemSolver);
+		myRenderer.update(timeStep+1,myState.uField,myState.vField,myState.pField);
+		cout << timeStep+1<< "\r";
+	}
+
+	cout << myDescriptor.Ny << "x" << myDescriptor.Nx << "x" << Nt-1 << " ";
+	cout << "(h=" << myState.h << ", dt=" << dt << ")\n";
+
+	// Pressure oscillation of the last time-step
+	myState.pressureOscillation=getPressureOscillation(myState.pField,myState.idP);
+	precisionScreening::lastOscillation=myState.pressureOscillation;
+	if(mySolutionHistory.compression!="none") cout << "History (" <<
+		mySolutionHistory.compression << "): " << mySolutionHistory.getStoredBytes() << " of " <<
+		mySolutionHistory.getRawBytes() << " bytes\n";
+	numaPlacement::printBandwidthReport();
+	if(operatorExportNo>0) exportOperatorManifest(myState,operatorName,myCellOrdering,
+		myLinearSystemSolver.coefficientsMatrix.size(),
+		myLinearSystemSolver.sparseCoefficientsValue.size(),operatorExportSteps);
+
+/*		DATA PROCESSING
+	----------------------------------------------------------------*/
+
+	PetscInt fieldExport=1;
+	PetscOptionsGetInt(NULL,NULL,"-field_export",&fieldExport,NULL);
+
+	myState.history=&mySolutionHistory;
+	if(fieldExport) for(int i=0; i<myDescriptor.exporters.size(); i++)
+		myDescriptor.exporters[i](myState);
+
+	// The observers may pass results to objects of the caller, which outlive the run arena
+	runArenaBypass myBypass;
+	for(int i=0; i<myDescriptor.observers.size(); i++) myDescriptor.observers[i](myState);
+	myState.history=NULL;
+
+	return ierr;
+};
@@ -0,0 +1,903 @@
+/*
+	This header is part of the development of a master's thesis entitled "Analysis of Numerical
+	Schemes in Collocated and Staggered Grids for Problems of Poroelasticity". The class defined
+	here stores the time history of the solution as one contiguous block per time-step, holding
+	the whole solution array of that time-step, instead of one vector per unknown.
+
+	Blocks may be stored raw ("none"), in double or, for the runs in single precision, in single
+	precision, or compressed. The lossless compression ("lossless") XORs
+	each value with the one of the previous time-step, groups the bytes of same significance
+	(byte-shuffle), collapses runs of zero bytes and codes the result with canonical Huffman
+	codes. The lossy compression ("lossy") quantizes the difference to the previous (decoded)
+	time-step with an error bound relative to the largest value of each variable, then applies the
+	same coding to the quantized integers. Every keyframeInterval time-steps a block is coded
+	without reference to the previous one, bounding the cost of random access. The compressed
+	blocks of a run in single precision are coded from the values rounded to single precision,
+	whose last 29 bits of mantissa are zero and are removed by the coding.
+
+	With -history_file the blocks are not kept in memory but appended to a file, through a buffer
+	flushed in page aligned writes, and read back from a read-only memory map, so the memory used
+	does not grow with the number of time-steps. The file starts with a header page (magic
+	"GFVHIST1", then as 64 bit fields n, snapshotsNo, number of variables, compression (0 none, 1
+	lossless, 2 lossy, 3 none in single precision), tolerance, keyframeInterval, offset of the
+	block index and the size of each variable), followed by the blocks and by the index (offset and
+	length of each block). Raw blocks are contiguous from the end of the header page, so other
+	tools may map them directly as a snapshotsNo x n array of double (of float with compression 3).
+	Blocks read while the file is still being written are copied from the file and from the buffer,
+	so the file stays open to the snapshots that follow. A file is only opened if its header, its
+	index and its blocks lie within it.
+
+ 	Written by FERREIRA, C. A. S.
+
+ 	Florianópolis, 2019.
+*/
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <limits.h>
+#include <iostream>
+#include <math.h>
+#include <queue>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+class solutionHistory
+{
+public:
+	// Class variables
+	int n;
+	int Nt;
+	string compression;
+	bool singlePrecision=false;
+	PetscReal tolerance=1e-6;
+	PetscInt keyframeInterval=16;
+	vector<int> blockSizes;
+	int snapshotsNo;
+	vector<vector<unsigned char>> snapshotBlocks;
+	vector<double> previousSnapshot;
+	vector<double> cachedSnapshot;
+	int cachedTimeStep;
+	static const int maxCodeLength=24;
+
+	// File storage variables
+	string fileName;
+	int fileDescriptor=-1;
+	bool fileWriting=false;
+	unsigned char* mappedFile=NULL;
+	size_t mappedBytes=0;
+	vector<unsigned char> encodedBlock;
+	vector<unsigned char> writeBuffer;
+	vector<unsigned char> readBlock;
+	size_t writtenBytes=0;
+	vector<size_t> blockOffsets;
+	vector<size_t> blockLengths;
+	static const size_t headerBytes=4096;
+	static const size_t writeBufferBytes=1<<22;
+
+	// Class functions
+	void storeSnapshot(vector<double>);
+	vector<double>& getSnapshot(int);
+	const double* getSnapshotView(int);
+	const unsigned char* getBlock(int);
+	size_t getBlockLength(int);
+	double getValue(int,int);
+	vector<vector<double>> getField(int,int);
+	template<class scalar> vector<double> joinFields(vector<vector<scalar>>&,
+		vector<vector<scalar>>&,vector<vector<scalar>>&,int);
+	template<class scalar> vector<double> joinFields(vector<vector<scalar>>&,
+		vector<vector<scalar>>&,vector<vector<scalar>>&,vector<vector<scalar>>&,int);
+	bool createFile(string);
+	void appendToFile(const unsigned char*,size_t);
+	void flushWriteBuffer(bool);
+	void finishFile();
+	bool mapFile();
+	bool openFile(string);
+	template<class scalar> void splitSnapshot(const double*,vector<vector<scalar>>&,
+		vector<vector<scalar>>&,vector<vector<scalar>>&);
+	template<class scalar> void splitSnapshot(const double*,vector<vector<scalar>>&,
+		vector<vector<scalar>>&,vector<vector<scalar>>&,vector<vector<scalar>>&);
+	size_t getStoredBytes();
+	size_t getRawBytes();
+	bool isKeyframe(int);
+	void encodeSnapshot(vector<double>&,vector<unsigned char>&);
+	void decodeSnapshot(int,vector<double>&);
+	void shuffleBytes(vector<uint64_t>&,vector<unsigned char>&);
+	void unshuffleBytes(vector<unsigned char>&,vector<uint64_t>&);
+	void encodeZeroRuns(vector<unsigned char>&,vector<unsigned char>&);
+	void decodeZeroRuns(vector<unsigned char>&,vector<unsigned char>&);
+	void getCodeLengths(vector<size_t>,vector<int>&);
+	void getCanonicalCodes(vector<int>&,vector<uint32_t>&);
+	void huffmanEncode(vector<unsigned char>&,vector<unsigned char>&);
+	void huffmanDecode(const unsigned char*,vector<unsigned char>&);
+
+	// Constructor
+	solutionHistory(vector<int>,int,bool=false);
+	solutionHistory(string);
+
+	// Destructor
+	~solutionHistory();
+};
+
+solutionHistory::solutionHistory(vector<int> myBlockSizes, int myNt, bool mySinglePrecision)
+{
+	// Block sizes are the number of unknowns of each variable ({Nu,Nv,NP}), ordered as in the
+	// solution array, and the snapshots are stored in single precision for the runs in single
+	// precision
+	char myCompression[PETSC_MAX_PATH_LEN]="none";
+	char myFileName[PETSC_MAX_PATH_LEN]="";
+
+	blockSizes=myBlockSizes;
+	Nt=myNt;
+	singlePrecision=mySinglePrecision;
+	n=0;
+	for(int b=0; b<blockSizes.size(); b++) n+=blockSizes[b];
+
+	PetscOptionsGetString(NULL,NULL,"-history_compression",myCompression,PETSC_MAX_PATH_LEN,NULL);
+	PetscOptionsGetReal(NULL,NULL,"-history_tolerance",&tolerance,NULL);
+	PetscOptionsGetInt(NULL,NULL,"-history_keyframe",&keyframeInterval,NULL);
+	compression=myCompression;
+	if(compression!="none" && compression!="lossless" && compression!="lossy")
+	{
+		cout << "Unknown history compression " << compression << ", using none\n";
+		compression="none";
+	}
+	if(keyframeInterval<1) keyframeInterval=1;
+
+	snapshotsNo=0;
+	cachedTimeStep=-1;
+
+	PetscOptionsGetString(NULL,NULL,"-history_file",myFileName,PETSC_MAX_PATH_LEN,NULL);
+	if(string(myFileName)=="" || !createFile(myFileName)) snapshotBlocks.reserve(Nt);
+}
+
+solutionHistory::solutionHistory(string myFileName)
+{
+	// Read-only access to a history file written by a previous run
+	n=0;
+	Nt=0;
+	snapshotsNo=0;
+	compression="none";
+	cachedTimeStep=-1;
+
+	if(openFile(myFileName)) Nt=snapshotsNo;
+}
+
+solutionHistory::~solutionHistory()
+{
+	if(fileWriting) finishFile();
+	if(mappedFile!=NULL) munmap(mappedFile,mappedBytes);
+	if(fileDescriptor>=0) close(fileDescriptor);
+}
+
+void solutionHistory::storeSnapshot(vector<double> snapshot)
+{
+	// Snapshots are stored in time order, starting from the initial condition
+	if(fileDescriptor>=0 && !fileWriting)
+	{
+		cout << "History file " << fileName << " is closed, snapshot not stored\n";
+
+		return;
+	}
+
+	if(compression=="none" && singlePrecision)
+	{
+		encodedBlock.resize(n*sizeof(float));
+		for(int i=0; i<n; i++)
+		{
+			float value=snapshot[i];
+			memcpy(encodedBlock.data()+i*sizeof(float),&value,sizeof(float));
+		}
+	}
+	else if(compression=="none")
+	{
+		encodedBlock.resize(n*sizeof(double));
+		memcpy(encodedBlock.data(),snapshot.data(),n*sizeof(double));
+	}
+	else
+	{
+		if(singlePrecision) for(int i=0; i<n; i++) snapshot[i]=(float)snapshot[i];
+		encodeSnapshot(snapshot,encodedBlock);
+	}
+
+	if(fileWriting) appendToFile(encodedBlock.data(),encodedBlock.size());
+	else
+	{
+		snapshotBlocks.push_back(encodedBlock);
+		snapshotBlocks.back().shrink_to_fit();
+	}
+	snapshotsNo++;
+
+	return;
+}
+
+vector<double>& solutionHistory::getSnapshot(int timeStep)
+{
+	// The last decoded snapshot is cached, so sequential access decodes each block once
+	int firstTimeStep;
+
+	if(timeStep==cachedTimeStep) return cachedSnapshot;
+
+	if(compression=="none")
+	{
+		const unsigned char* block=getBlock(timeStep);
+
+		cachedSnapshot.resize(n);
+		if(!singlePrecision) memcpy(cachedSnapshot.data(),block,n*sizeof(double));
+		else for(int i=0; i<n; i++)
+		{
+			float value;
+			memcpy(&value,block+i*sizeof(float),sizeof(float));
+			cachedSnapshot[i]=value;
+		}
+		cachedTimeStep=timeStep;
+
+		return cachedSnapshot;
+	}
+
+	firstTimeStep=timeStep-timeStep%keyframeInterval;
+	if(cachedTimeStep>=firstTimeStep && cachedTimeStep<timeStep) firstTimeStep=cachedTimeStep+1;
+
+	for(int t=firstTimeStep; t<=timeStep; t++) decodeSnapshot(t,cachedSnapshot);
+	cachedTimeStep=timeStep;
+
+	return cachedSnapshot;
+}
+
+const double* solutionHistory::getSnapshotView(int timeStep)
+{
+	// Raw blocks in double precision are read in place (from the memory map, when stored in a
+	// file), the others are decoded first
+	if(compression=="none" && !singlePrecision) return (const double*)getBlock(timeStep);
+
+	return getSnapshot(timeStep).data();
+}
+
+const unsigned char* solutionHistory::getBlock(int timeStep)
+{
+	// While the file is written the part of the block already flushed is read from the file and
+	// the rest from the write buffer
+	size_t offset, length, flushedLength, done=0;
+	ssize_t bytesRead;
+
+	if(fileDescriptor<0) return snapshotBlocks[timeStep].data();
+	if(!fileWriting) return mappedFile+blockOffsets[timeStep];
+
+	offset=blockOffsets[timeStep];
+	length=blockLengths[timeStep];
+	flushedLength=(offset<writtenBytes) ? min(length,writtenBytes-offset) : 0;
+	readBlock.resize(length);
+	while(done<flushedLength)
+	{
+		bytesRead=pread(fileDescriptor,readBlock.data()+done,flushedLength-done,offset+done);
+		if(bytesRead<=0)
+		{
+			cout << "Unable to read " << fileName << "\n";
+			break;
+		}
+		done+=bytesRead;
+	}
+	if(flushedLength<length) memcpy(readBlock.data()+flushedLength,
+		writeBuffer.data()+offset+flushedLength-writtenBytes,length-flushedLength);
+
+	return readBlock.data();
+}
+
+size_t solutionHistory::getBlockLength(int timeStep)
+{
+	if(fileDescriptor<0) return snapshotBlocks[timeStep].size();
+
+	return blockLengths[timeStep];
+}
+
+double solutionHistory::getValue(int position, int timeStep)
+{
+	return getSnapshot(timeStep)[position];
+}
+
+vector<vector<double>> solutionHistory::getField(int firstPosition, int positionsNo)
+{
+	// Unknown-major copy of part of the history, as used by the remaining functions of the library
+	vector<vector<double>> myField(positionsNo,vector<double>(snapshotsNo));
+
+	for(int t=0; t<snapshotsNo; t++)
+	{
+		const double* snapshot=getSnapshotView(t);
+		for(int i=0; i<positionsNo; i++) myField[i][t]=snapshot[firstPosition+i];
+	}
+
+	return myField;
+}
+
+template<class scalar>
+vector<double> solutionHistory::joinFields(vector<vector<scalar>>& uField,
+	vector<vector<scalar>>& vField, vector<vector<scalar>>& pField, int timeStep)
+{
+	vector<double> snapshot;
+
+	snapshot.reserve(n);
+	for(int i=0; i<uField.size(); i++) snapshot.push_back(uField[i][timeStep]);
+	for(int i=0; i<vField.size(); i++) snapshot.push_back(vField[i][timeStep]);
+	for(int i=0; i<pField.size(); i++) snapshot.push_back(pField[i][timeStep]);
+
+	return snapshot;
+}
+
+template<class scalar>
+vector<double> solutionHistory::joinFields(vector<vector<scalar>>& uField,
+	vector<vector<scalar>>& vField, vector<vector<scalar>>& pField,
+	vector<vector<scalar>>& pMField, int timeStep)
+{
+	vector<double> snapshot=joinFields(uField,vField,pField,timeStep);
+
+	for(int i=0; i<pMField.size(); i++) snapshot.push_back(pMField[i][timeStep]);
+
+	return snapshot;
+}
+
+template<class scalar>
+void solutionHistory::splitSnapshot(const double* snapshot, vector<vector<scalar>>& uField,
+	vector<vector<scalar>>& vField, vector<vector<scalar>>& pField)
+{
+	// Fields with a single time-step, holding the given snapshot rounded to the scalar type of
+	// the fields
+	int Nu=blockSizes[0];
+	int Nv=blockSizes[1];
+	int NP=blockSizes[2];
+
+	uField.resize(Nu);
+	vField.resize(Nv);
+	pField.resize(NP);
+	for(int i=0; i<Nu; i++) uField[i].assign(1,snapshot[i]);
+	for(int i=0; i<Nv; i++) vField[i].assign(1,snapshot[Nu+i]);
+	for(int i=0; i<NP; i++) pField[i].assign(1,snapshot[Nu+Nv+i]);
+
+	return;
+}
+
+template<class scalar>
+void solutionHistory::splitSnapshot(const double* snapshot, vector<vector<scalar>>& uField,
+	vector<vector<scalar>>& vField, vector<vector<scalar>>& pField,
+	vector<vector<scalar>>& pMField)
+{
+	// Double porosity snapshots hold the macro-pressure after the pressure
+	int position=blockSizes[0]+blockSizes[1]+blockSizes[2];
+	int NPM=blockSizes[3];
+
+	splitSnapshot(snapshot,uField,vField,pField);
+	pMField.resize(NPM);
+	for(int i=0; i<NPM; i++) pMField[i].assign(1,snapshot[position+i]);
+
+	return;
+}
+
+size_t solutionHistory::getStoredBytes()
+{
+	size_t bytesNo=0;
+
+	for(int t=0; t<snapshotsNo; t++) bytesNo+=getBlockLength(t);
+
+	return bytesNo;
+}
+
+size_t solutionHistory::getRawBytes()
+{
+	return snapshotsNo*n*sizeof(double);
+}
+
+bool solutionHistory::createFile(string myFileName)
+{
+	fileName=myFileName;
+	fileDescriptor=open(fileName.c_str(),O_RDWR|O_CREAT|O_TRUNC,0644);
+	if(fileDescriptor<0)
+	{
+		cout << "Unable to create " << fileName << ", history kept in memory\n";
+
+		return false;
+	}
+
+	// The header page is written when the file is finished
+	fileWriting=true;
+	writtenBytes=headerBytes;
+	writeBuffer.reserve(writeBufferBytes+headerBytes);
+
+	return true;
+}
+
+void solutionHistory::appendToFile(const unsigned char* block, size_t length)
+{
+	blockOffsets.push_back(writtenBytes+writeBuffer.size());
+	blockLengths.push_back(length);
+
+	writeBuffer.insert(writeBuffer.end(),block,block+length);
+	if(writeBuffer.size()>=writeBufferBytes) flushWriteBuffer(false);
+
+	return;
+}
+
+void solutionHistory::flushWriteBuffer(bool lastFlush)
+{
+	// Only whole pages are written, the remainder waits for the next flush unless it is the last
+	size_t length=writeBuffer.size();
+	size_t done=0;
+	ssize_t written;
+
+	if(!lastFlush) length-=length%headerBytes;
+
+	while(done<length)
+	{
+		written=pwrite(fileDescriptor,writeBuffer.data()+done,length-done,writtenBytes+done);
+		if(written<=0)
+		{
+			cout << "Unable to write " << fileName << "\n";
+			break;
+		}
+		done+=written;
+	}
+
+	writtenBytes+=done;
+	writeBuffer.erase(writeBuffer.begin(),writeBuffer.begin()+done);
+
+	return;
+}
+
+void solutionHistory::finishFile()
+{
+	// Appends the block index, writes the header and maps the file for reading
+	vector<unsigned char> header(headerBytes,0);
+	vector<int64_t> fields;
+	int64_t indexOffset=writtenBytes+writeBuffer.size();
+	int64_t entry[2];
+
+	for(int t=0; t<snapshotsNo; t++)
+	{
+		entry[0]=blockOffsets[t];
+		entry[1]=blockLengths[t];
+		writeBuffer.insert(writeBuffer.end(),(unsigned char*)entry,
+			(unsigned char*)entry+sizeof(entry));
+	}
+	flushWriteBuffer(true);
+	writeBuffer.clear();
+	writeBuffer.shrink_to_fit();
+
+	fields={n,snapshotsNo,(int64_t)blockSizes.size(),
+		(compression=="none") ? (singlePrecision ? 3 : 0) : (compression=="lossless") ? 1 : 2,0,
+		keyframeInterval,
+		indexOffset};
+	memcpy(&fields[4],&tolerance,sizeof(double));
+	for(int b=0; b<blockSizes.size(); b++) fields.push_back(blockSizes[b]);
+	memcpy(header.data(),"GFVHIST1",8);
+	memcpy(header.data()+8,fields.data(),fields.size()*sizeof(int64_t));
+	if(pwrite(fileDescriptor,header.data(),headerBytes,0)!=headerBytes)
+		cout << "Unable to write " << fileName << "\n";
+
+	fileWriting=false;
+	mapFile();
+
+	return;
+}
+
+bool solutionHistory::mapFile()
+{
+	struct stat fileStatus;
+
+	if(fstat(fileDescriptor,&fileStatus)!=0) return false;
+	mappedBytes=fileStatus.st_size;
+	mappedFile=(unsigned char*)mmap(NULL,mappedBytes,PROT_READ,MAP_SHARED,fileDescriptor,0);
+	if(mappedFile==MAP_FAILED)
+	{
+		cout << "Unable to map " << fileName << "\n";
+		mappedFile=NULL;
+
+		return false;
+	}
+
+	return true;
+}
+
+bool solutionHistory::openFile(string myFileName)
+{
+	int64_t fields[7];
+	int64_t blocksNo, blockSize, entry[2], blockSizesSum=0;
+	double myTolerance;
+	bool validFile;
+
+	fileName=myFileName;
+	fileDescriptor=open(fileName.c_str(),O_RDONLY);
+	if(fileDescriptor<0 || !mapFile() || mappedBytes<headerBytes ||
+		memcmp(mappedFile,"GFVHIST1",8)!=0)
+	{
+		cout << "Unable to read history file " << fileName << "\n";
+
+		return false;
+	}
+
+	// The header is not trusted, the index and the blocks must lie within the mapped file
+	memcpy(fields,mappedFile+8,sizeof(fields));
+	blocksNo=fields[2];
+	validFile=fields[0]>=0 && fields[0]<=INT_MAX && fields[1]>=0 && fields[1]<=INT_MAX &&
+		fields[3]>=0 && fields[3]<=3 && blocksNo>=0 &&
+		blocksNo<=(int64_t)((headerBytes-8-sizeof(fields))/sizeof(int64_t)) &&
+		fields[6]>=(int64_t)headerBytes && fields[6]<=(int64_t)mappedBytes &&
+		fields[1]<=(int64_t)((mappedBytes-fields[6])/sizeof(entry));
+	for(int b=0; validFile && b<blocksNo; b++)
+	{
+		memcpy(&blockSize,mappedFile+8+sizeof(fields)+b*sizeof(int64_t),sizeof(int64_t));
+		validFile=blockSize>=0 && blockSize<=fields[0];
+		blockSizesSum+=blockSize;
+		blockSizes.push_back(blockSize);
+	}
+	validFile=validFile && blockSizesSum==fields[0];
+	for(int t=0; validFile && t<fields[1]; t++)
+	{
+		memcpy(entry,mappedFile+fields[6]+t*sizeof(entry),sizeof(entry));
+		validFile=entry[0]>=(int64_t)headerBytes && entry[1]>=0 && entry[0]<=fields[6] &&
+			entry[1]<=fields[6]-entry[0] &&
+			(fields[3]!=0 || entry[1]==fields[0]*(int64_t)sizeof(double)) &&
+			(fields[3]!=3 || entry[1]==fields[0]*(int64_t)sizeof(float));
+		blockOffsets.push_back(entry[0]);
+		blockLengths.push_back(entry[1]);
+	}
+	if(!validFile)
+	{
+		cout << "History file " << fileName << " is corrupted, its index or blocks exceed the " <<
+			"file\n";
+		blockSizes.clear();
+		blockOffsets.clear();
+		blockLengths.clear();
+
+		return false;
+	}
+
+	n=fields[0];
+	snapshotsNo=fields[1];
+	compression=(fields[3]==0 || fields[3]==3) ? "none" : (fields[3]==1) ? "lossless" : "lossy";
+	singlePrecision=(fields[3]==3);
+	memcpy(&myTolerance,&fields[4],sizeof(double));
+	tolerance=myTolerance;
+	keyframeInterval=max(fields[5],(int64_t)1);
+
+	return true;
+}
+
+bool solutionHistory::isKeyframe(int timeStep)
+{
+	return timeStep%keyframeInterval==0;
+}
+
+void solutionHistory::encodeSnapshot(vector<double>& snapshot, vector<unsigned char>& block)
+{
+	int timeStep=snapshotsNo;
+	bool keyframe=isKeyframe(timeStep);
+	vector<uint64_t> residuals(n);
+	vector<unsigned char> shuffled, runs;
+	vector<double> bounds(blockSizes.size(),0);
+	uint64_t bits, previousBits;
+	int64_t quantized;
+	double prediction, quantum, maxValue;
+	int position;
+
+	if(keyframe) previousSnapshot.assign(n,0);
+
+	if(compression=="lossless")
+	{
+		for(int i=0; i<n; i++)
+		{
+			memcpy(&bits,&snapshot[i],sizeof(double));
+			memcpy(&previousBits,&previousSnapshot[i],sizeof(double));
+			residuals[i]=bits^previousBits;
+		}
+		previousSnapshot=snapshot;
+	}
+	else
+	{
+		// Quantized differences to the previous decoded snapshot, zigzag mapped to unsigned
+		position=0;
+		for(int b=0; b<blockSizes.size(); b++)
+		{
+			maxValue=0;
+			for(int i=position; i<position+blockSizes[b]; i++)
+				maxValue=max(maxValue,fabs(snapshot[i]));
+			bounds[b]=tolerance*maxValue;
+			quantum=2*bounds[b];
+
+			for(int i=position; i<position+blockSizes[b]; i++)
+			{
+				prediction=previousSnapshot[i];
+				quantized=(quantum>0) ? llround((snapshot[i]-prediction)/quantum) : 0;
+				residuals[i]=((uint64_t)quantized<<1)^(uint64_t)(quantized>>63);
+				previousSnapshot[i]=(quantum>0) ? prediction+quantized*quantum : 0;
+			}
+			position+=blockSizes[b];
+		}
+	}
+
+	shuffleBytes(residuals,shuffled);
+	encodeZeroRuns(shuffled,runs);
+
+	block.clear();
+	if(compression=="lossy")
+	{
+		block.resize(bounds.size()*sizeof(double));
+		memcpy(block.data(),bounds.data(),bounds.size()*sizeof(double));
+	}
+	huffmanEncode(runs,block);
+
+	return;
+}
+
+void solutionHistory::decodeSnapshot(int timeStep, vector<double>& snapshot)
+{
+	// Requires the snapshot of the previous time-step in snapshot, unless timeStep is a keyframe
+	vector<uint64_t> residuals;
+	vector<unsigned char> runs, shuffled;
+	vector<double> bounds(blockSizes.size(),0);
+	const unsigned char* block=getBlock(timeStep);
+	size_t offset=0;
+	uint64_t bits, previousBits;
+	int64_t quantized;
+	double quantum;
+	int position;
+
+	if(isKeyframe(timeStep)) snapshot.assign(n,0);
+
+	if(compression=="lossy")
+	{
+		offset=bounds.size()*sizeof(double);
+		memcpy(bounds.data(),block,offset);
+	}
+	huffmanDecode(block+offset,runs);
+	decodeZeroRuns(runs,shuffled);
+	unshuffleBytes(shuffled,residuals);
+
+	if(compression=="lossless")
+	{
+		for(int i=0; i<n; i++)
+		{
+			memcpy(&previousBits,&snapshot[i],sizeof(double));
+			bits=residuals[i]^previousBits;
+			memcpy(&snapshot[i],&bits,sizeof(double));
+		}
+	}
+	else
+	{
+		position=0;
+		for(int b=0; b<blockSizes.size(); b++)
+		{
+			quantum=2*bounds[b];
+			for(int i=position; i<position+blockSizes[b]; i++)
+			{
+				quantized=(int64_t)((residuals[i]>>1)^(~(residuals[i]&1)+1));
+				snapshot[i]=(quantum>0) ? snapshot[i]+quantized*quantum : 0;
+			}
+			position+=blockSizes[b];
+		}
+	}
+
+	return;
+}
+
+void solutionHistory::shuffleBytes(vector<uint64_t>& values, vector<unsigned char>& shuffled)
+{
+	// Byte k of every value is stored in the k-th plane, so the (mostly zero) high-order bytes of
+	// the residuals become long runs
+	int valuesNo=values.size();
+
+	shuffled.resize(8*valuesNo);
+	for(int k=0; k<8; k++)
+		for(int i=0; i<valuesNo; i++)
+			shuffled[k*valuesNo+i]=(values[i]>>(8*(7-k)))&0xFF;
+
+	return;
+}
+
+void solutionHistory::unshuffleBytes(vector<unsigned char>& shuffled, vector<uint64_t>& values)
+{
+	int valuesNo=shuffled.size()/8;
+
+	values.assign(valuesNo,0);
+	for(int k=0; k<8; k++)
+		for(int i=0; i<valuesNo; i++)
+			values[i]|=(uint64_t)shuffled[k*valuesNo+i]<<(8*(7-k));
+
+	return;
+}
+
+void solutionHistory::encodeZeroRuns(vector<unsigned char>& bytes, vector<unsigned char>& runs)
+{
+	// A zero byte is followed by the length of its run minus one (up to 256 zeros)
+	size_t i=0, runLength;
+
+	runs.clear();
+	while(i<bytes.size())
+	{
+		runs.push_back(bytes[i]);
+		if(bytes[i]==0)
+		{
+			runLength=1;
+			while(i+runLength<bytes.size() && bytes[i+runLength]==0 && runLength<256) runLength++;
+			runs.push_back(runLength-1);
+			i+=runLength;
+		}
+		else i++;
+	}
+
+	return;
+}
+
+void solutionHistory::decodeZeroRuns(vector<unsigned char>& runs, vector<unsigned char>& bytes)
+{
+	bytes.clear();
+	bytes.reserve(8*n);
+
+	for(size_t i=0; i<runs.size(); i++)
+	{
+		if(runs[i]==0)
+		{
+			bytes.insert(bytes.end(),runs[i+1]+1,0);
+			i++;
+		}
+		else bytes.push_back(runs[i]);
+	}
+
+	return;
+}
+
+void solutionHistory::getCodeLengths(vector<size_t> frequencies, vector<int>& codeLengths)
+{
+	// Huffman tree built with a priority queue; frequencies are halved until no code is longer
+	// than maxCodeLength
+	typedef pair<size_t,int> node;
+	vector<int> parents;
+	int symbolsNo=frequencies.size();
+	int usedNo, maxLength;
+
+	while(true)
+	{
+		priority_queue<node,vector<node>,greater<node>> myQueue;
+
+		parents.assign(symbolsNo,-1);
+		codeLengths.assign(symbolsNo,0);
+		usedNo=0;
+		for(int s=0; s<symbolsNo; s++)
+			if(frequencies[s]>0)
+			{
+				myQueue.push(node(frequencies[s],s));
+				usedNo++;
+			}
+
+		// A single symbol still needs one bit
+		if(usedNo==1)
+		{
+			for(int s=0; s<symbolsNo; s++) if(frequencies[s]>0) codeLengths[s]=1;
+
+			return;
+		}
+
+		while(myQueue.size()>1)
+		{
+			node first=myQueue.top();myQueue.pop();
+			node second=myQueue.top();myQueue.pop();
+			parents.push_back(-1);
+			parents[first.second]=parents.size()-1;
+			parents[second.second]=parents.size()-1;
+			myQueue.push(node(first.first+second.first,parents.size()-1));
+		}
+
+		maxLength=0;
+		for(int s=0; s<symbolsNo; s++)
+		{
+			if(frequencies[s]==0) continue;
+			for(int a=parents[s]; a!=-1; a=parents[a]) codeLengths[s]++;
+			maxLength=max(maxLength,codeLengths[s]);
+		}
+
+		if(maxLength<=maxCodeLength) return;
+
+		for(int s=0; s<symbolsNo; s++)
+			if(frequencies[s]>0) frequencies[s]=(frequencies[s]+1)/2;
+	}
+}
+
+void solutionHistory::getCanonicalCodes(vector<int>& codeLengths, vector<uint32_t>& codes)
+{
+	// Codes are assigned in order of length and then of symbol, so lengths alone define them
+	uint32_t code=0;
+
+	codes.assign(codeLengths.size(),0);
+	for(int length=1; length<=maxCodeLength; length++)
+	{
+		for(int s=0; s<codeLengths.size(); s++)
+			if(codeLengths[s]==length) codes[s]=code++;
+		code<<=1;
+	}
+
+	return;
+}
+
+void solutionHistory::huffmanEncode(vector<unsigned char>& bytes, vector<unsigned char>& block)
+{
+	vector<size_t> frequencies(256,0);
+	vector<int> codeLengths;
+	vector<uint32_t> codes;
+	uint32_t bytesNo=bytes.size();
+	uint64_t buffer=0;
+	int bufferLength=0;
+
+	for(size_t i=0; i<bytes.size(); i++) frequencies[bytes[i]]++;
+	getCodeLengths(frequencies,codeLengths);
+	getCanonicalCodes(codeLengths,codes);
+
+	// Header: number of coded bytes and the code length of each symbol
+	for(int k=0; k<4; k++) block.push_back((bytesNo>>(8*k))&0xFF);
+	for(int s=0; s<256; s++) block.push_back(codeLengths[s]);
+
+	for(size_t i=0; i<bytes.size(); i++)
+	{
+		buffer=(buffer<<codeLengths[bytes[i]])|codes[bytes[i]];
+		bufferLength+=codeLengths[bytes[i]];
+		while(bufferLength>=8)
+		{
+			bufferLength-=8;
+			block.push_back((buffer>>bufferLength)&0xFF);
+		}
+	}
+	if(bufferLength>0) block.push_back((buffer<<(8-bufferLength))&0xFF);
+
+	return;
+}
+
+void solutionHistory::huffmanDecode(const unsigned char* block, vector<unsigned char>& bytes)
+{
+	// Canonical decoding: the first code and the first symbol of each length locate the symbol
+	vector<int> codeLengths(256);
+	vector<uint32_t> firstCodes(maxCodeLength+2,0);
+	vector<int> firstSymbols(maxCodeLength+2,0), lengthCounts(maxCodeLength+2,0);
+	vector<unsigned char> sortedSymbols;
+	uint32_t bytesNo=0, code;
+	size_t bitPosition;
+	int length;
+
+	for(int k=0; k<4; k++) bytesNo|=(uint32_t)block[k]<<(8*k);
+	for(int s=0; s<256; s++) codeLengths[s]=block[4+s];
+	bitPosition=8*(4+256);
+
+	for(int l=1; l<=maxCodeLength; l++)
+		for(int s=0; s<256; s++)
+			if(codeLengths[s]==l)
+			{
+				sortedSymbols.push_back(s);
+				lengthCounts[l]++;
+			}
+
+	code=0;
+	for(int l=1; l<=maxCodeLength; l++)
+	{
+		firstCodes[l]=code;
+		firstSymbols[l+1]=firstSymbols[l]+lengthCounts[l];
+		code=(code+lengthCounts[l])<<1;
+	}
+
+	bytes.resize(bytesNo);
+	for(uint32_t i=0; i<bytesNo; i++)
+	{
+		code=0;
+		length=0;
+		do
+		{
+			code=(code<<1)|((block[bitPosition>>3]>>(7-(bitPosition&7)))&1);
+			bitPosition++;
+			length++;
+		} while(code-firstCodes[length]>=(uint32_t)lengthCounts[length]);
+
+		bytes[i]=sortedSymbols[firstSymbols[length]+code-firstCodes[length]];
+	}
+
+	return;
+}
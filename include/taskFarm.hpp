@@ -0,0 +1,486 @@
+/*
+	This header is part of the development of a master's thesis entitled "Analysis of Numerical
+	Schemes in Collocated and Staggered Grids for Problems of Poroelasticity". The class defined
+	here solves the cases of a sweep on many ranks of MPI as a master/worker task farm.
+
+	Rank 0 is the master: it drops the cases complete in the results manifest, sorts the others by
+	their estimated cost, largest first, and hands them out one at a time to the workers which ask
+	for work, so that the large meshes start early and the small ones fill the gaps at the end. The
+	workers solve their cases on PETSC_COMM_SELF, each in a scratch directory of its own (given by
+	-farm_scratch), where a results manifest of the worker records the values, the settings and the
+	files of the case. The record and the files are then sent to the master, which appends the
+	record to the results manifest and the files to a single tar archive of the export directory
+	(-farm_container, taskFarm.tar by default), named <hash of the case>/<file>, so that the files
+	of the cases never collide. The archive is valid after every file appended to it and a case is
+	complete while its files are in it. With a single rank the master solves the cases itself.
+
+ 	Written by FERREIRA, C. A. S.
+
+ 	Florianópolis, 2019.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <dirent.h>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+struct farmCase
+{
+	// Key of the case in the results manifest
+	string problemName;
+	string gridType;
+	string interpScheme;
+	string medium;
+	int meshSize;
+	int Nt;
+	double dt;
+
+	// Estimated cost, the number of unknowns times the number of time-steps
+	double cost;
+};
+
+class taskFarm
+{
+public:
+	// Class variables
+	static const int requestTag=1;
+	static const int caseTag=2;
+	static const int recordTag=3;
+	static const int fileTag=4;
+	int rank;
+	int ranksNo;
+	vector<farmCase> cases;
+	string scratchDirectory;
+	string containerName="taskFarm.tar";
+	string containerPath;
+	FILE* container=NULL;
+	long containerEnd=0;
+	set<string> containerHashes;
+	vector<int> rankCasesNo;
+	vector<double> rankSeconds;
+
+	// Class functions
+	void addCase(farmCase);
+	int run(function<int(const farmCase&)>,resultsManifest&);
+	int runMaster(function<int(const farmCase&)>,resultsManifest&);
+	int runWorker(function<int(const farmCase&)>);
+	string solveCase(const farmCase&,function<int(const farmCase&)>,resultsManifest&,
+		vector<string>&,vector<string>&);
+	void storeResult(int,string,vector<string>&,vector<string>&,resultsManifest&);
+	void sendString(const string&,int);
+	string receiveString(int,int);
+	bool openContainer(string);
+	void appendToContainer(string,const string&);
+	void closeContainer();
+	static void makeDirectory(string);
+	static vector<string> getOutputFiles(const string&);
+
+	// Constructor
+	taskFarm();
+
+	// Destructor
+	~taskFarm();
+};
+
+taskFarm::taskFarm()
+{
+	char myScratch[PETSC_MAX_PATH_LEN]="../export/taskFarmScratch";
+	char myContainer[PETSC_MAX_PATH_LEN]="taskFarm.tar";
+	char workingDirectory[PETSC_MAX_PATH_LEN];
+
+	MPI_Comm_rank(PETSC_COMM_WORLD,&rank);
+	MPI_Comm_size(PETSC_COMM_WORLD,&ranksNo);
+	PetscOptionsGetString(NULL,NULL,"-farm_scratch",myScratch,sizeof(myScratch),NULL);
+	PetscOptionsGetString(NULL,NULL,"-farm_container",myContainer,sizeof(myContainer),NULL);
+	containerName=myContainer;
+
+	// The workers change directory, so the scratch directory is made absolute
+	scratchDirectory=myScratch;
+	if(scratchDirectory[0]!='/' && getcwd(workingDirectory,sizeof(workingDirectory))!=NULL)
+		scratchDirectory=string(workingDirectory)+"/"+scratchDirectory;
+}
+
+taskFarm::~taskFarm()
+{
+	closeContainer();
+}
+
+void taskFarm::addCase(farmCase myCase)
+{
+	cases.push_back(myCase);
+
+	return;
+}
+
+void taskFarm::makeDirectory(string path)
+{
+	// Creates the directories of the path which do not exist yet
+	for(size_t position=path.find('/',1); position!=string::npos;
+		position=path.find('/',position+1)) mkdir(path.substr(0,position).c_str(),0755);
+	mkdir(path.c_str(),0755);
+
+	return;
+}
+
+vector<string> taskFarm::getOutputFiles(const string& record)
+{
+	// Files listed in the outputs of a record of the results manifest
+	vector<string> files;
+	size_t position=record.find("\"outputs\":[");
+	size_t end;
+
+	if(position==string::npos) return files;
+	end=record.find("],",position);
+	position=record.find("\"file\":\"",position);
+	while(position!=string::npos && position<end)
+	{
+		position+=7;
+		files.push_back(resultsManifest::readString(record,position));
+		position=record.find("\"file\":\"",position);
+	}
+
+	return files;
+}
+
+void taskFarm::sendString(const string& text, int tag)
+{
+	MPI_Send(text.data(),text.size(),MPI_CHAR,0,tag,PETSC_COMM_WORLD);
+
+	return;
+}
+
+string taskFarm::receiveString(int source, int tag)
+{
+	MPI_Status status;
+	int length;
+	string text;
+
+	MPI_Probe(source,tag,PETSC_COMM_WORLD,&status);
+	MPI_Get_count(&status,MPI_CHAR,&length);
+	text.resize(length);
+	MPI_Recv(&text[0],length,MPI_CHAR,source,tag,PETSC_COMM_WORLD,MPI_STATUS_IGNORE);
+
+	return text;
+}
+
+bool taskFarm::openContainer(string exportDirectory)
+{
+	// Reads the names of the archive and leaves containerEnd at its end-of-archive blocks
+	char header[512];
+	string name;
+	long size;
+
+	containerPath=exportDirectory+containerName;
+	container=fopen(containerPath.c_str(),"r+b");
+	if(container==NULL) container=fopen(containerPath.c_str(),"w+b");
+	if(container==NULL)
+	{
+		cout << "Unable to open " << containerPath << "\n";
+
+		return false;
+	}
+
+	containerEnd=0;
+	while(fseek(container,containerEnd,SEEK_SET)==0 && fread(header,1,512,container)==512 &&
+		header[0]!='\0')
+	{
+		name=string(header+345,strnlen(header+345,155));
+		if(name.empty()) name=string(header,strnlen(header,100));
+		else name+="/"+string(header,strnlen(header,100));
+		containerHashes.insert(name.substr(0,name.find('/')));
+
+		size=strtol(string(header+124,12).c_str(),NULL,8);
+		containerEnd+=512+(size+511)/512*512;
+	}
+
+	return true;
+}
+
+void taskFarm::appendToContainer(string entryName, const string& contents)
+{
+	// ustar entry written over the end-of-archive blocks, which are written again after it; the
+	// directory of the name (the hash of the case) goes to the prefix field
+	char header[512]={};
+	char zeros[1024]={};
+	size_t slash=entryName.find('/');
+	string prefix=entryName.substr(0,slash);
+	string name=entryName.substr(slash+1);
+	unsigned int checksum=0;
+
+	if(container==NULL) return;
+	if(name.size()>100 || prefix.size()>155)
+	{
+		cout << "File name too long for the archive: " << entryName << "\n";
+
+		return;
+	}
+
+	memcpy(header,name.data(),name.size());
+	snprintf(header+100,8,"%07o",0644);
+	snprintf(header+108,8,"%07o",0);
+	snprintf(header+116,8,"%07o",0);
+	snprintf(header+124,12,"%011lo",(unsigned long)contents.size());
+	snprintf(header+136,12,"%011lo",(unsigned long)time(NULL));
+	memset(header+148,' ',8);
+	header[156]='0';
+	memcpy(header+257,"ustar",6);
+	memcpy(header+263,"00",2);
+	memcpy(header+345,prefix.data(),prefix.size());
+	for(int i=0; i<512; i++) checksum+=(unsigned char)header[i];
+	snprintf(header+148,8,"%06o",checksum);
+	header[155]=' ';
+
+	fseek(container,containerEnd,SEEK_SET);
+	fwrite(header,1,512,container);
+	fwrite(contents.data(),1,contents.size(),container);
+	fwrite(zeros,1,(512-contents.size()%512)%512,container);
+	containerEnd+=512+(contents.size()+511)/512*512;
+	fwrite(zeros,1,1024,container);
+	fflush(container);
+	containerHashes.insert(prefix);
+
+	return;
+}
+
+void taskFarm::closeContainer()
+{
+	if(container!=NULL) fclose(container);
+	container=NULL;
+
+	return;
+}
+
+string taskFarm::solveCase(const farmCase& myCase, function<int(const farmCase&)> solve,
+	resultsManifest& myManifest, vector<string>& fileNames, vector<string>& fileContents)
+{
+	// Record of the case in the manifest of the scratch directory, empty if the run failed, and
+	// the files it exported, which are then removed from the scratch directory
+	string record;
+	int ierr;
+
+	fileNames.clear();
+	fileContents.clear();
+	myManifest.beginCase(myCase.problemName,myCase.gridType,myCase.interpScheme,myCase.medium,
+		myCase.meshSize,myCase.Nt,myCase.dt);
+	ierr=solve(myCase);
+	if(ierr==0)
+	{
+		myManifest.completeCase();
+		record=myManifest.lastRecords[myManifest.caseHash];
+		fileNames=getOutputFiles(record);
+		for(int i=0; i<fileNames.size(); i++)
+		{
+			ifstream inFile(myManifest.exportDirectory+fileNames[i],ios::binary);
+			fileContents.push_back(string(istreambuf_iterator<char>(inFile),
+				istreambuf_iterator<char>()));
+		}
+	}
+	else resultsManifest::openManifest=NULL;
+
+	map<string,exportedFile> files=myManifest.listExportedFiles();
+	for(map<string,exportedFile>::iterator file=files.begin(); file!=files.end(); file++)
+		remove((myManifest.exportDirectory+file->first).c_str());
+
+	return record;
+}
+
+void taskFarm::storeResult(int workerRank, string record, vector<string>& fileNames,
+	vector<string>& fileContents, resultsManifest& myManifest)
+{
+	string hash=resultsManifest::getField(record,"hash");
+	string status=",\"status\":\"complete\"";
+	size_t position=record.find(status);
+
+	if(record.empty() || position==string::npos)
+	{
+		cout << "Rank " << workerRank << ": case failed\n";
+
+		return;
+	}
+
+	for(int i=0; i<fileNames.size(); i++) appendToContainer(hash+"/"+fileNames[i],fileContents[i]);
+
+	// The files of the case are found in the archive
+	record.insert(position+status.size(),",\"container\":\""+resultsManifest::escape(
+		containerName)+"\"");
+	if(myManifest.enabled)
+	{
+		myManifest.appendRecord(record);
+		myManifest.lastRecords[hash]=record;
+	}
+
+	rankCasesNo[workerRank]++;
+	rankSeconds[workerRank]+=resultsManifest::getNumber(record,"seconds");
+	cout << "Rank " << workerRank << ": " << resultsManifest::getField(record,"problem") <<
+		" (" << resultsManifest::getField(record,"grid") << ", " <<
+		resultsManifest::getField(record,"scheme") << ", " <<
+		resultsManifest::getField(record,"medium") << ", mesh=" <<
+		resultsManifest::getNumber(record,"mesh") << ", dt=" <<
+		resultsManifest::getNumber(record,"dt") << ") complete\n";
+
+	return;
+}
+
+int taskFarm::runMaster(function<int(const farmCase&)> solve, resultsManifest& myManifest)
+{
+	vector<int> order;
+	int next=0;
+	int activeNo=ranksNo-1;
+	chrono::steady_clock::time_point start=chrono::steady_clock::now();
+
+	if(!openContainer(myManifest.exportDirectory)) return 1;
+
+	// Cases complete in the manifest whose files are in the archive are not solved again
+	for(int i=0; i<cases.size(); i++)
+	{
+		string hash=resultsManifest::getHash(myManifest.getCaseKey(cases[i].problemName,
+			cases[i].gridType,cases[i].interpScheme,cases[i].medium,cases[i].meshSize,cases[i].Nt,
+			cases[i].dt));
+		map<string,string>::iterator lastRecord=myManifest.lastRecords.find(hash);
+
+		if(myManifest.enabled && !myManifest.forced && lastRecord!=myManifest.lastRecords.end() &&
+			resultsManifest::getField(lastRecord->second,"status")=="complete" &&
+			resultsManifest::getField(lastRecord->second,"container")==containerName &&
+			containerHashes.count(hash)>0) continue;
+		order.push_back(i);
+	}
+	stable_sort(order.begin(),order.end(),[this](int a, int b)
+		{return cases[a].cost>cases[b].cost;});
+	cout << "Task farm: " << order.size() << " of " << cases.size() << " cases on " <<
+		max(ranksNo-1,1) << " workers, largest first\n";
+
+	rankCasesNo.assign(ranksNo,0);
+	rankSeconds.assign(ranksNo,0);
+
+	// Single rank, the master solves the cases in its scratch directory and stores them from its
+	// own working directory
+	if(ranksNo==1 && order.size()>0)
+	{
+		vector<string> fileNames, fileContents;
+		string workDirectory=scratchDirectory+"/rank0";
+		char workingDirectory[PETSC_MAX_PATH_LEN];
+
+		makeDirectory(workDirectory+"/build");
+		makeDirectory(workDirectory+"/export");
+		if(getcwd(workingDirectory,sizeof(workingDirectory))==NULL ||
+			chdir((workDirectory+"/build").c_str())!=0) return 1;
+		resultsManifest scratchManifest;
+		scratchManifest.enabled=true;
+		scratchManifest.forced=true;
+		for(int i=0; i<order.size(); i++)
+		{
+			if(chdir((workDirectory+"/build").c_str())!=0) return 1;
+			string record=solveCase(cases[order[i]],solve,scratchManifest,fileNames,fileContents);
+			if(chdir(workingDirectory)!=0) return 1;
+			storeResult(0,record,fileNames,fileContents,myManifest);
+		}
+	}
+
+	// Dynamic scheduling, the next case goes to the first worker which asks for one
+	while(activeNo>0)
+	{
+		MPI_Status status;
+		int source;
+
+		MPI_Probe(MPI_ANY_SOURCE,MPI_ANY_TAG,PETSC_COMM_WORLD,&status);
+		source=status.MPI_SOURCE;
+		if(status.MPI_TAG==requestTag)
+		{
+			int request, caseIndex=-1;
+
+			MPI_Recv(&request,1,MPI_INT,source,requestTag,PETSC_COMM_WORLD,MPI_STATUS_IGNORE);
+			if(next<order.size()) caseIndex=order[next++];
+			else activeNo--;
+			MPI_Send(&caseIndex,1,MPI_INT,source,caseTag,PETSC_COMM_WORLD);
+		}
+		else if(status.MPI_TAG==recordTag)
+		{
+			// The record, then the number of files and the name and contents of each
+			string record=receiveString(source,recordTag);
+			vector<string> fileNames, fileContents;
+			int filesNo;
+
+			MPI_Recv(&filesNo,1,MPI_INT,source,fileTag,PETSC_COMM_WORLD,MPI_STATUS_IGNORE);
+			for(int i=0; i<filesNo; i++)
+			{
+				fileNames.push_back(receiveString(source,fileTag));
+				fileContents.push_back(receiveString(source,fileTag));
+			}
+			storeResult(source,record,fileNames,fileContents,myManifest);
+		}
+	}
+	closeContainer();
+
+	// Balance of the farm
+	double seconds=chrono::duration<double>(chrono::steady_clock::now()-start).count();
+	cout << "Task farm finished in " << seconds << " s\n";
+	for(int i=(ranksNo>1); i<ranksNo; i++) cout << "Rank " << i << ": " << rankCasesNo[i] <<
+		" cases, " << rankSeconds[i] << " s busy (" << 100*rankSeconds[i]/max(seconds,1e-9) <<
+		"%)\n";
+
+	return 0;
+}
+
+int taskFarm::runWorker(function<int(const farmCase&)> solve)
+{
+	string workDirectory=scratchDirectory+"/rank"+to_string(rank);
+	vector<string> fileNames, fileContents;
+	int caseIndex;
+	int request=0;
+
+	// The exports of the worker go to its own directory, "../export/" of its working directory
+	makeDirectory(workDirectory+"/build");
+	makeDirectory(workDirectory+"/export");
+	if(chdir((workDirectory+"/build").c_str())!=0)
+	{
+		cout << "Rank " << rank << ": unable to enter " << workDirectory << "\n";
+		MPI_Abort(PETSC_COMM_WORLD,1);
+	}
+
+	resultsManifest scratchManifest;
+	scratchManifest.enabled=true;
+	scratchManifest.forced=true;
+
+	while(true)
+	{
+		MPI_Send(&request,1,MPI_INT,0,requestTag,PETSC_COMM_WORLD);
+		MPI_Recv(&caseIndex,1,MPI_INT,0,caseTag,PETSC_COMM_WORLD,MPI_STATUS_IGNORE);
+		if(caseIndex<0) break;
+
+		string record=solveCase(cases[caseIndex],solve,scratchManifest,fileNames,fileContents);
+		int filesNo=fileNames.size();
+
+		sendString(record,recordTag);
+		MPI_Send(&filesNo,1,MPI_INT,0,fileTag,PETSC_COMM_WORLD);
+		for(int i=0; i<filesNo; i++)
+		{
+			sendString(fileNames[i],fileTag);
+			sendString(fileContents[i],fileTag);
+		}
+	}
+
+	return 0;
+}
+
+int taskFarm::run(function<int(const farmCase&)> solve, resultsManifest& myManifest)
+{
+	// Every rank holds the same cases, so that only their index is sent
+	int ierr=(rank==0) ? runMaster(solve,myManifest) : runWorker(solve);
+
+	MPI_Barrier(PETSC_COMM_WORLD);
+
+	return ierr;
+}
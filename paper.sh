@@ -53,7 +53,6 @@ numRuns=${#gridType[@]}
 # echo ""
 
 # STABILITY
-rm -rf export/*
 export sourceName="mainStability"
 
 # COMPILE
@@ -68,6 +67,7 @@ problemsSolved+=8
 medium="abyssalRedClay";
 
 # RUN
+# Cases complete in export/manifest.jsonl are not solved again, delete it to solve them all
 echo "-- Testing method's stability"
 echo ""
 for ((i=0; i<numRuns; i++));
@@ -84,4 +84,3 @@ echo "-- Plotting results"
 # python3 -W ignore ./postpro/mandelPlotStabilityPaper.py ${medium}
 python3 -W ignore ./postpro/stripfootPlotStabilityPaper.py ${medium}
 echo ""
-rm -rf export/*
\ No newline at end of file
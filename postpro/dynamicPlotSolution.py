@@ -0,0 +1,64 @@
+"""
+	This source code is part of the development of a master's thesis entitled "Analysis of Numerical
+	Schemes in Collocated and Staggered Grids for Problems of Poroelasticity". The routine here
+	defined is used to plot the load and the vertical velocity of the surface under the strip of the
+	dynamic stripfoot problem, with the last snapshot of the pore pressure.
+
+	Written by FERREIRA, C. A. S.
+
+	Florianópolis, 2019.
+"""
+
+import numpy as np
+import pathlib
+import matplotlib.pyplot as plt
+import re
+import sys
+
+"""    PLOT RESULTS
+  ----------------------------------------------------------------"""
+
+# Get parent directory
+parentDirectory=pathlib.Path(__file__).resolve().parents[1]
+
+# Get medium and mesh
+medium=sys.argv[1]
+mesh=sys.argv[2] if len(sys.argv)>2 else "10"
+
+# Define figure's name
+plotName="plot/dynamic_"+medium+"_mesh="+mesh+"_staggered-grid.png"
+
+# Create and define figure's size and margins
+fig=plt.figure(figsize=(10,4))
+fig.subplots_adjust(top=0.88,bottom=0.15,left=0.08,right=0.92,wspace=0.4)
+
+# Plot load and surface velocity
+fileName=parentDirectory/("export/dynamic_"+medium+"_surfaceVelocity_mesh="+mesh+ \
+	"_staggered-grid.txt")
+time=np.loadtxt(fname=fileName,usecols=(0))
+load=np.loadtxt(fname=fileName,usecols=(1))
+velocity=np.loadtxt(fname=fileName,usecols=(2))
+fig.add_subplot(1,2,1)
+plt.plot(1e3*time,velocity,'-',color="#0d75f8")
+plt.xlabel('Time (ms)')
+plt.ylabel('Vertical velocity (m/s)')
+plt.grid(which='both',axis='both')
+axes=plt.gca().twinx()
+axes.plot(1e3*time,1e-3*load,'--',color="#fd411e")
+axes.set_ylabel('Load (kPa)')
+
+# Plot last snapshot of the pressure
+snapshots=list((parentDirectory/"export").glob("dynamic_"+medium+ \
+	"_PNumeric_timeStep=*_staggered-grid.txt"))
+snapshots.sort(key=lambda name:int(re.findall(r"timeStep=(\d+)",name.name)[0]))
+pressure=np.loadtxt(fname=snapshots[-1])
+fig.add_subplot(1,2,2)
+plt.imshow(1e-3*pressure,cmap="RdBu_r",extent=[0,20,0,20])
+plt.colorbar(label='Pressure (kPa)')
+plt.xlabel('x (m)')
+plt.ylabel('y (m)')
+
+# Save figure
+plt.savefig(plotName)
+
+print("Plotted dynamic stripfoot results")
@@ -0,0 +1,39 @@
+"""
+	This source code is part of the development of a master's thesis entitled "Analysis of Numerical
+	Schemes in Collocated and Staggered Grids for Problems of Poroelasticity". The routine here
+	defined maps a solution history file, written with the option -history_file, as an array of
+	snapshotsNo x n values without reading it into memory. Only uncompressed histories
+	(-history_compression none) can be mapped, compressed ones are read with the class
+	solutionHistory.
+
+	Written by FERREIRA, C. A. S.
+
+	Florianópolis, 2019.
+"""
+
+import numpy as np
+import sys
+
+"""    READ HISTORY
+  ----------------------------------------------------------------"""
+
+headerBytes=4096
+
+def readHistory(fileName):
+	header=np.fromfile(fileName,dtype=np.int64,count=8)
+	if header[0].tobytes()!=b"GFVHIST1":
+		raise ValueError(fileName+" is not a solution history file")
+
+	n,snapshotsNo,blocksNo,compression=header[1:5]
+	if compression!=0:
+		raise ValueError(fileName+" is compressed, read it with solutionHistory")
+
+	blockSizes=np.fromfile(fileName,dtype=np.int64,count=blocksNo,offset=8*8)
+	history=np.memmap(fileName,dtype=np.float64,mode="r",offset=headerBytes,
+		shape=(snapshotsNo,n))
+
+	return history,blockSizes
+
+if __name__=="__main__":
+	history,blockSizes=readHistory(sys.argv[1])
+	print("snapshots:",history.shape[0],"unknowns:",history.shape[1],"blocks:",blockSizes)
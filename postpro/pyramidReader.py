@@ -0,0 +1,50 @@
+"""
+	This source code is part of the development of a master's thesis entitled "Analysis of Numerical
+	Schemes in Collocated and Staggered Grids for Problems of Poroelasticity". The routine here
+	defined reads one level of one field of a pyramid file, written by the exporters of the
+	stripfoot and Mandel problems next to the full fields, seeking to it so that the other levels
+	are not read. Level 1 is downsampled by 2, level 2 by 4 and so on; the coordinates of the FV
+	of the level are returned with the values.
+
+	Written by FERREIRA, C. A. S.
+
+	Florianópolis, 2019.
+"""
+
+import numpy as np
+import sys
+
+"""    READ PYRAMID
+  ----------------------------------------------------------------"""
+
+headerBytes=4096
+
+def readPyramidHeader(fileName):
+	header=np.fromfile(fileName,dtype=np.int64,count=3)
+	if header[0].tobytes()!=b"GFVPYR1\0":
+		raise ValueError(fileName+" is not a pyramid file")
+
+	fieldsNo,levelsNo=header[1:3]
+	names=np.fromfile(fileName,dtype="S8",count=fieldsNo,offset=3*8)
+	levels=np.fromfile(fileName,dtype=[("factor",np.int64),("rowNo",np.int64),
+		("colNo",np.int64),("offset",np.int64),("x0",np.float64),("y0",np.float64),
+		("dx",np.float64),("dy",np.float64)],count=fieldsNo*levelsNo,offset=3*8+fieldsNo*8)
+
+	return [name.decode() for name in names],levels.reshape(fieldsNo,levelsNo)
+
+def readPyramid(fileName,field,level):
+	names,levels=readPyramidHeader(fileName)
+	description=levels[names.index(field),level-1]
+	rowNo,colNo=description["rowNo"],description["colNo"]
+	values=np.fromfile(fileName,dtype=np.float64,count=rowNo*colNo,
+		offset=description["offset"]).reshape(rowNo,colNo)
+	xCoord=description["x0"]+description["dx"]*np.arange(colNo)
+	yCoord=description["y0"]-description["dy"]*np.arange(rowNo)
+
+	return xCoord,yCoord,values
+
+if __name__=="__main__":
+	names,levels=readPyramidHeader(sys.argv[1])
+	for f,name in enumerate(names):
+		print(name+":",", ".join(str(level["factor"])+"x: "+str(level["rowNo"])+"x"+
+			str(level["colNo"]) for level in levels[f]))
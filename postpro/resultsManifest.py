@@ -0,0 +1,77 @@
+"""
+	This source code is part of the development of a master's thesis entitled "Analysis of Numerical
+	Schemes in Collocated and Staggered Grids for Problems of Poroelasticity". The routines here
+	defined read the index of the cases solved by the sweeps, export/manifest.jsonl, so that the
+	files, the error norms and the wall time of a case are looked up by its key (problem, grid,
+	scheme, medium, mesh, Nt, dt) instead of rebuilt from the run info files. The files of the cases
+	solved by the task farm are kept in its tar archive, as <hash>/<file>, and are extracted to
+	export/<archive>/<hash>/ when looked up. Run as a script, the complete cases matching the fields
+	given as name=value are listed.
+
+	Written by FERREIRA, C. A. S.
+
+	Florianópolis, 2019.
+"""
+
+import json
+import pathlib
+import sys
+import tarfile
+
+"""    READ MANIFEST
+  ----------------------------------------------------------------"""
+
+# Get parent directory
+parentDirectory=pathlib.Path(__file__).resolve().parents[1]
+
+def loadManifest(fileName=parentDirectory/"export/manifest.jsonl"):
+	# The last line of a hash wins, as in the solver
+	records={}
+	with open(fileName) as manifestFile:
+		for line in manifestFile:
+			if line.strip():
+				record=json.loads(line)
+				records[record["hash"]]=record
+
+	return records
+
+def findCases(records,**fields):
+	# Complete cases whose fields are equal to the ones given, dt compared to 6 significant digits
+	cases=[]
+	for record in records.values():
+		if record["status"]!="complete":
+			continue
+		matches=True
+		for name,value in fields.items():
+			if name=="dt":
+				matches=matches and abs(record["dt"]-float(value))<=5e-6*abs(float(value))
+			else:
+				matches=matches and str(record[name])==str(value)
+		if matches:
+			cases.append(record)
+
+	return sorted(cases,key=lambda case:(case["problem"],case["grid"],case["scheme"],
+		case["mesh"],case["dt"]))
+
+def getOutput(case,pattern):
+	# Path of the first file of the case whose name holds pattern
+	for output in case["outputs"]:
+		if pattern in output["file"]:
+			if "container" not in case:
+				return parentDirectory/"export"/output["file"]
+			archive=parentDirectory/"export"/case["container"]
+			directory=parentDirectory/"export"/archive.stem
+			fileName=directory/case["hash"]/output["file"]
+			if not fileName.exists():
+				with tarfile.open(archive) as archiveFile:
+					archiveFile.extract(case["hash"]+"/"+output["file"],directory)
+			return fileName
+
+	return None
+
+if __name__=="__main__":
+	fields=dict(argument.split("=",1) for argument in sys.argv[1:])
+	for case in findCases(loadManifest(),**fields):
+		print(case["problem"],case["grid"],case["scheme"],case["medium"],"mesh="+
+			str(case["mesh"]),"Nt="+str(case["Nt"]),"dt="+str(case["dt"]),"%.3f s"%case["seconds"],
+			case["values"],len(case["outputs"]),"files")
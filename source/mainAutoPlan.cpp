@@ -0,0 +1,79 @@
+/*
+	This source code implements a Finite Volume Method for discretization and solution of the
+	consolidation problem as part of a master's thesis entitled "Analysis of Numerical Schemes in
+	Collocated and Staggered Grids for Problems of Poroelasticity". This source code chooses the
+	formulation, the mesh and the time-step with which the problem presented and solved by
+	Terzaghi [2] reaches a target pressure error, relative to the load, at the least predicted
+	cost. The error and cost models are fitted to the convergence cases of the medium kept in the
+	results manifest, the chosen case is solved with a LU Factorization found in PETSc [1] and its
+	error is checked against the analytical solution.
+
+ 	Written by FERREIRA, C. A. S.
+
+ 	Florianópolis, 2019.
+
+ 	[1] BALAY et al. PETSc User Manual. Technical Report, Argonne National Laboratory, 2017.
+ 	[2] TERZAGHI, K. Erdbaumechanik auf Bodenphysikalischer Grundlage. Franz Deuticke, Leipzig,
+ 	1925.
+*/
+
+#include "customPrinter.hpp"
+#include "exportRunInfo.hpp"
+#include "benchmarking.hpp"
+
+int main(int argc, char** args)
+{
+	string myMedium=args[1];
+	double tolerance=atof(args[2]);
+
+/*		PROPERTIES IMPORT
+	----------------------------------------------------------------*/
+
+	poroelasticProperties myProperties;
+	ifstream inFile;
+	inFile.open("../input/"+myMedium+".txt");
+	if(!inFile)
+	{
+		cout << "Unable to open properties file.";
+		exit(1);
+	}
+	getline(inFile,myProperties.pairName);
+	myProperties.pairName=myMedium;
+	inFile >> myProperties.shearModulus;
+	inFile >> myProperties.bulkModulus;
+	inFile >> myProperties.solidBulkModulus;
+	inFile >> myProperties.solidDensity;
+	inFile >> myProperties.fluidBulkModulus;
+	inFile >> myProperties.porosity;
+	inFile >> myProperties.permeability;
+	inFile >> myProperties.fluidViscosity;
+	inFile >> myProperties.fluidDensity;
+	inFile.close();
+
+/*		OTHER PARAMETERS
+	----------------------------------------------------------------*/
+
+	double Lt=5e5; // [s], as in the convergence tests
+	double g=0; // m/s^2
+	double sigmab=-10e3; // Pa
+
+/*		PETSC INITIALIZE
+	----------------------------------------------------------------*/
+
+	PetscErrorCode ierr;
+	ierr=PetscInitialize(&argc,&args,(char*)0,NULL);CHKERRQ(ierr);
+
+/*		PLAN AND SOLVE TERZAGHI
+	----------------------------------------------------------------*/
+
+	cout << "Medium: " << myProperties.pairName << "\n";
+	cout << "Target relative pressure error: " << tolerance << "\n";
+	ierr=terzaghiAutoPlan(tolerance,Lt,g,sigmab,myProperties);CHKERRQ(ierr);
+
+/*		PETSC FINALIZE
+	----------------------------------------------------------------*/
+
+	ierr=PetscFinalize();CHKERRQ(ierr);
+
+	return ierr;
+};
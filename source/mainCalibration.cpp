@@ -0,0 +1,147 @@
+/*
+	This source code implements a Finite Volume Method for discretization and solution of the 
+	consolidation problem as part of a master's thesis entitled "Analysis of Numerical Schemes in
+	Collocated and Staggered Grids for Problems of Poroelasticity". This source code calibrates the
+	permeability and the shear modulus of the problem presented by Terzaghi [2] against measured
+	time series of settlement and pore pressure. The gradient of the misfit is computed with the
+	discrete adjoint, solved with the transpose of the LU Factorization found in PETSc [1]. Without
+	a measurements file, the measurements are synthesized from the medium and the calibration
+	starts from perturbed parameters.
+
+ 	Written by FERREIRA, C. A. S.
+
+ 	Florianópolis, 2019.
+
+ 	[1] BALAY et al. PETSc User Manual. Technical Report, Argonne National Laboratory, 2017.
+ 	[2] TERZAGHI, K. Erdbaumechanik auf Bodenphysikalischer Grundlage. Franz Deuticke, Leipzig,
+ 	1925.
+*/
+
+#include "customPrinter.hpp"
+#include "exportRunInfo.hpp"
+#include "benchmarking.hpp"
+
+int main(int argc, char** args)
+{	
+	string myGridType=args[1];
+	string myInterpScheme=args[2];
+	string myMedium=args[3];
+	string myMeasurements=(argc>4) ? args[4] : "";
+
+/*		PROPERTIES IMPORT
+	----------------------------------------------------------------*/	
+
+	poroelasticProperties myProperties;
+	ifstream inFile;
+	inFile.open("../input/"+myMedium+".txt");
+	if(!inFile)
+	{
+		cout << "Unable to open properties file.";
+		exit(1);
+	}
+	getline(inFile,myProperties.pairName);
+	myProperties.pairName=myMedium;
+	inFile >> myProperties.shearModulus;
+	inFile >> myProperties.bulkModulus;
+	inFile >> myProperties.solidBulkModulus;
+	inFile >> myProperties.solidDensity;
+	inFile >> myProperties.fluidBulkModulus;
+	inFile >> myProperties.porosity;
+	inFile >> myProperties.permeability;
+	inFile >> myProperties.fluidViscosity;
+	inFile >> myProperties.fluidDensity;
+	inFile.close();	
+	
+/*		GRID DEFINITION
+	----------------------------------------------------------------*/
+
+	// Consolidation coefficient
+	double storativity,porosity,fluidViscosity,permeability,fluidCompressibility,
+		solidCompressibility,bulkCompressibility,longitudinalModulus,alpha;
+	porosity=myProperties.porosity;
+	fluidViscosity=myProperties.fluidViscosity;
+	permeability=myProperties.permeability;
+	fluidCompressibility=1/myProperties.fluidBulkModulus;
+	solidCompressibility=1/myProperties.solidBulkModulus;
+	bulkCompressibility=1/myProperties.bulkModulus;
+	longitudinalModulus=myProperties.bulkModulus+4*myProperties.shearModulus/3;
+	alpha=1-solidCompressibility/bulkCompressibility;
+	storativity=porosity*fluidCompressibility+(alpha-porosity)*solidCompressibility;
+	double consolidationCoefficient=(permeability/fluidViscosity)/(storativity+
+		alpha*alpha/longitudinalModulus);
+
+	int Nt=101;
+	int mesh=5;
+	double h=1./mesh;
+	double consolidationTime=h*h/consolidationCoefficient;
+	double dt=consolidationTime/2;
+	double Lt=(Nt-1)*dt;
+	
+/*		OTHER PARAMETERS
+	----------------------------------------------------------------*/
+
+	double g=0; // m/s^2
+	double columnLoad=-10e3; // Pa
+
+	// Calibrated parameters (0 for K, 1 for G, 2 for alpha and 3 for Q)
+	vector<int> calibratedParameters={0,1};
+	
+/*		PETSC INITIALIZE
+	----------------------------------------------------------------*/
+
+	PetscErrorCode ierr;
+	ierr=PetscInitialize(&argc,&args,(char*)0,NULL);CHKERRQ(ierr);
+
+/*		MEASUREMENTS
+	----------------------------------------------------------------*/
+
+	adjointCalibration myCalibration(calibratedParameters);
+	double misfit;
+	vector<double> gradient;
+
+	if(myMeasurements!="")
+	{
+		if(!myCalibration.readMeasurements("../input/"+myMeasurements+".txt"))
+		{
+			cout << "Unable to open measurements file.";
+			exit(1);
+		}
+	}
+	else
+	{
+		// Synthetic measurements, probes at 20 instants
+		for(int probeNo=0; probeNo<myCalibration.probeNames.size(); probeNo++)
+			for(int i=1; i<=20; i++)
+			{
+				myCalibration.measuredProbes.push_back(probeNo);
+				myCalibration.measuredTimes.push_back(i*Lt/20);
+				myCalibration.measuredValues.push_back(0);
+			}
+		myCalibration.setMeasuredValues(myCalibration.measuredValues);
+		ierr=terzaghiAdjoint(myGridType,myInterpScheme,Nt,mesh,Lt,g,columnLoad,myProperties,
+			myCalibration,misfit,gradient);CHKERRQ(ierr);
+		myCalibration.setMeasuredValues(myCalibration.modelValues);
+
+		myCalibration.parameterValues[0]*=4;
+		myCalibration.parameterValues[1]*=0.5;
+	}
+
+/*		SOLVE CALIBRATION
+	----------------------------------------------------------------*/
+
+	cout << "Grid type: " << myGridType << "\n";
+	cout << "Interpolation scheme: " << myInterpScheme << "\n";
+	cout << "Medium:" << myProperties.pairName << "\n";
+	cout << "Calibrated Terzaghi for: \n";
+	createSolveRunInfo(myGridType,myInterpScheme,"TerzaghiCalibration");
+	exportSolveRunInfo(dt,"TerzaghiCalibration_"+myMedium);
+	ierr=terzaghiCalibration(myGridType,myInterpScheme,Nt,mesh,Lt,g,columnLoad,myProperties,
+		myCalibration);CHKERRQ(ierr);
+	
+/*		PETSC FINALIZE
+	----------------------------------------------------------------*/
+	
+	ierr=PetscFinalize();CHKERRQ(ierr);
+
+	return ierr;
+};
\ No newline at end of file
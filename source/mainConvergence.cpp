@@ -113,6 +113,7 @@ int main(int argc, char** args)
 	int meshSizeNo=meshSize.size();
 	double dt;
 	double h;
+	resultsManifest myManifest;
 
 	cout << "Grid type: " << myGridType << "\n";
 	cout << "Interpolation scheme: " << myInterpScheme << "\n";
@@ -126,8 +127,11 @@ int main(int argc, char** args)
 
 		for(int j=0; j<meshSizeNo; j++)
 		{
+			if(!myManifest.beginCase("TerzaghiConvergence",myGridType,myInterpScheme,myMedium,
+				meshSize[j],timeSteps[i],dt)) continue;
 			ierr=convergence(myGridType,myInterpScheme,timeSteps[i],meshSize[j],Lt,g,sigmab,
 				myProperties);CHKERRQ(ierr);
+			myManifest.completeCase();
 		}
 	}
 
@@ -22,6 +22,7 @@ int main(int argc, char** args)
 	string myGridType=args[1];
 	string myInterpScheme=args[2];
 	string myMedium=args[3];
+	bool useCache=(argc>4 && string(args[4])=="cached");
 
 /*		PROPERTIES IMPORT
 	----------------------------------------------------------------*/	
@@ -105,12 +106,16 @@ int main(int argc, char** args)
 	cout << "Stiffness Constrast:" << StiffContrast << "\n";
 	cout << "Solved Terzaghi for: \n";
 	createSolveRunInfo(myGridType,myInterpScheme,"Terzaghi");
+	dimensionlessCache myCache("../export/",1e-6);
 	for(int i=0; i<timestepSize.size(); i++)
 	{
 		Lt=(Nt-1)*(consolidationTime*timestepSize[i]);
 		dt=Lt/(Nt-1);
 		exportSolveRunInfo(dt,"Terzaghi_"+myMedium);
-		ierr=terzaghi(myGridType,myInterpScheme,Nt,mesh,Lt,g,columnLoad,myProperties);CHKERRQ(ierr);
+		if(useCache) ierr=terzaghiDimless(myGridType,myInterpScheme,Nt,mesh,Lt,g,columnLoad,
+			myProperties,myCache);
+		else ierr=terzaghi(myGridType,myInterpScheme,Nt,mesh,Lt,g,columnLoad,myProperties);
+		CHKERRQ(ierr);
 		// Reynolds=Reynolds*(h*h)/dt;
 		// Fourier=Fourier*dt/(h*h);
 		// printscalar(Reynolds);newline();
@@ -120,6 +125,8 @@ int main(int argc, char** args)
 		// Reynolds=Reynolds*dt/(h*h);
 		// Fourier=Fourier*(h*h)/dt;
 	}
+	if(useCache) cout << "Solutions served from cache: " << myCache.hitsNo << "/" <<
+		myCache.hitsNo+myCache.missesNo << "\n";
 	
 /*		PETSC FINALIZE
 	----------------------------------------------------------------*/
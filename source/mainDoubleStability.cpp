@@ -95,6 +95,9 @@ int main(int argc, char** args)
 /*		SOLVE BENCHMARKING PROBLEMS
 	----------------------------------------------------------------*/
 
+	resultsManifest myManifest;
+	string myFractions="pore="+to_string(pore)+";frac="+to_string(frac);
+
 	cout << "Grid type: " << myGridType << "\n";
 	cout << "Interpolation scheme: " << myInterpScheme << "\n";
 	cout << "Minimum time-step: " << consolidationTime/6 << "\n";
@@ -109,8 +112,11 @@ int main(int argc, char** args)
 				Lt=(Nt-1)*(consolidationTime*timestepSize[i]);
 				dt=Lt/(Nt-1);
 				exportSolveRunInfo(dt,"Stripfoot_"+myMedium);
+				if(!myManifest.beginCase("StripfootDouble",myGridType,myInterpScheme,myMedium,mesh,
+					Nt,dt,myFractions)) continue;
 				ierr=stripfootDouble(myGridType,myInterpScheme,Nt,mesh,Lt,0,stripLoad,
 					myProperties);CHKERRQ(ierr);
+				myManifest.completeCase();
 			}
 		}
 	}
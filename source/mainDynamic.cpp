@@ -0,0 +1,76 @@
+/*
+	This source code implements a Finite Difference Method for the dynamic poroelasticity problem as
+	part of a master's thesis entitled "Analysis of Numerical Schemes in Collocated and Staggered
+	Grids for Problems of Poroelasticity". This source code solves the waves radiated into the
+	medium by an impact on a strip footing, with the dynamic Biot equations [2] stepped explicitly
+	on the staggered grid. PETSc [1] is used only for the options.
+
+ 	Written by FERREIRA, C. A. S.
+
+ 	Florianópolis, 2019.
+
+ 	[1] BALAY et al. PETSc User Manual. Technical Report, Argonne National Laboratory, 2017.
+ 	[2] BIOT, M. A. Theory of Propagation of Elastic Waves in a Fluid-Saturated Porous Solid.
+ 	Journal of the Acoustical Society of America, 28, 1956.
+*/
+
+#include "customPrinter.hpp"
+#include "exportRunInfo.hpp"
+#include "benchmarking.hpp"
+
+int main(int argc, char** args)
+{
+	string myMedium=args[1];
+	int mesh=(argc>2) ? atoi(args[2]) : 10;
+	double Lt=(argc>3) ? atof(args[3]) : 0;
+
+/*		PROPERTIES IMPORT
+	----------------------------------------------------------------*/
+
+	poroelasticProperties myProperties;
+	ifstream inFile;
+	inFile.open("../input/"+myMedium+".txt");
+	if(!inFile)
+	{
+		cout << "Unable to open properties file.";
+		exit(1);
+	}
+	getline(inFile,myProperties.pairName);
+	myProperties.pairName=myMedium;
+	inFile >> myProperties.shearModulus;
+	inFile >> myProperties.bulkModulus;
+	inFile >> myProperties.solidBulkModulus;
+	inFile >> myProperties.solidDensity;
+	inFile >> myProperties.fluidBulkModulus;
+	inFile >> myProperties.porosity;
+	inFile >> myProperties.permeability;
+	inFile >> myProperties.fluidViscosity;
+	inFile >> myProperties.fluidDensity;
+	inFile.close();
+
+/*		OTHER PARAMETERS
+	----------------------------------------------------------------*/
+
+	double stripLoad=-10e3; // Pa, peak of the Ricker pulse
+
+/*		PETSC INITIALIZE
+	----------------------------------------------------------------*/
+
+	PetscErrorCode ierr;
+	ierr=PetscInitialize(&argc,&args,(char*)0,NULL);CHKERRQ(ierr);
+
+/*		SOLVE DYNAMIC STRIPFOOT
+	----------------------------------------------------------------*/
+
+	cout << "Grid type: staggered\n";
+	cout << "Medium:" << myProperties.pairName << "\n";
+	cout << "Solved dynamic stripfoot for: \n";
+	ierr=stripfootDynamic(mesh,Lt,stripLoad,myProperties);CHKERRQ(ierr);
+
+/*		PETSC FINALIZE
+	----------------------------------------------------------------*/
+
+	ierr=PetscFinalize();CHKERRQ(ierr);
+
+	return ierr;
+};
@@ -0,0 +1,114 @@
+/*
+	This source code implements a Finite Volume Method for discretization and solution of the 
+	consolidation problem as part of a master's thesis entitled "Analysis of Numerical Schemes in
+	Collocated and Staggered Grids for Problems of Poroelasticity". This source code solves an
+	ensemble of realizations of the problem presented by Terzaghi [2] in a column whose
+	permeability and shear modulus are lognormal random fields, exporting the mean, standard
+	deviation and quantiles of the settlement and of the pore pressure at the base. Realizations
+	share the ordering and the symbolic LU Factorization found in PETSc [1] and are solved
+	concurrently.
+
+ 	Written by FERREIRA, C. A. S.
+
+ 	Florianópolis, 2019.
+
+ 	[1] BALAY et al. PETSc User Manual. Technical Report, Argonne National Laboratory, 2017.
+ 	[2] TERZAGHI, K. Erdbaumechanik auf Bodenphysikalischer Grundlage. Franz Deuticke, Leipzig,
+ 	1925.
+*/
+
+#include "customPrinter.hpp"
+#include "exportRunInfo.hpp"
+#include "benchmarking.hpp"
+
+int main(int argc, char** args)
+{	
+	string myGridType=args[1];
+	string myInterpScheme=args[2];
+	string myMedium=args[3];
+	int myRealizationsNo=(argc>4) ? stoi(args[4]) : 100;
+
+/*		PROPERTIES IMPORT
+	----------------------------------------------------------------*/	
+
+	poroelasticProperties myProperties;
+	ifstream inFile;
+	inFile.open("../input/"+myMedium+".txt");
+	if(!inFile)
+	{
+		cout << "Unable to open properties file.";
+		exit(1);
+	}
+	getline(inFile,myProperties.pairName);
+	myProperties.pairName=myMedium;
+	inFile >> myProperties.shearModulus;
+	inFile >> myProperties.bulkModulus;
+	inFile >> myProperties.solidBulkModulus;
+	inFile >> myProperties.solidDensity;
+	inFile >> myProperties.fluidBulkModulus;
+	inFile >> myProperties.porosity;
+	inFile >> myProperties.permeability;
+	inFile >> myProperties.fluidViscosity;
+	inFile >> myProperties.fluidDensity;
+	inFile.close();	
+	
+/*		GRID DEFINITION
+	----------------------------------------------------------------*/
+
+	// Consolidation coefficient
+	double storativity,porosity,fluidViscosity,permeability,fluidCompressibility,
+		solidCompressibility,bulkCompressibility,longitudinalModulus,alpha;
+	porosity=myProperties.porosity;
+	fluidViscosity=myProperties.fluidViscosity;
+	permeability=myProperties.permeability;
+	fluidCompressibility=1/myProperties.fluidBulkModulus;
+	solidCompressibility=1/myProperties.solidBulkModulus;
+	bulkCompressibility=1/myProperties.bulkModulus;
+	longitudinalModulus=myProperties.bulkModulus+4*myProperties.shearModulus/3;
+	alpha=1-solidCompressibility/bulkCompressibility;
+	storativity=porosity*fluidCompressibility+(alpha-porosity)*solidCompressibility;
+	double consolidationCoefficient=(permeability/fluidViscosity)/(storativity+
+		alpha*alpha/longitudinalModulus);
+
+	int Nt=101;
+	int mesh=5;
+	double h=1./mesh;
+	double consolidationTime=h*h/consolidationCoefficient;
+	double dt=consolidationTime/2;
+	double Lt=(Nt-1)*dt;
+	
+/*		OTHER PARAMETERS
+	----------------------------------------------------------------*/
+
+	double g=0; // m/s^2
+	double columnLoad=-10e3; // Pa
+
+	// Random fields, with the correlation length and the standard deviation of log(K) and log(G)
+	double correlationLength=0.5; // m
+	double logDeviation=0.5;
+	
+/*		PETSC INITIALIZE
+	----------------------------------------------------------------*/
+
+	PetscErrorCode ierr;
+	ierr=PetscInitialize(&argc,&args,(char*)0,NULL);CHKERRQ(ierr);
+
+/*		SOLVE ENSEMBLE
+	----------------------------------------------------------------*/
+
+	cout << "Grid type: " << myGridType << "\n";
+	cout << "Interpolation scheme: " << myInterpScheme << "\n";
+	cout << "Medium:" << myProperties.pairName << "\n";
+	cout << "Solved Terzaghi ensemble for: \n";
+	createSolveRunInfo(myGridType,myInterpScheme,"TerzaghiEnsemble");
+	exportSolveRunInfo(dt,"TerzaghiEnsemble_"+myMedium);
+	ierr=terzaghiEnsemble(myGridType,myInterpScheme,Nt,mesh,Lt,g,columnLoad,myProperties,
+		myRealizationsNo,correlationLength,logDeviation);CHKERRQ(ierr);
+	
+/*		PETSC FINALIZE
+	----------------------------------------------------------------*/
+	
+	ierr=PetscFinalize();CHKERRQ(ierr);
+
+	return ierr;
+};
\ No newline at end of file
@@ -0,0 +1,103 @@
+/*
+	This source code implements a Finite Volume Method for discretization and solution of the
+	consolidation problem as part of a master's thesis entitled "Analysis of Numerical Schemes in
+	Collocated and Staggered Grids for Problems of Poroelasticity". This source code solves the
+	consolidation under a square footing in three dimensions. The operators are applied without
+	matrices, the flow and the mechanics are coupled by the fixed-stress split and each of them is
+	solved with the Conjugate Gradient method preconditioned by geometric multigrid. The mesh
+	argument gives 8*mesh FV per direction, 16 for 128^3 FV. PETSc [1] is used only for the
+	options.
+
+ 	Written by FERREIRA, C. A. S.
+
+ 	Florianópolis, 2019.
+
+ 	[1] BALAY et al. PETSc User Manual. Technical Report, Argonne National Laboratory, 2017.
+*/
+
+#include "customPrinter.hpp"
+#include "exportRunInfo.hpp"
+#include "benchmarking.hpp"
+
+int main(int argc, char** args)
+{
+	string myGridType=args[1];
+	string myMedium=args[2];
+	int mesh=(argc>3) ? atoi(args[3]) : 2;
+
+/*		PROPERTIES IMPORT
+	----------------------------------------------------------------*/
+
+	poroelasticProperties myProperties;
+	ifstream inFile;
+	inFile.open("../input/"+myMedium+".txt");
+	if(!inFile)
+	{
+		cout << "Unable to open properties file.";
+		exit(1);
+	}
+	getline(inFile,myProperties.pairName);
+	myProperties.pairName=myMedium;
+	inFile >> myProperties.shearModulus;
+	inFile >> myProperties.bulkModulus;
+	inFile >> myProperties.solidBulkModulus;
+	inFile >> myProperties.solidDensity;
+	inFile >> myProperties.fluidBulkModulus;
+	inFile >> myProperties.porosity;
+	inFile >> myProperties.permeability;
+	inFile >> myProperties.fluidViscosity;
+	inFile >> myProperties.fluidDensity;
+	inFile.close();
+
+/*		GRID DEFINITION
+	----------------------------------------------------------------*/
+
+	// Consolidation coefficient
+	double storativity,porosity,fluidViscosity,permeability,fluidCompressibility,
+		solidCompressibility,bulkCompressibility,longitudinalModulus,alpha;
+	porosity=myProperties.porosity;
+	fluidViscosity=myProperties.fluidViscosity;
+	permeability=myProperties.permeability;
+	fluidCompressibility=1/myProperties.fluidBulkModulus;
+	solidCompressibility=1/myProperties.solidBulkModulus;
+	bulkCompressibility=1/myProperties.bulkModulus;
+	longitudinalModulus=myProperties.bulkModulus+4*myProperties.shearModulus/3;
+	alpha=1-solidCompressibility/bulkCompressibility;
+	storativity=porosity*fluidCompressibility+(alpha-porosity)*solidCompressibility;
+	double consolidationCoefficient=(permeability/fluidViscosity)/(storativity+
+		alpha*alpha/longitudinalModulus);
+
+	// Time-steps of the consolidation time of the footing, 1 m wide
+	int Nt=21;
+	double consolidationTime=1/consolidationCoefficient;
+	double dt=consolidationTime/20;
+	double Lt=(Nt-1)*dt;
+
+/*		OTHER PARAMETERS
+	----------------------------------------------------------------*/
+
+	double footingLoad=-10e3; // Pa
+
+/*		PETSC INITIALIZE
+	----------------------------------------------------------------*/
+
+	PetscErrorCode ierr;
+	ierr=PetscInitialize(&argc,&args,(char*)0,NULL);CHKERRQ(ierr);
+
+/*		SOLVE 3D FOOTING
+	----------------------------------------------------------------*/
+
+	cout << "Grid type: " << myGridType << "\n";
+	cout << "Medium:" << myProperties.pairName << "\n";
+	cout << "Solved 3D footing for: \n";
+	createSolveRunInfo(myGridType,"NA","Footing3D");
+	exportSolveRunInfo(dt,"Footing3D_"+myMedium);
+	ierr=footing3D(myGridType,Nt,mesh,Lt,footingLoad,myProperties);CHKERRQ(ierr);
+
+/*		PETSC FINALIZE
+	----------------------------------------------------------------*/
+
+	ierr=PetscFinalize();CHKERRQ(ierr);
+
+	return ierr;
+};
@@ -0,0 +1,48 @@
+/*
+	This source code implements a Finite Volume Method for discretization and solution of the
+	consolidation problem as part of a master's thesis entitled "Analysis of Numerical Schemes in
+	Collocated and Staggered Grids for Problems of Poroelasticity". This source code replays the
+	linear systems written by the runs with -operator_export, given by their manifests, through
+	every configuration of the solver (the LU Factorization found in PETSc [1] with each fill
+	reducing ordering and the GCR method), timing the setup and the solves without running the
+	whole problem again.
+
+ 	Written by FERREIRA, C. A. S.
+
+ 	Florianópolis, 2019.
+
+ 	[1] BALAY et al. PETSc User Manual. Technical Report, Argonne National Laboratory, 2017.
+*/
+
+#include "customPrinter.hpp"
+#include "exportRunInfo.hpp"
+#include "benchmarking.hpp"
+
+int main(int argc, char** args)
+{
+	vector<string> manifestNames;
+	for(int i=1; i<argc && args[i][0]!='-'; i++) manifestNames.push_back(args[i]);
+
+/*		PETSC INITIALIZE
+	----------------------------------------------------------------*/
+
+	PetscErrorCode ierr;
+	ierr=PetscInitialize(&argc,&args,(char*)0,NULL);CHKERRQ(ierr);
+
+/*		REPLAY LINEAR SYSTEMS
+	----------------------------------------------------------------*/
+
+	for(int i=0; i<manifestNames.size(); i++)
+	{
+		cout << "Linear systems of " << manifestNames[i] << ":\n";
+		ierr=operatorReplay(manifestNames[i]);CHKERRQ(ierr);
+		cout << "\n";
+	}
+
+/*		PETSC FINALIZE
+	----------------------------------------------------------------*/
+
+	ierr=PetscFinalize();CHKERRQ(ierr);
+
+	return ierr;
+};
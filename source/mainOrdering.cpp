@@ -0,0 +1,80 @@
+/*
+	This source code implements a Finite Volume Method for discretization and solution of the
+	consolidation problem as part of a master's thesis entitled "Analysis of Numerical Schemes in
+	Collocated and Staggered Grids for Problems of Poroelasticity". This source code compares the
+	numberings of the FV of the stripfoot problem, row by row and along the Morton and Hilbert
+	curves, timing the assembly of the coefficients matrix and of the independent terms array, the
+	product of the matrix by an array and the triangular solves with the LU factors found in PETSc
+	[1]. The grids of Mandel's problem are the same.
+
+ 	Written by FERREIRA, C. A. S.
+
+ 	Florianópolis, 2019.
+
+ 	[1] BALAY et al. PETSc User Manual. Technical Report, Argonne National Laboratory, 2017.
+*/
+
+#include "customPrinter.hpp"
+#include "exportRunInfo.hpp"
+#include "benchmarking.hpp"
+
+int main(int argc, char** args)
+{
+	string myGridType=args[1];
+	string myInterpScheme=args[2];
+	string myMedium=args[3];
+	int mesh=(argc>4) ? atoi(args[4]) : 5;
+
+/*		PROPERTIES IMPORT
+	----------------------------------------------------------------*/
+
+	poroelasticProperties myProperties;
+	ifstream inFile;
+	inFile.open("../input/"+myMedium+".txt");
+	if(!inFile)
+	{
+		cout << "Unable to open properties file.";
+		exit(1);
+	}
+	getline(inFile,myProperties.pairName);
+	myProperties.pairName=myMedium;
+	inFile >> myProperties.shearModulus;
+	inFile >> myProperties.bulkModulus;
+	inFile >> myProperties.solidBulkModulus;
+	inFile >> myProperties.solidDensity;
+	inFile >> myProperties.fluidBulkModulus;
+	inFile >> myProperties.porosity;
+	inFile >> myProperties.permeability;
+	inFile >> myProperties.fluidViscosity;
+	inFile >> myProperties.fluidDensity;
+	inFile.close();
+
+/*		OTHER PARAMETERS
+	----------------------------------------------------------------*/
+
+	double stripLoad=-10e3; // Pa
+	double Lt=1; // s, a single time-step
+
+/*		PETSC INITIALIZE
+	----------------------------------------------------------------*/
+
+	PetscErrorCode ierr;
+	ierr=PetscInitialize(&argc,&args,(char*)0,NULL);CHKERRQ(ierr);
+
+/*		COMPARE NUMBERINGS
+	----------------------------------------------------------------*/
+
+	cout << "Grid type: " << myGridType << "\n";
+	cout << "Interpolation scheme: " << myInterpScheme << "\n";
+	cout << "Medium:" << myProperties.pairName << "\n";
+	cout << "Numberings of the stripfoot problem, " << 5*mesh << "x" << 5*mesh << " FV: \n";
+	ierr=stripfootOrdering(myGridType,myInterpScheme,mesh,Lt,stripLoad,myProperties);
+		CHKERRQ(ierr);
+
+/*		PETSC FINALIZE
+	----------------------------------------------------------------*/
+
+	ierr=PetscFinalize();CHKERRQ(ierr);
+
+	return ierr;
+};
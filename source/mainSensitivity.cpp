@@ -0,0 +1,107 @@
+/*
+	This source code implements a Finite Volume Method for discretization and solution of the 
+	consolidation problem as part of a master's thesis entitled "Analysis of Numerical Schemes in
+	Collocated and Staggered Grids for Problems of Poroelasticity". This source code solves the
+	problem presented by Terzaghi [2] together with the sensitivities of the solution with respect
+	to the permeability, shear modulus, Biot coefficient and Biot modulus. The sensitivity systems
+	are solved with the same LU Factorization found in PETSc [1] used for the solution.
+
+ 	Written by FERREIRA, C. A. S.
+
+ 	Florianópolis, 2019.
+
+ 	[1] BALAY et al. PETSc User Manual. Technical Report, Argonne National Laboratory, 2017.
+ 	[2] TERZAGHI, K. Erdbaumechanik auf Bodenphysikalischer Grundlage. Franz Deuticke, Leipzig,
+ 	1925.
+*/
+
+#include "customPrinter.hpp"
+#include "exportRunInfo.hpp"
+#include "benchmarking.hpp"
+
+int main(int argc, char** args)
+{	
+	string myGridType=args[1];
+	string myInterpScheme=args[2];
+	string myMedium=args[3];
+
+/*		PROPERTIES IMPORT
+	----------------------------------------------------------------*/	
+
+	poroelasticProperties myProperties;
+	ifstream inFile;
+	inFile.open("../input/"+myMedium+".txt");
+	if(!inFile)
+	{
+		cout << "Unable to open properties file.";
+		exit(1);
+	}
+	getline(inFile,myProperties.pairName);
+	myProperties.pairName=myMedium;
+	inFile >> myProperties.shearModulus;
+	inFile >> myProperties.bulkModulus;
+	inFile >> myProperties.solidBulkModulus;
+	inFile >> myProperties.solidDensity;
+	inFile >> myProperties.fluidBulkModulus;
+	inFile >> myProperties.porosity;
+	inFile >> myProperties.permeability;
+	inFile >> myProperties.fluidViscosity;
+	inFile >> myProperties.fluidDensity;
+	inFile.close();	
+	
+/*		GRID DEFINITION
+	----------------------------------------------------------------*/
+
+	// Consolidation coefficient
+	double storativity,porosity,fluidViscosity,permeability,fluidCompressibility,
+		solidCompressibility,bulkCompressibility,longitudinalModulus,alpha;
+	porosity=myProperties.porosity;
+	fluidViscosity=myProperties.fluidViscosity;
+	permeability=myProperties.permeability;
+	fluidCompressibility=1/myProperties.fluidBulkModulus;
+	solidCompressibility=1/myProperties.solidBulkModulus;
+	bulkCompressibility=1/myProperties.bulkModulus;
+	longitudinalModulus=myProperties.bulkModulus+4*myProperties.shearModulus/3;
+	alpha=1-solidCompressibility/bulkCompressibility;
+	storativity=porosity*fluidCompressibility+(alpha-porosity)*solidCompressibility;
+	double consolidationCoefficient=(permeability/fluidViscosity)/(storativity+
+		alpha*alpha/longitudinalModulus);
+
+	int Nt=501;
+	int mesh=5;
+	double h=1./mesh;
+	double consolidationTime=h*h/consolidationCoefficient;
+	double dt=consolidationTime/2;
+	double Lt=(Nt-1)*dt;
+	
+/*		OTHER PARAMETERS
+	----------------------------------------------------------------*/
+
+	double g=0; // m/s^2
+	double columnLoad=-10e3; // Pa
+	
+/*		PETSC INITIALIZE
+	----------------------------------------------------------------*/
+
+	PetscErrorCode ierr;
+	ierr=PetscInitialize(&argc,&args,(char*)0,NULL);CHKERRQ(ierr);
+
+/*		SOLVE TERZAGHI WITH SENSITIVITIES
+	----------------------------------------------------------------*/
+
+	cout << "Grid type: " << myGridType << "\n";
+	cout << "Interpolation scheme: " << myInterpScheme << "\n";
+	cout << "Medium:" << myProperties.pairName << "\n";
+	cout << "Solved Terzaghi with sensitivities for: \n";
+	createSolveRunInfo(myGridType,myInterpScheme,"TerzaghiSensitivity");
+	exportSolveRunInfo(dt,"TerzaghiSensitivity_"+myMedium);
+	ierr=terzaghiSensitivity(myGridType,myInterpScheme,Nt,mesh,Lt,g,columnLoad,myProperties);
+		CHKERRQ(ierr);
+	
+/*		PETSC FINALIZE
+	----------------------------------------------------------------*/
+	
+	ierr=PetscFinalize();CHKERRQ(ierr);
+
+	return ierr;
+};
\ No newline at end of file
@@ -97,6 +97,8 @@ int main(int argc, char** args)
 /*		SOLVE BENCHMARKING PROBLEMS
 	----------------------------------------------------------------*/
 
+	resultsManifest myManifest;
+
 	cout << "Grid type: " << myGridType << "\n";
 	cout << "Interpolation scheme: " << myInterpScheme << "\n";
 	cout << "Minimum time-step: " << consolidationTime/6 << "\n";
@@ -108,32 +110,44 @@ int main(int argc, char** args)
 			cout << "Solved sealed column for: \n";
 			createSolveRunInfo(myGridType,myInterpScheme,"SealedColumn");
 			exportSolveRunInfo(dt,"SealedColumn_"+myMedium);
+			if(!myManifest.beginCase("SealedColumn",myGridType,myInterpScheme,myMedium,mesh,
+				(Nt-1)*2+1,dt)) continue;
 			ierr=sealedColumn(myGridType,myInterpScheme,(Nt-1)*2+1,mesh,Lt*2,g,columnLoad,
 				myProperties);CHKERRQ(ierr);
+			myManifest.completeCase();
 		}
 		else if(problemsSolved[i]==2)
 		{
 			cout << "Solved Terzaghi for: \n";
 			createSolveRunInfo(myGridType,myInterpScheme,"Terzaghi");
 			exportSolveRunInfo(dt,"Terzaghi_"+myMedium);
+			if(!myManifest.beginCase("Terzaghi",myGridType,myInterpScheme,myMedium,mesh,Nt,dt))
+				continue;
 			ierr=terzaghi(myGridType,myInterpScheme,Nt,mesh,Lt,g,columnLoad,myProperties);
 				CHKERRQ(ierr);
+			myManifest.completeCase();
 		}
 		else if(problemsSolved[i]==4)
 		{
 			cout << "Solved Mandel for: \n";
 			createSolveRunInfo(myGridType,myInterpScheme,"Mandel");
 			exportSolveRunInfo(dt,"Mandel_"+myMedium);
+			if(!myManifest.beginCase("Mandel",myGridType,myInterpScheme,myMedium,mesh,Nt,dt))
+				continue;
 			ierr=mandel(myGridType,myInterpScheme,Nt,mesh,Lt,0,mandelLoad,myProperties);
 				CHKERRQ(ierr);
+			myManifest.completeCase();
 		}
 		else if(problemsSolved[i]==8)
 		{
 			cout << "Solved stripfoot for: \n";
 			createSolveRunInfo(myGridType,myInterpScheme,"Stripfoot");
 			exportSolveRunInfo(dt,"Stripfoot_"+myMedium);
+			if(!myManifest.beginCase("Stripfoot",myGridType,myInterpScheme,myMedium,mesh,Nt,dt))
+				continue;
 			ierr=stripfoot(myGridType,myInterpScheme,Nt,mesh,Lt,0,stripLoad,myProperties);
 				CHKERRQ(ierr);
+			myManifest.completeCase();
 		}
 	}
 	
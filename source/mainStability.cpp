@@ -6,6 +6,11 @@
 	Mandel [2]. The governing equations are discretized within the FVM and the resulting linear 
 	system of equations is solved with a LU Factorization found in PETSc [1]. The parameters chosen are such that the stability of the solution is tested.
 
+	With -screening_precision float32 the cases are screened in single precision and solved again
+	in double precision when the pressure oscillation of the single precision run is within
+	-screening_band (relative) of -screening_threshold, so that only the cases close to the
+	stability limit pay for the double precision run.
+
  	Written by FERREIRA, C. A. S.
 
  	Florianópolis, 2019.
@@ -104,6 +109,43 @@ int main(int argc, char** args)
 /*		SOLVE BENCHMARKING PROBLEMS
 	----------------------------------------------------------------*/
 
+	resultsManifest myManifest;
+
+	// Screening in single precision
+	char screeningPrecisionChar[PETSC_MAX_PATH_LEN]="float64";
+	PetscReal screeningThreshold=0.05;
+	PetscReal screeningBand=0.5;
+	PetscOptionsGetString(NULL,NULL,"-screening_precision",screeningPrecisionChar,
+		sizeof(screeningPrecisionChar),NULL);
+	PetscOptionsGetReal(NULL,NULL,"-screening_threshold",&screeningThreshold,NULL);
+	PetscOptionsGetReal(NULL,NULL,"-screening_band",&screeningBand,NULL);
+	bool screening=(string(screeningPrecisionChar)=="float32");
+	if(screening) cout << "Screening in single precision (threshold " << screeningThreshold <<
+		")\n";
+
+	// Screened cases are kept apart in the manifest from the ones solved in double precision
+	string caseParameters=screening ? "precision=float32" : "";
+	auto solveCase=[&](function<int()> floatRun, function<int()> doubleRun)
+	{
+		if(!screening) return doubleRun();
+
+		// Borderline cases are solved again in double precision, overwriting the exports
+		int ierr=floatRun();
+		double oscillation=precisionScreening::lastOscillation;
+		bool borderline=fabs(oscillation-screeningThreshold)<=screeningBand*screeningThreshold;
+		resultsManifest::recordValue("float32Oscillation",oscillation);
+		if(borderline && ierr==0)
+		{
+			cout << "Oscillation " << oscillation << " close to the threshold, solved again " <<
+				"in double precision\n";
+			ierr=doubleRun();
+		}
+		resultsManifest::recordSetting("precision",borderline ? "float64" : "float32");
+		resultsManifest::recordValue("pressureOscillation",precisionScreening::lastOscillation);
+
+		return ierr;
+	};
+
 	cout << "Grid type: " << myGridType << "\n";
 	cout << "Interpolation scheme: " << myInterpScheme << "\n";
 	cout << "Minimum time-step: " << consolidationTime/6 << "\n";
@@ -118,8 +160,13 @@ int main(int argc, char** args)
 				Lt=(Nt-1)*(consolidationTime*timestepSize[i]);
 				dt=Lt/(Nt-1);
 				exportSolveRunInfo(dt,"Terzaghi_"+myMedium);
-				ierr=terzaghi(myGridType,myInterpScheme,Nt,mesh,Lt,g,columnLoad,myProperties);
-					CHKERRQ(ierr);
+				if(!myManifest.beginCase("Terzaghi",myGridType,myInterpScheme,myMedium,mesh,Nt,dt,
+					caseParameters))
+					continue;
+				ierr=solveCase([&](){return terzaghi<float>(myGridType,myInterpScheme,Nt,mesh,Lt,g,
+					columnLoad,myProperties);},[&](){return terzaghi(myGridType,myInterpScheme,Nt,
+					mesh,Lt,g,columnLoad,myProperties);});CHKERRQ(ierr);
+				myManifest.completeCase();
 			}
 		}
 		else if(problemsSolved[i]==4)
@@ -131,8 +178,13 @@ int main(int argc, char** args)
 				Lt=(Nt-1)*(consolidationTime*timestepSize[i]);
 				dt=Lt/(Nt-1);
 				exportSolveRunInfo(dt,"Mandel_"+myMedium);
-				ierr=mandel(myGridType,myInterpScheme,Nt,mesh,Lt,0,mandelLoad,myProperties);
-					CHKERRQ(ierr);
+				if(!myManifest.beginCase("Mandel",myGridType,myInterpScheme,myMedium,mesh,Nt,dt,
+					caseParameters))
+					continue;
+				ierr=solveCase([&](){return mandel<float>(myGridType,myInterpScheme,Nt,mesh,Lt,0,
+					mandelLoad,myProperties);},[&](){return mandel(myGridType,myInterpScheme,Nt,
+					mesh,Lt,0,mandelLoad,myProperties);});CHKERRQ(ierr);
+				myManifest.completeCase();
 			}
 		}
 		else if(problemsSolved[i]==8)
@@ -144,8 +196,13 @@ int main(int argc, char** args)
 				Lt=(Nt-1)*(consolidationTime*timestepSize[i]);
 				dt=Lt/(Nt-1);
 				exportSolveRunInfo(dt,"Stripfoot_"+myMedium);
-				ierr=stripfoot(myGridType,myInterpScheme,Nt,mesh,Lt,0,stripLoad,myProperties);
-					CHKERRQ(ierr);
+				if(!myManifest.beginCase("Stripfoot",myGridType,myInterpScheme,myMedium,mesh,Nt,dt,
+					caseParameters))
+					continue;
+				ierr=solveCase([&](){return stripfoot<float>(myGridType,myInterpScheme,Nt,mesh,Lt,
+					0,stripLoad,myProperties);},[&](){return stripfoot(myGridType,myInterpScheme,
+					Nt,mesh,Lt,0,stripLoad,myProperties);});CHKERRQ(ierr);
+				myManifest.completeCase();
 			}
 		}
 	}
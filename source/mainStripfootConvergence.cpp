@@ -0,0 +1,166 @@
+/*
+	This source code implements a Finite Volume Method for discretization and solution of the 
+	consolidation problem as part of a master's thesis entitled "Analysis of Numerical Schemes in
+	Collocated and Staggered Grids for Problems of Poroelasticity". This source code estimates the
+	convergence of the stripfoot problem, which has no analytical solution, from a hierarchy of
+	meshes (h) or of time-steps (t) refined by two, compared on a common reference grid against
+	each other and against a finer reference run. The linear systems are solved with a LU
+	Factorization found in PETSc [1]. When the fractions of the porosity of the pores and of the
+	fractures are given, the double porosity problem is solved instead.
+
+ 	Written by FERREIRA, C. A. S.
+
+ 	Florianópolis, 2019.
+
+ 	[1] BALAY et al. PETSc User Manual. Technical Report, Argonne National Laboratory, 2017.
+*/
+
+#include "customPrinter.hpp"
+#include "exportRunInfo.hpp"
+#include "benchmarking.hpp"
+
+int main(int argc, char** args)
+{	
+	string myGridType=args[1];
+	string myInterpScheme=args[2];
+	string myMedium=args[3];
+	string myHierarchy=args[4];
+	bool isDouble=(argc>6);
+	double pore=isDouble ? stod(args[5]) : 1;
+	double frac=isDouble ? stod(args[6]) : 0;
+
+/*		PROPERTIES IMPORT
+	----------------------------------------------------------------*/	
+
+	poroelasticProperties myProperties;
+	ifstream inFile;
+	inFile.open("../input/"+myMedium+".txt");
+	if(!inFile)
+	{
+		cout << "Unable to open properties file.";
+		exit(1);
+	}
+	getline(inFile,myProperties.pairName);
+	myProperties.pairName=myMedium;
+	inFile >> myProperties.shearModulus;
+	inFile >> myProperties.bulkModulus;
+	inFile >> myProperties.solidBulkModulus;
+	inFile >> myProperties.solidDensity;
+	inFile >> myProperties.fluidBulkModulus;
+	double porosity;
+	inFile >> porosity;
+	inFile >> myProperties.permeability;
+	inFile >> myProperties.fluidViscosity;
+	inFile >> myProperties.fluidDensity;
+	inFile.close();
+	myProperties.porosity=porosity;
+	if(isDouble)
+	{
+		myProperties.macroPorosity=frac*porosity;
+		myProperties.porosity=pore*porosity;
+		myProperties.macroPermeability=myProperties.permeability*1e3;
+	}
+	
+/*		GRID DEFINITION
+	----------------------------------------------------------------*/
+
+	// Consolidation coefficient
+	double storativity,fluidViscosity,permeability,fluidCompressibility,solidCompressibility,
+		bulkCompressibility,longitudinalModulus,alpha;
+	porosity=myProperties.porosity;
+	fluidViscosity=myProperties.fluidViscosity;
+	permeability=myProperties.permeability;
+	if(isDouble)
+	{
+		porosity=myProperties.porosity+myProperties.macroPorosity;
+		permeability=(myProperties.permeability+myProperties.macroPermeability)/2;
+	}
+	fluidCompressibility=1/myProperties.fluidBulkModulus;
+	solidCompressibility=1/myProperties.solidBulkModulus;
+	bulkCompressibility=1/myProperties.bulkModulus;
+	longitudinalModulus=myProperties.bulkModulus+4*myProperties.shearModulus/3;
+	alpha=1-solidCompressibility/bulkCompressibility;
+	storativity=porosity*fluidCompressibility+(alpha-porosity)*solidCompressibility;
+	double consolidationCoefficient=(permeability/fluidViscosity)/(storativity+
+		alpha*alpha/longitudinalModulus);
+
+	// Time of the compared solutions, half the consolidation time of a 1 m volume
+	double Lt=0.5/consolidationCoefficient;
+	double Lx=5; // [m]
+	double Ly=5; // [m]
+	
+/*		OTHER PARAMETERS
+	----------------------------------------------------------------*/
+
+	double stripLoad=-10e3; // Pa
+	
+/*		PETSC INITIALIZE
+	----------------------------------------------------------------*/
+
+	PetscErrorCode ierr;
+	ierr=PetscInitialize(&argc,&args,(char*)0,NULL);CHKERRQ(ierr);
+
+	// Hierarchy: -convergence_levels levels refined by two from -convergence_mesh (h) or from
+	// -convergence_steps time-steps (t), with a reference run refined once more unless
+	// -convergence_reference 0, compared on a -reference_grid squared grid
+	PetscInt levelsNo=3;
+	PetscInt baseMesh=1;
+	PetscInt baseStepsNo=4;
+	PetscInt referenceEnabled=1;
+	PetscInt referenceGridSize=40;
+	PetscOptionsGetInt(NULL,NULL,"-convergence_levels",&levelsNo,NULL);
+	PetscOptionsGetInt(NULL,NULL,"-convergence_mesh",&baseMesh,NULL);
+	PetscOptionsGetInt(NULL,NULL,"-convergence_steps",&baseStepsNo,NULL);
+	PetscOptionsGetInt(NULL,NULL,"-convergence_reference",&referenceEnabled,NULL);
+	PetscOptionsGetInt(NULL,NULL,"-reference_grid",&referenceGridSize,NULL);
+
+	vector<int> meshSizes, timeStepsNo;
+	for(int k=0; k<=levelsNo; k++)
+	{
+		meshSizes.push_back((myHierarchy=="h") ? baseMesh<<k : baseMesh);
+		timeStepsNo.push_back(((myHierarchy=="t") ? baseStepsNo<<k : baseStepsNo)+1);
+	}
+
+/*		SOLVE STRIPFOOT HIERARCHY
+	----------------------------------------------------------------*/
+
+	convergenceAnalysis myAnalysis(Lx,Ly,referenceGridSize,referenceGridSize,levelsNo);
+	string gridName=(myGridType=="staggered") ? myGridType : myGridType+"+"+myInterpScheme;
+	string fileName;
+
+	cout << "Grid type: " << myGridType << "\n";
+	cout << "Interpolation scheme: " << myInterpScheme << "\n";
+	cout << "Medium:" << myProperties.pairName << "\n";
+	cout << "Solved stripfoot for: \n";
+	createSolveRunInfo(myGridType,myInterpScheme,"StripfootConvergence");
+
+	// The reference run, refined once more than the finest level, is solved first
+	for(int k=-1; k<levelsNo; k++)
+	{
+		int level=(k<0) ? levelsNo : k;
+
+		if(k<0 && !referenceEnabled) continue;
+		myAnalysis.fineReferenceRun=(k<0);
+		exportSolveRunInfo(Lt/(timeStepsNo[level]-1),"StripfootConvergence_"+myMedium);
+		if(isDouble) ierr=stripfootDouble(myGridType,myInterpScheme,timeStepsNo[level],
+			meshSizes[level],Lt,0,stripLoad,myProperties,&myAnalysis);
+		else ierr=stripfoot(myGridType,myInterpScheme,timeStepsNo[level],meshSizes[level],Lt,0,
+			stripLoad,myProperties,&myAnalysis);
+		CHKERRQ(ierr);
+	}
+
+	myAnalysis.printSummary();
+	fileName="../export/stripfootConvergence_"+myMedium+"_"+myHierarchy+"_"+gridName+
+		"-grid.txt";
+	myAnalysis.exportSummary(fileName);
+	fileName="../export/stripfoot_"+myMedium+"_PExtrapolated_"+myHierarchy+"_"+gridName+
+		"-grid.txt";
+	myAnalysis.exportExtrapolatedField(fileName,2);
+	
+/*		PETSC FINALIZE
+	----------------------------------------------------------------*/
+	
+	ierr=PetscFinalize();CHKERRQ(ierr);
+
+	return ierr;
+};
\ No newline at end of file
@@ -111,6 +111,7 @@ int main(int argc, char** args)
 	int meshSizeNo=meshSize.size();
 	double dt;
 	double h;
+	resultsManifest myManifest;
 
 	cout << "Grid type: " << myGridType << "\n";
 	cout << "Interpolation scheme: " << myInterpScheme << "\n";
@@ -124,8 +125,12 @@ int main(int argc, char** args)
 
 		for(int j=0; j<timeStepsNo; j++)
 		{
+			dt=Lt/(timeSteps[j]-1);
+			if(!myManifest.beginCase("TerzaghiConvergence",myGridType,myInterpScheme,myMedium,
+				meshSize[i],timeSteps[j],dt)) continue;
 			ierr=convergence(myGridType,myInterpScheme,timeSteps[j],meshSize[i],Lt,g,sigmab,
 				myProperties);CHKERRQ(ierr);
+			myManifest.completeCase();
 		}
 	}
 
@@ -0,0 +1,192 @@
+/*
+	This source code implements a Finite Volume Method for discretization and solution of the
+	consolidation problem as part of a master's thesis entitled "Analysis of Numerical Schemes in
+	Collocated and Staggered Grids for Problems of Poroelasticity". This source code uses the
+	functions predefined for the solution of the problems presented and solved by Terzaghi [3] and
+	Mandel [2], sweeping the media given, every grid type and interpolation scheme, the mesh sizes
+	and the time-step sizes on the ranks of a MPI task farm. The governing equations are discretized
+	within the FVM and the resulting linear system of equations is solved with a LU Factorization
+	found in PETSc [1], each case on a single rank.
+
+ 	Written by FERREIRA, C. A. S.
+
+ 	Florianópolis, 2019.
+
+ 	[1] BALAY et al. PETSc User Manual. Technical Report, Argonne National Laboratory, 2017.
+	[2] MANDEL, J. Consolidation Des Sols (Étude Mathématique). Géotechnique, v. 3, n. 7, pp. 287-
+	299, 1953.
+ 	[3] TERZAGHI, K. Erdbaumechanik auf Bodenphysikalischer Grundlage. Franz Deuticke, Leipzig,
+ 	1925.
+*/
+
+#include "customPrinter.hpp"
+#include "exportRunInfo.hpp"
+#include "benchmarking.hpp"
+
+int main(int argc, char** args)
+{
+	vector<int> problemsSolved;
+	problemsSolved.push_back(atoi(args[1])/100%10);
+	problemsSolved.push_back(atoi(args[1])/10%10);
+	problemsSolved.push_back(atoi(args[1])%10);
+	vector<string> myMedia;
+	for(int i=2; i<argc && args[i][0]!='-'; i++) myMedia.push_back(args[i]);
+
+/*		PROPERTIES IMPORT
+	----------------------------------------------------------------*/
+
+	map<string,poroelasticProperties> myProperties;
+	map<string,double> consolidationCoefficient;
+	for(int i=0; i<myMedia.size(); i++)
+	{
+		poroelasticProperties& properties=myProperties[myMedia[i]];
+		ifstream inFile;
+		inFile.open("../input/"+myMedia[i]+".txt");
+		if(!inFile)
+		{
+			cout << "Unable to open properties file.";
+			exit(1);
+		}
+		getline(inFile,properties.pairName);
+		properties.pairName=myMedia[i];
+		inFile >> properties.shearModulus;
+		inFile >> properties.bulkModulus;
+		inFile >> properties.solidBulkModulus;
+		inFile >> properties.solidDensity;
+		inFile >> properties.fluidBulkModulus;
+		inFile >> properties.porosity;
+		inFile >> properties.permeability;
+		inFile >> properties.fluidViscosity;
+		inFile >> properties.fluidDensity;
+		inFile.close();
+
+		// Consolidation coefficient
+		double storativity,porosity,fluidViscosity,permeability,fluidCompressibility,
+			solidCompressibility,bulkCompressibility,longitudinalModulus,alpha;
+		porosity=properties.porosity;
+		fluidViscosity=properties.fluidViscosity;
+		permeability=properties.permeability;
+		fluidCompressibility=1/properties.fluidBulkModulus;
+		solidCompressibility=1/properties.solidBulkModulus;
+		bulkCompressibility=1/properties.bulkModulus;
+		longitudinalModulus=properties.bulkModulus+4*properties.shearModulus/3;
+		alpha=1-solidCompressibility/bulkCompressibility;
+		storativity=porosity*fluidCompressibility+(alpha-porosity)*solidCompressibility;
+		consolidationCoefficient[myMedia[i]]=(permeability/fluidViscosity)/(storativity+
+			alpha*alpha/longitudinalModulus);
+	}
+
+/*		SWEEP DEFINITION
+	----------------------------------------------------------------*/
+
+	vector<vector<string>> formulations=
+	{
+		{"staggered","NA"},
+		{"collocated","CDS"},
+		{"collocated","1DPIS"},
+		{"collocated","I2DPIS"},
+		{"collocated","C2DPIS"}
+	};
+
+	vector<int> meshSizes=
+	{
+		{3},
+		{5},
+		{10},
+		{15}
+	};
+
+	// Time-step sizes relative to the consolidation time of a FV
+	vector<double> timestepSize=
+	{
+		0.50,
+		0.10
+	};
+
+	int Nt=501;
+
+/*		OTHER PARAMETERS
+	----------------------------------------------------------------*/
+
+	double g=0; // m/s^2
+	double columnLoad=-10e3; // Pa
+	double mandelLoad=-10e4; // N/m
+	double stripLoad=-10e3; // Pa
+
+/*		PETSC INITIALIZE
+	----------------------------------------------------------------*/
+
+	PetscErrorCode ierr;
+	ierr=PetscInitialize(&argc,&args,(char*)0,NULL);CHKERRQ(ierr);
+
+/*		SOLVE BENCHMARKING PROBLEMS
+	----------------------------------------------------------------*/
+
+	resultsManifest myManifest;
+	taskFarm myFarm;
+
+	// Every rank builds the same cases, in the same order
+	for(int i=0; i<3; i++)
+	{
+		string problemName;
+		int areaNo;
+
+		// FV of the grid per square of the mesh size
+		if(problemsSolved[i]==2)
+		{
+			problemName="Terzaghi";
+			areaNo=6;
+		}
+		else if(problemsSolved[i]==4)
+		{
+			problemName="Mandel";
+			areaNo=25;
+		}
+		else if(problemsSolved[i]==8)
+		{
+			problemName="Stripfoot";
+			areaNo=25;
+		}
+		else continue;
+
+		for(int j=0; j<myMedia.size(); j++)
+		for(int k=0; k<formulations.size(); k++)
+		for(int l=0; l<meshSizes.size(); l++)
+		for(int m=0; m<timestepSize.size(); m++)
+		{
+			double h=1./meshSizes[l];
+			double consolidationTime=h*h/consolidationCoefficient[myMedia[j]];
+			farmCase myCase;
+
+			myCase.problemName=problemName;
+			myCase.gridType=formulations[k][0];
+			myCase.interpScheme=formulations[k][1];
+			myCase.medium=myMedia[j];
+			myCase.meshSize=meshSizes[l];
+			myCase.Nt=Nt;
+			myCase.dt=consolidationTime*timestepSize[m];
+			myCase.cost=3.*areaNo*meshSizes[l]*meshSizes[l]*(Nt-1);
+			myFarm.addCase(myCase);
+		}
+	}
+
+	ierr=myFarm.run([&](const farmCase& myCase)
+	{
+		double Lt=(myCase.Nt-1)*myCase.dt;
+		poroelasticProperties& properties=myProperties[myCase.medium];
+
+		if(myCase.problemName=="Terzaghi") return terzaghi(myCase.gridType,myCase.interpScheme,
+			myCase.Nt,myCase.meshSize,Lt,g,columnLoad,properties);
+		else if(myCase.problemName=="Mandel") return mandel(myCase.gridType,myCase.interpScheme,
+			myCase.Nt,myCase.meshSize,Lt,0,mandelLoad,properties);
+		else return stripfoot(myCase.gridType,myCase.interpScheme,myCase.Nt,myCase.meshSize,Lt,0,
+			stripLoad,properties);
+	},myManifest);CHKERRQ(ierr);
+
+/*		PETSC FINALIZE
+	----------------------------------------------------------------*/
+
+	ierr=PetscFinalize();CHKERRQ(ierr);
+
+	return ierr;
+};